@@ -6,11 +6,15 @@ layout (location = 2) in mat4 instanceModel;
 
 layout (location = 0) out vec3 vertexColor;
 
-layout (location = 0) uniform mat4 view;
-layout (location = 1) uniform mat4 projection;
+// Shared by every shader, updated once per frame (see UniformBinding::Camera)
+layout (std140) uniform Camera
+{
+    mat4 view;
+    mat4 projection;
+};
 
 void main()
 {
     gl_Position = projection * view * instanceModel * vec4(aPos.x, aPos.y, aPos.z, 1.0);
     vertexColor = aColor;
-}
\ No newline at end of file
+}
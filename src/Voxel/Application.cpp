@@ -6,8 +6,12 @@
 #include <imgui_internal.h>
 #include <Voxel/Camera.h>
 #include <Voxel/EditorSettings.h>
+#include <Voxel/Memory/FrameArena.h>
 #include <Voxel/Rendering/FrameBuffer.h>
+#include <Voxel/Rendering/GpuProfiler.h>
 #include <Voxel/Rendering/ShaderLoader.h>
+#include <Voxel/Rendering/ShaderWatcher.h>
+#include <Voxel/Rendering/UniformBuffer.h>
 #include <Voxel/UI/MainUI.h>
 
 Application* Application::instance = nullptr;
@@ -19,27 +23,39 @@ Application* Application::GetInstance() {
     return instance;
 }
 
-bool Application::Initialise() {
+bool Application::Initialise(const LaunchOptions& launchOptions) {
+    this->options = launchOptions;
     EditorSettings::Initialise("EditorSettings.ini");
+    Log::ApplySettings();
+    Profiler::SetWindowFrames(EditorSettings::GetInt("Profiler", "WindowFrames", 300));
     InitialiseOpenGl();
     if (window == nullptr) {
         return false;
     }
-    MainUI::Initialise();
+    if (!IsHeadless()) {
+        MainUI::Initialise();
+    }
     if (!LoadShaders()) {
         return false;
     }
     InitialiseFrameBuffer();
+    GpuProfiler::Init();
     SetupCamera();
     return true;
 }
 
 void Application::Shutdown() {
+    delete this->shaderWatcher;
+    this->shaderWatcher = nullptr;
+
     activeShaderProgram->Delete();
+    GpuProfiler::Shutdown();
 
-    ImGui_ImplOpenGL3_Shutdown();
-    ImGui_ImplGlfw_Shutdown();
-    ImGui::DestroyContext();
+    if (!IsHeadless()) {
+        ImGui_ImplOpenGL3_Shutdown();
+        ImGui_ImplGlfw_Shutdown();
+        ImGui::DestroyContext();
+    }
 
     glfwDestroyWindow(window);
     glfwTerminate();
@@ -51,9 +67,16 @@ void Application::Shutdown() {
 
     delete this->camera;
     this->camera = nullptr;
+
+    FrameArena::Release();
 }
 
 void Application::InitialiseOpenGl() {
+    if (IsHeadless()) {
+        CreateHeadlessWindow();
+        return;
+    }
+
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
@@ -101,15 +124,58 @@ void Application::InitialiseOpenGl() {
     LOG_INFO("Initialised OpenGL with screen size ({}, {})", fbWidth, fbHeight);
 }
 
+// Headless runs use GLFW's null platform, which needs no display server, with either a
+// surfaceless EGL context or an OSMesa (llvmpipe) software context. All rendering goes to the
+// scene framebuffer, so the window itself is never presented.
+bool Application::CreateHeadlessWindow() {
+    glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+    if (!glfwInit()) {
+        LOG_FATAL("Failed to initialise GLFW null platform");
+        return false;
+    }
+
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    glfwWindowHint(GLFW_CONTEXT_CREATION_API, options.contextApi == "egl"
+                                                  ? GLFW_EGL_CONTEXT_API
+                                                  : GLFW_OSMESA_CONTEXT_API);
+
+    GLFWwindow* window =
+        glfwCreateWindow(options.width, options.height, "Voxel Editor (headless)", NULL, NULL);
+    if (window == NULL) {
+        LOG_FATAL("Failed to create headless {} context", options.contextApi);
+        glfwTerminate();
+        return false;
+    }
+    glfwMakeContextCurrent(window);
+    glfwSwapInterval(0);
+
+    if (!gladLoadGL(glfwGetProcAddress)) {
+        LOG_FATAL("Failed to initialise GLAD");
+        glfwTerminate();
+        return false;
+    }
+
+    glViewport(0, 0, options.width, options.height);
+    this->sceneViewportWidth = options.width;
+    this->sceneViewportHeight = options.height;
+    this->window = window;
+    LOG_INFO("Initialised headless OpenGL ({}) with {}", options.contextApi,
+             (const char*)glGetString(GL_RENDERER));
+    return true;
+}
+
 bool Application::LoadShaders() {
     // Load shaders
     bool shaderSuccess = false;
-    std::string vertexPath =
-        std::filesystem::current_path().string() + "\\resources\\shaders\\vertex.vert";
-    std::string fragmentPath =
-        std::filesystem::current_path().string() + "\\resources\\shaders\\fragment.frag";
-    Shader shader =
-        ShaderLoader::CreateShaderProgram(vertexPath.c_str(), fragmentPath.c_str(), shaderSuccess);
+    std::filesystem::path shaderDirectory =
+        std::filesystem::current_path() / "resources" / "shaders";
+    std::filesystem::path vertexPath = shaderDirectory / "vertex.vert";
+    std::filesystem::path fragmentPath = shaderDirectory / "fragment.frag";
+    Shader shader = ShaderLoader::CreateShaderProgram(
+        vertexPath.string().c_str(), fragmentPath.string().c_str(), shaderSuccess);
 
     // If shader compilation/linking failed
     if (!shaderSuccess) {
@@ -118,11 +184,46 @@ bool Application::LoadShaders() {
         return false;
     }
     this->activeShaderProgram = new Shader(shader);
+    this->activeShaderProgram->BindUniformBlock("Camera",
+                                                static_cast<unsigned int>(UniformBinding::Camera));
+
+    if (EditorSettings::GetBool("Shaders", "HotReload", true)) {
+        this->shaderWatcher = new ShaderWatcher(vertexPath, fragmentPath);
+        this->shaderWatcher->Start();
+    }
 
     LOG_INFO("Loaded shaders");
     return true;
 }
 
+// Compile and link any shader sources the watcher has re-read. The active program is only
+// replaced once the new one links, so a broken edit keeps the last working shader on screen.
+void Application::ReloadChangedShaders() {
+    ShaderSources sources;
+    if (this->shaderWatcher == nullptr || !this->shaderWatcher->ConsumeChanges(sources))
+        return;
+
+    bool shaderSuccess = false;
+    Shader shader = ShaderLoader::CreateShaderProgramFromSource(
+        sources.vertexSource, sources.fragmentSource, shaderSuccess);
+
+    if (!shaderSuccess) {
+        shader.Delete();
+        LOG_ERROR("Shader reload failed, keeping the previous shader program");
+        return;
+    }
+
+    Shader* reloadedShader = new Shader(shader);
+    reloadedShader->BindUniformBlock("Camera", static_cast<unsigned int>(UniformBinding::Camera));
+
+    Shader* previousShader = this->activeShaderProgram;
+    this->activeShaderProgram = reloadedShader;
+    previousShader->Delete();
+    delete previousShader;
+
+    LOG_INFO("Reloaded shaders");
+}
+
 void Application::InitialiseFrameBuffer() {
     glEnable(GL_DEPTH_TEST);
     glEnable(GL_CULL_FACE);
@@ -137,9 +238,17 @@ void Application::InitialiseFrameBuffer() {
 
 void Application::SetupCamera() { this->camera = new Camera(); }
 
-bool Application::ShouldStayOpen() { return !glfwWindowShouldClose(window); }
+bool Application::ShouldStayOpen() {
+    if (IsHeadless())
+        return renderedFrames < options.frames;
+    return !glfwWindowShouldClose(window);
+}
+
+bool Application::IsHeadless() const { return options.headless; }
 
 void Application::StartFrame() {
+    FrameArena::Reset();
+
     // Calculate delta time
     float currentFrame = static_cast<float>(glfwGetTime());
     this->deltaTime = currentFrame - this->lastFrame;
@@ -153,15 +262,18 @@ void Application::StartFrame() {
         this->lastTime += 1.0;
     }
 
+    ReloadChangedShaders();
     this->activeShaderProgram->Use();
     this->sceneBuffer->Bind();
     glEnable(GL_DEPTH_TEST);
 
     glfwPollEvents();
-    ImGui_ImplOpenGL3_NewFrame();
-    ImGui_ImplGlfw_NewFrame();
+    if (!IsHeadless()) {
+        ImGui_ImplOpenGL3_NewFrame();
+        ImGui_ImplGlfw_NewFrame();
 
-    ImGui::NewFrame();
+        ImGui::NewFrame();
+    }
 
     glClearColor(0.12f, 0.12f, 0.15f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -172,6 +284,14 @@ void Application::EndFrame() {
     sceneBuffer->Unbind();
     glDisable(GL_DEPTH_TEST); // Disable depth test so screen-space quad isnt discarded
 
+    if (IsHeadless()) {
+        // Wait for the GPU so frame timings include the actual rendering work
+        glFinish();
+        GpuProfiler::EndFrame();
+        renderedFrames++;
+        return;
+    }
+
     // Render over previous frame
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT);
@@ -179,6 +299,7 @@ void Application::EndFrame() {
     // Render ImGui stuff
     MainUI::RenderUI();
     glfwSwapBuffers(window);
+    GpuProfiler::EndFrame();
 }
 
 float Application::DeltaTime() { return this->deltaTime; }
@@ -195,6 +316,8 @@ int Application::GetSceneViewportHeight() { return this->sceneViewportHeight; }
 
 Camera* Application::GetCamera() { return this->camera; }
 
+const LaunchOptions& Application::GetLaunchOptions() const { return this->options; }
+
 void Application::SetSceneViewportWidth(int width) { this->sceneViewportWidth = width; }
 
 void Application::SetSceneViewportHeight(int height) { this->sceneViewportHeight = height; }
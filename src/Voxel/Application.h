@@ -1,12 +1,14 @@
 #pragma once
+#include <Voxel/LaunchOptions.h>
 
 class Application {
   public:
     static class Application* GetInstance();
 
-    bool Initialise();
+    bool Initialise(const LaunchOptions& launchOptions = LaunchOptions());
     void Shutdown();
     bool ShouldStayOpen();
+    bool IsHeadless() const;
     void StartFrame();
     void EndFrame();
     float DeltaTime();
@@ -18,11 +20,14 @@ class Application {
     void SetSceneViewportWidth(int width);
     void SetSceneViewportHeight(int height);
     class Camera* GetCamera();
+    const LaunchOptions& GetLaunchOptions() const;
 
   private:
     Application() = default;
     void InitialiseOpenGl();
+    bool CreateHeadlessWindow();
     bool LoadShaders();
+    void ReloadChangedShaders();
     void InitialiseFrameBuffer();
     void SetupCamera();
 
@@ -30,10 +35,12 @@ class Application {
 
   private:
     static Application* instance;
+    LaunchOptions options;
     class Camera* camera = nullptr;
 
     struct GLFWwindow* window = nullptr;
     class Shader* activeShaderProgram = nullptr;
+    class ShaderWatcher* shaderWatcher = nullptr;
     class FrameBuffer* sceneBuffer = nullptr;
     int sceneViewportWidth = 0;
     int sceneViewportHeight = 0;
@@ -41,4 +48,5 @@ class Application {
     float lastFrame = 0.0f;
     double lastTime = 0;
     int nbFrames = 0;
+    int renderedFrames = 0;
 };
\ No newline at end of file
@@ -0,0 +1,184 @@
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <Voxel/Benchmark/BenchReport.h>
+#include <Voxel/Benchmark/HeadlessRunner.h>
+#include <Voxel/Benchmark/MicroBenchmark.h>
+#include <Voxel/Camera.h>
+#include <Voxel/ECS/Systems/RenderSystem.h>
+#include <Voxel/ECS/Systems/TransformSystem.h>
+#include <Voxel/ECS/Systems/VisibilitySystem.h>
+#include <Voxel/Rendering/Primitives.h>
+#include <Voxel/Rendering/RawModel.h>
+#include <Voxel/Scene/SceneDescription.h>
+
+// voxel_bench run --scene <scene> [--frames N] [--warmup N] [--report results.json]
+//                 [--width W] [--height H] [--context egl|osmesa] [--camera-path path.txt]
+//                 [--timings frames.csv] [--dump-frames dir/]
+// voxel_bench compare <baseline.json> <current.json> [--threshold percent] [--noise-floor ms]
+// voxel_bench micro <name> [--repetitions N] [--warmup N] [--report results.json] [options]
+
+int RunBenchmark(int argc, char** argv);
+int CompareReports(int argc, char** argv);
+int RunMicroBenchmark(int argc, char** argv);
+
+int main(int argc, char** argv) {
+    Log::Init();
+
+    std::string mode = argc > 1 ? argv[1] : "";
+    if (mode == "run")
+        return RunBenchmark(argc - 1, argv + 1);
+    if (mode == "compare")
+        return CompareReports(argc - 1, argv + 1);
+    if (mode == "micro")
+        return RunMicroBenchmark(argc - 1, argv + 1);
+
+    LOG_ERROR("Usage: voxel_bench run --scene <scene> [options] | voxel_bench compare "
+              "<baseline.json> <current.json> [--threshold percent] | voxel_bench micro <name>");
+    return 1;
+}
+
+int RunBenchmark(int argc, char** argv) {
+    LaunchOptions options = LaunchOptions::Parse(argc, argv);
+    options.headless = true;
+    if (options.reportPath.empty())
+        options.reportPath = "bench_results.json";
+
+    SceneDescription scene;
+    if (!SceneDescription::Load(options.scenePath, scene))
+        return 2;
+    if (options.cameraPath.empty())
+        options.cameraPath = scene.GetCameraPath();
+
+    // Warmup frames run the same script but are dropped from the report
+    options.frames += options.warmupFrames;
+
+    Application* application = Application::GetInstance();
+    if (!application->Initialise(options)) {
+        Log::Shutdown();
+        return 3;
+    }
+
+    EntityRegistry* entityRegistry = EntityRegistry::GetInstance();
+    Camera* camera = application->GetCamera();
+    RawModel cubeModel = Primitives::CreateCube();
+
+    RenderSystem::Init(application, camera, entityRegistry);
+    TransformSystem::Init(entityRegistry);
+    VisibilitySystem::Init(entityRegistry);
+    scene.Instantiate(entityRegistry, &cubeModel);
+
+    HeadlessRunner runner(options, camera, scene.GetCenter(), scene.GetRadius());
+
+    int frameIndex = 0;
+    while (application->ShouldStayOpen()) {
+        runner.BeginFrame(frameIndex);
+        scene.ApplyEdits(entityRegistry, frameIndex);
+
+        Profiler::StartFrame();
+        {
+            PROFILE_SCOPE("Frame");
+            application->StartFrame();
+            {
+                PROFILE_SCOPE("System");
+                VisibilitySystem::Run();
+                TransformSystem::Run();
+                RenderSystem::Run();
+            }
+            application->EndFrame();
+        }
+        Profiler::EndFrame();
+
+        runner.EndFrame(frameIndex);
+        frameIndex++;
+    }
+
+    runner.WriteTimings();
+
+    BenchReport report = BenchReport::FromTimings(runner.GetTimerNames(),
+                                                  runner.GetFrameTimings(), options.warmupFrames);
+    report.scene = options.scenePath.filename().string();
+    report.renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+    report.width = options.width;
+    report.height = options.height;
+
+    if (const TimerSummary* frame = report.FindTimer("Frame")) {
+        LOG_INFO("Frame p50 {:.3f} ms, p95 {:.3f} ms, p99 {:.3f} ms over {} frames", frame->p50,
+                 frame->p95, frame->p99, report.frames);
+    }
+    bool written = report.Write(options.reportPath);
+
+    RenderSystem::Shutdown();
+    cubeModel.DeleteModel();
+    entityRegistry->Cleanup();
+    delete entityRegistry;
+    entityRegistry = nullptr;
+    application->Shutdown();
+    delete application;
+    application = nullptr;
+    Log::Shutdown();
+
+    return written ? 0 : 4;
+}
+
+int CompareReports(int argc, char** argv) {
+    std::vector<std::filesystem::path> paths;
+    float thresholdPercent = 5.0f;
+    float noiseFloorMs = 0.05f;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--threshold" && hasValue) {
+            thresholdPercent = std::max(0.0f, static_cast<float>(std::atof(argv[++i])));
+        } else if (arg == "--noise-floor" && hasValue) {
+            noiseFloorMs = std::max(0.0f, static_cast<float>(std::atof(argv[++i])));
+        } else {
+            paths.emplace_back(arg);
+        }
+    }
+
+    if (paths.size() != 2) {
+        LOG_ERROR("compare expects a baseline and a current report");
+        return 1;
+    }
+
+    BenchReport baseline, current;
+    if (!BenchReport::Load(paths[0], baseline) || !BenchReport::Load(paths[1], current))
+        return 2;
+
+    // Non-zero exit when anything regressed so CI can fail the job
+    return BenchReport::Compare(baseline, current, thresholdPercent, noiseFloorMs) > 0 ? 5 : 0;
+}
+
+int RunMicroBenchmark(int argc, char** argv) {
+    static const std::pair<const char*, void (*)(MicroBenchmark&)> benchmarks[] = {
+        {"brush", RunBrushBenchmark},
+        {"chunks", RunChunkBenchmark},
+        {"csg", RunCsgBenchmark},
+        {"events", RunEventBenchmark},
+        {"export", RunExportBenchmark},
+        {"regions", RunRegionBenchmark},
+        {"scene", RunSceneBenchmark},
+        {"snapshot", RunSnapshotBenchmark},
+        {"streaming", RunStreamingBenchmark},
+        {"undo", RunUndoBenchmark},
+        {"vox", RunVoxBenchmark},
+    };
+
+    std::string name = argc > 1 ? argv[1] : "";
+    for (const auto& [benchmarkName, run] : benchmarks) {
+        if (name != benchmarkName)
+            continue;
+
+        MicroBenchmark benchmark(name, argc - 1, argv + 1);
+        run(benchmark);
+        return benchmark.Finish();
+    }
+
+    std::string names;
+    for (const auto& [benchmarkName, run] : benchmarks)
+        names += std::string(names.empty() ? "" : ", ") + benchmarkName;
+    LOG_ERROR("Unknown micro benchmark '{}', expected one of: {}", name, names);
+    return 1;
+}
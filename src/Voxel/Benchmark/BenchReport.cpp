@@ -0,0 +1,309 @@
+#include "BenchReport.h"
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <cmath>
+#include <iterator>
+
+namespace {
+// Nearest-rank percentile of an already sorted sample set
+float Percentile(const std::vector<float>& sorted, float percent) {
+    if (sorted.empty())
+        return 0.0f;
+    size_t rank = static_cast<size_t>(std::ceil(percent / 100.0f * sorted.size()));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+void WriteJsonString(std::ofstream& file, const std::string& value) {
+    file << '"';
+    for (char c : value) {
+        if (c == '"' || c == '\\')
+            file << '\\';
+        file << c;
+    }
+    file << '"';
+}
+
+// Just enough JSON to read back the reports written below: objects, strings and numbers, with
+// any other value skipped
+class JsonReader {
+  public:
+    explicit JsonReader(std::string text) : text(std::move(text)) {}
+
+    bool ReadString(std::string& out) {
+        SkipWhitespace();
+        if (!Consume('"'))
+            return false;
+        out.clear();
+        while (position < text.size() && text[position] != '"') {
+            if (text[position] == '\\' && position + 1 < text.size())
+                position++;
+            out += text[position++];
+        }
+        return Consume('"');
+    }
+
+    bool ReadNumber(double& out) {
+        SkipWhitespace();
+        const char* start = text.c_str() + position;
+        char* end = nullptr;
+        out = std::strtod(start, &end);
+        if (end == start)
+            return false;
+        position += end - start;
+        return true;
+    }
+
+    // Calls onMember(key) for each member, which must consume the value
+    template <typename F> bool ReadObject(F&& onMember) {
+        SkipWhitespace();
+        if (!Consume('{'))
+            return false;
+        SkipWhitespace();
+        if (Consume('}'))
+            return true;
+
+        do {
+            std::string key;
+            if (!ReadString(key))
+                return false;
+            SkipWhitespace();
+            if (!Consume(':') || !onMember(key))
+                return false;
+            SkipWhitespace();
+        } while (Consume(','));
+        return Consume('}');
+    }
+
+    bool SkipValue() {
+        SkipWhitespace();
+        if (position >= text.size())
+            return false;
+
+        char c = text[position];
+        if (c == '{')
+            return ReadObject([this](const std::string&) { return SkipValue(); });
+        if (c == '"') {
+            std::string ignored;
+            return ReadString(ignored);
+        }
+        if (c == '[') {
+            position++;
+            SkipWhitespace();
+            if (Consume(']'))
+                return true;
+            do {
+                if (!SkipValue())
+                    return false;
+                SkipWhitespace();
+            } while (Consume(','));
+            return Consume(']');
+        }
+
+        // Numbers, true, false and null
+        size_t end = text.find_first_of(",}] \t\r\n", position);
+        position = end == std::string::npos ? text.size() : end;
+        return true;
+    }
+
+  private:
+    void SkipWhitespace() {
+        while (position < text.size() && std::isspace(static_cast<unsigned char>(text[position])))
+            position++;
+    }
+
+    bool Consume(char c) {
+        if (position < text.size() && text[position] == c) {
+            position++;
+            return true;
+        }
+        return false;
+    }
+
+    std::string text;
+    size_t position = 0;
+};
+} // namespace
+
+BenchReport BenchReport::FromTimings(const std::vector<std::string>& timerNames,
+                                     const std::vector<std::vector<float>>& frameTimings,
+                                     int warmupFrames) {
+    BenchReport report;
+    size_t firstFrame = std::min(static_cast<size_t>(std::max(warmupFrames, 0)),
+                                 frameTimings.size());
+    report.frames = static_cast<int>(frameTimings.size() - firstFrame);
+    report.warmupFrames = static_cast<int>(firstFrame);
+
+    std::vector<float> samples;
+    samples.reserve(frameTimings.size() - firstFrame);
+
+    for (size_t timer = 0; timer < timerNames.size(); timer++) {
+        samples.clear();
+        for (size_t frame = firstFrame; frame < frameTimings.size(); frame++) {
+            const std::vector<float>& row = frameTimings[frame];
+            samples.push_back(timer < row.size() ? row[timer] : 0.0f);
+        }
+        std::sort(samples.begin(), samples.end());
+
+        TimerSummary& summary = report.timers.emplace_back();
+        summary.name = timerNames[timer];
+        if (samples.empty())
+            continue;
+
+        summary.mean = std::accumulate(samples.begin(), samples.end(), 0.0f) / samples.size();
+        summary.p50 = Percentile(samples, 50.0f);
+        summary.p95 = Percentile(samples, 95.0f);
+        summary.p99 = Percentile(samples, 99.0f);
+        summary.max = samples.back();
+    }
+
+    return report;
+}
+
+bool BenchReport::Write(const std::filesystem::path& path) const {
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    if (!file.is_open()) {
+        LOG_ERROR("Unable to open {} for writing", path.string());
+        return false;
+    }
+
+    file << "{\n  \"scene\": ";
+    WriteJsonString(file, scene);
+    file << ",\n  \"renderer\": ";
+    WriteJsonString(file, renderer);
+    file << ",\n  \"frames\": " << frames << ",\n  \"warmup\": " << warmupFrames
+         << ",\n  \"width\": " << width << ",\n  \"height\": " << height
+         << ",\n  \"timers_ms\": {\n";
+
+    for (size_t i = 0; i < timers.size(); i++) {
+        const TimerSummary& timer = timers[i];
+        file << "    ";
+        WriteJsonString(file, timer.name);
+        file << ": {\"mean\": " << timer.mean << ", \"p50\": " << timer.p50
+             << ", \"p95\": " << timer.p95 << ", \"p99\": " << timer.p99
+             << ", \"max\": " << timer.max << "}" << (i + 1 < timers.size() ? "," : "") << "\n";
+    }
+
+    file << "  }\n}\n";
+    if (!file.good())
+        return false;
+
+    LOG_INFO("Wrote benchmark report to {}", path.string());
+    return true;
+}
+
+bool BenchReport::Load(const std::filesystem::path& path, BenchReport& outReport) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        LOG_ERROR("Unable to open benchmark report {}", path.string());
+        return false;
+    }
+
+    outReport = BenchReport();
+    JsonReader reader(std::string(std::istreambuf_iterator<char>(file), {}));
+
+    auto readInt = [&reader](int& out) {
+        double value = 0.0;
+        bool read = reader.ReadNumber(value);
+        out = static_cast<int>(value);
+        return read;
+    };
+
+    auto readTimer = [&reader, &outReport](const std::string& name) {
+        TimerSummary& timer = outReport.timers.emplace_back();
+        timer.name = name;
+        return reader.ReadObject([&reader, &timer](const std::string& key) {
+            float* field = key == "mean"  ? &timer.mean
+                           : key == "p50" ? &timer.p50
+                           : key == "p95" ? &timer.p95
+                           : key == "p99" ? &timer.p99
+                           : key == "max" ? &timer.max
+                                          : nullptr;
+            if (!field)
+                return reader.SkipValue();
+            double value = 0.0;
+            bool read = reader.ReadNumber(value);
+            *field = static_cast<float>(value);
+            return read;
+        });
+    };
+
+    bool parsed = reader.ReadObject([&](const std::string& key) {
+        if (key == "scene")
+            return reader.ReadString(outReport.scene);
+        if (key == "renderer")
+            return reader.ReadString(outReport.renderer);
+        if (key == "frames")
+            return readInt(outReport.frames);
+        if (key == "warmup")
+            return readInt(outReport.warmupFrames);
+        if (key == "width")
+            return readInt(outReport.width);
+        if (key == "height")
+            return readInt(outReport.height);
+        if (key == "timers_ms")
+            return reader.ReadObject(readTimer);
+        return reader.SkipValue();
+    });
+
+    if (!parsed)
+        LOG_ERROR("Malformed benchmark report {}", path.string());
+    return parsed;
+}
+
+const TimerSummary* BenchReport::FindTimer(const std::string& name) const {
+    auto it = std::find_if(timers.begin(), timers.end(),
+                           [&name](const TimerSummary& timer) { return timer.name == name; });
+    return it != timers.end() ? &*it : nullptr;
+}
+
+int BenchReport::Compare(const BenchReport& baseline, const BenchReport& current,
+                         float thresholdPercent, float noiseFloorMs) {
+    if (baseline.scene != current.scene || baseline.renderer != current.renderer)
+        LOG_WARN("Comparing different setups: {} on {} vs {} on {}", baseline.scene,
+                 baseline.renderer, current.scene, current.renderer);
+
+    int regressions = 0;
+    for (const TimerSummary& timer : current.timers) {
+        const TimerSummary* base = baseline.FindTimer(timer.name);
+        if (!base) {
+            LOG_INFO("{:<40} new scope, p95 {:.3f} ms", timer.name, timer.p95);
+            continue;
+        }
+
+        const std::pair<const char*, std::pair<float, float>> metrics[] = {
+            {"p50", {base->p50, timer.p50}},
+            {"p95", {base->p95, timer.p95}},
+            {"p99", {base->p99, timer.p99}},
+        };
+
+        bool regressed = false;
+        for (const auto& [metric, values] : metrics) {
+            auto [before, after] = values;
+            float delta = after - before;
+            float percent = before > 0.0f ? delta / before * 100.0f : 0.0f;
+            if (std::abs(delta) < noiseFloorMs || std::abs(percent) < thresholdPercent)
+                continue;
+
+            if (delta > 0.0f) {
+                regressed = true;
+                LOG_WARN("{:<40} {} {:.3f} -> {:.3f} ms (+{:.1f}%)", timer.name, metric, before,
+                         after, percent);
+            } else {
+                LOG_INFO("{:<40} {} {:.3f} -> {:.3f} ms ({:.1f}%)", timer.name, metric, before,
+                         after, percent);
+            }
+        }
+        regressions += regressed ? 1 : 0;
+    }
+
+    for (const TimerSummary& base : baseline.timers) {
+        if (!current.FindTimer(base.name))
+            LOG_INFO("{:<40} missing from the current run", base.name);
+    }
+
+    if (regressions > 0)
+        LOG_ERROR("{} scope(s) regressed by more than {:.1f}%", regressions, thresholdPercent);
+    else
+        LOG_INFO("No regressions beyond {:.1f}%", thresholdPercent);
+    return regressions;
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <Voxel/pch.h>
+
+// Frame time distribution of a single profiler scope, in milliseconds
+struct TimerSummary {
+    std::string name;
+    float mean = 0.0f;
+    float p50 = 0.0f;
+    float p95 = 0.0f;
+    float p99 = 0.0f;
+    float max = 0.0f;
+};
+
+// Per-scope percentiles of a voxel_bench run. Written as JSON so runs can be archived and
+// compared against each other later.
+class BenchReport {
+  public:
+    // Summarise per-frame timings (row per frame, column per timer, short rows padded with
+    // zeros), dropping warmup frames
+    static BenchReport FromTimings(const std::vector<std::string>& timerNames,
+                                   const std::vector<std::vector<float>>& frameTimings,
+                                   int warmupFrames);
+
+    static bool Load(const std::filesystem::path& path, BenchReport& outReport);
+    bool Write(const std::filesystem::path& path) const;
+
+    // Logs every scope that got slower by more than thresholdPercent at p50, p95 or p99 and
+    // returns how many did. Differences below noiseFloorMs are never reported.
+    static int Compare(const BenchReport& baseline, const BenchReport& current,
+                       float thresholdPercent, float noiseFloorMs);
+
+    const TimerSummary* FindTimer(const std::string& name) const;
+
+    std::string scene;
+    std::string renderer;
+    int frames = 0;
+    int warmupFrames = 0;
+    int width = 0;
+    int height = 0;
+    std::vector<TimerSummary> timers;
+};
@@ -0,0 +1,239 @@
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <format>
+#include <Voxel/Benchmark/MicroBenchmark.h>
+#include <Voxel/Benchmark/TestVolumes.h>
+#include <Voxel/Editing/UndoHistory.h>
+#include <Voxel/Editing/VoxelTools.h>
+
+// voxel_bench micro brush [--size N] [--box N] [--radius N]
+//
+// VoxelTools throughput in voxels per second: a box fill --box voxels across (512) aligned to
+// chunks and off by a few voxels, in an empty volume, then a sphere of --radius (64), a cylinder
+// and a colour replace in TestVolumes::Terrain --size voxels across (512), and the box fill
+// recorded for undo. Each tool is first checked against setting its voxels one at a time, on a
+// small terrain, along with the chunks it marked dirty.
+
+namespace {
+struct Tool {
+    std::string name;
+    // The tool, writing the given voxel
+    std::function<size_t(VoxelVolume&, Voxel)> apply;
+    // Voxels it covers, checked one at a time against the tool
+    glm::ivec3 min;
+    glm::ivec3 max;
+    std::function<bool(const glm::ivec3&)> covers;
+};
+
+// Runs the tool on a copy of the volume and sets its voxels one by one on another, then compares
+// the two and the dirty chunks with those that changed
+void Check(MicroBenchmark& benchmark, const VoxelVolume& volume, const Tool& tool, Voxel voxel) {
+    VoxelVolume edited = volume.Snapshot();
+    size_t changed = tool.apply(edited, voxel);
+
+    VoxelVolume expected = volume.Snapshot();
+    for (int z = tool.min.z; z <= tool.max.z; z++) {
+        for (int y = tool.min.y; y <= tool.max.y; y++) {
+            for (int x = tool.min.x; x <= tool.max.x; x++) {
+                if (tool.covers({x, y, z}))
+                    expected.Set({x, y, z}, voxel);
+            }
+        }
+    }
+
+    VoxelVolume::ChunkSet differences = TestVolumes::Differences(volume, expected);
+    if (!TestVolumes::Differences(edited, expected).empty())
+        benchmark.Fail(std::format("{} writing {} gives the wrong voxels", tool.name, voxel));
+    else if (edited.GetDirtyChunks() != differences || changed != differences.size())
+        benchmark.Fail(std::format("{} writing {} marked {} chunks dirty and reported {}, {} "
+                                   "changed",
+                                   tool.name, voxel, edited.GetDirtyChunks().size(), changed,
+                                   differences.size()));
+}
+
+std::vector<Tool> CheckedTools() {
+    glm::ivec3 boxMin(5, -3, 40);
+    glm::ivec3 boxMax(100, 70, 64);
+    // Centres half way across a voxel keep both sides of the comparisons exact
+    glm::vec3 centre(64.5f, 60.5f, 50.5f);
+    float radius = 37.0f;
+    auto inSphere = [=](const glm::ivec3& p) {
+        glm::vec3 d = glm::vec3(p) + 0.5f - centre;
+        return glm::dot(d, d) <= radius * radius;
+    };
+    auto cylinder = [=](VoxelTools::Axis axis) {
+        int along = static_cast<int>(axis);
+        glm::ivec3 min = glm::ivec3(glm::floor(centre - radius));
+        glm::ivec3 max = glm::ivec3(glm::ceil(centre + radius));
+        min[along] = static_cast<int>(centre[along]);
+        max[along] = min[along] + 50 - 1;
+        Tool tool = {std::format("Cylinder Along {}", "XYZ"[along]),
+                     [=](VoxelVolume& volume, Voxel voxel) {
+                         return VoxelTools::Cylinder(volume, centre, radius, 50, axis, voxel);
+                     },
+                     min, max, [=](const glm::ivec3& p) {
+                         glm::vec3 d = glm::vec3(p) + 0.5f - centre;
+                         d[along] = 0.0f;
+                         return glm::dot(d, d) <= radius * radius;
+                     }};
+        return tool;
+    };
+    return {
+        {"Box Fill",
+         [=](VoxelVolume& volume, Voxel voxel) {
+             return VoxelTools::FillBox(volume, boxMin, boxMax, voxel);
+         },
+         boxMin, boxMax, [](const glm::ivec3&) { return true; }},
+        {"Chunk Box Fill",
+         [=](VoxelVolume& volume, Voxel voxel) {
+             return VoxelTools::FillBox(volume, {32, 0, 0}, {95, 63, 31}, voxel);
+         },
+         glm::ivec3(32, 0, 0), glm::ivec3(95, 63, 31), [](const glm::ivec3&) { return true; }},
+        {"Sphere",
+         [=](VoxelVolume& volume, Voxel voxel) {
+             return VoxelTools::Sphere(volume, centre, radius, voxel);
+         },
+         glm::ivec3(glm::floor(centre - radius)), glm::ivec3(glm::ceil(centre + radius)),
+         inSphere},
+        cylinder(VoxelTools::Axis::X),
+        cylinder(VoxelTools::Axis::Y),
+        cylinder(VoxelTools::Axis::Z),
+    };
+}
+
+size_t CountVoxels(const glm::ivec3& min, const glm::ivec3& max,
+                   const std::function<bool(const glm::ivec3&)>& covers) {
+    size_t count = 0;
+    for (int z = min.z; z <= max.z; z++) {
+        for (int y = min.y; y <= max.y; y++) {
+            for (int x = min.x; x <= max.x; x++)
+                count += covers({x, y, z});
+        }
+    }
+    return count;
+}
+} // namespace
+
+void RunBrushBenchmark(MicroBenchmark& benchmark) {
+    int size = std::max(benchmark.GetOption("--size", 512), VoxelChunk::size);
+    int box = std::max(benchmark.GetOption("--box", 512), 1);
+    int radius = std::max(benchmark.GetOption("--radius", 64), 1);
+
+    {
+        VoxelVolume small;
+        TestVolumes::Terrain(small, 128);
+        for (const Tool& tool : CheckedTools()) {
+            Check(benchmark, small, tool, 9);
+            Check(benchmark, small, tool, 1);
+            // Erasing, which removes the chunks it empties
+            Check(benchmark, small, tool, 0);
+        }
+        // Colour replace checked against the same one voxel at a time, where replacing empty
+        // voxels changes nothing
+        for (auto [from, to] : {std::pair<Voxel, Voxel>{1, 5}, {3, 0}, {0, 4}}) {
+            VoxelVolume edited = small.Snapshot();
+            size_t changed = VoxelTools::ReplaceColour(edited, from, to);
+            VoxelVolume expected = small.Snapshot();
+            for (int z = 0; z < 128; z++) {
+                for (int y = 0; y < TestVolumes::height; y++) {
+                    for (int x = 0; x < 128; x++) {
+                        if (from != 0 && small.Get({x, y, z}) == from)
+                            expected.Set({x, y, z}, to);
+                    }
+                }
+            }
+            if (!TestVolumes::Differences(edited, expected).empty() ||
+                edited.GetDirtyChunks() != TestVolumes::Differences(small, expected) ||
+                changed != edited.GetDirtyChunks().size())
+                benchmark.Fail(std::format("replacing {} with {} went wrong", from, to));
+        }
+    }
+
+    // Each call writes a different colour, so every call changes every chunk it covers
+    Voxel colour = 1;
+    auto nextColour = [&]() { return colour = static_cast<Voxel>(colour % 250 + 1); };
+    size_t boxVoxels = size_t(box) * box * box;
+    size_t changed = 0;
+
+    VoxelVolume empty;
+    float alignedMs = benchmark.Run(std::format("Box Fill {}^3", box), boxVoxels, [&]() {
+        changed = VoxelTools::FillBox(empty, glm::ivec3(0), glm::ivec3(box - 1), nextColour());
+    });
+    TestVolumes::LogThroughput(std::format("Box Fill {}^3", box), boxVoxels, alignedMs, changed);
+    glm::ivec3 offset(7, 3, 11);
+    float unalignedMs = benchmark.Run("Box Fill Unaligned", boxVoxels, [&]() {
+        changed = VoxelTools::FillBox(empty, offset, offset + box - 1, nextColour());
+    });
+    TestVolumes::LogThroughput("Box Fill Unaligned", boxVoxels, unalignedMs, changed);
+    empty.Clear();
+
+    VoxelVolume volume;
+    TestVolumes::Terrain(volume, size);
+    size_t volumeVoxels = volume.GetChunkCount() * VoxelChunk::voxelCount;
+    LOG_INFO("Terrain {} across: {} chunks", size, volume.GetChunkCount());
+
+    glm::vec3 centre(size / 2 + 0.5f, TestVolumes::height / 2 + 0.5f, size / 2 + 0.5f);
+    float r = static_cast<float>(radius);
+    glm::ivec3 sphereMin = glm::ivec3(glm::floor(centre - r));
+    glm::ivec3 sphereMax = glm::ivec3(glm::ceil(centre + r));
+    size_t sphereVoxels = CountVoxels(sphereMin, sphereMax, [&](const glm::ivec3& p) {
+        glm::vec3 d = glm::vec3(p) + 0.5f - centre;
+        return glm::dot(d, d) <= r * r;
+    });
+    float sphereMs = benchmark.Run(std::format("Sphere Radius {}", radius), sphereVoxels, [&]() {
+        changed = VoxelTools::Sphere(volume, centre, r, nextColour());
+    });
+    TestVolumes::LogThroughput(std::format("Sphere Radius {}", radius), sphereVoxels, sphereMs,
+                               changed);
+    // The same sphere a voxel at a time, as the tools replace
+    float setMs = benchmark.Run("Sphere Per Voxel", sphereVoxels, [&]() {
+        Voxel voxel = nextColour();
+        for (int z = sphereMin.z; z <= sphereMax.z; z++) {
+            for (int y = sphereMin.y; y <= sphereMax.y; y++) {
+                for (int x = sphereMin.x; x <= sphereMax.x; x++) {
+                    glm::vec3 d = glm::vec3(x, y, z) + 0.5f - centre;
+                    if (glm::dot(d, d) <= r * r)
+                        volume.Set({x, y, z}, voxel);
+                }
+            }
+        }
+    });
+    LOG_INFO("{:<28} {:7.3f} ms setting voxels one at a time, {:.0f}x slower", "Sphere Per Voxel",
+             setMs, setMs / std::max(sphereMs, 1e-6f));
+
+    int height = TestVolumes::height;
+    glm::vec3 base(centre.x, 0.0f, centre.z);
+    size_t cylinderVoxels =
+        CountVoxels(glm::ivec3(sphereMin.x, 0, sphereMin.z),
+                    glm::ivec3(sphereMax.x, 0, sphereMax.z), [&](const glm::ivec3& p) {
+                        float dx = p.x + 0.5f - base.x;
+                        float dz = p.z + 0.5f - base.z;
+                        return dx * dx + dz * dz <= r * r;
+                    }) *
+        height;
+    float cylinderMs = benchmark.Run("Cylinder", cylinderVoxels, [&]() {
+        changed = VoxelTools::Cylinder(volume, base, r, height, VoxelTools::Axis::Y, nextColour());
+    });
+    TestVolumes::LogThroughput(std::format("Cylinder Radius {} x {}", radius, height),
+                               cylinderVoxels, cylinderMs, changed);
+
+    // Stone to one colour and back, the terrain's most common voxel
+    bool swapped = false;
+    float replaceMs = benchmark.Run("Replace Colour", volumeVoxels, [&]() {
+        changed = swapped ? VoxelTools::ReplaceColour(volume, 200, 1)
+                          : VoxelTools::ReplaceColour(volume, 1, 200);
+        swapped = !swapped;
+    });
+    TestVolumes::LogThroughput("Replace Colour", volumeVoxels, replaceMs, changed);
+
+    // Recorded for undo, which copies the partly covered chunks and keeps the replaced ones
+    UndoHistory::Clear();
+    float undoMs = benchmark.Run("Box Fill + Undo", boxVoxels, [&]() {
+        VoxelEditRecorder recorder(volume, "Fill");
+        changed = VoxelTools::FillBox(volume, offset, offset + box - 1, nextColour(), &recorder);
+        recorder.Commit();
+        UndoHistory::Undo();
+    });
+    TestVolumes::LogThroughput("Box Fill + Undo", boxVoxels, undoMs, changed);
+    UndoHistory::Clear();
+}
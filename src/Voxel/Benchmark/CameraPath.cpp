@@ -0,0 +1,68 @@
+#include "CameraPath.h"
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <sstream>
+#include <glm/gtc/constants.hpp>
+
+bool CameraPath::Load(const std::filesystem::path& path, CameraPath& outPath) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        LOG_ERROR("Unable to open camera path {}", path.string());
+        return false;
+    }
+
+    outPath.keyframes.clear();
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::istringstream stream(line);
+        CameraKeyframe keyframe{};
+        if (stream >> keyframe.position.x >> keyframe.position.y >> keyframe.position.z >>
+            keyframe.yaw >> keyframe.pitch) {
+            outPath.keyframes.push_back(keyframe);
+        } else {
+            LOG_WARN("Skipping malformed camera keyframe: {}", line);
+        }
+    }
+
+    return !outPath.keyframes.empty();
+}
+
+CameraPath CameraPath::Orbit(const glm::vec3& center, float radius, float height,
+                             int keyframeCount) {
+    CameraPath path;
+    float pitch = glm::degrees(std::atan2(-height, radius));
+
+    for (int i = 0; i <= keyframeCount; i++) {
+        float angle = glm::two_pi<float>() * static_cast<float>(i) / keyframeCount;
+        glm::vec3 offset(std::cos(angle) * radius, height, std::sin(angle) * radius);
+
+        // Yaw is measured the same way as Camera::UpdateCameraVectors, facing back to the center
+        float yaw = glm::degrees(std::atan2(-offset.z, -offset.x));
+        path.keyframes.push_back({center + offset, yaw, pitch});
+    }
+    return path;
+}
+
+CameraKeyframe CameraPath::Evaluate(int frame, int frameCount) const {
+    if (keyframes.empty())
+        return {glm::vec3(0.0f), 0.0f, 0.0f};
+    if (keyframes.size() == 1 || frameCount <= 1)
+        return keyframes.front();
+
+    float t = static_cast<float>(frame) / static_cast<float>(frameCount - 1);
+    float scaled = glm::clamp(t, 0.0f, 1.0f) * static_cast<float>(keyframes.size() - 1);
+    size_t index = std::min(static_cast<size_t>(scaled), keyframes.size() - 2);
+    float blend = scaled - static_cast<float>(index);
+
+    const CameraKeyframe& a = keyframes[index];
+    const CameraKeyframe& b = keyframes[index + 1];
+
+    // Take the short way around when yaw wraps
+    float yawDelta = std::remainder(b.yaw - a.yaw, 360.0f);
+
+    return {glm::mix(a.position, b.position, blend), a.yaw + yawDelta * blend,
+            glm::mix(a.pitch, b.pitch, blend)};
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <Voxel/pch.h>
+
+struct CameraKeyframe {
+    glm::vec3 position;
+    float yaw;
+    float pitch;
+};
+
+// Deterministic camera motion for headless runs and benchmarks. Keyframes are spread evenly
+// over the run and linearly interpolated, so the same frame index always gives the same pose.
+class CameraPath {
+  public:
+    // One keyframe per line: "x y z yaw pitch", lines starting with '#' are ignored
+    static bool Load(const std::filesystem::path& path, CameraPath& outPath);
+
+    // Circle around a point while looking at it
+    static CameraPath Orbit(const glm::vec3& center, float radius, float height,
+                            int keyframeCount = 64);
+
+    CameraKeyframe Evaluate(int frame, int frameCount) const;
+    bool Empty() const { return keyframes.empty(); }
+
+    void AddKeyframe(const CameraKeyframe& keyframe) { keyframes.push_back(keyframe); }
+
+  private:
+    std::vector<CameraKeyframe> keyframes;
+};
@@ -0,0 +1,89 @@
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <format>
+#include <random>
+#include <Voxel/Benchmark/MicroBenchmark.h>
+#include <Voxel/Benchmark/TestVolumes.h>
+#include <Voxel/Volume/ChunkFile.h>
+
+// voxel_bench micro chunks [--size N] [--level N]
+//
+// Saving and loading chunk files of the three TestVolumes, N voxels across. Logs throughput in
+// MB/s of voxels and the compression ratio with and without zstd, and checks that every chunk
+// loads back the same.
+
+namespace {
+void RunDataset(MicroBenchmark& benchmark, const std::string& name, const VoxelVolume& volume,
+                int level) {
+    std::filesystem::path path =
+        std::filesystem::temp_directory_path() / ("voxel_bench_" + name + ChunkFile::extension);
+    size_t chunkCount = volume.GetChunkCount();
+    double megabytes = static_cast<double>(chunkCount * VoxelChunk::voxelCount) / (1 << 20);
+
+    bool ok = true;
+    float saveMs = benchmark.Run(name + " Save", chunkCount, [&]() {
+        ok = ChunkFile::SaveVolume(path, volume, level) && ok;
+    });
+
+    VoxelVolume loaded;
+    float loadMs = benchmark.Run(name + " Load", chunkCount,
+                                 [&]() { ok = ChunkFile::LoadVolume(path, loaded) && ok; });
+
+    // Single chunks in a random order, through one open file
+    ChunkFile file;
+    ok = file.Open(path) && ok;
+    std::vector<glm::ivec3> positions = file.GetChunkPositions();
+    std::shuffle(positions.begin(), positions.end(), std::mt19937(42));
+    VoxelChunk chunk;
+    float randomMs = benchmark.Run(name + " LoadChunk random", positions.size(), [&]() {
+        for (const glm::ivec3& position : positions)
+            ok = file.LoadChunk(position, chunk) && ok;
+    });
+
+    double raw = static_cast<double>(chunkCount) * VoxelChunk::voxelCount;
+    LOG_INFO("{:<36} save {:7.1f} MB/s  load {:7.1f} MB/s  random {:7.1f} MB/s", name,
+             megabytes * 1000.0 / saveMs, megabytes * 1000.0 / loadMs,
+             megabytes * 1000.0 / randomMs);
+    LOG_INFO("{:<36} {} chunks, {:.1f} MB -> encoded {:.2f} MB ({:.1f}x) -> zstd {:.2f} MB "
+             "({:.1f}x), file {:.2f} MB",
+             name, chunkCount, megabytes, file.GetEncodedBytes() / double(1 << 20),
+             raw / std::max<uint64_t>(file.GetEncodedBytes(), 1),
+             file.GetStoredBytes() / double(1 << 20),
+             raw / std::max<uint64_t>(file.GetStoredBytes(), 1),
+             file.GetFileSize() / double(1 << 20));
+    file.Close();
+
+    if (!ok) {
+        benchmark.Fail(name + ": saving or loading failed");
+    } else if (loaded.GetChunkCount() != chunkCount || loaded.GetPalette() != volume.GetPalette()) {
+        benchmark.Fail(name + ": the loaded volume has different chunks");
+    } else {
+        for (const auto& [position, voxels] : volume.GetChunks()) {
+            const VoxelChunk* other = loaded.GetChunk(position);
+            if (!other || !(*other == *voxels)) {
+                benchmark.Fail(std::format("{}: chunk ({}, {}, {}) differs after loading", name,
+                                           position.x, position.y, position.z));
+                break;
+            }
+        }
+    }
+    std::filesystem::remove(path);
+}
+} // namespace
+
+void RunChunkBenchmark(MicroBenchmark& benchmark) {
+    int size = std::max(benchmark.GetOption("--size", 512), VoxelChunk::size);
+    int level = benchmark.GetOption("--level", ChunkFile::defaultCompressionLevel);
+
+    struct Dataset {
+        const char* name;
+        void (*generate)(VoxelVolume&, int);
+    };
+    for (Dataset dataset :
+         {Dataset{"terrain", TestVolumes::Terrain}, Dataset{"scan", TestVolumes::Scan},
+          Dataset{"city", TestVolumes::City}}) {
+        VoxelVolume volume;
+        dataset.generate(volume, size);
+        RunDataset(benchmark, dataset.name, volume, level);
+    }
+}
@@ -0,0 +1,219 @@
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <cstring>
+#include <format>
+#include <Voxel/Benchmark/MicroBenchmark.h>
+#include <Voxel/Benchmark/TestVolumes.h>
+#include <Voxel/Editing/UndoHistory.h>
+#include <Voxel/Editing/VoxelCsg.h>
+#include <Voxel/Editing/VoxelTools.h>
+#include <Voxel/Volume/VolumeMesh.h>
+
+// voxel_bench micro csg [--size N] [--terrain N]
+//
+// VoxelCsg throughput in voxels per second of the target: a solid box --size voxels across
+// (1024) with a sphere nearly as wide, for each operation with the volumes lined up on chunks and
+// off by a few voxels. Then a tunnel cut through TestVolumes::Terrain --terrain voxels across
+// (512) and remeshed through VolumeMesh::Update, against meshing the whole terrain again. Every
+// operation is first checked against working out its voxels one at a time on small volumes,
+// along with the chunks marked dirty, undo and the remeshed chunks.
+
+namespace {
+using Operation = VoxelCsg::Operation;
+
+const std::pair<Operation, const char*> operations[] = {
+    {Operation::Union, "Union"},
+    {Operation::Subtract, "Subtract"},
+    {Operation::Intersect, "Intersect"},
+    {Operation::Xor, "Xor"},
+};
+
+Voxel Combine(Voxel a, Voxel b, Operation operation) {
+    switch (operation) {
+    case Operation::Union:
+        return b != 0 ? b : a;
+    case Operation::Subtract:
+        return b != 0 ? 0 : a;
+    case Operation::Intersect:
+        return b != 0 ? a : 0;
+    default:
+        return a == 0 ? b : (b != 0 ? 0 : a);
+    }
+}
+
+// The operation a voxel at a time, over the chunks of target and those other covers
+VoxelVolume Expected(const VoxelVolume& target, const VoxelVolume& other,
+                     const glm::ivec3& offset, Operation operation) {
+    VoxelVolume::ChunkSet chunks;
+    for (const auto& [chunk, voxels] : target.GetChunks())
+        chunks.insert(chunk);
+    for (const auto& [chunk, voxels] : other.GetChunks()) {
+        glm::ivec3 min = chunk * VoxelChunk::size + offset;
+        glm::ivec3 first = VoxelVolume::ToChunk(min);
+        glm::ivec3 last = VoxelVolume::ToChunk(min + (VoxelChunk::size - 1));
+        for (int z = first.z; z <= last.z; z++) {
+            for (int y = first.y; y <= last.y; y++) {
+                for (int x = first.x; x <= last.x; x++)
+                    chunks.insert({x, y, z});
+            }
+        }
+    }
+
+    VoxelVolume expected = target.Snapshot();
+    for (const glm::ivec3& chunk : chunks) {
+        glm::ivec3 origin = chunk * VoxelChunk::size;
+        for (int z = 0; z < VoxelChunk::size; z++) {
+            for (int y = 0; y < VoxelChunk::size; y++) {
+                for (int x = 0; x < VoxelChunk::size; x++) {
+                    glm::ivec3 p = origin + glm::ivec3(x, y, z);
+                    Voxel a = target.Get(p);
+                    Voxel voxel = Combine(a, other.Get(p - offset), operation);
+                    if (voxel != a)
+                        expected.Set(p, voxel);
+                }
+            }
+        }
+    }
+    return expected;
+}
+
+bool SameMeshes(const VolumeMesh& a, const VolumeMesh& b) {
+    if (a.GetMeshes().size() != b.GetMeshes().size())
+        return false;
+    for (const auto& [chunk, mesh] : a.GetMeshes()) {
+        const VolumeMesh::ChunkMesh* other = b.GetMesh(chunk);
+        if (!other || mesh.indices != other->indices ||
+            mesh.vertices.size() != other->vertices.size() ||
+            std::memcmp(mesh.vertices.data(), other->vertices.data(),
+                        mesh.vertices.size() * sizeof(Vertex)) != 0)
+            return false;
+    }
+    return true;
+}
+
+// Runs the operation on a copy of target and compares it with the voxel at a time result, the
+// dirty chunks with those that changed, the meshes updated from them with a full rebuild, and
+// the volume after undo with target
+void Check(MicroBenchmark& benchmark, const VoxelVolume& target, const VoxelVolume& other,
+           const glm::ivec3& offset, Operation operation, const std::string& name) {
+    VoxelVolume expected = Expected(target, other, offset, operation);
+    VoxelVolume::ChunkSet differences = TestVolumes::Differences(target, expected);
+
+    VoxelVolume edited = target.Snapshot();
+    VolumeMesh mesh;
+    mesh.Rebuild(edited);
+    UndoHistory::Clear();
+    VoxelEditRecorder recorder(edited, "CSG");
+    size_t changed = VoxelCsg::Apply(edited, other, offset, operation, &recorder);
+    recorder.Commit();
+
+    if (!TestVolumes::Differences(edited, expected).empty()) {
+        benchmark.Fail(std::format("{} gives the wrong voxels", name));
+        return;
+    }
+    if (edited.GetDirtyChunks() != differences || changed != differences.size()) {
+        benchmark.Fail(std::format("{} marked {} chunks dirty and reported {}, {} changed", name,
+                                   edited.GetDirtyChunks().size(), changed, differences.size()));
+        return;
+    }
+
+    mesh.Update(edited);
+    VolumeMesh rebuilt;
+    rebuilt.Rebuild(edited);
+    if (!SameMeshes(mesh, rebuilt))
+        benchmark.Fail(std::format("{} remeshed differently from a full rebuild", name));
+
+    UndoHistory::Undo();
+    if (!TestVolumes::Differences(edited, target).empty())
+        benchmark.Fail(std::format("{} isn't undone", name));
+    UndoHistory::Clear();
+}
+} // namespace
+
+void RunCsgBenchmark(MicroBenchmark& benchmark) {
+    int size = std::max(benchmark.GetOption("--size", 1024), VoxelChunk::size);
+    int terrainSize = std::max(benchmark.GetOption("--terrain", 512), VoxelChunk::size);
+
+    {
+        VoxelVolume terrain;
+        TestVolumes::Terrain(terrain, 96);
+        VoxelVolume scan;
+        TestVolumes::Scan(scan, 64);
+        // Uniform chunks on the other side, and chunks it fills that the target doesn't have
+        VoxelVolume block;
+        VoxelTools::FillBox(block, glm::ivec3(0), glm::ivec3(63), 7);
+        const glm::ivec3 offsets[] = {{0, 0, 0}, {32, 64, -32}, {7, -5, 13}, {70, 90, -20}};
+        for (const auto& [operation, name] : operations) {
+            for (const glm::ivec3& offset : offsets) {
+                std::string at = std::format("at ({}, {}, {})", offset.x, offset.y, offset.z);
+                Check(benchmark, terrain, scan, offset, operation,
+                      std::format("{} Scan {}", name, at));
+                Check(benchmark, terrain, block, offset, operation,
+                      std::format("{} Block {}", name, at));
+                Check(benchmark, block, terrain, offset, operation,
+                      std::format("{} Terrain From Block {}", name, at));
+            }
+        }
+    }
+
+    // Chunks of the box are all one shared chunk, most of the sphere's are solid too
+    VoxelVolume box;
+    VoxelTools::FillBox(box, glm::ivec3(0), glm::ivec3(size - 1), 1);
+    VoxelVolume sphere;
+    VoxelTools::Sphere(sphere, glm::vec3(size / 2 + 0.5f), size * 0.45f, 2);
+    size_t boxVoxels = size_t(size) * size * size;
+    LOG_INFO("Box {}^3: {} chunks, sphere: {} chunks", size, box.GetChunkCount(),
+             sphere.GetChunkCount());
+
+    size_t changed = 0;
+    for (const auto& [operation, name] : operations) {
+        for (glm::ivec3 offset : {glm::ivec3(0), glm::ivec3(5, -3, 9)}) {
+            std::string caseName =
+                std::format("{} Sphere{}", name, offset == glm::ivec3(0) ? "" : " Unaligned");
+            // A snapshot per call, a handle copy per chunk, so every call starts from the box
+            float ms = benchmark.Run(caseName, boxVoxels, [&]() {
+                VoxelVolume target = box.Snapshot();
+                changed = VoxelCsg::Apply(target, sphere, offset, operation);
+            });
+            TestVolumes::LogThroughput(caseName, boxVoxels, ms, changed);
+        }
+    }
+    box.Clear();
+    sphere.Clear();
+
+    VoxelVolume terrain;
+    TestVolumes::Terrain(terrain, terrainSize);
+    VoxelVolume tunnel;
+    VoxelTools::Cylinder(tunnel, glm::vec3(0.0f, 40.5f, terrainSize / 2 + 0.5f), 12.0f,
+                         terrainSize, VoxelTools::Axis::X, 1);
+    size_t terrainVoxels = terrain.GetChunkCount() * VoxelChunk::voxelCount;
+    LOG_INFO("Terrain {} across: {} chunks", terrainSize, terrain.GetChunkCount());
+
+    VolumeMesh mesh;
+    size_t meshed = 0;
+    float rebuildMs = benchmark.Run("Remesh All", terrainVoxels, [&]() {
+        meshed = mesh.Rebuild(terrain);
+    });
+    LOG_INFO("{:<28} {:8.3f} ms for {} chunks, {} triangles", "Remesh All", rebuildMs, meshed,
+             mesh.GetTriangleCount());
+
+    // Cut and undone in turn, each remeshing only the chunks that changed and their neighbours
+    UndoHistory::Clear();
+    bool cut = false;
+    float updateMs = benchmark.Run("Tunnel + Remesh", terrainVoxels, [&]() {
+        if (cut) {
+            UndoHistory::Undo();
+        } else {
+            VoxelEditRecorder recorder(terrain, "Tunnel");
+            changed = VoxelCsg::Apply(terrain, tunnel, glm::ivec3(0), Operation::Subtract,
+                                      &recorder);
+            recorder.Commit();
+        }
+        meshed = mesh.Update(terrain);
+        cut = !cut;
+    });
+    LOG_INFO("{:<28} {:8.3f} ms, {} chunks changed, {} meshed, {:.1f}x faster than remeshing "
+             "everything",
+             "Tunnel + Remesh", updateMs, changed, meshed, rebuildMs / std::max(updateMs, 1e-6f));
+    UndoHistory::Clear();
+}
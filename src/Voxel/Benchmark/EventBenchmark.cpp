@@ -0,0 +1,104 @@
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <Voxel/Benchmark/MicroBenchmark.h>
+#include <Voxel/Event/Event.h>
+
+// voxel_bench micro events [--events N] [--observers N] [--churn N]
+//
+// Dispatch throughput of Subject against the std::function vector it used to be, per event and
+// batched, plus the cost of adding and removing observers in random order.
+
+namespace {
+struct BenchEvent {
+    uint32_t entity;
+    float value;
+};
+
+// The previous Subject: type erased callbacks in a vector, removal by search
+class FunctionSubject {
+  public:
+    using Callback = std::function<void(const BenchEvent&)>;
+
+    size_t AddObserver(Callback callback) {
+        size_t id = nextId++;
+        observers.emplace_back(id, std::move(callback));
+        return id;
+    }
+
+    void Notify(const BenchEvent& event) {
+        for (auto& [id, callback] : observers)
+            callback(event);
+    }
+
+    void RemoveObserver(size_t id) {
+        observers.erase(std::remove_if(observers.begin(), observers.end(),
+                                       [id](auto& pair) { return pair.first == id; }),
+                        observers.end());
+    }
+
+  private:
+    std::vector<std::pair<size_t, Callback>> observers;
+    size_t nextId = 1;
+};
+} // namespace
+
+void RunEventBenchmark(MicroBenchmark& benchmark) {
+    size_t eventCount = static_cast<size_t>(std::max(benchmark.GetOption("--events", 1000000), 1));
+    int observerCount = std::max(benchmark.GetOption("--observers", 4), 1);
+    int churnCount = std::max(benchmark.GetOption("--churn", 10000), 1);
+
+    std::vector<BenchEvent> events(eventCount);
+    for (size_t i = 0; i < eventCount; i++)
+        events[i] = {static_cast<uint32_t>(i), static_cast<float>(i % 97)};
+
+    // Observers accumulate into this so the calls can't be optimised away
+    std::vector<double> sums(static_cast<size_t>(observerCount));
+    FunctionSubject functionSubject;
+    Subject<BenchEvent> subject;
+    for (double& sum : sums) {
+        functionSubject.AddObserver([&sum](const BenchEvent& event) { sum += event.value; });
+        subject.AddObserver([sum = &sum](const BenchEvent& event) { *sum += event.value; });
+    }
+
+    size_t dispatches = eventCount * static_cast<size_t>(observerCount);
+    benchmark.Run("std::function Notify", dispatches, [&]() {
+        for (const BenchEvent& event : events)
+            functionSubject.Notify(event);
+    });
+    benchmark.Run("Subject Notify", dispatches, [&]() {
+        for (const BenchEvent& event : events)
+            subject.Notify(event);
+    });
+    benchmark.Run("Subject NotifyBatch", dispatches, [&]() { subject.NotifyBatch(events); });
+
+    // Same random removal order for both
+    std::vector<size_t> removalOrder(static_cast<size_t>(churnCount));
+    std::iota(removalOrder.begin(), removalOrder.end(), 0);
+    uint32_t seed = 12345;
+    for (size_t i = removalOrder.size(); i > 1; i--) {
+        seed = seed * 1664525u + 1013904223u;
+        std::swap(removalOrder[i - 1], removalOrder[seed % i]);
+    }
+
+    double churnSum = 0.0;
+    auto observer = [sum = &churnSum](const BenchEvent& event) { *sum += event.value; };
+    benchmark.Run("std::function add/remove", static_cast<size_t>(churnCount), [&]() {
+        FunctionSubject churnSubject;
+        std::vector<size_t> ids;
+        for (int i = 0; i < churnCount; i++)
+            ids.push_back(churnSubject.AddObserver(observer));
+        for (size_t index : removalOrder)
+            churnSubject.RemoveObserver(ids[index]);
+    });
+    benchmark.Run("Subject add/remove", static_cast<size_t>(churnCount), [&]() {
+        Subject<BenchEvent> churnSubject;
+        std::vector<ObserverHandle<BenchEvent>> handles;
+        for (int i = 0; i < churnCount; i++)
+            handles.push_back(churnSubject.AddObserver(observer));
+        for (size_t index : removalOrder)
+            handles[index].Unsubscribe();
+    });
+
+    double total = std::accumulate(sums.begin(), sums.end(), churnSum);
+    LOG_TRACE("Checksum {}", total);
+}
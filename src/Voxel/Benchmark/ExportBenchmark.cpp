@@ -0,0 +1,111 @@
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <cstring>
+#include <format>
+#include <Voxel/Benchmark/MicroBenchmark.h>
+#include <Voxel/Benchmark/TestVolumes.h>
+#include <Voxel/Memory/MappedFile.h>
+#include <Voxel/Rendering/RawModel.h>
+#include <Voxel/Volume/MeshExporter.h>
+
+// voxel_bench micro export [--size N] [--colours 0|1] [--batch N]
+//
+// Exports TestVolumes::Terrain N voxels across (512) as OBJ, PLY and glb. --size 1350 is about
+// 100M voxels. Logs throughput, the file sizes and the exporter's peak working memory next to
+// what holding the whole mesh would take, and checks each file's counts against the export.
+
+namespace {
+// Counts in the file itself, false when the file doesn't add up
+bool CheckFile(const std::filesystem::path& path, const MeshExportStats& stats, bool colours) {
+    MappedFile file;
+    if (!file.Open(path))
+        return false;
+    std::span<const std::byte> bytes = file.GetBytes();
+    const char* text = reinterpret_cast<const char*>(bytes.data());
+    std::string_view view(text, bytes.size());
+    if (bytes.size() != stats.fileBytes)
+        return false;
+
+    std::string extension = path.extension().string();
+    if (extension == ".obj") {
+        uint64_t vertices = 0;
+        uint64_t faces = 0;
+        for (size_t line = 0; line < view.size();) {
+            vertices += view.compare(line, 2, "v ") == 0;
+            faces += view.compare(line, 2, "f ") == 0;
+            size_t end = view.find('\n', line);
+            line = end == std::string_view::npos ? view.size() : end + 1;
+        }
+        return vertices == stats.vertices && faces == stats.triangles;
+    }
+    if (extension == ".ply") {
+        size_t headerEnd = view.find("end_header\n");
+        std::string expected = std::format("element vertex {:010}", stats.vertices);
+        std::string expectedFaces = std::format("element face {:010}", stats.triangles);
+        return headerEnd != std::string_view::npos &&
+               view.substr(0, headerEnd).find(expected) != std::string_view::npos &&
+               view.substr(0, headerEnd).find(expectedFaces) != std::string_view::npos &&
+               bytes.size() == headerEnd + 11 + stats.vertices * (colours ? 15 : 12) +
+                                   stats.triangles * 13;
+    }
+    if (extension == ".glb") {
+        uint32_t header[5];
+        if (bytes.size() < sizeof(header))
+            return false;
+        std::memcpy(header, bytes.data(), sizeof(header));
+        std::string_view json = view.substr(sizeof(header), header[3]);
+        return header[0] == 0x46546C67 && header[1] == 2 && header[2] == bytes.size() &&
+               json.find(std::format(R"("count":{})", stats.vertices)) != std::string_view::npos &&
+               json.find(std::format(R"("count":{})", stats.triangles * 3)) !=
+                   std::string_view::npos;
+    }
+    return false;
+}
+} // namespace
+
+void RunExportBenchmark(MicroBenchmark& benchmark) {
+    int size = std::max(benchmark.GetOption("--size", 512), VoxelChunk::size);
+    MeshExportSettings settings;
+    settings.colours = benchmark.GetOption("--colours", 1) != 0;
+    settings.chunksPerBatch = std::max(benchmark.GetOption("--batch", 16), 1);
+
+    VoxelVolume volume;
+    TestVolumes::Terrain(volume, size);
+    size_t voxels = 0;
+    for (const auto& [position, chunk] : volume.GetChunks()) {
+        for (Voxel voxel : chunk->GetVoxels())
+            voxels += voxel != 0;
+    }
+    LOG_INFO("Terrain {} across: {:.1f}M voxels in {} chunks", size, voxels / 1e6,
+             volume.GetChunkCount());
+
+    for (const char* extension : {".obj", ".ply", ".glb"}) {
+        std::filesystem::path path = std::filesystem::temp_directory_path() /
+                                     (std::string("voxel_bench_export") + extension);
+        bool ok = true;
+        MeshExportStats stats;
+        float ms = benchmark.Run(std::string(extension + 1) + " Export", volume.GetChunkCount(),
+                                 [&]() {
+                                     ok = MeshExporter::Export(path, volume, settings, &stats) &&
+                                          ok;
+                                 });
+
+        double fileMegabytes = stats.fileBytes / double(1 << 20);
+        // A Vertex per face corner and six indices per face, as ChunkMesher hands them out
+        double wholeMesh = (stats.triangles * 2 * sizeof(Vertex) +
+                            stats.triangles * 3 * sizeof(unsigned int)) /
+                           double(1 << 20);
+        LOG_INFO("{:<4} {:.2f}M vertices, {:.2f}M triangles, {:.1f} MB at {:.1f} MB/s, {:.1f}M "
+                 "voxels/s",
+                 extension + 1, stats.vertices / 1e6, stats.triangles / 1e6, fileMegabytes,
+                 fileMegabytes * 1000.0 / ms, voxels / 1e3 / ms);
+        LOG_INFO("{:<4} peak working memory {:.1f} MB, the whole mesh would be {:.1f} MB",
+                 extension + 1, stats.peakWorkingBytes / double(1 << 20), wholeMesh);
+
+        if (!ok)
+            benchmark.Fail(std::format("{}: the export failed", extension));
+        else if (!CheckFile(path, stats, settings.colours))
+            benchmark.Fail(std::format("{}: the file doesn't match the export", extension));
+        std::filesystem::remove(path);
+    }
+}
@@ -0,0 +1,132 @@
+#include "HeadlessRunner.h"
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <format>
+#include <Voxel/Camera.h>
+#include <Voxel/EditorSettings.h>
+#include <Voxel/Rendering/FrameBuffer.h>
+#include <Voxel/Rendering/ImageWriter.h>
+
+HeadlessRunner::HeadlessRunner(const LaunchOptions& options, Camera* camera,
+                               const glm::vec3& sceneCenter, float sceneRadius)
+    : options(options), camera(camera) {
+    if (options.cameraPath.empty() || !CameraPath::Load(options.cameraPath, cameraPath)) {
+        cameraPath = CameraPath::Orbit(sceneCenter, sceneRadius * 2.0f, sceneRadius);
+    }
+
+    frameTimings.reserve(options.frames);
+
+    if (!options.dumpFramesDirectory.empty()) {
+        std::error_code ec;
+        std::filesystem::create_directories(options.dumpFramesDirectory, ec);
+        if (ec)
+            LOG_ERROR("Unable to create {}: {}", options.dumpFramesDirectory.string(),
+                      ec.message());
+    }
+
+    if (!options.tracePath.empty()) {
+        int eventsPerThread = EditorSettings::GetInt("Profiler", "CaptureEventsPerThread", 262144);
+        Profiler::BeginCapture(options.frames, static_cast<uint32_t>(std::max(eventsPerThread, 1)),
+                               options.tracePath);
+    }
+
+    LOG_INFO("Running headless for {} frames at {}x{}", options.frames, options.width,
+             options.height);
+}
+
+void HeadlessRunner::BeginFrame(int frame) {
+    CameraKeyframe pose = cameraPath.Evaluate(frame, options.frames);
+    camera->SetPose(pose.position, pose.yaw, pose.pitch);
+}
+
+void HeadlessRunner::EndFrame(int frame) {
+    std::vector<float>& timings = frameTimings.emplace_back(timerNames.size(), 0.0f);
+
+    // Scopes can first appear part way through a run, e.g. on the first edit of a kind, so
+    // columns are added as they are seen and earlier rows read as zero
+    auto addTiming = [this, &timings](const std::string& name, float value) {
+        auto [it, added] = timerColumns.try_emplace(name, timerNames.size());
+        if (added) {
+            timerNames.push_back(name);
+            timings.push_back(0.0f);
+        }
+        timings[it->second] += value;
+    };
+
+    addTiming("Heap Allocations", Profiler::GetHeapAllocations().previousFrame);
+    Profiler::VisitThreads([&addTiming](const ProfilerThread& thread) {
+        for (size_t i = 1; i < thread.nodes.size(); i++) {
+            const ProfilerNode& node = thread.nodes[i];
+            std::string name = thread.isMain ? node.path : thread.name + "/" + node.path;
+            addTiming(name, node.timer.previousFrame);
+            if (node.hasGpuTimer)
+                addTiming(name + " [GPU]", node.gpuTimer.previousFrame);
+        }
+    });
+
+    if (!options.dumpFramesDirectory.empty())
+        DumpFrame(frame);
+}
+
+void HeadlessRunner::DumpFrame(int frame) {
+    FrameBuffer* sceneBuffer = Application::GetInstance()->GetSceneBuffer();
+    sceneBuffer->ReadPixels(pixelBuffer);
+
+    std::filesystem::path path =
+        options.dumpFramesDirectory / std::format("frame_{:05}.png", frame);
+    if (!ImageWriter::WritePng(path, sceneBuffer->GetWidth(), sceneBuffer->GetHeight(), 3,
+                               pixelBuffer.data())) {
+        LOG_ERROR("Failed to write {}", path.string());
+    }
+}
+
+bool HeadlessRunner::WriteTimings() const {
+    if (options.timingsPath.empty())
+        return true;
+
+    std::ofstream file(options.timingsPath, std::ios::out | std::ios::trunc);
+    if (!file.is_open()) {
+        LOG_ERROR("Unable to open {} for writing", options.timingsPath.string());
+        return false;
+    }
+
+    bool written = options.timingsPath.extension() == ".json" ? WriteTimingsJson(file)
+                                                               : WriteTimingsCsv(file);
+    if (written)
+        LOG_INFO("Wrote {} frame timings to {}", frameTimings.size(),
+                 options.timingsPath.string());
+    return written;
+}
+
+bool HeadlessRunner::WriteTimingsCsv(std::ofstream& file) const {
+    file << "frame";
+    for (const std::string& name : timerNames)
+        file << "," << name;
+    file << "\n";
+
+    for (size_t frame = 0; frame < frameTimings.size(); frame++) {
+        file << frame;
+        for (size_t timer = 0; timer < timerNames.size(); timer++)
+            file << "," << GetTiming(frame, timer);
+        file << "\n";
+    }
+    return file.good();
+}
+
+bool HeadlessRunner::WriteTimingsJson(std::ofstream& file) const {
+    file << "{\n  \"frames\": " << frameTimings.size() << ",\n  \"width\": " << options.width
+         << ",\n  \"height\": " << options.height << ",\n  \"timings_ms\": {\n";
+
+    for (size_t timer = 0; timer < timerNames.size(); timer++) {
+        file << "    \"" << timerNames[timer] << "\": [";
+        for (size_t frame = 0; frame < frameTimings.size(); frame++) {
+            if (frame > 0)
+                file << ", ";
+            file << GetTiming(frame, timer);
+        }
+        file << "]" << (timer + 1 < timerNames.size() ? "," : "") << "\n";
+    }
+
+    file << "  }\n}\n";
+    return file.good();
+}
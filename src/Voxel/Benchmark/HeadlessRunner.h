@@ -0,0 +1,41 @@
+#pragma once
+#include <Voxel/pch.h>
+#include <Voxel/Benchmark/CameraPath.h>
+#include <Voxel/LaunchOptions.h>
+
+// Drives a headless run: poses the camera along a scripted path each frame, optionally dumps
+// the scene buffer to PNGs and collects the per-frame Profiler timings for CSV/JSON export.
+class HeadlessRunner {
+  public:
+    HeadlessRunner(const LaunchOptions& options, class Camera* camera,
+                   const glm::vec3& sceneCenter, float sceneRadius);
+
+    // Call before the frame is simulated/rendered
+    void BeginFrame(int frame);
+    // Call after Profiler::EndFrame, while the scene buffer still holds this frame
+    void EndFrame(int frame);
+    // Write collected timings to LaunchOptions::timingsPath (format picked by extension)
+    bool WriteTimings() const;
+
+    const std::vector<std::string>& GetTimerNames() const { return timerNames; }
+    const std::vector<std::vector<float>>& GetFrameTimings() const { return frameTimings; }
+
+  private:
+    void DumpFrame(int frame);
+    bool WriteTimingsCsv(std::ofstream& file) const;
+    bool WriteTimingsJson(std::ofstream& file) const;
+    float GetTiming(size_t frame, size_t timer) const {
+        return timer < frameTimings[frame].size() ? frameTimings[frame][timer] : 0.0f;
+    }
+
+    LaunchOptions options;
+    class Camera* camera = nullptr;
+    CameraPath cameraPath;
+
+    std::vector<std::string> timerNames;
+    std::unordered_map<std::string, size_t> timerColumns;
+    // Row per frame, column per timer, in milliseconds. Rows only cover the timers known at the
+    // time, later columns are implicitly zero.
+    std::vector<std::vector<float>> frameTimings;
+    std::vector<uint8_t> pixelBuffer;
+};
@@ -0,0 +1,58 @@
+#include "MicroBenchmark.h"
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <chrono>
+
+MicroBenchmark::MicroBenchmark(std::string name, int argc, char** argv) : name(std::move(name)) {
+    for (int i = 1; i + 1 < argc; i += 2)
+        options[argv[i]] = argv[i + 1];
+
+    repetitions = std::max(GetOption("--repetitions", repetitions), 1);
+    warmup = std::max(GetOption("--warmup", warmup), 0);
+    if (auto it = options.find("--report"); it != options.end())
+        reportPath = it->second;
+
+    timings.resize(static_cast<size_t>(warmup + repetitions));
+}
+
+int MicroBenchmark::GetOption(const std::string& option, int defaultValue) const {
+    auto it = options.find(option);
+    return it != options.end() ? std::atoi(it->second.c_str()) : defaultValue;
+}
+
+float MicroBenchmark::Run(const std::string& caseName, size_t itemCount,
+                          const std::function<void()>& body) {
+    using Clock = std::chrono::steady_clock;
+    caseNames.push_back(caseName);
+
+    for (std::vector<float>& row : timings) {
+        Clock::time_point start = Clock::now();
+        body();
+        row.push_back(std::chrono::duration<float, std::milli>(Clock::now() - start).count());
+    }
+
+    std::vector<float> samples;
+    for (size_t i = static_cast<size_t>(warmup); i < timings.size(); i++)
+        samples.push_back(timings[i].back());
+    std::sort(samples.begin(), samples.end());
+    float median = samples[samples.size() / 2];
+    LOG_INFO("{:<36} p50 {:8.3f} ms  {:8.2f} ns/item", caseName, median,
+             itemCount > 0 ? median * 1e6f / itemCount : 0.0f);
+    return median;
+}
+
+void MicroBenchmark::Fail(const std::string& reason) {
+    LOG_ERROR("{}: {}", name, reason);
+    failed = true;
+}
+
+int MicroBenchmark::Finish() {
+    int result = failed ? 5 : 0;
+    if (reportPath.empty())
+        return result;
+
+    BenchReport report = BenchReport::FromTimings(caseNames, timings, warmup);
+    report.scene = name;
+    report.renderer = "cpu";
+    return report.Write(reportPath) ? result : 4;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <Voxel/pch.h>
+#include <Voxel/Benchmark/BenchReport.h>
+
+// Harness for the micro benchmarks run through `voxel_bench micro <name>`. Each case is timed
+// over a number of repetitions and summarised like a scene run, so `voxel_bench compare` works
+// on micro benchmark reports too.
+class MicroBenchmark {
+  public:
+    // Reads --repetitions N, --warmup N and --report path, the rest is left to GetOption
+    MicroBenchmark(std::string name, int argc, char** argv);
+
+    int GetOption(const std::string& option, int defaultValue) const;
+
+    // Times body once per repetition. itemCount is how many items a single call handles, for the
+    // per item cost in the log. Returns the median in milliseconds.
+    float Run(const std::string& caseName, size_t itemCount, const std::function<void()>& body);
+
+    // Marks the run as failed, for benchmarks that check their results as well
+    void Fail(const std::string& reason);
+
+    // Writes the report if one was asked for, returns the exit code
+    int Finish();
+
+  private:
+    std::string name;
+    int repetitions = 20;
+    int warmup = 3;
+    std::filesystem::path reportPath;
+    bool failed = false;
+    std::unordered_map<std::string, std::string> options;
+
+    std::vector<std::string> caseNames;
+    // Row per repetition, column per case, in milliseconds
+    std::vector<std::vector<float>> timings;
+};
+
+// Micro benchmarks, each in its own file
+void RunBrushBenchmark(MicroBenchmark& benchmark);
+void RunChunkBenchmark(MicroBenchmark& benchmark);
+void RunCsgBenchmark(MicroBenchmark& benchmark);
+void RunEventBenchmark(MicroBenchmark& benchmark);
+void RunExportBenchmark(MicroBenchmark& benchmark);
+void RunRegionBenchmark(MicroBenchmark& benchmark);
+void RunSceneBenchmark(MicroBenchmark& benchmark);
+void RunSnapshotBenchmark(MicroBenchmark& benchmark);
+void RunStreamingBenchmark(MicroBenchmark& benchmark);
+void RunUndoBenchmark(MicroBenchmark& benchmark);
+void RunVoxBenchmark(MicroBenchmark& benchmark);
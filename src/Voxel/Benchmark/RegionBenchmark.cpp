@@ -0,0 +1,283 @@
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <format>
+#include <Voxel/Benchmark/MicroBenchmark.h>
+#include <Voxel/Benchmark/TestVolumes.h>
+#include <Voxel/Editing/VoxelRegions.h>
+#include <Voxel/Editing/VoxelTools.h>
+#include <Voxel/Jobs/JobSystem.h>
+
+// voxel_bench micro regions [--size N] [--block N]
+//
+// Connected regions in TestVolumes::Terrain --size voxels across (512): flood filling the ground
+// and the largest cave, labelling every solid component and every cave, and filling the caves.
+// Then a solid block --block voxels across (256), and a hollow one whose inside gets filled.
+// Flood fills and labels are first checked against a breadth first search one voxel at a time on
+// a small terrain, which is also timed against the flood fill for a cave of the large one.
+
+namespace {
+const glm::ivec3 directions[6] = {{-1, 0, 0}, {1, 0, 0},  {0, -1, 0},
+                                  {0, 1, 0},  {0, 0, -1}, {0, 0, 1}};
+
+bool InBox(const glm::ivec3& p, const glm::ivec3& min, const glm::ivec3& max) {
+    return glm::all(glm::greaterThanEqual(p, min)) && glm::all(glm::lessThanEqual(p, max));
+}
+
+// Breadth first search from seed, a voxel at a time
+VoxelMask Search(const VoxelVolume& volume, const glm::ivec3& seed, const glm::ivec3& min,
+                 const glm::ivec3& max, const std::function<bool(Voxel)>& matches) {
+    VoxelMask mask;
+    if (!InBox(seed, min, max))
+        return mask;
+    std::vector<glm::ivec3> queue{seed};
+    mask.Insert(seed);
+    for (size_t i = 0; i < queue.size(); i++) {
+        for (const glm::ivec3& direction : directions) {
+            glm::ivec3 next = queue[i] + direction;
+            if (InBox(next, min, max) && !mask.Contains(next) && matches(volume.Get(next))) {
+                mask.Insert(next);
+                queue.push_back(next);
+            }
+        }
+    }
+    return mask;
+}
+
+VoxelMask SearchFrom(const VoxelVolume& volume, const glm::ivec3& seed, const glm::ivec3& min,
+                     const glm::ivec3& max, bool sameColour) {
+    Voxel seedVoxel = volume.Get(seed);
+    return Search(volume, seed, min, max, [&](Voxel voxel) {
+        return sameColour ? voxel == seedVoxel : (voxel != 0) == (seedVoxel != 0);
+    });
+}
+
+bool SameMask(const VoxelMask& a, const VoxelMask& b) {
+    if (a.GetChunkCount() != b.GetChunkCount())
+        return false;
+    for (const auto& [chunk, bits] : a.GetChunks()) {
+        const VoxelMask::ChunkBits* other = b.GetChunk(chunk);
+        if (!other || *other != bits)
+            return false;
+    }
+    return true;
+}
+
+// Sizes of every component a search finds, smallest first
+std::vector<size_t> SearchComponents(const VoxelVolume& volume, VoxelRegions::Match match,
+                                     const glm::ivec3& min, const glm::ivec3& max) {
+    auto included = [&](Voxel voxel) {
+        return match == VoxelRegions::Match::Empty ? voxel == 0 : voxel != 0;
+    };
+    VoxelMask seen;
+    std::vector<size_t> sizes;
+    for (int z = min.z; z <= max.z; z++) {
+        for (int y = min.y; y <= max.y; y++) {
+            for (int x = min.x; x <= max.x; x++) {
+                Voxel voxel = volume.Get({x, y, z});
+                if (!included(voxel) || seen.Contains({x, y, z}))
+                    continue;
+                VoxelMask component = Search(volume, {x, y, z}, min, max, [&](Voxel other) {
+                    return match == VoxelRegions::Match::Colour ? other == voxel
+                                                                : included(other);
+                });
+                sizes.push_back(component.Count());
+                for (const auto& [chunk, bits] : component.GetChunks()) {
+                    VoxelMask::ChunkBits& into = seen.GetOrCreateChunk(chunk);
+                    for (int row = 0; row < VoxelMask::rowCount; row++)
+                        into[row] |= bits[row];
+                }
+            }
+        }
+    }
+    std::sort(sizes.begin(), sizes.end());
+    return sizes;
+}
+
+std::vector<size_t> LabelSizes(const VoxelLabels& labels) {
+    std::vector<size_t> sizes;
+    for (uint32_t i = 0; i < labels.GetComponentCount(); i++)
+        sizes.push_back(labels.GetVoxelCount(i));
+    std::sort(sizes.begin(), sizes.end());
+    return sizes;
+}
+
+// The largest component that doesn't reach the edge, none when there are none
+uint32_t LargestEnclosed(const VoxelLabels& labels) {
+    uint32_t largest = VoxelLabels::none;
+    for (uint32_t i = 0; i < labels.GetComponentCount(); i++) {
+        bool larger =
+            largest == VoxelLabels::none || labels.GetVoxelCount(i) > labels.GetVoxelCount(largest);
+        if (labels.IsEnclosed(i) && larger)
+            largest = i;
+    }
+    return largest;
+}
+
+// A voxel of the component
+glm::ivec3 FirstVoxel(const VoxelLabels& labels, uint32_t component) {
+    for (const VoxelLabels::ChunkRuns& chunk : labels.GetChunks()) {
+        for (const VoxelLabels::Run& run : chunk.runs) {
+            if (run.component == component)
+                return chunk.chunk * VoxelChunk::size +
+                       glm::ivec3(run.first, run.row % VoxelChunk::size,
+                                  run.row / VoxelChunk::size);
+        }
+    }
+    return glm::ivec3(0);
+}
+
+void CheckSmall(MicroBenchmark& benchmark) {
+    constexpr int size = 96;
+    VoxelVolume volume;
+    TestVolumes::Terrain(volume, size);
+    glm::ivec3 min, max;
+    VoxelRegions::GetBounds(volume, min, max);
+
+    for (VoxelRegions::Match match :
+         {VoxelRegions::Match::Solid, VoxelRegions::Match::Colour, VoxelRegions::Match::Empty}) {
+        VoxelLabels labels = VoxelRegions::Label(volume, match, min, max);
+        if (LabelSizes(labels) != SearchComponents(volume, match, min, max))
+            benchmark.Fail(std::format("labelling match {} finds different components",
+                                       static_cast<int>(match)));
+    }
+
+    VoxelLabels caves = VoxelRegions::Label(volume, VoxelRegions::Match::Empty);
+    uint32_t cave = LargestEnclosed(caves);
+    std::vector<std::pair<glm::ivec3, bool>> seeds = {
+        {{size / 2, 0, size / 2}, false}, {{size / 2, 0, size / 2}, true},
+        {{3, 2, 70}, true}, {{size / 2, max.y, size / 2}, false}};
+    if (cave != VoxelLabels::none)
+        seeds.push_back({FirstVoxel(caves, cave), true});
+    for (const auto& [seed, sameColour] : seeds) {
+        VoxelMask filled = VoxelRegions::FloodFill(volume, seed, min, max, sameColour);
+        if (!SameMask(filled, SearchFrom(volume, seed, min, max, sameColour)))
+            benchmark.Fail(std::format("flood filling from {} {} {} selects the wrong voxels",
+                                       seed.x, seed.y, seed.z));
+    }
+    if (cave != VoxelLabels::none &&
+        !SameMask(caves.Select(cave), VoxelRegions::FloodFill(volume, FirstVoxel(caves, cave),
+                                                               min, max)))
+        benchmark.Fail("the largest cave's label and flood fill differ");
+
+    // A hollow box closing in a missing chunk, and a chunk far off from it, which leaves the
+    // chunks between them missing too
+    VoxelVolume sparse;
+    VoxelTools::FillBox(sparse, glm::ivec3(0), glm::ivec3(95), 1);
+    VoxelTools::FillBox(sparse, glm::ivec3(32), glm::ivec3(63), 0);
+    VoxelTools::FillBox(sparse, glm::ivec3(200, 40, 70), glm::ivec3(201, 41, 71), 2);
+    VoxelRegions::GetBounds(sparse, min, max);
+    VoxelLabels empty = VoxelRegions::Label(sparse, VoxelRegions::Match::Empty, min, max);
+    glm::ivec3 inside(48);
+    if (LabelSizes(empty) != SearchComponents(sparse, VoxelRegions::Match::Empty, min, max) ||
+        !SameMask(empty.SelectEnclosed(), VoxelRegions::FloodFill(sparse, inside, min, max)) ||
+        empty.GetComponent(inside) == empty.GetComponent(glm::ivec3(150, 10, 10)))
+        benchmark.Fail("labelling the empty space of missing chunks finds different components");
+}
+
+void LogRegion(const std::string& name, size_t voxels, float ms) {
+    LOG_INFO("{:<24} {:>7.2f}M voxels in {:8.3f} ms, {:6.1f}M voxels/s", name, voxels / 1e6, ms,
+             voxels / (std::max(ms, 1e-6f) * 1e3));
+}
+} // namespace
+
+void RunRegionBenchmark(MicroBenchmark& benchmark) {
+    int size = std::max(benchmark.GetOption("--size", 512), VoxelChunk::size);
+    int block = std::max(benchmark.GetOption("--block", 256), 8);
+
+    CheckSmall(benchmark);
+    LOG_INFO("Regions over {} threads", JobSystem::GetThreadCount());
+
+    VoxelVolume volume;
+    TestVolumes::Terrain(volume, size);
+    glm::ivec3 min, max;
+    VoxelRegions::GetBounds(volume, min, max);
+
+    // The ground, everything solid connected to the bottom of the terrain
+    glm::ivec3 ground(size / 2, 0, size / 2);
+    VoxelMask selected;
+    float groundMs = benchmark.Run("Flood Fill Ground", volume.GetChunkCount(), [&]() {
+        selected = VoxelRegions::FloodFill(volume, ground, min, max, false);
+    });
+    LogRegion("Flood Fill Ground", selected.Count(), groundMs);
+
+    VoxelLabels labels;
+    float solidMs = benchmark.Run("Label Solid", volume.GetChunkCount(), [&]() {
+        labels = VoxelRegions::Label(volume, VoxelRegions::Match::Solid, min, max);
+    });
+    size_t solidVoxels = 0;
+    for (uint32_t i = 0; i < labels.GetComponentCount(); i++)
+        solidVoxels += labels.GetVoxelCount(i);
+    LogRegion("Label Solid", solidVoxels, solidMs);
+    LOG_INFO("{} solid components", labels.GetComponentCount());
+
+    float emptyMs = benchmark.Run("Label Caves", volume.GetChunkCount(), [&]() {
+        labels = VoxelRegions::Label(volume, VoxelRegions::Match::Empty, min, max);
+    });
+    size_t caves = 0;
+    size_t caveVoxels = 0;
+    for (uint32_t i = 0; i < labels.GetComponentCount(); i++) {
+        caves += labels.IsEnclosed(i);
+        caveVoxels += labels.IsEnclosed(i) ? labels.GetVoxelCount(i) : 0;
+    }
+    LOG_INFO("Label Caves              {} empty components, {} caves of {:.2f}M voxels in "
+             "{:.3f} ms",
+             labels.GetComponentCount(), caves, caveVoxels / 1e6, emptyMs);
+
+    uint32_t cave = LargestEnclosed(labels);
+    if (cave != VoxelLabels::none) {
+        glm::ivec3 seed = FirstVoxel(labels, cave);
+        float caveMs = benchmark.Run("Flood Fill Cave", labels.GetVoxelCount(cave), [&]() {
+            selected = VoxelRegions::FloodFill(volume, seed, min, max);
+        });
+        LogRegion("Flood Fill Cave", selected.Count(), caveMs);
+
+        auto start = std::chrono::steady_clock::now();
+        VoxelMask searched = SearchFrom(volume, seed, min, max, true);
+        float searchMs = std::chrono::duration<float, std::milli>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+        LogRegion("Search Cave", searched.Count(), searchMs);
+        if (!SameMask(searched, selected))
+            benchmark.Fail("flood filling the largest cave selects the wrong voxels");
+    }
+
+    float fillMs = benchmark.Run("Fill Caves", caveVoxels, [&]() {
+        VoxelVolume copy = volume.Snapshot();
+        VoxelRegions::FillEnclosed(copy, 9);
+    });
+    LogRegion("Fill Caves", caveVoxels, fillMs);
+
+    // A solid block, every chunk uniform apart from those it partly covers
+    volume.Clear();
+    glm::ivec3 corner(5);
+    glm::ivec3 far = corner + block - 1;
+    VoxelTools::FillBox(volume, corner, far, 3);
+    VoxelRegions::GetBounds(volume, min, max);
+    size_t blockVoxels = size_t(block) * block * block;
+    float blockMs = benchmark.Run("Flood Fill Block", blockVoxels, [&]() {
+        selected = VoxelRegions::FloodFill(volume, corner, min, max);
+    });
+    LogRegion("Flood Fill Block", selected.Count(), blockMs);
+    if (selected.Count() != blockVoxels)
+        benchmark.Fail("flood filling the block misses some of it");
+    float blockLabelMs = benchmark.Run("Label Block", blockVoxels, [&]() {
+        labels = VoxelRegions::Label(volume, VoxelRegions::Match::Solid, min, max);
+    });
+    LogRegion("Label Block", blockVoxels, blockLabelMs);
+    if (labels.GetComponentCount() != 1)
+        benchmark.Fail(std::format("the block has {} components", labels.GetComponentCount()));
+
+    // Hollowed out, the inside is closed in and the outside reaches the edge of the chunks
+    VoxelTools::FillBox(volume, corner + 1, far - 1, 0);
+    size_t inside = size_t(block - 2) * (block - 2) * (block - 2);
+    size_t changed = 0;
+    float hollowMs = benchmark.Run("Fill Hollow Block", inside, [&]() {
+        VoxelVolume copy = volume.Snapshot();
+        changed = VoxelRegions::FillEnclosed(copy, 7);
+    });
+    LogRegion("Fill Hollow Block", inside, hollowMs);
+    VoxelRegions::FillEnclosed(volume, 7);
+    if (volume.Get(corner + 1) != 7 || volume.Get(far - 1) != 7 || volume.Get(corner - 1) != 0 ||
+        changed == 0)
+        benchmark.Fail("filling the hollow block fills the wrong voxels");
+}
@@ -0,0 +1,82 @@
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <format>
+#include <Voxel/Benchmark/MicroBenchmark.h>
+#include <Voxel/ECS/Components/HierarchyComponent.h>
+#include <Voxel/ECS/Components/MeshComponent.h>
+#include <Voxel/ECS/Components/MetaComponent.h>
+#include <Voxel/ECS/Components/TransformComponent.h>
+#include <Voxel/Scene/SceneSerializer.h>
+
+// voxel_bench micro scene [--entities N] [--group N]
+//
+// Saving and loading a binary scene of N entities in groups of N, the first of each group parent
+// of the rest. Also checks the round trip: the loaded scene must save to the same bytes and have
+// the same world matrices. At the default 10M entities --repetitions 5 --warmup 1 is plenty.
+
+namespace {
+double SumWorldMatrices(EntityRegistry* registry) {
+    double sum = 0.0;
+    auto view = registry->MakeView<const TransformComponent>();
+    for (auto&& [entity, transform] : view) {
+        for (int column = 0; column < 4; column++) {
+            for (int row = 0; row < 4; row++)
+                sum += transform.worldMatrix[column][row];
+        }
+    }
+    return sum;
+}
+
+std::vector<char> ReadFile(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(file), {});
+}
+} // namespace
+
+void RunSceneBenchmark(MicroBenchmark& benchmark) {
+    size_t entityCount =
+        static_cast<size_t>(std::max(benchmark.GetOption("--entities", 10000000), 1));
+    size_t groupSize = static_cast<size_t>(std::max(benchmark.GetOption("--group", 8), 1));
+
+    EntityRegistry* registry = EntityRegistry::GetInstance();
+    RawModel* model = nullptr;
+    registry->Cleanup();
+    TransformSystem::Init(registry);
+    Entity groupParent = InvalidEntity;
+    for (size_t i = 0; i < entityCount; i++) {
+        Entity entity = registry->CreateEntity();
+        bool first = i % groupSize == 0;
+        glm::ivec3 cell(i % 1000, i / 1000 % 1000, i / 1000000);
+        glm::vec3 rotation(0.0f, static_cast<float>(i % 360), 0.0f);
+        registry->AddComponent<MetaComponent>(
+            entity, std::format("Cube ({}, {}, {})", cell.x, cell.y, cell.z), i % 7 != 0);
+        registry->AddComponent<TransformComponent>(
+            entity, first ? glm::vec3(cell) : glm::vec3(1.0f), rotation);
+        registry->AddComponent<MeshComponent>(entity, model);
+        registry->AddComponent<HierarchyComponent>(entity, first ? InvalidEntity : groupParent);
+        if (first)
+            groupParent = entity;
+    }
+    TransformSystem::Run();
+    double worldSum = SumWorldMatrices(registry);
+
+    std::filesystem::path directory = std::filesystem::temp_directory_path();
+    std::filesystem::path path = directory / "voxel_bench_scene.vscene";
+    std::filesystem::path resavePath = directory / "voxel_bench_scene_resave.vscene";
+
+    bool ok = true;
+    benchmark.Run("Save", entityCount, [&]() { ok = SceneSerializer::Save(path, registry) && ok; });
+    benchmark.Run("Load", entityCount,
+                  [&]() { ok = SceneSerializer::Load(path, registry, model) && ok; });
+
+    if (!ok || !SceneSerializer::Save(resavePath, registry))
+        benchmark.Fail("saving or loading failed");
+    else if (ReadFile(path) != ReadFile(resavePath))
+        benchmark.Fail("the loaded scene saves differently");
+    else if (std::abs(SumWorldMatrices(registry) - worldSum) > 1e-6 * std::abs(worldSum) + 1e-3)
+        benchmark.Fail("world matrices differ after loading");
+
+    registry->Cleanup();
+    std::filesystem::remove(path);
+    std::filesystem::remove(resavePath);
+}
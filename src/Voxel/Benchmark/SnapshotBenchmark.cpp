@@ -0,0 +1,138 @@
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <format>
+#include <Voxel/Benchmark/MicroBenchmark.h>
+#include <Voxel/Benchmark/TestVolumes.h>
+#include <Voxel/Volume/ChunkFile.h>
+#include <Voxel/Volume/VolumeAutosave.h>
+
+// voxel_bench micro snapshot [--size N] [--edits N] [--radius N] [--fill N]
+//
+// Copy on write snapshots of TestVolumes::Terrain --size voxels across (1024): taking one against
+// copying every chunk, then the memory a live snapshot costs for typical edits, --edits scattered
+// voxels (1000), a sphere brush of --radius voxels (24) and a chunk aligned box fill --fill voxels
+// across (224). Last an autosave, counting the edits made while it writes and checking the file
+// holds the volume as it was when the save started.
+
+namespace {
+int64_t LiveVoxelBytes() {
+    return MemoryTracker::GetStats(MemoryTag::Voxel).liveBytes.load(std::memory_order_relaxed);
+}
+
+// Sets edits voxels spread over the volume, different ones for each seed
+void Scatter(VoxelVolume& volume, int size, int edits, uint32_t seed, Voxel voxel) {
+    uint32_t state = seed;
+    for (int i = 0; i < edits; i++)
+        volume.Set(TestVolumes::RandomPosition(state, size), voxel);
+}
+
+void Sphere(VoxelVolume& volume, const glm::ivec3& centre, int radius, Voxel voxel) {
+    for (int z = -radius; z <= radius; z++) {
+        for (int y = -radius; y <= radius; y++) {
+            for (int x = -radius; x <= radius; x++) {
+                if (x * x + y * y + z * z <= radius * radius)
+                    volume.Set(centre + glm::ivec3(x, y, z), voxel);
+            }
+        }
+    }
+}
+} // namespace
+
+void RunSnapshotBenchmark(MicroBenchmark& benchmark) {
+    int size = std::max(benchmark.GetOption("--size", 1024), VoxelChunk::size);
+    int edits = std::max(benchmark.GetOption("--edits", 1000), 1);
+    int radius = std::max(benchmark.GetOption("--radius", 24), 1);
+    int fillChunks = std::max(benchmark.GetOption("--fill", 224) / VoxelChunk::size, 1);
+
+    VoxelVolume volume;
+    TestVolumes::Terrain(volume, size);
+    size_t chunks = volume.GetChunkCount();
+    double volumeMegabytes = chunks * sizeof(VoxelChunk) / double(1 << 20);
+    LOG_INFO("Terrain {} across: {} chunks, {:.1f} MB of voxels", size, chunks, volumeMegabytes);
+
+    float snapshotMs = benchmark.Run("Snapshot", chunks, [&]() {
+        VoxelVolume snapshot = volume.Snapshot();
+    });
+    float copyMs = benchmark.Run("Deep Copy", chunks, [&]() {
+        VoxelVolume copy;
+        for (const auto& [chunk, voxels] : volume.GetChunks())
+            copy.SetChunk(chunk, std::make_unique<VoxelChunk>(*voxels));
+    });
+    LOG_INFO("Snapshot in {:.3f} ms against {:.1f} ms to copy the voxels, {:.0f}x", snapshotMs,
+             copyMs, copyMs / std::max(snapshotMs, 1e-6f));
+
+    // What a snapshot kept alive during each kind of edit costs on top of the edit itself
+    struct Pattern {
+        std::string name;
+        size_t items;
+        std::function<void(Voxel)> edit;
+    };
+    glm::ivec3 centre(size / 2, TestVolumes::height / 2, size / 2);
+    Voxel colour = 1;
+    size_t sphereVoxels = 0;
+    for (int z = -radius; z <= radius; z++) {
+        for (int y = -radius; y <= radius; y++) {
+            for (int x = -radius; x <= radius; x++)
+                sphereVoxels += x * x + y * y + z * z <= radius * radius;
+        }
+    }
+    std::vector<Pattern> patterns = {
+        {std::format("{} Scattered Voxels", edits), size_t(edits),
+         [&](Voxel voxel) { Scatter(volume, size, edits, 777, voxel); }},
+        {std::format("Sphere Radius {}", radius), sphereVoxels,
+         [&](Voxel voxel) { Sphere(volume, centre, radius, voxel); }},
+        {std::format("Fill {} Chunks", fillChunks * fillChunks * fillChunks),
+         size_t(fillChunks) * fillChunks * fillChunks,
+         [&](Voxel voxel) {
+             TestVolumes::FillChunks(volume, glm::ivec3(1, 0, 1), fillChunks, voxel);
+         }},
+    };
+    for (const Pattern& pattern : patterns) {
+        int64_t before = LiveVoxelBytes();
+        VoxelVolume snapshot = volume.Snapshot();
+        uint64_t snapshotChecksum = TestVolumes::Checksum(volume);
+        pattern.edit(++colour);
+        size_t copied = snapshot.GetChunkCount() - volume.GetSharedChunkCount();
+        int64_t withSnapshot = LiveVoxelBytes() - before;
+        bool intact = TestVolumes::Checksum(snapshot) == snapshotChecksum;
+        snapshot = VoxelVolume();
+        int64_t overhead = withSnapshot - (LiveVoxelBytes() - before);
+
+        float ms = benchmark.Run(pattern.name + " With Snapshot", pattern.items, [&]() {
+            VoxelVolume kept = volume.Snapshot();
+            pattern.edit(++colour);
+        });
+        LOG_INFO("{:<24} {:.1f} MB kept by the snapshot, {:.2f}% of the volume, {} chunks no "
+                 "longer shared, {:.2f} ms with a snapshot alive",
+                 pattern.name, overhead / double(1 << 20),
+                 100.0 * overhead / (chunks * sizeof(VoxelChunk)), copied, ms);
+        if (!intact)
+            benchmark.Fail(pattern.name + ": editing the volume changed its snapshot");
+    }
+
+    // Edits keep landing while the autosave writes
+    std::filesystem::path path = std::filesystem::temp_directory_path() /
+                                 (std::string("voxel_bench_autosave") + ChunkFile::extension);
+    VolumeAutosave autosave;
+    uint64_t saved = TestVolumes::Checksum(volume);
+    auto start = std::chrono::steady_clock::now();
+    bool started = autosave.Save(volume, path);
+    int batches = 0;
+    while (autosave.IsSaving()) {
+        Scatter(volume, size, edits, 1000 + batches, ++colour);
+        batches++;
+    }
+    bool ok = started && autosave.Wait();
+    float totalMs =
+        std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    LOG_INFO("Autosave held up editing for {:.3f} ms, wrote for {:.1f} ms, {} batches of {} edits "
+             "made meanwhile in {:.1f} ms",
+             autosave.GetSnapshotMs(), autosave.GetWriteMs(), batches, edits, totalMs);
+
+    VoxelVolume loaded;
+    if (!ok || !ChunkFile::LoadVolume(path, loaded))
+        benchmark.Fail("the autosave failed");
+    else if (TestVolumes::Checksum(loaded) != saved)
+        benchmark.Fail("the autosave doesn't hold the volume as it was when saving started");
+    std::filesystem::remove(path);
+}
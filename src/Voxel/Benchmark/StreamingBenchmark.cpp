@@ -0,0 +1,93 @@
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <Voxel/Benchmark/MicroBenchmark.h>
+#include <Voxel/Benchmark/TestVolumes.h>
+#include <Voxel/Volume/ChunkManager.h>
+
+// voxel_bench micro streaming [--size N] [--budget MB] [--radius N]
+//
+// Flies across a streamed TestVolumes::Terrain chunk file N voxels across and back, a chunk per
+// step, waiting at each step until its chunks are loaded. Also checks that the memory budget
+// holds, and that an edit survives being evicted to the cache and is saved back to the file.
+
+void RunStreamingBenchmark(MicroBenchmark& benchmark) {
+    int size = std::max(benchmark.GetOption("--size", 1024), VoxelChunk::size);
+    ChunkStreamingSettings settings;
+    settings.memoryBudget = size_t(std::max(benchmark.GetOption("--budget", 32), 1)) << 20;
+    settings.residentRadius = std::max(benchmark.GetOption("--radius", 6), 0);
+    settings.maxUploadsPerFrame = std::numeric_limits<int>::max();
+
+    std::filesystem::path path =
+        std::filesystem::temp_directory_path() / "voxel_bench_streaming.vxchunks";
+    {
+        VoxelVolume volume;
+        TestVolumes::Terrain(volume, size);
+        if (!ChunkFile::SaveVolume(path, volume)) {
+            benchmark.Fail("could not write the chunk file");
+            return;
+        }
+    }
+
+    std::vector<glm::vec3> steps;
+    for (int i = VoxelChunk::size / 2; i < size; i += VoxelChunk::size)
+        steps.emplace_back(i, 64.0f, i);
+    steps.insert(steps.end(), steps.rbegin(), steps.rend());
+
+    ChunkManager manager(settings);
+    if (!manager.Open(path)) {
+        benchmark.Fail("could not open the chunk file");
+        return;
+    }
+
+    size_t peakBytes = 0;
+    auto flyTo = [&](const glm::vec3& focus) {
+        manager.Update(focus);
+        manager.WaitForIdle();
+        manager.Update(focus);
+        peakBytes = std::max(peakBytes, manager.GetResidentBytes());
+    };
+
+    // Above the terrain, so the edit creates a chunk the file doesn't have
+    glm::ivec3 edit(20, TestVolumes::height - 4, 20);
+    flyTo(steps.front());
+    manager.Set(edit, 200);
+
+    // Loads and bytes read by the last flight, they are the same every time
+    size_t loads = 0;
+    uint64_t read = 0;
+    float ms = benchmark.Run("Fly", steps.size(), [&]() {
+        size_t loadsBefore = manager.GetLoadedCount();
+        uint64_t readBefore = manager.GetBytesRead();
+        for (const glm::vec3& step : steps)
+            flyTo(step);
+        loads = manager.GetLoadedCount() - loadsBefore;
+        read = manager.GetBytesRead() - readBefore;
+    });
+
+    double megabytes = static_cast<double>(loads * sizeof(VoxelChunk)) / (1 << 20);
+    LOG_INFO("{} chunks loaded and meshed per flight, {:.1f} MB/s of voxels from {:.2f} MB on "
+             "disk",
+             loads, megabytes * 1000.0 / ms, read / double(1 << 20));
+    LOG_INFO("{} evictions, peak {:.1f} of {} MB resident", manager.GetEvictedCount(),
+             peakBytes / double(1 << 20), settings.memoryBudget >> 20);
+
+    if (manager.GetEvictedCount() == 0)
+        LOG_WARN("Nothing was evicted, lower --budget or raise --size to exercise the cache");
+    if (peakBytes > settings.memoryBudget)
+        benchmark.Fail("resident chunks went over the budget, or --radius needs more than it");
+    if (manager.Get(edit) != 200)
+        benchmark.Fail("the edit was lost after its chunk was evicted");
+
+    manager.Save();
+    manager.WaitForIdle();
+    manager.Close();
+
+    ChunkFile file;
+    VoxelChunk chunk;
+    glm::ivec3 local = VoxelVolume::ToLocal(edit);
+    if (!file.Open(path) || !file.LoadChunk(VoxelVolume::ToChunk(edit), chunk) ||
+        chunk.Get(local.x, local.y, local.z) != 200)
+        benchmark.Fail("the edit was not saved to the chunk file");
+    file.Close();
+    std::filesystem::remove(path);
+}
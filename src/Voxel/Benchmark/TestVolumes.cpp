@@ -0,0 +1,167 @@
+#include "TestVolumes.h"
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <cstring>
+#include <Voxel/Editing/VoxelEdit.h>
+
+namespace {
+constexpr int height = TestVolumes::height;
+
+uint32_t Hash(int x, int y, int z) {
+    uint32_t h = static_cast<uint32_t>(x) * 0x8DA6B343u ^ static_cast<uint32_t>(y) * 0xD8163841u ^
+                 static_cast<uint32_t>(z) * 0xCB1AB31Fu;
+    h ^= h >> 13;
+    h *= 0x5BD1E995u;
+    return h ^ (h >> 15);
+}
+
+// Smooth value noise in [0, 1)
+float Noise(float x, float z, int seed) {
+    int x0 = static_cast<int>(std::floor(x));
+    int z0 = static_cast<int>(std::floor(z));
+    float fx = x - x0;
+    float fz = z - z0;
+    fx = fx * fx * (3.0f - 2.0f * fx);
+    fz = fz * fz * (3.0f - 2.0f * fz);
+    auto value = [&](int dx, int dz) {
+        return (Hash(x0 + dx, seed, z0 + dz) & 0xFFFF) / 65536.0f;
+    };
+    float a = value(0, 0) + (value(1, 0) - value(0, 0)) * fx;
+    float b = value(0, 1) + (value(1, 1) - value(0, 1)) * fx;
+    return a + (b - a) * fz;
+}
+
+float Fractal(float x, float z, int seed) {
+    float sum = 0.0f;
+    float amplitude = 0.5f;
+    for (int octave = 0; octave < 4; octave++) {
+        sum += Noise(x, z, seed + octave) * amplitude;
+        x *= 2.0f;
+        z *= 2.0f;
+        amplitude *= 0.5f;
+    }
+    return sum;
+}
+
+} // namespace
+
+void TestVolumes::Terrain(VoxelVolume& volume, int size) {
+    for (int z = 0; z < size; z++) {
+        for (int x = 0; x < size; x++) {
+            int ground = 24 + static_cast<int>(Fractal(x / 96.0f, z / 96.0f, 1) * 80.0f);
+            for (int y = 0; y < ground; y++) {
+                // Caves carved where two noise fields cross
+                bool cave = y < ground - 6 && y > 4 &&
+                            std::abs(Noise(x / 24.0f, z / 24.0f + y / 16.0f, 7) - 0.5f) < 0.04f;
+                if (cave)
+                    continue;
+                Voxel voxel = y == ground - 1 ? 3 : y > ground - 5 ? 2 : 1;
+                if (voxel == 1 && Hash(x, y, z) % 97 == 0)
+                    voxel = 4; // Ore
+                volume.Set({x, y, z}, voxel);
+            }
+        }
+    }
+}
+
+void TestVolumes::Scan(VoxelVolume& volume, int size) {
+    for (int z = 0; z < size; z++) {
+        for (int x = 0; x < size; x++) {
+            int surface = 16 + static_cast<int>(Fractal(x / 48.0f, z / 48.0f, 11) * 96.0f);
+            // A shell a few voxels thick, coloured by position and noise
+            for (int y = std::max(surface - 3, 0); y <= surface && y < height; y++) {
+                uint32_t tint = Hash(x, y, z) % 12;
+                Voxel voxel = static_cast<Voxel>(16 + (x / 8 + z / 8) % 8 * 24 + tint);
+                volume.Set({x, y, z}, voxel);
+            }
+        }
+    }
+}
+
+void TestVolumes::City(VoxelVolume& volume, int size) {
+    constexpr int block = 24;
+    for (int z = 0; z < size; z++) {
+        for (int x = 0; x < size; x++) {
+            volume.Set({x, 0, z}, 5);
+            int lx = x % block;
+            int lz = z % block;
+            if (lx < 4 || lz < 4)
+                continue; // Street
+            int floors = 2 + Hash(x / block, 0, z / block) % 28;
+            Voxel wall = static_cast<Voxel>(6 + Hash(x / block, 1, z / block) % 6);
+            bool edge = lx == 4 || lx == block - 1 || lz == 4 || lz == block - 1;
+            for (int y = 1; y <= floors * 4 && y < height; y++) {
+                if (!edge && y % 4 != 0)
+                    continue; // Hollow, with floors
+                bool window = edge && y % 4 == 2 && (lx + lz) % 3 != 0;
+                volume.Set({x, y, z}, window ? 12 : wall);
+            }
+        }
+    }
+}
+
+void TestVolumes::FillChunks(VoxelVolume& volume, const glm::ivec3& first, int chunksAcross,
+                             Voxel voxel, VoxelEditRecorder* recorder) {
+    for (int z = 0; z < chunksAcross; z++) {
+        for (int y = 0; y < chunksAcross; y++) {
+            for (int x = 0; x < chunksAcross; x++) {
+                ChunkHandle chunk = ChunkHandle::Make();
+                chunk.Write().Fill(voxel);
+                if (recorder)
+                    recorder->Replace(first + glm::ivec3(x, y, z), std::move(chunk));
+                else
+                    volume.SetChunk(first + glm::ivec3(x, y, z), std::move(chunk));
+            }
+        }
+    }
+}
+
+glm::ivec3 TestVolumes::RandomPosition(uint32_t& state, int size) {
+    auto next = [&](int range) {
+        state = state * 1664525u + 1013904223u;
+        return static_cast<int>((state >> 8) % static_cast<uint32_t>(range));
+    };
+    // Named so the calls happen in order, argument evaluation order is unspecified
+    int x = next(size);
+    int y = next(height);
+    int z = next(size);
+    return {x, y, z};
+}
+
+uint64_t TestVolumes::Checksum(const VoxelVolume& volume) {
+    uint64_t sum = 0;
+    for (const auto& [position, chunk] : volume.GetChunks()) {
+        uint64_t h = std::hash<glm::ivec3>()(position);
+        const Voxel* voxels = chunk->GetVoxels().data();
+        for (size_t i = 0; i < VoxelChunk::voxelCount; i += sizeof(uint64_t)) {
+            uint64_t word;
+            std::memcpy(&word, voxels + i, sizeof(word));
+            h = (h ^ word) * 0x100000001B3ull;
+        }
+        // Order independent, the map isn't sorted
+        sum += h ^ (h >> 31);
+    }
+    return sum;
+}
+
+VoxelVolume::ChunkSet TestVolumes::Differences(const VoxelVolume& a, const VoxelVolume& b) {
+    static const VoxelChunk empty;
+    auto same = [](const VoxelChunk* x, const VoxelChunk* y) {
+        return *(x ? x : &empty) == *(y ? y : &empty);
+    };
+    VoxelVolume::ChunkSet differences;
+    for (const auto& [chunk, voxels] : a.GetChunks()) {
+        if (!same(voxels.Get(), b.GetChunk(chunk)))
+            differences.insert(chunk);
+    }
+    for (const auto& [chunk, voxels] : b.GetChunks()) {
+        if (!same(a.GetChunk(chunk), voxels.Get()))
+            differences.insert(chunk);
+    }
+    return differences;
+}
+
+void TestVolumes::LogThroughput(const std::string& name, size_t voxels, float ms, size_t chunks) {
+    LOG_INFO("{:<28} {:>7.1f}M voxels in {:8.3f} ms, {:6.2f}G voxels/s, {} chunks changed", name,
+             voxels / 1e6, ms, voxels / (std::max(ms, 1e-6f) * 1e6), chunks);
+}
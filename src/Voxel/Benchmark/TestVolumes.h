@@ -0,0 +1,35 @@
+#pragma once
+#include <Voxel/pch.h>
+#include <Voxel/Volume/VoxelVolume.h>
+
+class VoxelEditRecorder;
+
+// Procedural volumes for the voxel benchmarks, size voxels across x and z and up to height high.
+// The same size always gives the same voxels.
+class TestVolumes {
+  public:
+    static constexpr int height = 128;
+
+    // Layered ground with caves, mostly uniform chunks and long runs
+    static void Terrain(VoxelVolume& volume, int size);
+    // A noisy surface in many colours, like a photogrammetry import
+    static void Scan(VoxelVolume& volume, int size);
+    // Blocks of hollow buildings with windows, short regular runs
+    static void City(VoxelVolume& volume, int size);
+
+    // Fills chunksAcross cubed chunks from first, each its own newly allocated chunk. With a
+    // recorder the chunks are replaced through it, for undo.
+    static void FillChunks(VoxelVolume& volume, const glm::ivec3& first, int chunksAcross,
+                           Voxel voxel, VoxelEditRecorder* recorder = nullptr);
+    // A position in a volume size voxels across, stepping a linear congruential generator
+    static glm::ivec3 RandomPosition(uint32_t& state, int size);
+    // Order independent hash of every chunk's position and voxels, to check a volume came back
+    // as it was
+    static uint64_t Checksum(const VoxelVolume& volume);
+    // Chunks whose voxels differ between the volumes, missing chunks reading as empty
+    static VoxelVolume::ChunkSet Differences(const VoxelVolume& a, const VoxelVolume& b);
+
+    // One line per edit benchmark: voxels per second over the voxels it covers, and the chunks
+    // it changed
+    static void LogThroughput(const std::string& name, size_t voxels, float ms, size_t chunks);
+};
@@ -0,0 +1,224 @@
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <format>
+#include <Voxel/Benchmark/MicroBenchmark.h>
+#include <Voxel/Benchmark/TestVolumes.h>
+#include <Voxel/ECS/Components/HierarchyComponent.h>
+#include <Voxel/ECS/Components/MetaComponent.h>
+#include <Voxel/ECS/Components/TransformComponent.h>
+#include <Voxel/Editing/EntityEdits.h>
+#include <Voxel/Editing/UndoHistory.h>
+#include <Voxel/Editing/VoxelEdit.h>
+
+// voxel_bench micro undo [--size N] [--fill N] [--edits N] [--entities N] [--drag N]
+//
+// Undo history in TestVolumes::Terrain --size voxels across (512): recording, undoing and redoing
+// a chunk aligned box fill --fill voxels across (224, about 11M voxels), and --edits single voxel
+// edits (1000) kept as XOR runs. Then --entities transform drags of --drag frames each (1000 and
+// 120), which must merge into one entry per drag, and the memory cap dropping the oldest fills.
+// Every undo and redo is checked to put back exactly the voxels or fields it should.
+
+namespace {
+void Fill(VoxelVolume& volume, const glm::ivec3& first, int chunksAcross, Voxel voxel) {
+    VoxelEditRecorder recorder(volume, "Fill");
+    TestVolumes::FillChunks(volume, first, chunksAcross, voxel, &recorder);
+    recorder.Commit();
+}
+
+// Recolours edits voxels of the terrain spread over the whole volume, the same ones every call
+void SparseEdit(VoxelVolume& volume, int size, int edits) {
+    VoxelEditRecorder recorder(volume, "Paint");
+    uint32_t state = 12345;
+    for (int i = 0; i < edits; i++) {
+        glm::ivec3 position = TestVolumes::RandomPosition(state, size);
+        recorder.Touch(VoxelVolume::ToChunk(position));
+        volume.Set(position, static_cast<Voxel>(volume.Get(position) * 7 + 1));
+    }
+    recorder.Commit();
+}
+
+void RunVoxelCases(MicroBenchmark& benchmark) {
+    int size = std::max(benchmark.GetOption("--size", 512), VoxelChunk::size);
+    int fillChunks = std::max(benchmark.GetOption("--fill", 224) / VoxelChunk::size, 1);
+    int edits = std::max(benchmark.GetOption("--edits", 1000), 1);
+    glm::ivec3 first(1, 0, 1);
+
+    VoxelVolume volume;
+    TestVolumes::Terrain(volume, size);
+    uint64_t original = TestVolumes::Checksum(volume);
+    UndoHistory::Clear();
+
+    Fill(volume, first, fillChunks, 9);
+    uint64_t filled = TestVolumes::Checksum(volume);
+    size_t fillBytes = UndoHistory::GetMemoryUsed();
+    UndoHistory::Undo();
+    if (TestVolumes::Checksum(volume) != original)
+        benchmark.Fail("undoing the fill didn't restore the terrain");
+
+    size_t chunks = size_t(fillChunks) * fillChunks * fillChunks;
+    double voxels = double(chunks) * VoxelChunk::voxelCount;
+    float fillMs = benchmark.Run("Fill + Undo", chunks, [&]() {
+        Fill(volume, first, fillChunks, 9);
+        UndoHistory::Undo();
+    });
+    // Each call flips the fill, the history ends up as it started whatever the repetitions
+    bool isFilled = false;
+    float swapMs = benchmark.Run("Undo/Redo Fill", chunks, [&]() {
+        isFilled ? UndoHistory::Undo() : UndoHistory::Redo();
+        isFilled = !isFilled;
+    });
+    if (isFilled)
+        UndoHistory::Undo();
+    LOG_INFO("Fill of {:.1f}M voxels in {} chunks: recorded and undone in {:.2f} ms, undo or redo "
+             "in {:.3f} ms, {:.1f} MB of history",
+             voxels / 1e6, chunks, fillMs, swapMs, fillBytes / double(1 << 20));
+
+    if (TestVolumes::Checksum(volume) != original)
+        benchmark.Fail("the terrain differs after undoing the fill");
+    UndoHistory::Redo();
+    if (TestVolumes::Checksum(volume) != filled)
+        benchmark.Fail("redoing the fill doesn't give the filled volume");
+    UndoHistory::Undo();
+
+    UndoHistory::Clear();
+    SparseEdit(volume, size, edits);
+    uint64_t edited = TestVolumes::Checksum(volume);
+    size_t editBytes = UndoHistory::GetMemoryUsed();
+    UndoHistory::Undo();
+    if (TestVolumes::Checksum(volume) != original)
+        benchmark.Fail("undoing the sparse edit didn't restore the terrain");
+    UndoHistory::Redo();
+    if (TestVolumes::Checksum(volume) != edited)
+        benchmark.Fail("redoing the sparse edit doesn't give the edited volume");
+    UndoHistory::Undo();
+
+    float editMs = benchmark.Run("Sparse Edit + Undo", edits, [&]() {
+        SparseEdit(volume, size, edits);
+        UndoHistory::Undo();
+    });
+    LOG_INFO("{} voxel edit: recorded and undone in {:.2f} ms, {:.1f} KB of history, {:.1f} bytes "
+             "per voxel",
+             edits, editMs, editBytes / 1024.0, editBytes / double(edits));
+
+    // Five fills in turn against a cap that holds the old chunks of three and a half
+    UndoHistory::Clear();
+    std::vector<uint64_t> states{TestVolumes::Checksum(volume)};
+    UndoHistory::SetMemoryCap(chunks * sizeof(VoxelChunk) * 7 / 2);
+    for (Voxel voxel = 1; voxel <= 5; voxel++) {
+        Fill(volume, first, fillChunks, voxel);
+        states.push_back(TestVolumes::Checksum(volume));
+    }
+    size_t kept = UndoHistory::GetUndoCount();
+    bool capped = UndoHistory::GetMemoryUsed() <= UndoHistory::GetMemoryCap() && kept < 5;
+    while (UndoHistory::Undo()) {
+    }
+    if (!capped)
+        benchmark.Fail(std::format("the history holds {} bytes over a cap of {}",
+                                   UndoHistory::GetMemoryUsed(), UndoHistory::GetMemoryCap()));
+    else if (TestVolumes::Checksum(volume) != states[5 - kept])
+        benchmark.Fail("undoing what is left after eviction gives the wrong voxels");
+    LOG_INFO("Memory cap of {:.1f} MB kept {} of 5 fills",
+             UndoHistory::GetMemoryCap() / double(1 << 20), kept);
+    UndoHistory::Clear();
+    UndoHistory::SetMemoryCap(size_t(256) << 20);
+}
+
+void RunEntityCases(MicroBenchmark& benchmark) {
+    int entityCount = std::max(benchmark.GetOption("--entities", 1000), 2);
+    int frames = std::max(benchmark.GetOption("--drag", 120), 1);
+
+    EntityRegistry* registry = EntityRegistry::GetInstance();
+    registry->Cleanup();
+    TransformSystem::Init(registry);
+    std::vector<Entity> entities;
+    for (int i = 0; i < entityCount; i++) {
+        Entity entity = registry->CreateEntity();
+        registry->AddComponent<MetaComponent>(entity, std::format("Entity {}", i));
+        registry->AddComponent<TransformComponent>(entity, glm::vec3(float(i), 0.0f, 0.0f));
+        registry->AddComponent<HierarchyComponent>(entity);
+        entities.push_back(entity);
+    }
+    TransformSystem::Run();
+
+    auto fieldsOf = [&](Entity entity) {
+        return TransformEdit::GetFields(*registry->GetComponent<TransformComponent>(entity));
+    };
+    std::vector<TransformFields> start;
+    for (Entity entity : entities)
+        start.push_back(fieldsOf(entity));
+
+    // A drag per entity, each frame recorded as the transform panel does
+    auto drag = [&]() {
+        for (Entity entity : entities) {
+            TransformComponent* transform = registry->GetComponent<TransformComponent>(entity);
+            for (int frame = 0; frame < frames; frame++) {
+                TransformFields before = TransformEdit::GetFields(*transform);
+                transform->position.x += 0.25f;
+                transform->eulerRotation.y += 1.0f;
+                transform->SetRotationEulerDegrees(transform->eulerRotation);
+                UndoHistory::Record(std::make_unique<TransformEdit>(
+                    entity, before, TransformEdit::GetFields(*transform)));
+            }
+            UndoHistory::Seal();
+        }
+    };
+
+    UndoHistory::Clear();
+    float dragMs = benchmark.Run("Drag Record", size_t(entityCount) * frames, [&]() {
+        UndoHistory::Clear();
+        for (size_t i = 0; i < entities.size(); i++) {
+            TransformComponent* transform = registry->GetComponent<TransformComponent>(entities[i]);
+            TransformEdit::SetFields(*transform, start[i]);
+        }
+        drag();
+    });
+    size_t entries = UndoHistory::GetUndoCount();
+    size_t dragBytes = UndoHistory::GetMemoryUsed();
+    std::vector<TransformFields> end;
+    for (Entity entity : entities)
+        end.push_back(fieldsOf(entity));
+
+    bool undone = true;
+    float undoMs = benchmark.Run("Drag Undo/Redo", entityCount, [&]() {
+        while (UndoHistory::Undo()) {
+        }
+        for (size_t i = 0; i < entities.size(); i++)
+            undone = undone && fieldsOf(entities[i]) == start[i];
+        while (UndoHistory::Redo()) {
+        }
+    });
+    bool redone = true;
+    for (size_t i = 0; i < entities.size(); i++)
+        redone = redone && fieldsOf(entities[i]) == end[i];
+    LOG_INFO("{} drags of {} frames: {} entries, {:.1f} bytes each, recorded in {:.2f} ms, all "
+             "undone and redone in {:.3f} ms",
+             entityCount, frames, entries, dragBytes / double(std::max<size_t>(entries, 1)),
+             dragMs, undoMs);
+    // Hands the queued transform changes over, as a frame would
+    TransformSystem::Run();
+
+    if (entries != entities.size())
+        benchmark.Fail(std::format("{} drags gave {} undo entries", entities.size(), entries));
+    else if (!undone || !redone)
+        benchmark.Fail("undoing or redoing the drags gave different transforms");
+
+    // Reparenting keeps the world transform, undo must also give back the exact local one
+    TransformFields childFields = fieldsOf(entities[1]);
+    ReparentEdit::Reparent(entities[1], entities[0]);
+    TransformSystem::Run();
+    UndoHistory::Undo();
+    TransformSystem::Run();
+    if (registry->GetComponent<HierarchyComponent>(entities[1])->parent != InvalidEntity ||
+        registry->GetComponent<HierarchyComponent>(entities[0])->children.size() != 0 ||
+        fieldsOf(entities[1]) != childFields)
+        benchmark.Fail("undoing a reparent doesn't restore the hierarchy and transform");
+
+    UndoHistory::Clear();
+    registry->Cleanup();
+}
+} // namespace
+
+void RunUndoBenchmark(MicroBenchmark& benchmark) {
+    RunVoxelCases(benchmark);
+    RunEntityCases(benchmark);
+}
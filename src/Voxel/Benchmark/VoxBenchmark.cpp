@@ -0,0 +1,240 @@
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <cstring>
+#include <format>
+#include <Voxel/Benchmark/MicroBenchmark.h>
+#include <Voxel/Benchmark/TestVolumes.h>
+#include <Voxel/Jobs/JobSystem.h>
+#include <Voxel/Volume/VoxFile.h>
+
+// voxel_bench micro vox [--size N] [--large N] [--model N]
+//
+// Importing MagicaVoxel files cut from the TestVolumes: terrain --size voxels across (256) and a
+// scan --large voxels across (2048), each split into models --model voxels across (128) that a
+// group of transform nodes puts back in place. Logs voxels and megabytes per second, and checks
+// every model decodes to the voxels it was cut from.
+
+namespace {
+// One model of the file, in the order they are written
+struct Block {
+    glm::ivec3 cell{0};
+    // XYZI entries, in MagicaVoxel axes
+    std::vector<uint8_t> voxels;
+    // Order independent sum over the voxels, in editor axes
+    uint64_t checksum = 0;
+};
+
+uint64_t Checksum(const glm::ivec3& position, Voxel voxel) {
+    uint64_t h = (uint64_t(position.x) << 40 | uint64_t(position.y) << 20 | uint64_t(position.z)) *
+                 0x9E3779B97F4A7C15ull;
+    return (h ^ (h >> 29)) * (voxel + 1u);
+}
+
+struct Writer {
+    std::vector<char> bytes;
+
+    void Int(int32_t value) {
+        char raw[sizeof(value)];
+        std::memcpy(raw, &value, sizeof(value));
+        bytes.insert(bytes.end(), raw, raw + sizeof(value));
+    }
+    void Id(const char* id) { bytes.insert(bytes.end(), id, id + 4); }
+    void String(const std::string& value) {
+        Int(static_cast<int32_t>(value.size()));
+        bytes.insert(bytes.end(), value.begin(), value.end());
+    }
+    void Dict(std::initializer_list<std::pair<std::string, std::string>> pairs) {
+        Int(static_cast<int32_t>(pairs.size()));
+        for (const auto& [key, value] : pairs) {
+            String(key);
+            String(value);
+        }
+    }
+    // Starts a chunk without children, returns where its content size goes
+    size_t Begin(const char* id) {
+        Id(id);
+        size_t sizeOffset = bytes.size();
+        Int(0);
+        Int(0);
+        return sizeOffset;
+    }
+    void End(size_t sizeOffset) {
+        int32_t size = static_cast<int32_t>(bytes.size() - sizeOffset - 2 * sizeof(int32_t));
+        std::memcpy(bytes.data() + sizeOffset, &size, sizeof(size));
+    }
+};
+
+// Cuts the volume into cubes of modelSize voxels, leaving out empty ones, and writes them as one
+// model each under a group
+bool WriteVox(const std::filesystem::path& path, const VoxelVolume& volume, int modelSize,
+              std::vector<Block>& outBlocks) {
+    std::map<std::tuple<int, int, int>, Block> blocks;
+    for (const auto& [position, chunk] : volume.GetChunks()) {
+        for (int z = 0; z < VoxelChunk::size; z++) {
+            for (int y = 0; y < VoxelChunk::size; y++) {
+                for (int x = 0; x < VoxelChunk::size; x++) {
+                    Voxel voxel = chunk->Get(x, y, z);
+                    if (voxel == 0)
+                        continue;
+                    glm::ivec3 world = position * VoxelChunk::size + glm::ivec3(x, y, z);
+                    glm::ivec3 cell = world / modelSize;
+                    glm::ivec3 local = world - cell * modelSize;
+
+                    Block& block = blocks[{cell.x, cell.y, cell.z}];
+                    block.cell = cell;
+                    block.voxels.insert(block.voxels.end(),
+                                        {uint8_t(local.x), uint8_t(modelSize - 1 - local.z),
+                                         uint8_t(local.y), voxel});
+                    block.checksum += Checksum(local, voxel);
+                }
+            }
+        }
+    }
+
+    outBlocks.clear();
+    Writer writer;
+    for (auto& [cell, block] : blocks) {
+        size_t size = writer.Begin("SIZE");
+        for (int i = 0; i < 3; i++)
+            writer.Int(modelSize);
+        writer.End(size);
+
+        size_t xyzi = writer.Begin("XYZI");
+        writer.Int(static_cast<int32_t>(block.voxels.size() / 4));
+        writer.bytes.insert(writer.bytes.end(), block.voxels.begin(), block.voxels.end());
+        writer.End(xyzi);
+        outBlocks.push_back(std::move(block));
+    }
+
+    size_t rgba = writer.Begin("RGBA");
+    for (int i = 1; i <= 256; i++)
+        writer.Int(static_cast<int32_t>(volume.GetPalette()[i % 256]));
+    writer.End(rgba);
+
+    int32_t modelCount = static_cast<int32_t>(outBlocks.size());
+    size_t root = writer.Begin("nTRN");
+    writer.Int(0);
+    writer.Dict({});
+    writer.Int(1);
+    writer.Int(-1);
+    writer.Int(-1);
+    writer.Int(1);
+    writer.Dict({});
+    writer.End(root);
+
+    size_t group = writer.Begin("nGRP");
+    writer.Int(1);
+    writer.Dict({});
+    writer.Int(modelCount);
+    for (int32_t i = 0; i < modelCount; i++)
+        writer.Int(2 + 2 * i);
+    writer.End(group);
+
+    glm::ivec3 pivot(modelSize / 2, modelSize / 2, modelSize - modelSize / 2);
+    for (int32_t i = 0; i < modelCount; i++) {
+        const glm::ivec3& cell = outBlocks[i].cell;
+        glm::ivec3 centre = cell * modelSize + pivot;
+        size_t transform = writer.Begin("nTRN");
+        writer.Int(2 + 2 * i);
+        writer.Dict({{"_name", std::format("Block {} {} {}", cell.x, cell.y, cell.z)}});
+        writer.Int(3 + 2 * i);
+        writer.Int(-1);
+        writer.Int(0);
+        writer.Int(1);
+        // Back to MagicaVoxel axes
+        writer.Dict({{"_t", std::format("{} {} {}", centre.x, -centre.z, centre.y)}});
+        writer.End(transform);
+
+        size_t shape = writer.Begin("nSHP");
+        writer.Int(3 + 2 * i);
+        writer.Dict({});
+        writer.Int(1);
+        writer.Int(i);
+        writer.Dict({});
+        writer.End(shape);
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    file.write("VOX ", 4);
+    Writer header;
+    header.Int(200);
+    header.Id("MAIN");
+    header.Int(0);
+    header.Int(static_cast<int32_t>(writer.bytes.size()));
+    file.write(header.bytes.data(), header.bytes.size());
+    file.write(writer.bytes.data(), writer.bytes.size());
+    return static_cast<bool>(file);
+}
+
+void RunDataset(MicroBenchmark& benchmark, const std::string& name, const VoxelVolume& volume,
+                int modelSize) {
+    std::filesystem::path path =
+        std::filesystem::temp_directory_path() / ("voxel_bench_" + name + VoxFile::extension);
+    std::vector<Block> blocks;
+    if (!WriteVox(path, volume, modelSize, blocks)) {
+        benchmark.Fail(name + ": could not write the .vox file");
+        return;
+    }
+
+    bool ok = true;
+    VoxFile file;
+    float ms = benchmark.Run(name + " Load", blocks.size(),
+                             [&]() { ok = VoxFile::Load(path, file) && ok; });
+
+    size_t voxels = file.GetVoxelCount();
+    double megabytes = std::filesystem::file_size(path) / double(1 << 20);
+    LOG_INFO("{:<16} {} models, {:.1f}M voxels, {:.1f} MB: {:.1f}M voxels/s, {:.1f} MB/s on {} "
+             "threads",
+             name, blocks.size(), voxels / 1e6, megabytes, voxels / 1e3 / ms,
+             megabytes * 1000.0 / ms, JobSystem::GetThreadCount());
+
+    const std::vector<VoxModel>& models = file.GetModels();
+    if (!ok) {
+        benchmark.Fail(name + ": loading failed");
+    } else if (models.size() != blocks.size() || file.GetNodeCount() != 2 + 2 * blocks.size()) {
+        benchmark.Fail(name + ": the file loaded with a different scene graph");
+    } else if (!std::equal(volume.GetPalette().begin() + 1, volume.GetPalette().end(),
+                           file.GetPalette().begin() + 1)) {
+        benchmark.Fail(name + ": the palette differs after loading");
+    } else {
+        for (size_t i = 0; i < models.size(); i++) {
+            uint64_t checksum = 0;
+            for (const auto& [position, chunk] : models[i].voxels.GetChunks()) {
+                for (size_t v = 0; v < VoxelChunk::voxelCount; v++) {
+                    Voxel voxel = chunk->GetVoxels()[v];
+                    glm::ivec3 local(v & (VoxelChunk::size - 1),
+                                     (v >> VoxelChunk::shift) & (VoxelChunk::size - 1),
+                                     v >> (2 * VoxelChunk::shift));
+                    if (voxel != 0)
+                        checksum += Checksum(position * VoxelChunk::size + local, voxel);
+                }
+            }
+            if (checksum != blocks[i].checksum ||
+                models[i].voxelCount != blocks[i].voxels.size() / 4) {
+                const glm::ivec3& cell = blocks[i].cell;
+                benchmark.Fail(std::format("{}: model {} at ({}, {}, {}) differs after loading",
+                                           name, i, cell.x, cell.y, cell.z));
+                break;
+            }
+        }
+    }
+    std::filesystem::remove(path);
+}
+} // namespace
+
+void RunVoxBenchmark(MicroBenchmark& benchmark) {
+    int size = std::max(benchmark.GetOption("--size", 256), 1);
+    int large = std::max(benchmark.GetOption("--large", 2048), 1);
+    int modelSize = std::clamp(benchmark.GetOption("--model", 128), 1, VoxFile::maxModelSize);
+
+    {
+        VoxelVolume volume;
+        TestVolumes::Terrain(volume, size);
+        RunDataset(benchmark, std::format("terrain {}", size), volume, modelSize);
+    }
+    {
+        VoxelVolume volume;
+        TestVolumes::Scan(volume, large);
+        RunDataset(benchmark, std::format("scan {}", large), volume, modelSize);
+    }
+}
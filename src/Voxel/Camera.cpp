@@ -219,4 +219,13 @@ void Camera::DecreaseSpeed() {
 
 float Camera::GetZoom() { return zoom; }
 
+glm::vec3 Camera::GetPosition() const { return position; }
+
+void Camera::SetPose(const glm::vec3& newPosition, float newYaw, float newPitch) {
+    position = newPosition;
+    yaw = newYaw;
+    pitch = glm::clamp(newPitch, -89.0f, 89.0f);
+    UpdateCameraVectors();
+}
+
 glm::mat4 Camera::GetViewMatrix() { return glm::lookAt(position, position + front, up); }
\ No newline at end of file
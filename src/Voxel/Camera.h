@@ -45,6 +45,10 @@ class Camera {
     void ProcessMouseMovement(float xoffset, float yoffset);
 
     float GetZoom();
+    glm::vec3 GetPosition() const;
+
+    // Place the camera directly, used by scripted camera paths
+    void SetPose(const glm::vec3& newPosition, float newYaw, float newPitch);
 
   private:
     // calculates the front vector from the Camera's (updated) Euler Angles
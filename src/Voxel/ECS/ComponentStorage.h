@@ -1,12 +1,13 @@
 #pragma once
 #include <Voxel/pch.h>
 #include <Voxel/Core.h>
+#include <Voxel/Log/MemoryTracker.h>
 
 template <typename T> class ComponentStorage {
   public:
     template <typename... Args> T& Add(Entity e, Args&&... args) {
         auto it = Find(e);
-        if (it != components.end())
+        if (it != components.end() && it->entity == e)
             return *it;
 
         it = components.insert(it, T(e, std::forward<Args>(args)...));
@@ -15,7 +16,7 @@ template <typename T> class ComponentStorage {
 
     bool Remove(Entity e) {
         auto it = Find(e);
-        if (it == components.end())
+        if (it == components.end() || it->entity != e)
             return false;
         components.erase(it);
         return true;
@@ -23,16 +24,16 @@ template <typename T> class ComponentStorage {
 
     T* Get(Entity e) {
         auto it = Find(e);
-        return it != components.end() ? &*it : nullptr;
+        return it != components.end() && it->entity == e ? &*it : nullptr;
     }
 
     const T* Get(Entity e) const {
         auto it = Find(e);
-        return it != components.end() ? &*it : nullptr;
+        return it != components.end() && it->entity == e ? &*it : nullptr;
     }
 
-    bool Has(Entity e) const { return Find(e) != components.end(); }
-    const std::vector<T>& All() const { return components; }
+    bool Has(Entity e) const { return Get(e) != nullptr; }
+    const TrackedVector<T, MemoryTag::ECS>& All() const { return components; }
 
     T& operator[](size_t index) { return components[index]; }
     const T& operator[](size_t index) const { return components[index]; }
@@ -40,10 +41,13 @@ template <typename T> class ComponentStorage {
     size_t Size() const { return components.size(); }
 
     void Clear() { components.clear(); }
+    // Replaces every component at once, they must already be sorted by entity
+    void Assign(TrackedVector<T, MemoryTag::ECS>&& sorted) { components = std::move(sorted); }
 
   private:
-    std::vector<T> components;
+    TrackedVector<T, MemoryTag::ECS> components;
 
+    // First component at or after e, check the entity before using it
     auto Find(Entity e) {
         return std::lower_bound(components.begin(), components.end(), e,
                                 [](const T& c, Entity e) { return c.entity < e; });
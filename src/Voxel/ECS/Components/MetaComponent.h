@@ -3,6 +3,7 @@
 #include <Voxel/pch.h>
 #include <Voxel/Core.h>
 #include <Voxel/ECS/Systems/VisibilitySystem.h>
+#include <Voxel/Editing/EntityEdits.h>
 
 struct MetaComponent {
   public:
@@ -55,6 +56,7 @@ struct MetaComponent {
             ImGui::TableSetColumnIndex(1);
             if (ImGui::Checkbox("##Visible", &visibility)) {
                 VisibilitySystem::onEntityChangedVisibility.Notify({entity, visibility});
+                UndoHistory::Record(std::make_unique<VisibilityEdit>(entity, visibility));
             }
 
             ImGui::EndTable();
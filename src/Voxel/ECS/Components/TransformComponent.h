@@ -6,6 +6,8 @@
 #include <glm/gtx/quaternion.hpp>
 #include <Voxel/ECS/Components/HierarchyComponent.h>
 #include <Voxel/ECS/Systems/TransformSystem.h>
+#include <Voxel/Editing/EntityEdits.h>
+#include <Voxel/Memory/FrameArena.h>
 
 struct TransformComponent {
   public:
@@ -65,13 +67,16 @@ struct TransformComponent {
         UpdateTransform();
     }
 
-    void UpdateTransform() {
-        glm::mat4 t = glm::translate(glm::mat4(1.0f), position);
+    // Translate * rotate * scale, written out to skip the two matrix products
+    glm::mat4 ComputeLocalMatrix() const {
         glm::mat4 r = glm::toMat4(rotation);
-        glm::mat4 s = glm::scale(glm::mat4(1.0f), scale);
+        return glm::mat4(r[0] * scale.x, r[1] * scale.y, r[2] * scale.z,
+                         glm::vec4(position, 1.0f));
+    }
 
+    void UpdateTransform() {
         glm::mat4 oldMatrix = localMatrix;
-        localMatrix = t * r * s;
+        localMatrix = ComputeLocalMatrix();
         TransformSystem::onEntityChangedLocalTransform.Notify({entity, oldMatrix, localMatrix});
     }
 
@@ -84,6 +89,9 @@ struct TransformComponent {
         const float dragSpeedScale = 0.01f;
 
         bool changed = false;
+        // Sealed after recording, a typed in value changes and deactivates in the same frame
+        bool deactivated = false;
+        TransformFields before = TransformEdit::GetFields(*this);
 
         auto drawAxis = [&](const char* label, ImVec4 color, float& value, float speed) {
             ImGui::BeginGroup();
@@ -93,8 +101,10 @@ struct TransformComponent {
 
             ImGui::SameLine();
             ImGui::PushItemWidth(-1);
-            bool changed = ImGui::DragFloat(("##" + std::string(label)).c_str(), &value, speed,
-                                            0.0f, 0.0f, "%.1f", ImGuiSliderFlags_NoRoundToFormat);
+            bool changed = ImGui::DragFloat(FrameArena::Format("##{}", label), &value, speed, 0.0f,
+                                            0.0f, "%.1f", ImGuiSliderFlags_NoRoundToFormat);
+            // A drag is one undo step, the next edit starts a new one
+            deactivated |= ImGui::IsItemDeactivated();
 
             ImGui::PopItemWidth();
             ImGui::EndGroup();
@@ -132,7 +142,14 @@ struct TransformComponent {
 
         ImGui::PopID();
 
-        if (changed)
+        if (changed) {
             SetRotationEulerDegrees(eulerRotation);
+            auto edit =
+                std::make_unique<TransformEdit>(entity, before, TransformEdit::GetFields(*this));
+            if (!edit->IsEmpty())
+                UndoHistory::Record(std::move(edit));
+        }
+        if (deactivated)
+            UndoHistory::Seal();
     }
 };
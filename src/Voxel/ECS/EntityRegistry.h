@@ -82,8 +82,13 @@ class EntityRegistry {
 
     void SelectEntity(Entity entity) { selectedEntity = entity; }
     Entity GetSelectedEntity() { return selectedEntity; }
+    // Entities are numbered from 1 up to this
+    Entity GetLastEntity() const { return nextEntity; }
 
   private:
+    // Fills storages in bulk when loading
+    friend class SceneSerializer;
+
     static EntityRegistry* instance;
     Entity nextEntity = InvalidEntity;
 
@@ -4,19 +4,23 @@
 #include <Voxel/ECS/Components/MeshComponent.h>
 #include <Voxel/ECS/Components/MetaComponent.h>
 #include <Voxel/ECS/Components/TransformComponent.h>
+#include <Voxel/Rendering/GpuProfiler.h>
 #include <Voxel/Rendering/ShaderLoader.h>
+#include <Voxel/Rendering/UniformBuffer.h>
 
 void RenderSystem::Run() {
-    ScopedTimer timer(Profiler::system_render);
+    PROFILE_SCOPE("Render");
     glm::mat4 view = camera->GetViewMatrix();
     glm::mat4 projection = glm::perspective(glm::radians(camera->GetZoom()),
                                             (float)application->GetSceneViewportWidth() /
                                                 (float)application->GetSceneViewportHeight(),
                                             0.1f, 10000.0f);
 
-    application->GetActiveShader()->SetMat4("view", view);
-    application->GetActiveShader()->SetMat4("projection", projection);
+    // Camera matrices are shared by every shader through one uniform buffer per frame
+    cameraBuffer->SetData(CameraUniforms{view, projection});
+    cameraBuffer->Bind();
 
+    PROFILE_GPU_SCOPE("Scene Pass");
     for (auto& [model, batch] : batches) {
         if (batch.transforms.empty())
             continue;
@@ -26,10 +30,29 @@ void RenderSystem::Run() {
             batch.dirty = false;
         }
 
+        PROFILE_GPU_SCOPE("Draw Batch");
         rawModelRenderer.Bind(*model);
         rawModelRenderer.Render(*model, batch.transforms.size());
         rawModelRenderer.Unbind();
     }
+
+    if (!chunkModels.empty()) {
+        PROFILE_GPU_SCOPE("Chunks");
+        for (auto& [chunk, model] : chunkModels) {
+            rawModelRenderer.Bind(*model);
+            rawModelRenderer.Render(*model, 1);
+        }
+        rawModelRenderer.Unbind();
+    }
+}
+
+void RenderSystem::Shutdown() {
+    for (auto& [chunk, model] : chunkModels)
+        model->DeleteModel();
+    chunkModels.clear();
+
+    delete cameraBuffer;
+    cameraBuffer = nullptr;
 }
 
 void RenderSystem::AddEntityToBatch(Entity e) {
@@ -77,4 +100,26 @@ void RenderSystem::RemoveEntityFromBatch(Entity e) {
     batch.entities.pop_back();
     batch.slots.erase(itSlot);
     batch.dirty = true;
-}
\ No newline at end of file
+}
+void RenderSystem::SetChunkMesh(const ChunkMeshEvent& event) {
+    RemoveChunkMesh(event.chunk);
+    if (event.indices.empty())
+        return;
+
+    auto model = std::make_unique<RawModel>(
+        std::vector<Vertex>(event.vertices.begin(), event.vertices.end()),
+        std::vector<unsigned int>(event.indices.begin(), event.indices.end()));
+    glm::mat4 transform =
+        glm::translate(glm::mat4(1.0f), glm::vec3(event.chunk * VoxelChunk::size));
+    model->UpdateInstanceBuffer(std::span<const glm::mat4>(&transform, 1));
+    chunkModels.emplace(event.chunk, std::move(model));
+}
+
+void RenderSystem::RemoveChunkMesh(const glm::ivec3& chunk) {
+    auto it = chunkModels.find(chunk);
+    if (it == chunkModels.end())
+        return;
+
+    it->second->DeleteModel();
+    chunkModels.erase(it);
+}
@@ -8,21 +8,31 @@
 #include <Voxel/ECS/Components/TransformComponent.h>
 #include <Voxel/ECS/Systems/TransformSystem.h>
 #include <Voxel/ECS/Systems/VisibilitySystem.h>
+#include <Voxel/Log/MemoryTracker.h>
 #include <Voxel/Rendering/RawModelRenderer.h>
+#include <Voxel/Rendering/UniformBuffer.h>
+#include <Voxel/Volume/ChunkManager.h>
 
 struct ModelBatch {
-    std::vector<glm::mat4> transforms;
-    std::vector<Entity> entities;
-    std::unordered_map<Entity, size_t> slots;
+    TrackedVector<glm::mat4, MemoryTag::Rendering> transforms;
+    TrackedVector<Entity, MemoryTag::Rendering> entities;
+    TrackedUnorderedMap<Entity, size_t, MemoryTag::Rendering> slots;
     bool dirty = true;
 };
 
+// Matches the std140 "Camera" uniform block in the shaders
+struct CameraUniforms {
+    glm::mat4 view;
+    glm::mat4 projection;
+};
+
 class RenderSystem {
   public:
     static void Init(Application* app, Camera* cam, EntityRegistry* registry) {
         application = app;
         camera = cam;
         entityRegistry = registry;
+        cameraBuffer = new UniformBuffer(sizeof(CameraUniforms), UniformBinding::Camera);
 
         VisibilitySystem::onEntityChangedEffectiveVisibility.AddObserver(
             [](const EntityVisibilityChangedEvent& event) {
@@ -64,20 +74,32 @@ class RenderSystem {
         EntityRegistry::onClearEntities.AddObserver(
             [](const EntityClearEvent& event) { batches.clear(); });
 
+        ChunkManager::onChunkMeshChanged.AddObserver(
+            [](const ChunkMeshEvent& event) { SetChunkMesh(event); });
+        ChunkManager::onChunkUnloaded.AddObserver(
+            [](const ChunkUnloadedEvent& event) { RemoveChunkMesh(event.chunk); });
+
         LOG_INFO("Initialised RenderSystem");
     }
 
     static void Run();
+    static void Shutdown();
 
     static void AddEntityToBatch(Entity e);
     static void RemoveEntityFromBatch(Entity e);
 
+    // Streamed voxel chunks, one model each, drawn at their chunk position
+    static void SetChunkMesh(const ChunkMeshEvent& event);
+    static void RemoveChunkMesh(const glm::ivec3& chunk);
+
   private:
-    static inline std::unordered_map<RawModel*, ModelBatch> batches =
-        std::unordered_map<RawModel*, ModelBatch>();
+    static inline TrackedUnorderedMap<RawModel*, ModelBatch, MemoryTag::Rendering> batches;
+    static inline TrackedUnorderedMap<glm::ivec3, std::unique_ptr<RawModel>, MemoryTag::Rendering>
+        chunkModels;
 
     static inline Camera* camera = nullptr;
     static inline Application* application = nullptr;
     static inline EntityRegistry* entityRegistry = nullptr;
     static inline RawModelRenderer rawModelRenderer = RawModelRenderer();
+    static inline UniformBuffer* cameraBuffer = nullptr;
 };
\ No newline at end of file
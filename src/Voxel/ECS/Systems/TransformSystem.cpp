@@ -6,7 +6,7 @@
 #include <Voxel/ECS/Systems/VisibilitySystem.h>
 
 void TransformSystem::Run() {
-    ScopedTimer timer(Profiler::system_transform);
+    PROFILE_SCOPE("Transform");
 
     for (Entity entity : dirtyEntities) {
         HierarchyComponent* hierarchy = entityRegistry->GetComponent<HierarchyComponent>(entity);
@@ -23,6 +23,9 @@ void TransformSystem::Run() {
         }
     }
     dirtyEntities.clear();
+
+    onEntityChangedWorldTransform.NotifyBatch(worldTransformEvents);
+    worldTransformEvents.clear();
 }
 
 void TransformSystem::Reparent(Entity child, Entity newParent) {
@@ -96,7 +99,7 @@ void TransformSystem::UpdateRecursive(Entity entity, const glm::mat4& parentWorl
     TransformComponent* transform = entityRegistry->GetComponent<TransformComponent>(entity);
     glm::mat4 oldWorldTransform = transform->worldMatrix;
     transform->worldMatrix = parentWorld * transform->localMatrix;
-    onEntityChangedWorldTransform.Notify({entity, oldWorldTransform, transform->worldMatrix});
+    worldTransformEvents.push_back({entity, oldWorldTransform, transform->worldMatrix});
 
     if (!entityRegistry->HasComponent<HierarchyComponent>(entity))
         return;
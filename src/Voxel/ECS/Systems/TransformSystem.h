@@ -3,6 +3,7 @@
 #include <Voxel/pch.h>
 #include <Voxel/Core.h>
 #include <glm/gtx/matrix_decompose.hpp>
+#include <Voxel/Log/MemoryTracker.h>
 
 struct EntityChangedParentEvent {
     Entity entity;
@@ -41,7 +42,9 @@ class TransformSystem {
 
   private:
     static inline EntityRegistry* entityRegistry = nullptr;
-    static inline std::vector<Entity> dirtyEntities = std::vector<Entity>();
+    static inline TrackedVector<Entity, MemoryTag::ECS> dirtyEntities;
+    // World transform changes of this Run, sent as one batch at the end
+    static inline TrackedVector<EntityChangedTransformEvent, MemoryTag::ECS> worldTransformEvents;
 
     static void UpdateRecursive(Entity entity, const glm::mat4& parentWorld);
 
@@ -5,7 +5,7 @@
 #include <Voxel/ECS/Components/MetaComponent.h>
 
 void VisibilitySystem::Run() {
-    ScopedTimer timer(Profiler::system_visibility);
+    PROFILE_SCOPE("Visibility");
 
     for (Entity entity : dirtyEntities) {
         MetaComponent* meta = entityRegistry->GetComponent<MetaComponent>(entity);
@@ -22,6 +22,9 @@ void VisibilitySystem::Run() {
         UpdateVisibilityRecursive(entity, parentEffective);
     }
     dirtyEntities.clear();
+
+    onEntityChangedEffectiveVisibility.NotifyBatch(effectiveEvents);
+    effectiveEvents.clear();
 }
 
 void VisibilitySystem::UpdateVisibilityRecursive(Entity entity, bool parentVisible) {
@@ -35,7 +38,7 @@ void VisibilitySystem::UpdateVisibilityRecursive(Entity entity, bool parentVisib
     if (meta->effectiveVisibility != newEffectiveVisibility) {
         meta->effectiveVisibility = newEffectiveVisibility;
 
-        onEntityChangedEffectiveVisibility.Notify({entity, newEffectiveVisibility});
+        effectiveEvents.push_back({entity, newEffectiveVisibility});
     }
 
     for (Entity child : hierarchy->children) {
@@ -2,6 +2,7 @@
 
 #include <Voxel/pch.h>
 #include <Voxel/Core.h>
+#include <Voxel/Log/MemoryTracker.h>
 
 struct EntityVisibilityChangedEvent {
     Entity entity;
@@ -24,9 +25,12 @@ class VisibilitySystem {
     static inline Subject<EntityVisibilityChangedEvent> onEntityChangedEffectiveVisibility;
 
     static void Run();
-    static void UpdateVisibilityRecursive(Entity entity, bool parentVisible);
 
   private:
+    static void UpdateVisibilityRecursive(Entity entity, bool parentVisible);
+
     static inline EntityRegistry* entityRegistry = nullptr;
-    static inline std::vector<Entity> dirtyEntities = std::vector<Entity>();
+    static inline TrackedVector<Entity, MemoryTag::ECS> dirtyEntities;
+    // Effective visibility changes of this Run, sent as one batch at the end
+    static inline TrackedVector<EntityVisibilityChangedEvent, MemoryTag::ECS> effectiveEvents;
 };
\ No newline at end of file
@@ -0,0 +1,104 @@
+#include "EntityEdits.h"
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <Voxel/ECS/Components/HierarchyComponent.h>
+#include <Voxel/ECS/Components/MetaComponent.h>
+#include <Voxel/ECS/Components/TransformComponent.h>
+#include <Voxel/ECS/Systems/TransformSystem.h>
+#include <Voxel/ECS/Systems/VisibilitySystem.h>
+
+TransformEdit::TransformEdit(Entity entity, const TransformFields& before,
+                             const TransformFields& after)
+    : entity(entity) {
+    for (size_t i = 0; i < before.size(); i++) {
+        if (before[i] != after[i])
+            changes[changeCount++] = {static_cast<uint8_t>(i), before[i], after[i]};
+    }
+}
+
+TransformFields TransformEdit::GetFields(const TransformComponent& transform) {
+    const glm::vec3& p = transform.position;
+    const glm::quat& r = transform.rotation;
+    const glm::vec3& e = transform.eulerRotation;
+    const glm::vec3& s = transform.scale;
+    return {p.x, p.y, p.z, r.w, r.x, r.y, r.z, e.x, e.y, e.z, s.x, s.y, s.z};
+}
+
+void TransformEdit::SetFields(TransformComponent& transform, const TransformFields& fields) {
+    transform.position = glm::vec3(fields[0], fields[1], fields[2]);
+    transform.rotation = glm::quat(fields[3], fields[4], fields[5], fields[6]);
+    transform.eulerRotation = glm::vec3(fields[7], fields[8], fields[9]);
+    transform.scale = glm::vec3(fields[10], fields[11], fields[12]);
+    transform.UpdateTransform();
+}
+
+bool TransformEdit::Merge(const UndoEntry& next) {
+    const TransformEdit* edit = dynamic_cast<const TransformEdit*>(&next);
+    if (!edit || edit->entity != entity)
+        return false;
+
+    for (uint8_t i = 0; i < edit->changeCount; i++) {
+        const FieldChange& change = edit->changes[i];
+        FieldChange* existing = std::find_if(
+            changes.begin(), changes.begin() + changeCount,
+            [&](const FieldChange& other) { return other.field == change.field; });
+        if (existing != changes.begin() + changeCount)
+            existing->after = change.after;
+        else
+            changes[changeCount++] = change;
+    }
+    return true;
+}
+
+void TransformEdit::Apply(bool undo) {
+    TransformComponent* transform =
+        EntityRegistry::GetInstance()->GetComponent<TransformComponent>(entity);
+    if (!transform) {
+        LOG_WARN("Entity {} no longer has a transform to {}", entity, undo ? "undo" : "redo");
+        return;
+    }
+
+    TransformFields fields = GetFields(*transform);
+    for (uint8_t i = 0; i < changeCount; i++)
+        fields[changes[i].field] = undo ? changes[i].before : changes[i].after;
+    SetFields(*transform, fields);
+}
+
+void VisibilityEdit::Apply(bool visibility) {
+    MetaComponent* meta = EntityRegistry::GetInstance()->GetComponent<MetaComponent>(entity);
+    if (!meta) {
+        LOG_WARN("Entity {} no longer exists to change its visibility", entity);
+        return;
+    }
+
+    meta->visibility = visibility;
+    VisibilitySystem::onEntityChangedVisibility.Notify({entity, visibility});
+}
+
+void ReparentEdit::Reparent(Entity child, Entity newParent) {
+    EntityRegistry* registry = EntityRegistry::GetInstance();
+    HierarchyComponent* hierarchy = registry->GetComponent<HierarchyComponent>(child);
+    TransformComponent* transform = registry->GetComponent<TransformComponent>(child);
+    if (!hierarchy || !transform || hierarchy->parent == newParent)
+        return;
+
+    Entity oldParent = hierarchy->parent;
+    TransformFields oldFields = TransformEdit::GetFields(*transform);
+    TransformSystem::Reparent(child, newParent);
+    UndoHistory::Record(std::unique_ptr<ReparentEdit>(new ReparentEdit(
+        child, oldParent, newParent, oldFields, TransformEdit::GetFields(*transform))));
+}
+
+void ReparentEdit::Apply(Entity parent, const TransformFields& fields) {
+    EntityRegistry* registry = EntityRegistry::GetInstance();
+    TransformComponent* transform = registry->GetComponent<TransformComponent>(child);
+    bool parentExists =
+        parent == InvalidEntity || registry->HasComponent<HierarchyComponent>(parent);
+    if (!transform || !registry->HasComponent<HierarchyComponent>(child) || !parentExists) {
+        LOG_WARN("Entity {} or its parent {} no longer exists to reparent", child, parent);
+        return;
+    }
+
+    TransformSystem::Reparent(child, parent);
+    TransformEdit::SetFields(*transform, fields);
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <Voxel/Editing/UndoHistory.h>
+
+struct TransformComponent;
+
+// Position, rotation, euler rotation and scale of a TransformComponent, the fields a
+// TransformEdit compares. The matrices follow from them.
+using TransformFields = std::array<float, 13>;
+
+// Fields of one entity's TransformComponent that changed, each with its value before and after
+class TransformEdit : public UndoEntry {
+  public:
+    TransformEdit(Entity entity, const TransformFields& before, const TransformFields& after);
+
+    static TransformFields GetFields(const TransformComponent& transform);
+    // Writes the fields back and updates the matrices
+    static void SetFields(TransformComponent& transform, const TransformFields& fields);
+
+    void Undo() override { Apply(true); }
+    void Redo() override { Apply(false); }
+    const char* GetName() const override { return "Transform"; }
+    size_t GetBytes() const override { return sizeof(*this); }
+    // Edits of the same entity merge, keeping the first value before and the last value after
+    bool Merge(const UndoEntry& next) override;
+
+    bool IsEmpty() const { return changeCount == 0; }
+
+  private:
+    struct FieldChange {
+        uint8_t field;
+        float before;
+        float after;
+    };
+
+    void Apply(bool undo);
+
+    Entity entity;
+    std::array<FieldChange, std::tuple_size_v<TransformFields>> changes;
+    uint8_t changeCount = 0;
+};
+
+// The Visible checkbox of a MetaComponent
+class VisibilityEdit : public UndoEntry {
+  public:
+    VisibilityEdit(Entity entity, bool visible) : entity(entity), visible(visible) {}
+
+    void Undo() override { Apply(!visible); }
+    void Redo() override { Apply(visible); }
+    const char* GetName() const override { return visible ? "Show" : "Hide"; }
+    size_t GetBytes() const override { return sizeof(*this); }
+
+  private:
+    void Apply(bool visibility);
+
+    Entity entity;
+    // After the edit
+    bool visible;
+};
+
+// Moving an entity to another parent. Reparenting keeps the world transform by changing the
+// local one, which is put back exactly rather than worked out again from the matrices.
+class ReparentEdit : public UndoEntry {
+  public:
+    // TransformSystem::Reparent, recorded in the UndoHistory when the parent changes
+    static void Reparent(Entity child, Entity newParent);
+
+    void Undo() override { Apply(oldParent, oldFields); }
+    void Redo() override { Apply(newParent, newFields); }
+    const char* GetName() const override { return "Reparent"; }
+    size_t GetBytes() const override { return sizeof(*this); }
+
+  private:
+    ReparentEdit(Entity child, Entity oldParent, Entity newParent,
+                 const TransformFields& oldFields, const TransformFields& newFields)
+        : child(child), oldParent(oldParent), newParent(newParent), oldFields(oldFields),
+          newFields(newFields) {}
+
+    void Apply(Entity parent, const TransformFields& fields);
+
+    Entity child;
+    Entity oldParent;
+    Entity newParent;
+    TransformFields oldFields;
+    TransformFields newFields;
+};
@@ -0,0 +1,92 @@
+#include "UndoHistory.h"
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+
+void UndoHistory::Record(std::unique_ptr<UndoEntry> entry) {
+    for (const std::unique_ptr<UndoEntry>& undone : redoStack)
+        memoryUsed -= undone->GetBytes();
+    redoStack.clear();
+
+    if (!sealed && !undoStack.empty()) {
+        UndoEntry& top = *undoStack.back();
+        size_t bytes = top.GetBytes();
+        if (top.Merge(*entry)) {
+            memoryUsed += top.GetBytes() - bytes;
+            Trim();
+            return;
+        }
+    }
+
+    memoryUsed += entry->GetBytes();
+    undoStack.push_back(std::move(entry));
+    sealed = false;
+    Trim();
+}
+
+bool UndoHistory::Undo() {
+    sealed = true;
+    if (undoStack.empty())
+        return false;
+
+    std::unique_ptr<UndoEntry> entry = std::move(undoStack.back());
+    undoStack.pop_back();
+    size_t bytes = entry->GetBytes();
+    entry->Undo();
+    memoryUsed += entry->GetBytes() - bytes;
+    LOG_TRACE("Undo {}", entry->GetName());
+
+    redoStack.push_back(std::move(entry));
+    Trim();
+    return true;
+}
+
+bool UndoHistory::Redo() {
+    sealed = true;
+    if (redoStack.empty())
+        return false;
+
+    std::unique_ptr<UndoEntry> entry = std::move(redoStack.back());
+    redoStack.pop_back();
+    size_t bytes = entry->GetBytes();
+    entry->Redo();
+    memoryUsed += entry->GetBytes() - bytes;
+    LOG_TRACE("Redo {}", entry->GetName());
+
+    undoStack.push_back(std::move(entry));
+    Trim();
+    return true;
+}
+
+const char* UndoHistory::GetUndoName() {
+    return undoStack.empty() ? nullptr : undoStack.back()->GetName();
+}
+
+const char* UndoHistory::GetRedoName() {
+    return redoStack.empty() ? nullptr : redoStack.back()->GetName();
+}
+
+void UndoHistory::Clear() {
+    undoStack.clear();
+    redoStack.clear();
+    memoryUsed = 0;
+    sealed = true;
+}
+
+void UndoHistory::SetMemoryCap(size_t bytes) {
+    memoryCap = bytes;
+    Trim();
+}
+
+void UndoHistory::Trim() {
+    // Edits furthest from the present go first: the bottom of the undo stack, then the last of
+    // the redo stack
+    while (memoryUsed > memoryCap && undoStack.size() + redoStack.size() > 1) {
+        if (!undoStack.empty()) {
+            memoryUsed -= undoStack.front()->GetBytes();
+            undoStack.pop_front();
+        } else {
+            memoryUsed -= redoStack.front()->GetBytes();
+            redoStack.erase(redoStack.begin());
+        }
+    }
+}
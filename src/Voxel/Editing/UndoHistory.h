@@ -0,0 +1,57 @@
+#pragma once
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+
+// One reversible edit. Entries keep what changed, not copies of everything they touched.
+class UndoEntry {
+  public:
+    virtual ~UndoEntry() = default;
+
+    virtual void Undo() = 0;
+    virtual void Redo() = 0;
+    // For the Edit menu, "Move", "Hide" and so on
+    virtual const char* GetName() const = 0;
+    // Bytes held by the entry, counted against the history's memory cap. Can change after an
+    // Undo or Redo.
+    virtual size_t GetBytes() const = 0;
+    // Folds the next edit into this one when both change the same thing, so a drag that edits
+    // every frame ends up as a single entry
+    virtual bool Merge(const UndoEntry& next) { return false; }
+};
+
+// Undo and redo stacks for the editor. Recording drops everything that was undone, and the
+// oldest entries are dropped once the entries hold more than the memory cap.
+//
+// Record merges into the newest entry until Seal is called, UI code seals when a widget is let
+// go of. Undo and Redo seal too.
+class UndoHistory {
+  public:
+    static void Record(std::unique_ptr<UndoEntry> entry);
+    static void Seal() { sealed = true; }
+
+    static bool Undo();
+    static bool Redo();
+    static bool CanUndo() { return !undoStack.empty(); }
+    static bool CanRedo() { return !redoStack.empty(); }
+    // Nullptr when there is nothing to undo or redo
+    static const char* GetUndoName();
+    static const char* GetRedoName();
+
+    static void Clear();
+
+    static void SetMemoryCap(size_t bytes);
+    static size_t GetMemoryCap() { return memoryCap; }
+    static size_t GetMemoryUsed() { return memoryUsed; }
+    static size_t GetUndoCount() { return undoStack.size(); }
+    static size_t GetRedoCount() { return redoStack.size(); }
+
+  private:
+    // Drops the oldest entries until the history fits the cap again, keeping the newest one
+    static void Trim();
+
+    static inline std::deque<std::unique_ptr<UndoEntry>> undoStack;
+    static inline std::vector<std::unique_ptr<UndoEntry>> redoStack;
+    static inline bool sealed = true;
+    static inline size_t memoryCap = size_t(256) << 20;
+    static inline size_t memoryUsed = 0;
+};
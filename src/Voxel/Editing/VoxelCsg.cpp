@@ -0,0 +1,286 @@
+#include "VoxelCsg.h"
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <cstring>
+#include <Voxel/Volume/VoxelMask.h>
+
+namespace {
+constexpr int size = VoxelChunk::size;
+constexpr int rowCount = VoxelMask::rowCount;
+using Operation = VoxelCsg::Operation;
+using ChunkVoxels = std::array<Voxel, VoxelChunk::voxelCount>;
+
+// The other volume's voxels over one chunk of the target
+struct Source {
+    // Every voxel is value, 0 when there are none
+    bool uniform = false;
+    Voxel value = 0;
+    // The other volume's chunk when chunks line up, which can be shared rather than copied
+    ChunkHandle aligned;
+    // Laid out as a chunk, unless uniform
+    const Voxel* voxels = nullptr;
+};
+
+// The voxels of other from origin, in its coordinates, to origin + size - 1. Chunks that don't
+// line up are copied a row at a time into scratch.
+Source Gather(const VoxelVolume& other, const glm::ivec3& origin, ChunkVoxels& scratch) {
+    Source source;
+    glm::ivec3 first = VoxelVolume::ToChunk(origin);
+    glm::ivec3 local = VoxelVolume::ToLocal(origin);
+    if (local.x == 0 && local.y == 0 && local.z == 0) {
+        source.aligned = other.GetChunkHandle(first);
+        if (!source.aligned) {
+            source.uniform = true;
+            return source;
+        }
+        source.uniform = source.aligned->IsUniform(source.value);
+        source.voxels = source.aligned->GetVoxels().data();
+        return source;
+    }
+
+    // Two chunks along each axis the origin is off by
+    const VoxelChunk* chunks[2][2][2] = {};
+    source.uniform = true;
+    bool firstChunk = true;
+    for (int z = 0; z <= (local.z != 0); z++) {
+        for (int y = 0; y <= (local.y != 0); y++) {
+            for (int x = 0; x <= (local.x != 0); x++) {
+                const VoxelChunk* chunk = other.GetChunk(first + glm::ivec3(x, y, z));
+                chunks[z][y][x] = chunk;
+                Voxel value = 0;
+                if (chunk && !chunk->IsUniform(value))
+                    source.uniform = false;
+                if (!firstChunk && value != source.value)
+                    source.uniform = false;
+                source.value = value;
+                firstChunk = false;
+            }
+        }
+    }
+    if (source.uniform)
+        return source;
+
+    int head = size - local.x;
+    for (int z = 0; z < size; z++) {
+        for (int y = 0; y < size; y++) {
+            int sy = local.y + y;
+            int sz = local.z + z;
+            Voxel* out = scratch.data() + ((y + z * size) << VoxelChunk::shift);
+            size_t start = VoxelChunk::Index(0, sy & (size - 1), sz & (size - 1));
+            const VoxelChunk* near = chunks[sz / size][sy / size][0];
+            const VoxelChunk* far = chunks[sz / size][sy / size][1];
+            if (near)
+                std::memcpy(out, near->GetVoxels().data() + start + local.x, head);
+            else
+                std::memset(out, 0, head);
+            if (local.x == 0)
+                continue;
+            if (far)
+                std::memcpy(out + head, far->GetVoxels().data() + start, local.x);
+            else
+                std::memset(out + head, 0, local.x);
+        }
+    }
+    // The parts in view can still be empty, or all one colour
+    source.value = scratch[0];
+    source.uniform = std::all_of(scratch.begin(), scratch.end(),
+                                 [&](Voxel voxel) { return voxel == source.value; });
+    if (!source.uniform)
+        source.voxels = scratch.data();
+    return source;
+}
+
+// Voxels of a row the operation may change, from the occupancy of both volumes
+uint32_t Changes(uint32_t a, uint32_t b, Operation operation) {
+    switch (operation) {
+    case Operation::Union:
+        return b;
+    case Operation::Subtract:
+        return a & b;
+    case Operation::Intersect:
+        return a & ~b;
+    default:
+        return b;
+    }
+}
+
+// Occupancy of a row of the result
+uint32_t Occupied(uint32_t a, uint32_t b, Operation operation) {
+    switch (operation) {
+    case Operation::Union:
+        return a | b;
+    case Operation::Subtract:
+        return a & ~b;
+    case Operation::Intersect:
+        return a & b;
+    default:
+        return a ^ b;
+    }
+}
+
+// A row of the result, branch free selects the compiler vectorises
+void CombineRow(const Voxel* a, const Voxel* b, Voxel* out, Operation operation) {
+    switch (operation) {
+    case Operation::Union:
+        for (int x = 0; x < size; x++)
+            out[x] = b[x] != 0 ? b[x] : a[x];
+        break;
+    case Operation::Subtract:
+        for (int x = 0; x < size; x++)
+            out[x] = b[x] != 0 ? 0 : a[x];
+        break;
+    case Operation::Intersect:
+        for (int x = 0; x < size; x++)
+            out[x] = b[x] != 0 ? a[x] : 0;
+        break;
+    case Operation::Xor:
+        for (int x = 0; x < size; x++)
+            out[x] = a[x] == 0 ? b[x] : (b[x] != 0 ? 0 : a[x]);
+        break;
+    }
+}
+} // namespace
+
+size_t VoxelCsg::Apply(VoxelVolume& target, const VoxelVolume& other, const glm::ivec3& offset,
+                       Operation operation, VoxelEditRecorder* recorder) {
+    // Reading chunks while writing them would see the operation's own results
+    if (&target == &other)
+        return Apply(target, other.Snapshot(), offset, operation, recorder);
+
+    // The chunks other overlaps, where an intersection also clears those it doesn't
+    std::vector<glm::ivec3> visit;
+    if (operation == Operation::Intersect) {
+        visit.reserve(target.GetChunkCount());
+        for (const auto& [chunk, voxels] : target.GetChunks())
+            visit.push_back(chunk);
+    } else {
+        VoxelVolume::ChunkSet overlapped;
+        for (const auto& [chunk, voxels] : other.GetChunks()) {
+            glm::ivec3 min = chunk * size + offset;
+            glm::ivec3 first = VoxelVolume::ToChunk(min);
+            glm::ivec3 last = VoxelVolume::ToChunk(min + (size - 1));
+            for (int z = first.z; z <= last.z; z++) {
+                for (int y = first.y; y <= last.y; y++) {
+                    for (int x = first.x; x <= last.x; x++)
+                        overlapped.insert({x, y, z});
+                }
+            }
+        }
+        visit.assign(overlapped.begin(), overlapped.end());
+    }
+
+    auto exchange = [&](const glm::ivec3& chunk, ChunkHandle voxels) {
+        if (recorder)
+            recorder->Replace(chunk, std::move(voxels));
+        else
+            target.ExchangeChunk(chunk, std::move(voxels));
+    };
+    // One filled chunk per colour, shared by every chunk the operation fills with it
+    std::array<ChunkHandle, 256> filled;
+    auto fill = [&](Voxel voxel) {
+        if (!filled[voxel]) {
+            filled[voxel] = ChunkHandle::Make();
+            filled[voxel].Write().Fill(voxel);
+        }
+        return filled[voxel];
+    };
+
+    auto gathered = std::make_unique<ChunkVoxels>();
+    auto result = std::make_unique<ChunkVoxels>();
+    VoxelMask::ChunkBits aBits;
+    VoxelMask::ChunkBits bBits;
+    VoxelMask::ChunkBits changes;
+    Voxel uniformRow[size];
+    size_t changed = 0;
+    for (const glm::ivec3& chunk : visit) {
+        const VoxelChunk* a = target.GetChunk(chunk);
+        if (!a && (operation == Operation::Subtract || operation == Operation::Intersect))
+            continue;
+        Source b = Gather(other, chunk * size - offset, *gathered);
+        Voxel aValue = 0;
+        bool aUniform = !a || a->IsUniform(aValue);
+
+        // Settled without reading voxels when either side is missing or the other is uniform
+        if (b.uniform && b.value == 0) {
+            // Nothing there, only an intersection changes anything
+            if (operation != Operation::Intersect || (aUniform && aValue == 0))
+                continue;
+            exchange(chunk, ChunkHandle());
+        } else if (!a) {
+            // The other volume's voxels as they are, for a union or xor
+            if (b.aligned)
+                exchange(chunk, b.aligned);
+            else if (b.uniform)
+                exchange(chunk, fill(b.value));
+            else {
+                ChunkHandle copy = ChunkHandle::Make();
+                std::memcpy(copy.Write().GetVoxels().data(), b.voxels, VoxelChunk::voxelCount);
+                exchange(chunk, std::move(copy));
+            }
+        } else if (b.uniform && operation != Operation::Xor) {
+            // Solid throughout: a union becomes it, a subtraction empty and an intersection is
+            // left as it was
+            if (operation == Operation::Intersect ||
+                (operation == Operation::Union && aUniform && aValue == b.value))
+                continue;
+            exchange(chunk, operation == Operation::Union ? fill(b.value) : ChunkHandle());
+        } else if (b.uniform && aUniform) {
+            // An xor of two uniform chunks is one or the other
+            exchange(chunk, aValue != 0 ? ChunkHandle() : fill(b.value));
+        } else {
+            VoxelMask::Occupancy(a->GetVoxels(), aBits);
+            if (b.uniform) {
+                bBits.fill(~0u);
+                std::memset(uniformRow, b.value, size);
+            } else {
+                VoxelMask::Occupancy(std::span<const Voxel, VoxelChunk::voxelCount>(
+                                         b.voxels, VoxelChunk::voxelCount),
+                                     bBits);
+            }
+
+            // Word at a time over both occupancies, skipping the chunk when nothing can change
+            uint32_t anyChange = 0;
+            uint32_t anyOccupied = 0;
+            for (int row = 0; row < rowCount; row++) {
+                changes[row] = Changes(aBits[row], bBits[row], operation);
+                anyChange |= changes[row];
+                anyOccupied |= Occupied(aBits[row], bBits[row], operation);
+            }
+            if (anyChange == 0)
+                continue;
+
+            if (anyOccupied == 0) {
+                exchange(chunk, ChunkHandle());
+            } else {
+                // Rows worked out aside, the chunk is only copied when one of them differs
+                const Voxel* aVoxels = a->GetVoxels().data();
+                bool differs = false;
+                for (int row = 0; row < rowCount; row++) {
+                    if (changes[row] == 0)
+                        continue;
+                    size_t start = size_t(row) << VoxelChunk::shift;
+                    const Voxel* bRow = b.uniform ? uniformRow : b.voxels + start;
+                    CombineRow(aVoxels + start, bRow, result->data() + start, operation);
+                    if (std::memcmp(result->data() + start, aVoxels + start, size) == 0)
+                        changes[row] = 0;
+                    else
+                        differs = true;
+                }
+                if (!differs)
+                    continue;
+
+                if (recorder)
+                    recorder->Touch(chunk);
+                Voxel* voxels = target.WriteChunk(chunk)->GetVoxels().data();
+                for (int row = 0; row < rowCount; row++) {
+                    size_t start = size_t(row) << VoxelChunk::shift;
+                    if (changes[row] != 0)
+                        std::memcpy(voxels + start, result->data() + start, size);
+                }
+            }
+        }
+        target.MarkDirty(chunk);
+        changed++;
+    }
+    return changed;
+}
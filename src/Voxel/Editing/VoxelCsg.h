@@ -0,0 +1,30 @@
+#pragma once
+#include <Voxel/pch.h>
+#include <Voxel/Editing/VoxelEdit.h>
+#include <Voxel/Volume/VoxelVolume.h>
+
+// Boolean operations between two volumes, written into the first. Only the chunks the other
+// volume can change are visited. A chunk is settled from the other volume's chunks alone when
+// they are missing or uniform, otherwise from the occupancy words of both, and only rows whose
+// voxels change are written.
+//
+// Voxels are palette indices and are copied as they are, so the volumes should share a palette.
+// As with VoxelTools, a recorder makes the operation undoable, and the number of chunks changed
+// is returned, which are marked dirty.
+class VoxelCsg {
+  public:
+    enum class Operation {
+        // The other volume's voxels wherever it has any, the target's elsewhere
+        Union,
+        // The target's voxels where the other volume is empty
+        Subtract,
+        // The target's voxels where the other volume has voxels too
+        Intersect,
+        // Voxels where exactly one of the volumes has one
+        Xor,
+    };
+
+    // Applies the operation between target and other, moved by offset voxels
+    static size_t Apply(VoxelVolume& target, const VoxelVolume& other, const glm::ivec3& offset,
+                        Operation operation, VoxelEditRecorder* recorder = nullptr);
+};
@@ -0,0 +1,132 @@
+#include "VoxelEdit.h"
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <cstring>
+
+namespace {
+uint64_t LoadWord(const Voxel* voxels) {
+    uint64_t word;
+    std::memcpy(&word, voxels, sizeof(word));
+    return word;
+}
+} // namespace
+
+VoxelEdit::VoxelEdit(VoxelVolume& volume, const char* name, std::vector<ChunkChange> changes)
+    : volume(&volume), name(name), changes(std::move(changes)) {
+    CountBytes();
+}
+
+bool VoxelEdit::EncodeXor(const VoxelChunk& a, const VoxelChunk& b, size_t maxBytes,
+                          TrackedVector<uint8_t, MemoryTag::Undo>& outRuns) {
+    const Voxel* x = a.GetVoxels().data();
+    const Voxel* y = b.GetVoxels().data();
+    constexpr size_t count = VoxelChunk::voxelCount;
+
+    outRuns.clear();
+    for (size_t i = 0; i < count;) {
+        uint8_t value = x[i] ^ y[i];
+        size_t end = i + 1;
+        // Unchanged voxels are most of a small edit, skip them a word at a time
+        if (value == 0) {
+            while (end + 8 <= count && LoadWord(x + end) == LoadWord(y + end))
+                end += 8;
+        }
+        while (end < count && (x[end] ^ y[end]) == value)
+            end++;
+
+        if (outRuns.size() + 3 > maxBytes)
+            return false;
+        size_t length = end - i;
+        outRuns.insert(outRuns.end(), {static_cast<uint8_t>(length & 0xFF),
+                                       static_cast<uint8_t>(length >> 8), value});
+        i = end;
+    }
+    return true;
+}
+
+void VoxelEdit::ApplyXor(VoxelChunk& chunk, std::span<const uint8_t> runs) {
+    Voxel* voxels = chunk.GetVoxels().data();
+    size_t i = 0;
+    for (size_t r = 0; r + 3 <= runs.size(); r += 3) {
+        size_t length = runs[r] | size_t(runs[r + 1]) << 8;
+        uint8_t value = runs[r + 2];
+        if (value != 0) {
+            for (size_t v = i; v < i + length; v++)
+                voxels[v] ^= value;
+        }
+        i += length;
+    }
+}
+
+size_t VoxelEdit::GetSwapCount() const {
+    return std::count_if(changes.begin(), changes.end(),
+                         [](const ChunkChange& change) { return change.runs.empty(); });
+}
+
+void VoxelEdit::Apply() {
+    for (ChunkChange& change : changes) {
+        if (change.runs.empty())
+            change.swap = volume->ExchangeChunk(change.chunk, std::move(change.swap));
+        else
+            ApplyXor(volume->GetOrCreateChunk(change.chunk), change.runs);
+        volume->MarkDirty(change.chunk);
+    }
+    CountBytes();
+}
+
+void VoxelEdit::CountBytes() {
+    bytes = sizeof(*this) + changes.capacity() * sizeof(ChunkChange);
+    for (const ChunkChange& change : changes)
+        bytes += change.swap ? sizeof(VoxelChunk) : change.runs.capacity();
+}
+
+void VoxelEditRecorder::Touch(const glm::ivec3& chunk) {
+    if (!before.contains(chunk))
+        before.emplace(chunk, volume.GetChunkHandle(chunk));
+}
+
+void VoxelEditRecorder::TouchAll() {
+    before.reserve(before.size() + volume.GetChunkCount());
+    for (const auto& [chunk, voxels] : volume.GetChunks())
+        before.try_emplace(chunk, voxels);
+}
+
+void VoxelEditRecorder::Replace(const glm::ivec3& chunk, ChunkHandle voxels) {
+    ChunkHandle previous = volume.ExchangeChunk(chunk, std::move(voxels));
+    // A chunk touched earlier already has its state from before the edit
+    before.try_emplace(chunk, std::move(previous));
+    replaced.insert(chunk);
+}
+
+size_t VoxelEditRecorder::Commit() {
+    std::vector<VoxelEdit::ChunkChange> changes;
+    changes.reserve(before.size());
+    for (auto& [chunk, previous] : before) {
+        // Untouched chunks are still the very same chunk
+        const VoxelChunk* current = volume.GetChunk(chunk);
+        if (current == previous.Get())
+            continue;
+        if (previous && current && *previous == *current)
+            continue;
+
+        VoxelEdit::ChunkChange& change = changes.emplace_back();
+        change.chunk = chunk;
+        // A chunk that was created or removed always swaps, so undo takes it out or back in
+        bool diff = previous && current && !replaced.contains(chunk) &&
+                    VoxelEdit::EncodeXor(*previous, *current, VoxelEdit::maxDiffBytes,
+                                         change.runs);
+        if (!diff) {
+            change.runs.clear();
+            change.swap = std::move(previous);
+        }
+        change.runs.shrink_to_fit();
+        volume.MarkDirty(chunk);
+    }
+    before.clear();
+    replaced.clear();
+
+    size_t changed = changes.size();
+    if (changed > 0)
+        UndoHistory::Record(std::make_unique<VoxelEdit>(volume, name, std::move(changes)));
+    return changed;
+}
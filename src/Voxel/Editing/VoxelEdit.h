@@ -0,0 +1,86 @@
+#pragma once
+#include <Voxel/pch.h>
+#include <Voxel/Editing/UndoHistory.h>
+#include <Voxel/Log/MemoryTracker.h>
+#include <Voxel/Volume/VoxelVolume.h>
+
+// Voxels an edit changed in a VoxelVolume, chunk by chunk. A chunk with few changes keeps the XOR
+// of its voxels before and after as (count, value) runs, and applying it again undoes or redoes
+// it. A chunk that mostly changed, was created or was removed keeps a handle to the other version
+// of itself and undo swaps it in, so undoing a large fill moves pointers rather than voxels.
+//
+// The volume has to outlive the entry, clear the UndoHistory before destroying an edited volume.
+class VoxelEdit : public UndoEntry {
+  public:
+    // Runs of more than this many bytes keep the whole chunk instead
+    static constexpr size_t maxDiffBytes = VoxelChunk::voxelCount / 8;
+
+    struct ChunkChange {
+        glm::ivec3 chunk{0};
+        // The version of the chunk that isn't in the volume, empty when it doesn't exist. Only
+        // used when runs is empty.
+        ChunkHandle swap;
+        // Little endian uint16 count then the XOR value, per run
+        TrackedVector<uint8_t, MemoryTag::Undo> runs;
+    };
+
+    VoxelEdit(VoxelVolume& volume, const char* name, std::vector<ChunkChange> changes);
+
+    // Runs for the XOR of two chunks, false once they would take more than maxBytes
+    static bool EncodeXor(const VoxelChunk& a, const VoxelChunk& b, size_t maxBytes,
+                          TrackedVector<uint8_t, MemoryTag::Undo>& outRuns);
+    static void ApplyXor(VoxelChunk& chunk, std::span<const uint8_t> runs);
+
+    void Undo() override { Apply(); }
+    void Redo() override { Apply(); }
+    const char* GetName() const override { return name; }
+    size_t GetBytes() const override { return bytes; }
+
+    size_t GetChunkCount() const { return changes.size(); }
+    // Chunks kept whole rather than as runs
+    size_t GetSwapCount() const;
+
+  private:
+    // Undo and redo are the same, both flip the volume to the other version of each chunk
+    void Apply();
+    void CountBytes();
+
+    VoxelVolume* volume;
+    const char* name;
+    std::vector<ChunkChange> changes;
+    size_t bytes = 0;
+};
+
+// Keeps handles to the chunks an edit is about to write, then records what changed as a
+// VoxelEdit. The edit's first write to each of them copies it, as for a snapshot:
+//
+//   VoxelEditRecorder recorder(volume, "Fill");
+//   recorder.Touch(chunk);
+//   ... write to the chunk ...
+//   recorder.Commit();
+class VoxelEditRecorder {
+  public:
+    VoxelEditRecorder(VoxelVolume& volume, const char* name) : volume(volume), name(name) {}
+
+    // Keeps the chunk as it is before the edit writes to it, once per chunk
+    void Touch(const glm::ivec3& chunk);
+    // Touch for every chunk of the volume, a checkpoint for edits that can't tell which chunks
+    // they will write. Chunks left alone are skipped by Commit without comparing voxels.
+    void TouchAll();
+    // For edits that rewrite a whole chunk: puts voxels in its place and keeps the old chunk.
+    // An empty handle removes the chunk.
+    void Replace(const glm::ivec3& chunk, ChunkHandle voxels);
+
+    // Records the edit in the UndoHistory and marks the changed chunks dirty. Chunks that ended up
+    // as they were are left out, and nothing is recorded when nothing changed. Returns the number
+    // of changed chunks.
+    size_t Commit();
+
+  private:
+    VoxelVolume& volume;
+    const char* name;
+    // As they were before the edit, empty for chunks that didn't exist
+    VoxelVolume::ChunkMap before;
+    // Chunks given to Replace, which are kept whole however little changed
+    VoxelVolume::ChunkSet replaced;
+};
@@ -0,0 +1,619 @@
+#include "VoxelRegions.h"
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <numeric>
+#include <tuple>
+#include <Voxel/Editing/VoxelTools.h>
+#include <Voxel/Jobs/JobSystem.h>
+
+namespace {
+constexpr int size = VoxelChunk::size;
+constexpr int rowCount = VoxelMask::rowCount;
+using Run = VoxelLabels::Run;
+using ChunkRuns = VoxelLabels::ChunkRuns;
+
+// Class of each voxel value. Voxels connect only to those of the same class, and those of class
+// excluded aren't labelled.
+constexpr uint16_t excluded = UINT16_MAX;
+using Classes = std::array<uint16_t, 256>;
+
+Classes MatchClasses(VoxelRegions::Match match) {
+    Classes classes;
+    for (int voxel = 0; voxel < 256; voxel++) {
+        switch (match) {
+        case VoxelRegions::Match::Solid:
+            classes[voxel] = voxel != 0 ? 0 : excluded;
+            break;
+        case VoxelRegions::Match::Colour:
+            classes[voxel] = voxel != 0 ? static_cast<uint16_t>(voxel) : excluded;
+            break;
+        case VoxelRegions::Match::Empty:
+            classes[voxel] = voxel == 0 ? 0 : excluded;
+            break;
+        }
+    }
+    return classes;
+}
+
+uint32_t Find(std::vector<uint32_t>& parent, uint32_t i) {
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+// Roots always point at the smaller index, so a set's root comes before the rest of it
+void Unite(std::vector<uint32_t>& parent, uint32_t a, uint32_t b) {
+    a = Find(parent, a);
+    b = Find(parent, b);
+    if (a != b)
+        parent[std::max(a, b)] = std::min(a, b);
+}
+
+// Calls unite(i, j) for each pair of runs of the same class that overlap along x, one from each
+// of two rows
+template <typename Unite>
+void ConnectRows(const std::vector<Run>& a, size_t i, size_t aEnd, const std::vector<Run>& b,
+                 size_t j, size_t bEnd, Unite unite) {
+    while (i < aEnd && j < bEnd) {
+        if (a[i].last < b[j].first) {
+            i++;
+        } else if (b[j].last < a[i].first) {
+            j++;
+        } else {
+            if (a[i].key == b[j].key)
+                unite(i, j);
+            if (a[i].last < b[j].last)
+                i++;
+            else
+                j++;
+        }
+    }
+}
+
+// Part of the box from min to max within a chunk, in its local coordinates
+void LocalBox(const glm::ivec3& chunk, const glm::ivec3& min, const glm::ivec3& max,
+              glm::ivec3& outMin, glm::ivec3& outMax) {
+    glm::ivec3 origin = chunk * size;
+    outMin = glm::clamp(min - origin, glm::ivec3(0), glm::ivec3(size - 1));
+    outMax = glm::clamp(max - origin, glm::ivec3(0), glm::ivec3(size - 1));
+}
+
+// Runs of the voxels of a chunk within the local box from min to max, labelled with components
+// numbered from 0. A missing chunk is empty. Returns the number of components.
+uint32_t LabelChunk(const VoxelChunk* chunk, const Classes& classes, const glm::ivec3& min,
+                    const glm::ivec3& max, ChunkRuns& out) {
+    thread_local std::vector<uint32_t> parent;
+    std::vector<Run>& runs = out.runs;
+    runs.clear();
+    parent.clear();
+
+    Voxel uniform = 0;
+    bool isUniform = !chunk || chunk->IsUniform(uniform);
+    if (isUniform) {
+        // A row across the box for each row in it, which are all connected
+        for (int row = 0; row < rowCount; row++) {
+            out.rowStart[row] = static_cast<uint32_t>(runs.size());
+            int y = row % size;
+            int z = row / size;
+            if (classes[uniform] != excluded && y >= min.y && y <= max.y && z >= min.z &&
+                z <= max.z)
+                runs.push_back({0, uint16_t(row), uint8_t(min.x), uint8_t(max.x),
+                                classes[uniform]});
+        }
+        out.rowStart[rowCount] = static_cast<uint32_t>(runs.size());
+        return runs.empty() ? 0 : 1;
+    }
+
+    for (int z = 0; z < size; z++) {
+        for (int y = 0; y < size; y++) {
+            int row = y + z * size;
+            size_t start = runs.size();
+            out.rowStart[row] = static_cast<uint32_t>(start);
+            if (y < min.y || y > max.y || z < min.z || z > max.z)
+                continue;
+
+            const Voxel* voxels = chunk->GetVoxels().data() + (row << VoxelChunk::shift);
+            for (int x = min.x; x <= max.x;) {
+                uint16_t key = classes[voxels[x]];
+                int first = x;
+                while (x <= max.x && classes[voxels[x]] == key)
+                    x++;
+                if (key != excluded)
+                    runs.push_back({0, uint16_t(row), uint8_t(first), uint8_t(x - 1), key});
+            }
+
+            size_t end = runs.size();
+            for (size_t i = start; i < end; i++)
+                parent.push_back(static_cast<uint32_t>(i));
+            auto unite = [&](size_t i, size_t j) {
+                Unite(parent, static_cast<uint32_t>(i), static_cast<uint32_t>(j));
+            };
+            // The row before along y, then along z
+            if (y > min.y)
+                ConnectRows(runs, out.rowStart[row - 1], start, runs, start, end, unite);
+            if (z > min.z)
+                ConnectRows(runs, out.rowStart[row - size], out.rowStart[row - size + 1], runs,
+                            start, end, unite);
+        }
+    }
+    out.rowStart[rowCount] = static_cast<uint32_t>(runs.size());
+
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < runs.size(); i++) {
+        uint32_t root = Find(parent, i);
+        runs[i].component = root == i ? count++ : runs[root].component;
+    }
+    return count;
+}
+
+// Calls unite(x, y) with a run x of chunk a and y of chunk b for each pair that share a face, b
+// being the next chunk along axis
+template <typename Unite>
+void ConnectChunks(const ChunkRuns& a, const ChunkRuns& b, int axis, Unite unite) {
+    if (axis == 0) {
+        // The last run of each row in a against the first in b
+        for (int row = 0; row < rowCount; row++) {
+            uint32_t aEnd = a.rowStart[row + 1];
+            uint32_t bStart = b.rowStart[row];
+            if (aEnd == a.rowStart[row] || bStart == b.rowStart[row + 1])
+                continue;
+            const Run& x = a.runs[aEnd - 1];
+            const Run& y = b.runs[bStart];
+            if (x.last == size - 1 && y.first == 0 && x.key == y.key)
+                unite(x, y);
+        }
+        return;
+    }
+
+    // Rows along the face of a at the far end of the axis against those of b at the near end
+    int stride = axis == 1 ? size : 1;
+    int offset = axis == 1 ? size - 1 : (size - 1) * size;
+    for (int i = 0; i < size; i++) {
+        int aRow = i * stride + offset;
+        int bRow = i * stride;
+        ConnectRows(a.runs, a.rowStart[aRow], a.rowStart[aRow + 1], b.runs, b.rowStart[bRow],
+                    b.rowStart[bRow + 1],
+                    [&](size_t x, size_t y) { unite(a.runs[x], b.runs[y]); });
+    }
+}
+
+// Calls touch(run) for each run of a chunk on its face at side, -x, +x, -y, +y, -z then +z
+template <typename Touch>
+void FaceRuns(const ChunkRuns& chunk, int side, Touch touch) {
+    if (side < 2) {
+        // The first run of each row starting at the face, or the last ending at it
+        for (int row = 0; row < rowCount; row++) {
+            uint32_t start = chunk.rowStart[row];
+            uint32_t end = chunk.rowStart[row + 1];
+            if (start == end)
+                continue;
+            const Run& run = chunk.runs[side == 0 ? start : end - 1];
+            if (side == 0 ? run.first == 0 : run.last == size - 1)
+                touch(run);
+        }
+        return;
+    }
+
+    int stride = side < 4 ? size : 1;
+    int offset = (side & 1) == 0 ? 0 : (side < 4 ? size - 1 : (size - 1) * size);
+    for (int i = 0; i < size; i++) {
+        int row = i * stride + offset;
+        for (uint32_t j = chunk.rowStart[row]; j < chunk.rowStart[row + 1]; j++)
+            touch(chunk.runs[j]);
+    }
+}
+
+// Writes the masks of the chunks holding runs for which chosen(chunk, run) is true
+template <typename Chosen>
+VoxelMask MaskRuns(const std::vector<ChunkRuns>& chunks, Chosen chosen) {
+    std::vector<uint8_t> any(chunks.size());
+    JobSystem::ParallelFor(chunks.size(), [&](size_t i) {
+        for (const Run& run : chunks[i].runs) {
+            if (chosen(i, run)) {
+                any[i] = true;
+                break;
+            }
+        }
+    });
+
+    // Created up front, workers only write to their own chunk's bits
+    VoxelMask mask;
+    std::vector<VoxelMask::ChunkBits*> bits(chunks.size());
+    for (size_t i = 0; i < chunks.size(); i++) {
+        if (any[i])
+            bits[i] = &mask.GetOrCreateChunk(chunks[i].chunk);
+    }
+    JobSystem::ParallelFor(chunks.size(), [&](size_t i) {
+        if (!bits[i])
+            return;
+        for (const Run& run : chunks[i].runs) {
+            if (chosen(i, run))
+                (*bits[i])[run.row] |= VoxelMask::RowBits(run.first, run.last);
+        }
+    });
+    return mask;
+}
+} // namespace
+
+uint32_t VoxelLabels::GetComponent(const glm::ivec3& position) const {
+    glm::ivec3 chunkPosition = VoxelVolume::ToChunk(position);
+    auto it = chunkIndices.find(chunkPosition);
+    if (it == chunkIndices.end()) {
+        const EmptyRun* run = FindEmptyRun(chunkPosition);
+        bool inBox = glm::all(glm::greaterThanEqual(position, min)) &&
+                     glm::all(glm::lessThanEqual(position, max));
+        return run && inBox ? run->component : none;
+    }
+
+    const ChunkRuns& chunk = chunks[it->second];
+    glm::ivec3 local = VoxelVolume::ToLocal(position);
+    int row = local.y + local.z * size;
+    for (uint32_t i = chunk.rowStart[row]; i < chunk.rowStart[row + 1]; i++) {
+        const Run& run = chunk.runs[i];
+        if (local.x >= run.first && local.x <= run.last)
+            return run.component;
+    }
+    return none;
+}
+
+VoxelMask VoxelLabels::Select(std::span<const uint32_t> components) const {
+    std::vector<bool> chosen(GetComponentCount());
+    for (uint32_t component : components)
+        chosen[component] = true;
+    return SelectChosen(chosen);
+}
+
+VoxelMask VoxelLabels::SelectEnclosed() const {
+    std::vector<bool> chosen(GetComponentCount());
+    for (size_t component = 0; component < chosen.size(); component++)
+        chosen[component] = !onEdge[component];
+    return SelectChosen(chosen);
+}
+
+VoxelMask VoxelLabels::SelectChosen(const std::vector<bool>& chosen) const {
+    VoxelMask mask =
+        MaskRuns(chunks, [&](size_t, const Run& run) { return chosen[run.component]; });
+
+    // Chunks that don't exist, as much of each as is within the box
+    VoxelMask::ChunkBits bits;
+    for (const EmptyRun& run : emptyRuns) {
+        if (!chosen[run.component])
+            continue;
+        for (glm::ivec3 chunk = run.chunk; chunk.x <= run.last; chunk.x++) {
+            glm::ivec3 localMin, localMax;
+            LocalBox(chunk, min, max, localMin, localMax);
+            uint32_t row = VoxelMask::RowBits(localMin.x, localMax.x);
+            for (int z = 0; z < size; z++) {
+                for (int y = 0; y < size; y++) {
+                    bool inBox = y >= localMin.y && y <= localMax.y && z >= localMin.z &&
+                                 z <= localMax.z;
+                    bits[y + z * size] = inBox ? row : 0;
+                }
+            }
+            mask.SetChunk(chunk, bits);
+        }
+    }
+    return mask;
+}
+
+const VoxelLabels::EmptyRun* VoxelLabels::FindEmptyRun(const glm::ivec3& chunk) const {
+    if (emptyRowStart.empty() || glm::any(glm::lessThan(chunk, minChunk)) ||
+        glm::any(glm::greaterThan(chunk, maxChunk)))
+        return nullptr;
+
+    size_t row = size_t(chunk.y - minChunk.y) + size_t(chunk.z - minChunk.z) *
+                                                    (maxChunk.y - minChunk.y + 1);
+    auto first = emptyRuns.begin() + emptyRowStart[row];
+    auto last = emptyRuns.begin() + emptyRowStart[row + 1];
+    // The last run starting at or before the chunk
+    auto it = std::upper_bound(first, last, chunk.x,
+                               [](int x, const EmptyRun& run) { return x < run.chunk.x; });
+    if (it == first || (--it)->last < chunk.x)
+        return nullptr;
+    return &*it;
+}
+
+VoxelMask VoxelRegions::FloodFill(const VoxelVolume& volume, const glm::ivec3& seed,
+                                  const glm::ivec3& min, const glm::ivec3& max, bool sameColour) {
+    if (glm::any(glm::lessThan(seed, min)) || glm::any(glm::greaterThan(seed, max)))
+        return VoxelMask();
+
+    Voxel seedVoxel = volume.Get(seed);
+    Classes classes;
+    for (int voxel = 0; voxel < 256; voxel++) {
+        bool matches = sameColour ? voxel == seedVoxel : (voxel != 0) == (seedVoxel != 0);
+        classes[voxel] = matches ? 0 : excluded;
+    }
+
+    glm::ivec3 minChunk = VoxelVolume::ToChunk(min);
+    glm::ivec3 maxChunk = VoxelVolume::ToChunk(max);
+    std::vector<ChunkRuns> visited;
+    // Per visited chunk, 0 for components not reached yet, 1 reached this round, 2 before
+    std::vector<std::vector<uint8_t>> reached;
+    std::unordered_map<glm::ivec3, size_t> indices;
+    // Voxels the fill has reached in chunks it still has to go through
+    std::unordered_map<glm::ivec3, VoxelMask::ChunkBits> pending;
+    glm::ivec3 local = VoxelVolume::ToLocal(seed);
+    pending[VoxelVolume::ToChunk(seed)].fill(0);
+    pending[VoxelVolume::ToChunk(seed)][local.y + local.z * size] = uint32_t(1) << local.x;
+
+    const glm::ivec3 steps[6] = {{-1, 0, 0}, {1, 0, 0}, {0, -1, 0},
+                                 {0, 1, 0},  {0, 0, -1}, {0, 0, 1}};
+    std::vector<std::pair<glm::ivec3, VoxelMask::ChunkBits>> wave;
+    std::vector<size_t> fresh;
+    while (!pending.empty()) {
+        wave.assign(pending.begin(), pending.end());
+        pending.clear();
+
+        fresh.clear();
+        for (const auto& [chunk, seeds] : wave) {
+            if (indices.try_emplace(chunk, visited.size()).second) {
+                fresh.push_back(visited.size());
+                visited.emplace_back().chunk = chunk;
+                reached.emplace_back();
+            }
+        }
+        JobSystem::ParallelFor(fresh.size(), [&](size_t i) {
+            ChunkRuns& runs = visited[fresh[i]];
+            glm::ivec3 localMin, localMax;
+            LocalBox(runs.chunk, min, max, localMin, localMax);
+            uint32_t count = LabelChunk(volume.GetChunk(runs.chunk), classes, localMin,
+                                        localMax, runs);
+            reached[fresh[i]].assign(count, 0);
+        });
+
+        for (const auto& [chunk, seeds] : wave) {
+            size_t index = indices[chunk];
+            const ChunkRuns& runs = visited[index];
+            std::vector<uint8_t>& state = reached[index];
+            bool any = false;
+            for (int row = 0; row < rowCount; row++) {
+                if (seeds[row] == 0)
+                    continue;
+                for (uint32_t i = runs.rowStart[row]; i < runs.rowStart[row + 1]; i++) {
+                    const Run& run = runs.runs[i];
+                    if (state[run.component] == 0 &&
+                        (seeds[row] & VoxelMask::RowBits(run.first, run.last))) {
+                        state[run.component] = 1;
+                        any = true;
+                    }
+                }
+            }
+            if (!any)
+                continue;
+
+            // Voxels across the faces of the chunk from the newly reached components
+            std::array<VoxelMask::ChunkBits*, 6> faces{};
+            auto face = [&](int side) -> VoxelMask::ChunkBits* {
+                if (!faces[side]) {
+                    glm::ivec3 next = chunk + steps[side];
+                    if (glm::any(glm::lessThan(next, minChunk)) ||
+                        glm::any(glm::greaterThan(next, maxChunk)))
+                        return nullptr;
+                    auto [it, inserted] = pending.try_emplace(next);
+                    if (inserted)
+                        it->second.fill(0);
+                    faces[side] = &it->second;
+                }
+                return faces[side];
+            };
+            for (const Run& run : runs.runs) {
+                if (state[run.component] != 1)
+                    continue;
+                int y = run.row % size;
+                int z = run.row / size;
+                uint32_t bits = VoxelMask::RowBits(run.first, run.last);
+                if (run.first == 0 && face(0))
+                    (*face(0))[run.row] |= uint32_t(1) << (size - 1);
+                if (run.last == size - 1 && face(1))
+                    (*face(1))[run.row] |= 1;
+                if (y == 0 && face(2))
+                    (*face(2))[run.row + size - 1] |= bits;
+                if (y == size - 1 && face(3))
+                    (*face(3))[run.row - (size - 1)] |= bits;
+                if (z == 0 && face(4))
+                    (*face(4))[run.row + (size - 1) * size] |= bits;
+                if (z == size - 1 && face(5))
+                    (*face(5))[run.row - (size - 1) * size] |= bits;
+            }
+            for (uint8_t& component : state)
+                component = component != 0 ? 2 : 0;
+        }
+    }
+
+    return MaskRuns(visited,
+                    [&](size_t i, const Run& run) { return reached[i][run.component] != 0; });
+}
+
+VoxelLabels VoxelRegions::Label(const VoxelVolume& volume, Match match, const glm::ivec3& min,
+                                const glm::ivec3& max) {
+    VoxelLabels labels;
+    if (glm::any(glm::greaterThan(min, max)))
+        return labels;
+
+    Classes classes = MatchClasses(match);
+    glm::ivec3 minChunk = VoxelVolume::ToChunk(min);
+    glm::ivec3 maxChunk = VoxelVolume::ToChunk(max);
+    labels.min = min;
+    labels.max = max;
+    labels.minChunk = minChunk;
+    labels.maxChunk = maxChunk;
+
+    // Chunks in row order, z then y then x, which the runs of missing chunks are built along
+    std::vector<glm::ivec3> present;
+    for (const auto& [chunk, voxels] : volume.GetChunks()) {
+        if (glm::all(glm::greaterThanEqual(chunk, minChunk)) &&
+            glm::all(glm::lessThanEqual(chunk, maxChunk)))
+            present.push_back(chunk);
+    }
+    std::sort(present.begin(), present.end(), [](const glm::ivec3& a, const glm::ivec3& b) {
+        return std::tie(a.z, a.y, a.x) < std::tie(b.z, b.y, b.x);
+    });
+    labels.chunks.resize(present.size());
+    labels.chunkIndices.reserve(present.size());
+    for (size_t i = 0; i < present.size(); i++) {
+        labels.chunks[i].chunk = present[i];
+        labels.chunkIndices.emplace(present[i], static_cast<uint32_t>(i));
+    }
+
+    std::vector<uint32_t> offsets(labels.chunks.size() + 1, 0);
+    JobSystem::ParallelFor(labels.chunks.size(), [&](size_t i) {
+        ChunkRuns& runs = labels.chunks[i];
+        glm::ivec3 localMin, localMax;
+        LocalBox(runs.chunk, min, max, localMin, localMax);
+        offsets[i + 1] = LabelChunk(volume.GetChunk(runs.chunk), classes, localMin, localMax, runs);
+    });
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    // Missing chunks only matter when empty voxels are labelled, as the gaps between the chunks
+    // of each row, so the box can be far larger than the chunks in it
+    std::vector<VoxelLabels::EmptyRun>& emptyRuns = labels.emptyRuns;
+    std::vector<uint32_t>& emptyRowStart = labels.emptyRowStart;
+    glm::ivec3 extent = maxChunk - minChunk + 1;
+    if (classes[0] != excluded) {
+        emptyRowStart.reserve(size_t(extent.y) * extent.z + 1);
+        size_t next = 0;
+        for (int z = minChunk.z; z <= maxChunk.z; z++) {
+            for (int y = minChunk.y; y <= maxChunk.y; y++) {
+                emptyRowStart.push_back(static_cast<uint32_t>(emptyRuns.size()));
+                int x = minChunk.x;
+                for (; next < present.size() && present[next].y == y && present[next].z == z;
+                     next++) {
+                    if (present[next].x > x)
+                        emptyRuns.push_back({{x, y, z}, present[next].x - 1, 0});
+                    x = present[next].x + 1;
+                }
+                if (x <= maxChunk.x)
+                    emptyRuns.push_back({{x, y, z}, maxChunk.x, 0});
+            }
+        }
+        emptyRowStart.push_back(static_cast<uint32_t>(emptyRuns.size()));
+    }
+
+    // Components of every chunk numbered one after the other followed by the runs of missing
+    // chunks, joined where they meet across chunk faces
+    uint32_t emptyBase = offsets.back();
+    std::vector<uint32_t> parent(emptyBase + emptyRuns.size());
+    std::iota(parent.begin(), parent.end(), 0);
+    const glm::ivec3 steps[6] = {{-1, 0, 0}, {1, 0, 0},  {0, -1, 0},
+                                 {0, 1, 0},  {0, 0, -1}, {0, 0, 1}};
+    for (size_t i = 0; i < labels.chunks.size(); i++) {
+        const ChunkRuns& a = labels.chunks[i];
+        for (int axis = 0; axis < 3; axis++) {
+            glm::ivec3 next = a.chunk;
+            next[axis]++;
+            auto it = labels.chunkIndices.find(next);
+            if (it == labels.chunkIndices.end())
+                continue;
+            const ChunkRuns& b = labels.chunks[it->second];
+            ConnectChunks(a, b, axis, [&](const Run& x, const Run& y) {
+                Unite(parent, offsets[i] + x.component, offsets[it->second] + y.component);
+            });
+        }
+        if (emptyRuns.empty())
+            continue;
+        for (int side = 0; side < 6; side++) {
+            const VoxelLabels::EmptyRun* run = labels.FindEmptyRun(a.chunk + steps[side]);
+            if (!run)
+                continue;
+            uint32_t empty = emptyBase + static_cast<uint32_t>(run - emptyRuns.data());
+            FaceRuns(a, side, [&](const Run& x) {
+                if (x.key == classes[0])
+                    Unite(parent, offsets[i] + x.component, empty);
+            });
+        }
+    }
+    // Runs of missing chunks that overlap along x, against the row before along y then along z
+    auto connectEmpty = [&](size_t aRow, size_t bRow) {
+        uint32_t i = emptyRowStart[aRow];
+        uint32_t j = emptyRowStart[bRow];
+        while (i < emptyRowStart[aRow + 1] && j < emptyRowStart[bRow + 1]) {
+            if (emptyRuns[i].last < emptyRuns[j].chunk.x) {
+                i++;
+            } else if (emptyRuns[j].last < emptyRuns[i].chunk.x) {
+                j++;
+            } else {
+                Unite(parent, emptyBase + i, emptyBase + j);
+                if (emptyRuns[i].last < emptyRuns[j].last)
+                    i++;
+                else
+                    j++;
+            }
+        }
+    };
+    for (size_t row = 0; row + 1 < emptyRowStart.size(); row++) {
+        if (row % extent.y != 0)
+            connectEmpty(row - 1, row);
+        if (row >= size_t(extent.y))
+            connectEmpty(row - extent.y, row);
+    }
+
+    std::vector<uint32_t> components(parent.size());
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < parent.size(); i++) {
+        uint32_t root = Find(parent, i);
+        components[i] = root == i ? count++ : components[root];
+    }
+    JobSystem::ParallelFor(labels.chunks.size(), [&](size_t i) {
+        for (Run& run : labels.chunks[i].runs)
+            run.component = components[offsets[i] + run.component];
+    });
+    for (size_t i = 0; i < emptyRuns.size(); i++)
+        emptyRuns[i].component = components[emptyBase + i];
+
+    labels.voxelCounts.assign(count, 0);
+    labels.onEdge.assign(count, false);
+    for (const ChunkRuns& chunk : labels.chunks) {
+        glm::ivec3 origin = chunk.chunk * size;
+        for (const Run& run : chunk.runs) {
+            int y = origin.y + run.row % size;
+            int z = origin.z + run.row / size;
+            labels.voxelCounts[run.component] += run.last - run.first + 1;
+            if (y == min.y || y == max.y || z == min.z || z == max.z ||
+                origin.x + run.first == min.x || origin.x + run.last == max.x)
+                labels.onEdge[run.component] = true;
+        }
+    }
+    for (const VoxelLabels::EmptyRun& run : emptyRuns) {
+        glm::ivec3 low = glm::max(run.chunk * size, min);
+        glm::ivec3 high = glm::min(glm::ivec3(run.last, run.chunk.y, run.chunk.z) * size +
+                                       (size - 1),
+                                   max);
+        glm::ivec3 voxels = high - low + 1;
+        labels.voxelCounts[run.component] += size_t(voxels.x) * voxels.y * voxels.z;
+        // Clamped to the box, so only ever reaching its edge
+        if (glm::any(glm::lessThanEqual(low, min)) || glm::any(glm::greaterThanEqual(high, max)))
+            labels.onEdge[run.component] = true;
+    }
+    return labels;
+}
+
+VoxelLabels VoxelRegions::Label(const VoxelVolume& volume, Match match) {
+    glm::ivec3 min, max;
+    if (!GetBounds(volume, min, max))
+        return VoxelLabels();
+    return Label(volume, match, min, max);
+}
+
+size_t VoxelRegions::FillEnclosed(VoxelVolume& volume, Voxel voxel,
+                                  VoxelEditRecorder* recorder) {
+    VoxelMask enclosed = Label(volume, Match::Empty).SelectEnclosed();
+    return VoxelTools::FillMask(volume, enclosed, voxel, recorder);
+}
+
+bool VoxelRegions::GetBounds(const VoxelVolume& volume, glm::ivec3& outMin, glm::ivec3& outMax) {
+    if (volume.GetChunkCount() == 0)
+        return false;
+
+    glm::ivec3 minChunk(std::numeric_limits<int>::max());
+    glm::ivec3 maxChunk(std::numeric_limits<int>::min());
+    for (const auto& [chunk, voxels] : volume.GetChunks()) {
+        minChunk = glm::min(minChunk, chunk);
+        maxChunk = glm::max(maxChunk, chunk);
+    }
+    outMin = minChunk * size;
+    outMax = (maxChunk + 1) * size - 1;
+    return true;
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include <Voxel/pch.h>
+#include <Voxel/Editing/VoxelEdit.h>
+#include <Voxel/Volume/VoxelMask.h>
+#include <Voxel/Volume/VoxelVolume.h>
+
+// Connected components of a volume from VoxelRegions::Label, voxels sharing a face being
+// connected. Kept as the runs along x of each chunk, tagged with their component. Chunks that
+// don't exist are empty throughout, so when empty voxels are labelled they are kept as runs of
+// whole chunks along x instead.
+class VoxelLabels {
+  public:
+    static constexpr uint32_t none = UINT32_MAX;
+
+    // Runs of one chunk in row order, rowStart[row] being the first of a row
+    struct Run {
+        uint32_t component;
+        uint16_t row;
+        uint8_t first;
+        uint8_t last;
+        uint16_t key;
+    };
+    struct ChunkRuns {
+        glm::ivec3 chunk{0};
+        std::vector<Run> runs;
+        std::array<uint32_t, VoxelMask::rowCount + 1> rowStart;
+    };
+
+    size_t GetComponentCount() const { return voxelCounts.size(); }
+    size_t GetVoxelCount(uint32_t component) const { return voxelCounts[component]; }
+    // Components that don't reach the edge of the labelled box are closed in by other voxels
+    bool IsEnclosed(uint32_t component) const { return !onEdge[component]; }
+    // none for voxels that weren't labelled
+    uint32_t GetComponent(const glm::ivec3& position) const;
+
+    // Voxels of the given components, built chunk by chunk on the JobSystem
+    VoxelMask Select(std::span<const uint32_t> components) const;
+    VoxelMask Select(uint32_t component) const { return Select({&component, 1}); }
+    // Voxels of every enclosed component
+    VoxelMask SelectEnclosed() const;
+
+    // Runs of the chunks that exist
+    const std::vector<ChunkRuns>& GetChunks() const { return chunks; }
+
+  private:
+    friend class VoxelRegions;
+
+    // Chunks that don't exist from chunk to last along x
+    struct EmptyRun {
+        glm::ivec3 chunk;
+        int last;
+        uint32_t component;
+    };
+
+    VoxelMask SelectChosen(const std::vector<bool>& chosen) const;
+    // The empty run holding a chunk that doesn't exist, nullptr outside of the box
+    const EmptyRun* FindEmptyRun(const glm::ivec3& chunk) const;
+
+    std::vector<ChunkRuns> chunks;
+    TrackedUnorderedMap<glm::ivec3, uint32_t, MemoryTag::Voxel> chunkIndices;
+    // Labelled box, and the chunks it covers
+    glm::ivec3 min{0};
+    glm::ivec3 max{-1};
+    glm::ivec3 minChunk{0};
+    glm::ivec3 maxChunk{-1};
+    // Ordered by row of chunks, y + z * rows along y, emptyRowStart[row] being the first of a
+    // row. Empty unless empty voxels were labelled.
+    std::vector<EmptyRun> emptyRuns;
+    std::vector<uint32_t> emptyRowStart;
+    std::vector<size_t> voxelCounts;
+    std::vector<bool> onEdge;
+};
+
+// Selecting connected voxels. Chunks are labelled on their own across the JobSystem, each
+// labelling its runs along x with a union find, and the labels are then joined across chunk
+// faces. Work is bounded by a box, which voxels outside of are never connected to.
+class VoxelRegions {
+  public:
+    enum class Match {
+        // Every voxel that isn't empty
+        Solid,
+        // Voxels that aren't empty, connected only to those of the same colour
+        Colour,
+        // Empty voxels, including those of chunks that don't exist, which are labelled a whole
+        // chunk at a time
+        Empty,
+    };
+
+    // Voxels connected to seed, within min to max. With sameColour they are those of the seed's
+    // colour, otherwise those that are empty or solid like it. Chunks are visited as the fill
+    // reaches them, each round of newly reached chunks labelled in parallel.
+    static VoxelMask FloodFill(const VoxelVolume& volume, const glm::ivec3& seed,
+                               const glm::ivec3& min, const glm::ivec3& max,
+                               bool sameColour = true);
+
+    // Every component of the matching voxels from min to max
+    static VoxelLabels Label(const VoxelVolume& volume, Match match, const glm::ivec3& min,
+                             const glm::ivec3& max);
+    // Label within the box holding every chunk of the volume
+    static VoxelLabels Label(const VoxelVolume& volume, Match match);
+
+    // Fills the empty spaces the volume closes off, such as the inside of a hollow model, and
+    // returns the number of chunks changed as VoxelTools does
+    static size_t FillEnclosed(VoxelVolume& volume, Voxel voxel,
+                               VoxelEditRecorder* recorder = nullptr);
+
+    // Box holding every chunk of the volume, false when it has none
+    static bool GetBounds(const VoxelVolume& volume, glm::ivec3& outMin, glm::ivec3& outMax);
+};
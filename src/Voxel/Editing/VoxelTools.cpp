@@ -0,0 +1,259 @@
+#include "VoxelTools.h"
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <bit>
+#include <cstring>
+
+namespace {
+constexpr int size = VoxelChunk::size;
+constexpr int rowCount = size * size;
+
+// Voxels first to last along x, both included, empty when first > last
+struct Span {
+    int first = 1;
+    int last = 0;
+};
+using RowSpans = std::array<Span, rowCount>;
+
+// Voxels along a row whose centre is within sqrt(halfSquared) of centre
+Span Around(float centre, float halfSquared) {
+    if (halfSquared < 0.0f)
+        return Span();
+    float half = std::sqrt(halfSquared);
+    return {static_cast<int>(std::ceil(centre - half - 0.5f)),
+            static_cast<int>(std::floor(centre + half - 0.5f))};
+}
+
+bool IsAll(const VoxelChunk& chunk, Voxel voxel) {
+    Voxel existing;
+    // The first voxel rules out almost every chunk without reading the rest
+    return chunk.Get(0, 0, 0) == voxel && chunk.IsUniform(existing);
+}
+
+// Whether writing voxel over the spans changes any voxel of the chunk
+bool Changes(const VoxelChunk& chunk, const RowSpans& spans, Voxel voxel) {
+    const Voxel* voxels = chunk.GetVoxels().data();
+    for (int row = 0; row < rowCount; row++) {
+        const Span& span = spans[row];
+        if (span.first > span.last)
+            continue;
+        const Voxel* first = voxels + (row << VoxelChunk::shift) + span.first;
+        // Every voxel equals the next one, as in VoxelChunk::IsUniform
+        if (*first != voxel || std::memcmp(first, first + 1, span.last - span.first) != 0)
+            return true;
+    }
+    return false;
+}
+
+// Puts a chunk of nothing but voxel in place of the chunk, or removes it for 0. Every chunk
+// replaced by one edit shares filled, which is made by the first.
+void ReplaceWhole(VoxelVolume& volume, const glm::ivec3& chunk, Voxel voxel, ChunkHandle& filled,
+                  VoxelEditRecorder* recorder) {
+    if (voxel != 0 && !filled) {
+        filled = ChunkHandle::Make();
+        filled.Write().Fill(voxel);
+    }
+    ChunkHandle voxels = voxel != 0 ? filled : ChunkHandle();
+    if (recorder)
+        recorder->Replace(chunk, std::move(voxels));
+    else
+        volume.ExchangeChunk(chunk, std::move(voxels));
+}
+
+// Writes voxel over the voxels from min to max that rowSpan(y, z) gives for each row, as a Span
+// in world coordinates. Spans of a row are the same in every chunk along x, so they are worked
+// out once per row of chunks and clipped to each chunk.
+template <typename RowSpan>
+size_t Paint(VoxelVolume& volume, const glm::ivec3& min, const glm::ivec3& max, Voxel voxel,
+             VoxelEditRecorder* recorder, RowSpan rowSpan) {
+    if (min.x > max.x || min.y > max.y || min.z > max.z)
+        return 0;
+
+    glm::ivec3 minChunk = VoxelVolume::ToChunk(min);
+    glm::ivec3 maxChunk = VoxelVolume::ToChunk(max);
+    ChunkHandle filled;
+    RowSpans worldSpans;
+    RowSpans spans;
+    size_t changed = 0;
+    for (int cz = minChunk.z; cz <= maxChunk.z; cz++) {
+        for (int cy = minChunk.y; cy <= maxChunk.y; cy++) {
+            for (int z = 0; z < size; z++) {
+                for (int y = 0; y < size; y++) {
+                    int worldY = cy * size + y;
+                    int worldZ = cz * size + z;
+                    Span span;
+                    if (worldY >= min.y && worldY <= max.y && worldZ >= min.z && worldZ <= max.z) {
+                        span = rowSpan(worldY, worldZ);
+                        span.first = std::max(span.first, min.x);
+                        span.last = std::min(span.last, max.x);
+                    }
+                    worldSpans[y + z * size] = span;
+                }
+            }
+
+            for (int cx = minChunk.x; cx <= maxChunk.x; cx++) {
+                int originX = cx * size;
+                bool any = false;
+                bool whole = true;
+                for (int row = 0; row < rowCount; row++) {
+                    Span span = {std::max(worldSpans[row].first - originX, 0),
+                                 std::min(worldSpans[row].last - originX, size - 1)};
+                    any |= span.first <= span.last;
+                    whole &= span.first == 0 && span.last == size - 1;
+                    spans[row] = span;
+                }
+                if (!any)
+                    continue;
+
+                glm::ivec3 chunk(cx, cy, cz);
+                const VoxelChunk* current = volume.GetChunk(chunk);
+                if (whole) {
+                    if (current ? IsAll(*current, voxel) : voxel == 0)
+                        continue;
+                    ReplaceWhole(volume, chunk, voxel, filled, recorder);
+                } else {
+                    if (current ? !Changes(*current, spans, voxel) : voxel == 0)
+                        continue;
+                    if (recorder)
+                        recorder->Touch(chunk);
+                    Voxel* voxels = volume.GetOrCreateChunk(chunk).GetVoxels().data();
+                    for (int row = 0; row < rowCount; row++) {
+                        const Span& span = spans[row];
+                        if (span.first <= span.last)
+                            std::memset(voxels + (row << VoxelChunk::shift) + span.first, voxel,
+                                        span.last - span.first + 1);
+                    }
+                }
+                volume.MarkDirty(chunk);
+                changed++;
+            }
+        }
+    }
+    return changed;
+}
+} // namespace
+
+size_t VoxelTools::FillBox(VoxelVolume& volume, const glm::ivec3& min, const glm::ivec3& max,
+                           Voxel voxel, VoxelEditRecorder* recorder) {
+    return Paint(volume, min, max, voxel, recorder,
+                 [&](int, int) { return Span{min.x, max.x}; });
+}
+
+size_t VoxelTools::Sphere(VoxelVolume& volume, const glm::vec3& centre, float radius,
+                          Voxel voxel, VoxelEditRecorder* recorder) {
+    if (radius < 0.0f)
+        return 0;
+
+    glm::ivec3 min = glm::ivec3(glm::floor(centre - radius));
+    glm::ivec3 max = glm::ivec3(glm::ceil(centre + radius));
+    return Paint(volume, min, max, voxel, recorder, [&](int y, int z) {
+        float dy = y + 0.5f - centre.y;
+        float dz = z + 0.5f - centre.z;
+        return Around(centre.x, radius * radius - dy * dy - dz * dz);
+    });
+}
+
+size_t VoxelTools::Cylinder(VoxelVolume& volume, const glm::vec3& centre, float radius,
+                            int height, Axis axis, Voxel voxel, VoxelEditRecorder* recorder) {
+    if (radius < 0.0f || height <= 0)
+        return 0;
+
+    int along = static_cast<int>(axis);
+    glm::ivec3 min = glm::ivec3(glm::floor(centre - radius));
+    glm::ivec3 max = glm::ivec3(glm::ceil(centre + radius));
+    min[along] = static_cast<int>(std::floor(centre[along]));
+    max[along] = min[along] + height - 1;
+    float radiusSquared = radius * radius;
+    return Paint(volume, min, max, voxel, recorder, [&](int y, int z) {
+        float dy = y + 0.5f - centre.y;
+        float dz = z + 0.5f - centre.z;
+        switch (axis) {
+        case Axis::X:
+            // Rows run along the axis, each is either wholly in or out
+            return dy * dy + dz * dz <= radiusSquared ? Span{min.x, max.x} : Span();
+        case Axis::Y:
+            return Around(centre.x, radiusSquared - dz * dz);
+        default:
+            return Around(centre.x, radiusSquared - dy * dy);
+        }
+    });
+}
+
+size_t VoxelTools::FillMask(VoxelVolume& volume, const VoxelMask& mask, Voxel voxel,
+                            VoxelEditRecorder* recorder) {
+    // Calls span(offset, length) for each run of set bits of a row of the chunk
+    auto forEachSpan = [](const VoxelMask::ChunkBits& bits, auto span) {
+        for (int row = 0; row < rowCount; row++) {
+            for (uint32_t word = bits[row]; word != 0;) {
+                int first = std::countr_zero(word);
+                int length = std::countr_one(word >> first);
+                if (!span((row << VoxelChunk::shift) + first, length))
+                    return;
+                word &= ~VoxelMask::RowBits(first, first + length - 1);
+            }
+        }
+    };
+
+    ChunkHandle filled;
+    size_t changed = 0;
+    for (const auto& [chunk, bits] : mask.GetChunks()) {
+        const VoxelChunk* current = volume.GetChunk(chunk);
+        bool whole = std::all_of(bits.begin(), bits.end(), [](uint32_t row) { return row == ~0u; });
+        if (whole) {
+            if (current ? IsAll(*current, voxel) : voxel == 0)
+                continue;
+            ReplaceWhole(volume, chunk, voxel, filled, recorder);
+        } else {
+            bool changes = false;
+            if (current) {
+                const Voxel* voxels = current->GetVoxels().data();
+                forEachSpan(bits, [&](int offset, int length) {
+                    const Voxel* first = voxels + offset;
+                    changes = *first != voxel || std::memcmp(first, first + 1, length - 1) != 0;
+                    return !changes;
+                });
+            }
+            if (current ? !changes : voxel == 0)
+                continue;
+            if (recorder)
+                recorder->Touch(chunk);
+            Voxel* voxels = volume.GetOrCreateChunk(chunk).GetVoxels().data();
+            forEachSpan(bits, [&](int offset, int length) {
+                std::memset(voxels + offset, voxel, length);
+                return true;
+            });
+        }
+        volume.MarkDirty(chunk);
+        changed++;
+    }
+    return changed;
+}
+
+size_t VoxelTools::ReplaceColour(VoxelVolume& volume, Voxel from, Voxel to,
+                                 VoxelEditRecorder* recorder) {
+    if (from == to || from == 0)
+        return 0;
+
+    // Found first, replacing a whole chunk with nothing removes it from the map
+    std::vector<glm::ivec3> found;
+    for (const auto& [chunk, voxels] : volume.GetChunks()) {
+        if (std::memchr(voxels->GetVoxels().data(), from, VoxelChunk::voxelCount))
+            found.push_back(chunk);
+    }
+
+    ChunkHandle filled;
+    for (const glm::ivec3& chunk : found) {
+        if (IsAll(*volume.GetChunk(chunk), from)) {
+            ReplaceWhole(volume, chunk, to, filled, recorder);
+        } else {
+            if (recorder)
+                recorder->Touch(chunk);
+            Voxel* voxels = volume.WriteChunk(chunk)->GetVoxels().data();
+            // Compare and select without branches, which the compiler vectorises
+            for (size_t i = 0; i < VoxelChunk::voxelCount; i++)
+                voxels[i] = voxels[i] == from ? to : voxels[i];
+        }
+        volume.MarkDirty(chunk);
+    }
+    return found.size();
+}
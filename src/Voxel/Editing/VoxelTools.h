@@ -0,0 +1,38 @@
+#pragma once
+#include <Voxel/pch.h>
+#include <Voxel/Editing/VoxelEdit.h>
+#include <Voxel/Volume/VoxelMask.h>
+#include <Voxel/Volume/VoxelVolume.h>
+
+// Bulk edits of a VoxelVolume, chunk by chunk. Shapes are written as spans along x, one memset
+// per row of a chunk, and a chunk the shape covers entirely gets a handle to one filled chunk
+// shared by all of them, copied on the first write like any other. Chunks the edit leaves as they
+// were aren't written to, touched or marked dirty. Writing 0 erases, and erasing a whole chunk
+// removes it.
+//
+// With a recorder, chunks are touched or replaced through it before being written and the caller
+// commits it, so several tools can make up one undo step.
+//
+// Each returns the number of chunks it changed, which are marked dirty.
+class VoxelTools {
+  public:
+    enum class Axis { X, Y, Z };
+
+    // Every voxel from min to max, both included
+    static size_t FillBox(VoxelVolume& volume, const glm::ivec3& min, const glm::ivec3& max,
+                          Voxel voxel, VoxelEditRecorder* recorder = nullptr);
+    // Voxels whose centre is within radius of centre
+    static size_t Sphere(VoxelVolume& volume, const glm::vec3& centre, float radius, Voxel voxel,
+                         VoxelEditRecorder* recorder = nullptr);
+    // Voxels whose centre is within radius of the line through centre along axis, for height
+    // voxels along it starting at the one holding centre
+    static size_t Cylinder(VoxelVolume& volume, const glm::vec3& centre, float radius, int height,
+                           Axis axis, Voxel voxel, VoxelEditRecorder* recorder = nullptr);
+    // Every voxel of the mask, such as a selection from VoxelRegions
+    static size_t FillMask(VoxelVolume& volume, const VoxelMask& mask, Voxel voxel,
+                           VoxelEditRecorder* recorder = nullptr);
+    // Every from voxel in the volume becomes to. Empty space is endless, so from can't be 0 and
+    // nothing changes when it is.
+    static size_t ReplaceColour(VoxelVolume& volume, Voxel from, Voxel to,
+                                VoxelEditRecorder* recorder = nullptr);
+};
@@ -165,6 +165,30 @@ class EditorSettings {
 
     static void EnsureDefaults() {
         SetDefault("Editor", "UIScale", "1.0");
+        // Undo history kept before the oldest edits are dropped
+        SetDefault("Editor", "UndoMemoryMB", "256");
+        SetDefault("Shaders", "HotReload", "true");
+        SetDefault("Profiler", "CaptureFrames", "120");
+        SetDefault("Profiler", "CaptureEventsPerThread", "262144");
+        SetDefault("Profiler", "WindowFrames", "300");
+        SetDefault("Logging", "Async", "true");
+        SetDefault("Logging", "QueueSize", "8192");
+        // block, drop or drop-oldest
+        SetDefault("Logging", "OverflowPolicy", "block");
+        SetDefault("Logging", "File", "true");
+        SetDefault("Logging", "FilePath", "logs/voxel.log");
+        SetDefault("Logging", "MaxFileSizeMB", "10");
+        SetDefault("Logging", "MaxFiles", "3");
+        // Messages kept for the log panel
+        SetDefault("Logging", "HistorySize", "1048576");
+        // Binary session logs that the log panel can open later
+        SetDefault("Logging", "Session", "true");
+        SetDefault("Logging", "SessionDirectory", "logs");
+        SetDefault("Logging", "MaxSessions", "10");
+        // Voxel chunks kept in memory when a .vxchunks file is streamed
+        SetDefault("Streaming", "MemoryBudgetMB", "512");
+        SetDefault("Streaming", "ResidentRadius", "8");
+        SetDefault("Streaming", "MaxUploadsPerFrame", "32");
         dirty = true;
     }
 
@@ -0,0 +1,55 @@
+#pragma once
+#include <Voxel/pch.h>
+#include <cstring>
+#include <new>
+#include <span>
+#include <type_traits>
+
+// Type erased callback for events of type T that never allocates. The callable is stored inline
+// next to a pointer to a stub that calls it directly, so invoking it is one indirect call with
+// the callable's body inlined into the stub. Captureless lambdas, lambdas capturing a pointer or
+// two, and member functions through Bind all fit.
+template <typename T> class Delegate {
+  public:
+    static constexpr size_t bufferSize = 2 * sizeof(void*);
+
+    Delegate() = default;
+
+    template <typename F>
+        requires(!std::is_same_v<std::decay_t<F>, Delegate> &&
+                 std::is_invocable_v<const std::decay_t<F>&, const T&>)
+    Delegate(F&& callable) {
+        using Callable = std::decay_t<F>;
+        static_assert(sizeof(Callable) <= bufferSize && alignof(Callable) <= alignof(void*),
+                      "Delegate callables must fit the inline buffer, capture a pointer instead");
+        static_assert(std::is_trivially_copyable_v<Callable> &&
+                          std::is_trivially_destructible_v<Callable>,
+                      "Delegate callables are copied as bytes, capture pointers and values only");
+
+        new (storage) Callable(std::forward<F>(callable));
+        invoke = [](const std::byte* storage, const T& event) {
+            (*std::launder(reinterpret_cast<const Callable*>(storage)))(event);
+        };
+        invokeBatch = [](const std::byte* storage, std::span<const T> events) {
+            const Callable& callable = *std::launder(reinterpret_cast<const Callable*>(storage));
+            for (const T& event : events)
+                callable(event);
+        };
+    }
+
+    // Delegate calling instance->Method(event)
+    template <auto Method, typename Class> static Delegate Bind(Class* instance) {
+        return Delegate([instance](const T& event) { (instance->*Method)(event); });
+    }
+
+    void operator()(const T& event) const { invoke(storage, event); }
+    // Calls the callable for every event with a single indirect call
+    void InvokeBatch(std::span<const T> events) const { invokeBatch(storage, events); }
+
+    explicit operator bool() const { return invoke != nullptr; }
+
+  private:
+    alignas(void*) std::byte storage[bufferSize]{};
+    void (*invoke)(const std::byte*, const T&) = nullptr;
+    void (*invokeBatch)(const std::byte*, std::span<const T>) = nullptr;
+};
@@ -1,51 +1,121 @@
 #pragma once
 #include <Voxel/pch.h>
+#include <span>
+#include <Voxel/Event/Delegate.h>
 
 // Forward declare for handle
 template <typename T> class Subject;
 
 template <typename T> class ObserverHandle {
   public:
-    ObserverHandle() : subject(nullptr), id(0) {}
-    ObserverHandle(Subject<T>* subject, size_t id) : subject(subject), id(id) {}
+    ObserverHandle() : subject(nullptr), slot(0), generation(0) {}
+    ObserverHandle(Subject<T>* subject, uint32_t slot, uint32_t generation)
+        : subject(subject), slot(slot), generation(generation) {}
 
+    // Safe to call from inside a notification, the observer isn't called again after this
     void Unsubscribe() {
         if (subject)
-            subject->RemoveObserver(id);
+            subject->RemoveObserver(slot, generation);
         subject = nullptr;
     }
 
   private:
     Subject<T>* subject;
-    size_t id;
+    uint32_t slot;
+    uint32_t generation;
 };
 
+// Observers live in slots that never move, so removing one is O(1) and handles stay valid. Slots
+// freed during a notification are only reused once it finishes, and observers added during a
+// notification are first called by the next one.
 template <typename T> class Subject {
   public:
-    using Callback = std::function<void(const T&)>;
+    using Callback = Delegate<T>;
 
     // Add an observer, returns a handle that can unsubscribe
-    ObserverHandle<T> AddObserver(Callback cb) {
-        size_t observerId = nextId++;
-        observers.emplace_back(observerId, std::move(cb));
-        return ObserverHandle<T>(this, observerId);
+    ObserverHandle<T> AddObserver(Callback callback) {
+        uint32_t slot;
+        if (!freeSlots.empty() && dispatchDepth == 0) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            slot = static_cast<uint32_t>(observers.size());
+            observers.emplace_back();
+        }
+
+        observers[slot].callback = callback;
+        observerCount++;
+        return ObserverHandle<T>(this, slot, observers[slot].generation);
     }
 
     // Notify all observers
     void Notify(const T& data) {
-        for (auto& [id, cb] : observers) {
-            cb(data);
+        DispatchScope scope(this);
+        for (size_t i = 0; i < scope.count; i++) {
+            // A copy, the observer may remove itself or add others while it runs
+            Callback callback = observers[i].callback;
+            if (callback)
+                callback(data);
         }
     }
 
+    // Notify every observer of all events in turn, each observer handles the whole batch before
+    // the next one sees any of it. One indirect call per observer instead of one per event.
+    void NotifyBatch(std::span<const T> events) {
+        if (events.empty())
+            return;
+
+        DispatchScope scope(this);
+        for (size_t i = 0; i < scope.count; i++) {
+            Callback callback = observers[i].callback;
+            if (callback)
+                callback.InvokeBatch(events);
+        }
+    }
+
+    size_t GetObserverCount() const { return observerCount; }
+
   private:
     friend class ObserverHandle<T>;
-    void RemoveObserver(size_t id) {
-        observers.erase(std::remove_if(observers.begin(), observers.end(),
-                                       [id](auto& pair) { return pair.first == id; }),
-                        observers.end());
+
+    struct Observer {
+        Callback callback;
+        // Bumped when the slot is freed, so stale handles do nothing
+        uint32_t generation = 0;
+    };
+
+    // Observers present when a notification starts are the ones it calls
+    struct DispatchScope {
+        explicit DispatchScope(Subject* subject)
+            : subject(subject), count(subject->observers.size()) {
+            subject->dispatchDepth++;
+        }
+        ~DispatchScope() {
+            if (--subject->dispatchDepth == 0 && !subject->pendingFreeSlots.empty()) {
+                subject->freeSlots.insert(subject->freeSlots.end(),
+                                          subject->pendingFreeSlots.begin(),
+                                          subject->pendingFreeSlots.end());
+                subject->pendingFreeSlots.clear();
+            }
+        }
+
+        Subject* subject;
+        size_t count;
+    };
+
+    void RemoveObserver(uint32_t slot, uint32_t generation) {
+        if (slot >= observers.size() || observers[slot].generation != generation)
+            return;
+
+        observers[slot].callback = Callback();
+        observers[slot].generation++;
+        observerCount--;
+        (dispatchDepth > 0 ? pendingFreeSlots : freeSlots).push_back(slot);
     }
 
-    std::vector<std::pair<size_t, Callback>> observers;
-    size_t nextId = 1;
+    std::vector<Observer> observers;
+    std::vector<uint32_t> freeSlots;
+    std::vector<uint32_t> pendingFreeSlots;
+    size_t observerCount = 0;
+    uint32_t dispatchDepth = 0;
 };
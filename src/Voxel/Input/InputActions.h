@@ -11,8 +11,11 @@
     X(FreeCam_DecreaseSpeed)                                                                       \
     X(FreeCam_ZoomIn)                                                                              \
     X(FreeCam_ZoomOut)                                                                             \
+    X(Edit_Undo)                                                                                   \
+    X(Edit_Redo)                                                                                   \
     X(Debug_Exit)                                                                                  \
-    X(Debug_Wireframe)
+    X(Debug_Wireframe)                                                                             \
+    X(Debug_ProfilerCapture)
 
 enum class InputAction {
 #define X(name) name,
@@ -1,6 +1,7 @@
 #include "InputManager.h"
 #include <Voxel/pch.h>
 #include <Voxel/Core.h>
+#include <bit>
 #include <Voxel/Camera.h>
 #include <Voxel/EditorSettings.h>
 
@@ -36,8 +37,11 @@ bool InputManager::AddBinding(InputAction action, InputDevice device, int key, i
     chord.key = key;
     chord.mods = mods;
 
-    // Prevent conflicts
-    if (FindMatchingAction(chord) != InputAction::None) {
+    // Prevent conflicts. Only the same chord is one, Ctrl+Shift+Z can sit next to Ctrl+Z.
+    bool bound = std::any_of(actionBindings.begin(), actionBindings.end(), [&](const auto& entry) {
+        return std::find(entry.second.begin(), entry.second.end(), chord) != entry.second.end();
+    });
+    if (bound) {
         LOG_WARN("Key conflict found, unable to bind key {} with mods {} to action {}.", key, mods,
                  ActionToString(action));
         return false;
@@ -77,6 +81,9 @@ void InputManager::Update() {
 }
 
 InputAction InputManager::FindMatchingAction(const KeyChord& current) {
+    // The binding with the most held modifiers wins, so Ctrl+Shift+Z isn't taken for Ctrl+Z
+    InputAction match = InputAction::None;
+    int matchMods = -1;
     for (const auto& [action, chords] : actionBindings) {
         for (const KeyChord& binding : chords) {
             if (binding.device != current.device)
@@ -85,12 +92,15 @@ InputAction InputManager::FindMatchingAction(const KeyChord& current) {
             if (binding.key != current.key)
                 continue;
 
-            if ((binding.mods & current.mods) == binding.mods)
-                return action;
+            if ((binding.mods & current.mods) == binding.mods &&
+                std::popcount(static_cast<unsigned>(binding.mods)) > matchMods) {
+                match = action;
+                matchMods = std::popcount(static_cast<unsigned>(binding.mods));
+            }
         }
     }
 
-    return InputAction::None;
+    return match;
 }
 
 void InputManager::TriggerAction(InputAction action, InputTrigger trigger) {
@@ -0,0 +1,117 @@
+#include "JobSystem.h"
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace {
+struct Batch {
+    const std::function<void(size_t)>* body;
+    size_t count;
+    std::atomic<size_t> next{0};
+};
+
+// Set while a thread runs a body, so nested calls don't wait on the pool they are part of
+thread_local bool insideJob = false;
+
+void Drain(Batch& batch) {
+    insideJob = true;
+    for (size_t i = batch.next.fetch_add(1, std::memory_order_relaxed); i < batch.count;
+         i = batch.next.fetch_add(1, std::memory_order_relaxed))
+        (*batch.body)(i);
+    insideJob = false;
+}
+
+class WorkerPool {
+  public:
+    WorkerPool() {
+        unsigned cores = std::max(std::thread::hardware_concurrency(), 1u);
+        for (unsigned i = 1; i < cores; i++)
+            threads.emplace_back(&WorkerPool::WorkerLoop, this);
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& thread : threads)
+            thread.join();
+    }
+
+    void Run(Batch& batch) {
+        std::lock_guard callLock(callMutex);
+        {
+            std::lock_guard lock(mutex);
+            current = &batch;
+            generation++;
+        }
+        wake.notify_all();
+        Drain(batch);
+
+        // Workers that wake after this see no batch and go back to sleep
+        std::unique_lock lock(mutex);
+        finished.wait(lock, [&]() { return busy == 0; });
+        current = nullptr;
+    }
+
+    unsigned GetThreadCount() const { return static_cast<unsigned>(threads.size()) + 1; }
+
+  private:
+    void WorkerLoop() {
+        uint64_t seen = 0;
+        std::unique_lock lock(mutex);
+        while (true) {
+            wake.wait(lock, [&]() { return stopping || generation != seen; });
+            if (stopping)
+                return;
+            seen = generation;
+            Batch* batch = current;
+            if (!batch)
+                continue;
+
+            busy++;
+            lock.unlock();
+            Drain(*batch);
+            lock.lock();
+            if (--busy == 0)
+                finished.notify_all();
+        }
+    }
+
+    std::vector<std::thread> threads;
+    // Held for a whole ParallelFor, one batch at a time
+    std::mutex callMutex;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    Batch* current = nullptr;
+    uint64_t generation = 0;
+    unsigned busy = 0;
+    bool stopping = false;
+};
+
+WorkerPool& GetPool() {
+    static WorkerPool pool;
+    return pool;
+}
+} // namespace
+
+void JobSystem::ParallelFor(size_t count, const std::function<void(size_t)>& body) {
+    if (count == 0)
+        return;
+
+    if (count == 1 || insideJob || GetPool().GetThreadCount() == 1) {
+        for (size_t i = 0; i < count; i++)
+            body(i);
+        return;
+    }
+
+    Batch batch{&body, count};
+    GetPool().Run(batch);
+}
+
+unsigned JobSystem::GetThreadCount() { return GetPool().GetThreadCount(); }
@@ -0,0 +1,15 @@
+#pragma once
+#include <Voxel/pch.h>
+
+// A pool of worker threads, one per core after the first, started on first use. Work is handed
+// out an item at a time, so items should each be worth at least tens of microseconds.
+class JobSystem {
+  public:
+    // Calls body(i) for every i in [0, count) across the workers and the calling thread, and
+    // returns once all of them are done. One call runs at a time, calls made from inside a body
+    // run on the calling thread.
+    static void ParallelFor(size_t count, const std::function<void(size_t)>& body);
+
+    // Threads a ParallelFor runs on, the caller included
+    static unsigned GetThreadCount();
+};
@@ -0,0 +1,72 @@
+#pragma once
+#include <Voxel/pch.h>
+#include <Voxel/Log/Log.h>
+
+// Command line options, e.g.
+//   voxel_editor --headless --frames 600 --width 1280 --height 720 --context egl
+//                --scene scene.txt --camera-path path.txt --dump-frames frames/
+//                --timings timings.csv --trace trace.json
+// voxel_bench additionally reads --warmup and --report.
+struct LaunchOptions {
+    // Render offscreen without a visible window or UI, then exit after a fixed number of frames
+    bool headless = false;
+    int frames = 300;
+    int width = 1920;
+    int height = 1080;
+
+    // Context API used when headless, "osmesa" (software, llvmpipe) or "egl" (surfaceless)
+    std::string contextApi = "osmesa";
+
+    // A text scene description, a binary .vscene, a MagicaVoxel .vox, or a .vxchunks voxel
+    // volume which is streamed
+    std::filesystem::path scenePath =
+        std::filesystem::path("resources") / "scenes" / "default.scene";
+    std::filesystem::path cameraPath;
+    std::filesystem::path dumpFramesDirectory;
+    std::filesystem::path timingsPath;
+    // Profiler capture of the whole run
+    std::filesystem::path tracePath;
+
+    // Frames rendered before timings count towards a benchmark report
+    int warmupFrames = 0;
+    std::filesystem::path reportPath;
+
+    static LaunchOptions Parse(int argc, char** argv) {
+        LaunchOptions options;
+
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+
+            if (arg == "--headless") {
+                options.headless = true;
+            } else if (arg == "--frames" && hasValue) {
+                options.frames = std::max(1, std::atoi(argv[++i]));
+            } else if (arg == "--width" && hasValue) {
+                options.width = std::max(1, std::atoi(argv[++i]));
+            } else if (arg == "--height" && hasValue) {
+                options.height = std::max(1, std::atoi(argv[++i]));
+            } else if (arg == "--context" && hasValue) {
+                options.contextApi = argv[++i];
+            } else if (arg == "--scene" && hasValue) {
+                options.scenePath = argv[++i];
+            } else if (arg == "--camera-path" && hasValue) {
+                options.cameraPath = argv[++i];
+            } else if (arg == "--dump-frames" && hasValue) {
+                options.dumpFramesDirectory = argv[++i];
+            } else if (arg == "--timings" && hasValue) {
+                options.timingsPath = argv[++i];
+            } else if (arg == "--trace" && hasValue) {
+                options.tracePath = argv[++i];
+            } else if (arg == "--warmup" && hasValue) {
+                options.warmupFrames = std::max(0, std::atoi(argv[++i]));
+            } else if (arg == "--report" && hasValue) {
+                options.reportPath = argv[++i];
+            } else {
+                LOG_WARN("Ignoring unknown argument: {}", arg);
+            }
+        }
+
+        return options;
+    }
+};
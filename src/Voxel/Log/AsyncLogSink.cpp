@@ -0,0 +1,114 @@
+#include "AsyncLogSink.h"
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+
+AsyncLogSink::AsyncLogSink(std::vector<spdlog::sink_ptr> sinks, size_t queueSize,
+                           LogOverflowPolicy policy)
+    : queue(queueSize), sinks(std::move(sinks)), policy(policy) {
+    thread = std::thread(&AsyncLogSink::BackendLoop, this);
+}
+
+AsyncLogSink::~AsyncLogSink() {
+    running.store(false, std::memory_order_release);
+    pushed.fetch_add(1, std::memory_order_release);
+    pushed.notify_one();
+    if (thread.joinable())
+        thread.join();
+}
+
+void AsyncLogSink::log(const spdlog::details::log_msg& msg) {
+    spdlog::details::log_msg_buffer message(msg);
+
+    // TryPush only moves from message when it succeeds
+    while (!queue.TryPush(std::move(message))) {
+        if (policy == LogOverflowPolicy::Drop) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        if (policy == LogOverflowPolicy::DropOldest) {
+            spdlog::details::log_msg_buffer oldest;
+            if (queue.TryPop(oldest))
+                dropped.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        // Block until the backend has made room, re-checking first so a wakeup can't be missed
+        uint32_t seen = popped.load(std::memory_order_acquire);
+        if (queue.TryPush(std::move(message)))
+            break;
+        popped.wait(seen, std::memory_order_acquire);
+    }
+
+    size_t size = queue.GetSizeApprox();
+    size_t highest = highWaterMark.load(std::memory_order_relaxed);
+    while (size > highest &&
+           !highWaterMark.compare_exchange_weak(highest, size, std::memory_order_relaxed))
+        ;
+
+    pushed.fetch_add(1, std::memory_order_release);
+    pushed.notify_one();
+}
+
+void AsyncLogSink::flush() { pushed.notify_one(); }
+
+void AsyncLogSink::set_pattern(const std::string& pattern) {
+    for (spdlog::sink_ptr& sink : sinks)
+        sink->set_pattern(pattern);
+}
+
+void AsyncLogSink::set_formatter(std::unique_ptr<spdlog::formatter> formatter) {
+    for (spdlog::sink_ptr& sink : sinks)
+        sink->set_formatter(formatter->clone());
+}
+
+LogOverflowPolicy AsyncLogSink::ParsePolicy(const std::string& name) {
+    if (name == "drop")
+        return LogOverflowPolicy::Drop;
+    if (name == "drop-oldest")
+        return LogOverflowPolicy::DropOldest;
+    return LogOverflowPolicy::Block;
+}
+
+void AsyncLogSink::WriteMessage(const spdlog::details::log_msg& msg) {
+    for (spdlog::sink_ptr& sink : sinks) {
+        if (sink->should_log(msg.level))
+            sink->log(msg);
+    }
+}
+
+void AsyncLogSink::NotifyPopped() {
+    popped.fetch_add(1, std::memory_order_release);
+    popped.notify_all();
+}
+
+void AsyncLogSink::BackendLoop() {
+    spdlog::details::log_msg_buffer message;
+    while (true) {
+        uint32_t seen = pushed.load(std::memory_order_acquire);
+
+        size_t drained = 0;
+        while (queue.TryPop(message)) {
+            WriteMessage(message);
+            // Let blocked producers in before the whole burst is written
+            if (++drained % 64 == 0)
+                NotifyPopped();
+        }
+
+        if (drained > 0) {
+            NotifyPopped();
+            for (spdlog::sink_ptr& sink : sinks)
+                sink->flush();
+        }
+
+        if (!running.load(std::memory_order_acquire))
+            break;
+        pushed.wait(seen, std::memory_order_acquire);
+    }
+
+    // Anything pushed while shutting down
+    while (queue.TryPop(message))
+        WriteMessage(message);
+    for (spdlog::sink_ptr& sink : sinks)
+        sink->flush();
+}
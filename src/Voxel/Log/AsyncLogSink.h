@@ -0,0 +1,53 @@
+#pragma once
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <spdlog/details/log_msg_buffer.h>
+#include <spdlog/sinks/sink.h>
+#include <Voxel/Log/BoundedQueue.h>
+
+// What a logging thread does when the queue is full
+enum class LogOverflowPolicy { Block, Drop, DropOldest };
+
+// Hands messages to a backend thread through a bounded lock-free queue. The backend formats and
+// writes them to the wrapped sinks, so the logging thread only copies the message. Messages up
+// to ~250 bytes are copied without allocating.
+class AsyncLogSink final : public spdlog::sinks::sink {
+  public:
+    AsyncLogSink(std::vector<spdlog::sink_ptr> sinks, size_t queueSize, LogOverflowPolicy policy);
+    // Writes out everything still queued
+    ~AsyncLogSink() override;
+
+    void log(const spdlog::details::log_msg& msg) override;
+    // The backend flushes whenever it runs out of messages, this only wakes it
+    void flush() override;
+    // Configuration only, not safe while other threads are logging
+    void set_pattern(const std::string& pattern) override;
+    void set_formatter(std::unique_ptr<spdlog::formatter> formatter) override;
+
+    uint64_t GetDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+    size_t GetHighWaterMark() const { return highWaterMark.load(std::memory_order_relaxed); }
+    size_t GetCapacity() const { return queue.GetCapacity(); }
+    LogOverflowPolicy GetPolicy() const { return policy; }
+
+    static LogOverflowPolicy ParsePolicy(const std::string& name);
+
+  private:
+    void BackendLoop();
+    void WriteMessage(const spdlog::details::log_msg& msg);
+    void NotifyPopped();
+
+    BoundedQueue<spdlog::details::log_msg_buffer, MemoryTag::Logging> queue;
+    std::vector<spdlog::sink_ptr> sinks;
+    LogOverflowPolicy policy;
+
+    std::thread thread;
+    std::atomic<bool> running = true;
+    // Bumped after every push, the backend sleeps on it when the queue is empty
+    std::atomic<uint32_t> pushed{0};
+    // Bumped as the backend drains, blocked producers sleep on it
+    std::atomic<uint32_t> popped{0};
+
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<size_t> highWaterMark{0};
+};
@@ -0,0 +1,64 @@
+#pragma once
+#include <Voxel/pch.h>
+#include <cstring>
+#include <span>
+
+// Session log files (.vlog) written by BinaryLogSink and read by BinaryLogReader.
+//
+// A 16 byte header is followed by a stream of records, each starting with a kind byte:
+//   string   varint length, bytes. Strings get ids 0, 1, 2... in file order.
+//   message  kind is the level, then varints: zigzag nanoseconds since the previous message
+//            (the session start for the first), thread id, string id of the format, and one
+//            value per argument slot in the format.
+// Formats are the message text with every plain number cut out into an argument, so repeated
+// messages only store the numbers that changed. Varints are LEB128, little endian throughout.
+class BinaryLog {
+  public:
+    static constexpr uint32_t magic = 0x474C5856; // "VXLG"
+    static constexpr uint16_t version = 1;
+    static constexpr size_t headerSize = 16;
+    static constexpr uint8_t stringKind = 0x80;
+    // Stands in for an argument in a format, messages never contain it
+    static constexpr char argumentSlot = '\x1F';
+    // Longer digit runs could overflow and stay part of the format
+    static constexpr size_t maxArgumentDigits = 19;
+    static constexpr const char* extension = ".vlog";
+
+    struct Header {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t flags;
+        // System clock, nanoseconds since the epoch
+        int64_t startTime;
+    };
+    static_assert(sizeof(Header) == headerSize);
+
+    template <typename Bytes> static void WriteVarint(Bytes& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    // False when the varint runs past the end or is longer than 64 bits
+    static bool ReadVarint(std::span<const std::byte> bytes, size_t& position,
+                           uint64_t& outValue) {
+        outValue = 0;
+        for (int shift = 0; shift < 64 && position < bytes.size(); shift += 7) {
+            uint8_t byte = static_cast<uint8_t>(bytes[position++]);
+            outValue |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    static uint64_t ZigZagEncode(int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    static int64_t ZigZagDecode(uint64_t value) {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+};
@@ -0,0 +1,128 @@
+#include "BinaryLogReader.h"
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <charconv>
+#include <cstring>
+#include <Voxel/Log/BinaryLogFormat.h>
+
+bool BinaryLogReader::Load(const std::filesystem::path& path, BinaryLogReader& outReader) {
+    outReader = BinaryLogReader();
+    if (!outReader.file.Open(path))
+        return false;
+
+    if (!outReader.Index()) {
+        outReader = BinaryLogReader();
+        return false;
+    }
+
+    LOG_INFO("Opened session log {} ({} messages, {} formats{})", path.string(),
+             outReader.rows.size(), outReader.formats.size(),
+             outReader.truncated ? ", cut short" : "");
+    return true;
+}
+
+bool BinaryLogReader::Index() {
+    std::span<const std::byte> bytes = file.GetBytes();
+    BinaryLog::Header header{};
+    if (bytes.size() >= sizeof(header))
+        std::memcpy(&header, bytes.data(), sizeof(header));
+    if (header.magic != BinaryLog::magic || header.version != BinaryLog::version) {
+        LOG_ERROR("{} is not a version {} session log", file.GetPath().string(),
+                  BinaryLog::version);
+        return false;
+    }
+
+    int64_t time = header.startTime;
+    size_t position = BinaryLog::headerSize;
+    while (position < bytes.size()) {
+        size_t start = position;
+        uint8_t kind = static_cast<uint8_t>(bytes[position]);
+
+        if (kind == BinaryLog::stringKind) {
+            position++;
+            uint64_t length = 0;
+            if (!BinaryLog::ReadVarint(bytes, position, length) ||
+                length > bytes.size() - position) {
+                truncated = true;
+                break;
+            }
+            std::string_view format(reinterpret_cast<const char*>(bytes.data() + position),
+                                    static_cast<size_t>(length));
+            auto arguments = std::count(format.begin(), format.end(), BinaryLog::argumentSlot);
+            formats.push_back({format, static_cast<uint32_t>(arguments)});
+            position += static_cast<size_t>(length);
+            continue;
+        }
+
+        Message message;
+        if (!ReadMessage(position, message)) {
+            truncated = true;
+            break;
+        }
+        // Skip over the arguments
+        bool complete = true;
+        uint64_t argument = 0;
+        for (uint32_t i = 0; i < formats[message.format].argumentCount && complete; i++)
+            complete = BinaryLog::ReadVarint(bytes, position, argument);
+        if (!complete) {
+            truncated = true;
+            break;
+        }
+
+        time += message.timeDelta;
+        rows.push_back({start, time});
+        levelCounts[message.level]++;
+        size_t thread = static_cast<size_t>(message.thread);
+        if (threads.empty() || (threads.back() != thread &&
+                                std::find(threads.begin(), threads.end(), thread) == threads.end()))
+            threads.push_back(thread);
+    }
+
+    if (truncated)
+        LOG_WARN("{} ends in an incomplete record at byte {}", file.GetPath().string(), position);
+    return true;
+}
+
+bool BinaryLogReader::ReadMessage(size_t& position, Message& outMessage) const {
+    std::span<const std::byte> bytes = file.GetBytes();
+    uint8_t kind = static_cast<uint8_t>(bytes[position++]);
+    if (kind >= spdlog::level::n_levels)
+        return false;
+
+    uint64_t timeDelta = 0;
+    if (!BinaryLog::ReadVarint(bytes, position, timeDelta) ||
+        !BinaryLog::ReadVarint(bytes, position, outMessage.thread) ||
+        !BinaryLog::ReadVarint(bytes, position, outMessage.format))
+        return false;
+
+    outMessage.level = static_cast<spdlog::level::level_enum>(kind);
+    outMessage.timeDelta = BinaryLog::ZigZagDecode(timeDelta);
+    return outMessage.format < formats.size();
+}
+
+LogRow BinaryLogReader::GetRow(uint64_t row) const {
+    const RowIndex& index = rows[row];
+    std::span<const std::byte> bytes = file.GetBytes();
+    size_t position = static_cast<size_t>(index.offset);
+    Message message;
+    ReadMessage(position, message);
+
+    // Rebuild the text, the file was checked while indexing
+    std::string_view format = formats[message.format].text;
+    text.clear();
+    while (true) {
+        size_t slot = format.find(BinaryLog::argumentSlot);
+        text.append(format.substr(0, slot));
+        if (slot == std::string_view::npos)
+            break;
+
+        uint64_t argument = 0;
+        BinaryLog::ReadVarint(bytes, position, argument);
+        char digits[24];
+        char* end = std::to_chars(digits, digits + sizeof(digits), argument).ptr;
+        text.append(digits, end);
+        format.remove_prefix(slot + 1);
+    }
+
+    return {index.time, static_cast<size_t>(message.thread), message.level, text};
+}
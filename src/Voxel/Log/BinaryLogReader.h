@@ -0,0 +1,59 @@
+#pragma once
+#include <Voxel/pch.h>
+#include <Voxel/Log/LogFilter.h>
+#include <Voxel/Log/MemoryTracker.h>
+#include <Voxel/Memory/MappedFile.h>
+
+// Opens a session log written by BinaryLogSink for the log panel. The file is memory mapped and
+// indexed with one pass over it, messages are only rebuilt from their format and arguments when
+// they are shown or searched. A file cut short, by a crash for example, loads up to the last
+// complete message.
+class BinaryLogReader final : public LogRowSource {
+  public:
+    static bool Load(const std::filesystem::path& path, BinaryLogReader& outReader);
+
+    uint64_t GetFirstRow() const override { return 0; }
+    uint64_t GetEndRow() const override { return rows.size(); }
+    LogRow GetRow(uint64_t row) const override;
+    size_t GetLevelCount(spdlog::level::level_enum level) const override {
+        return levelCounts[level];
+    }
+    const std::vector<size_t>& GetThreads() const override { return threads; }
+
+    const std::filesystem::path& GetPath() const { return file.GetPath(); }
+    size_t GetFileSize() const { return file.GetBytes().size(); }
+    size_t GetFormatCount() const { return formats.size(); }
+    bool IsTruncated() const { return truncated; }
+
+  private:
+    struct RowIndex {
+        // Of the kind byte
+        uint64_t offset;
+        int64_t time;
+    };
+
+    struct Format {
+        std::string_view text;
+        uint32_t argumentCount;
+    };
+
+    struct Message {
+        spdlog::level::level_enum level;
+        int64_t timeDelta;
+        uint64_t thread;
+        uint64_t format;
+    };
+
+    // Reads a message record up to its arguments, false if it is cut short or malformed
+    bool ReadMessage(size_t& position, Message& outMessage) const;
+    bool Index();
+
+    MappedFile file;
+    TrackedVector<RowIndex, MemoryTag::Logging> rows;
+    TrackedVector<Format, MemoryTag::Logging> formats;
+    std::array<size_t, spdlog::level::n_levels> levelCounts{};
+    std::vector<size_t> threads;
+    bool truncated = false;
+    // Text of the last row read
+    mutable std::string text;
+};
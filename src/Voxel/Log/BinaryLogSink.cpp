@@ -0,0 +1,158 @@
+#include "BinaryLogSink.h"
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <charconv>
+#include <chrono>
+
+#if defined(_WIN32) || defined(_WIN64)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+namespace {
+int64_t ToNanoseconds(std::chrono::system_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+} // namespace
+
+BinaryLogSink::BinaryLogSink(const std::filesystem::path& path)
+    : path(path), lastTime(ToNanoseconds(std::chrono::system_clock::now())) {
+    std::error_code ec;
+    if (path.has_parent_path())
+        std::filesystem::create_directories(path.parent_path(), ec);
+
+    // Created here and never truncated, so another session's file is never written over. Its
+    // handle stays open: Windows then refuses exclusive opens, elsewhere it holds a flock.
+#if defined(_WIN32) || defined(_WIN64)
+    HANDLE handle = CreateFileW(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                nullptr, CREATE_NEW, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+        throw spdlog::spdlog_ex("Unable to create session log " + path.string());
+    lockHandle = handle;
+#else
+    lockDescriptor = open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (lockDescriptor < 0)
+        throw spdlog::spdlog_ex("Unable to create session log " + path.string());
+    flock(lockDescriptor, LOCK_EX | LOCK_NB);
+#endif
+
+    // In and out opens without truncating
+    file.open(path, std::ios::in | std::ios::out | std::ios::binary);
+    if (!file.is_open()) {
+        ReleaseLock();
+        throw spdlog::spdlog_ex("Unable to create session log " + path.string());
+    }
+
+    BinaryLog::Header header{BinaryLog::magic, BinaryLog::version, 0, lastTime};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    bytesWritten = sizeof(header);
+}
+
+BinaryLogSink::~BinaryLogSink() {
+    file.close();
+    ReleaseLock();
+}
+
+void BinaryLogSink::ReleaseLock() {
+#if defined(_WIN32) || defined(_WIN64)
+    if (lockHandle)
+        CloseHandle(lockHandle);
+    lockHandle = nullptr;
+#else
+    if (lockDescriptor >= 0)
+        close(lockDescriptor);
+    lockDescriptor = -1;
+#endif
+}
+
+bool BinaryLogSink::IsRecording(const std::filesystem::path& path) {
+#if defined(_WIN32) || defined(_WIN64)
+    // Sharing nothing fails while any other handle is open
+    HANDLE handle = CreateFileW(path.c_str(), GENERIC_READ, 0, nullptr, OPEN_EXISTING,
+                                FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+        return GetLastError() == ERROR_SHARING_VIOLATION;
+    CloseHandle(handle);
+    return false;
+#else
+    int descriptor = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (descriptor < 0)
+        return false;
+    bool locked = flock(descriptor, LOCK_EX | LOCK_NB) != 0;
+    close(descriptor);
+    return locked;
+#endif
+}
+
+void BinaryLogSink::sink_it_(const spdlog::details::log_msg& msg) {
+    ExtractFormat(std::string_view(msg.payload.data(), msg.payload.size()));
+    uint64_t formatId = InternFormat();
+
+    int64_t time = ToNanoseconds(msg.time);
+    record.push_back(static_cast<uint8_t>(msg.level));
+    // Threads take their timestamps before the logger orders them, so deltas can be negative
+    BinaryLog::WriteVarint(record, BinaryLog::ZigZagEncode(time - lastTime));
+    BinaryLog::WriteVarint(record, msg.thread_id);
+    BinaryLog::WriteVarint(record, formatId);
+    for (uint64_t argument : arguments)
+        BinaryLog::WriteVarint(record, argument);
+    lastTime = time;
+
+    file.write(reinterpret_cast<const char*>(record.data()),
+               static_cast<std::streamsize>(record.size()));
+    bytesWritten += record.size();
+    record.clear();
+}
+
+void BinaryLogSink::flush_() { file.flush(); }
+
+void BinaryLogSink::ExtractFormat(std::string_view message) {
+    format.clear();
+    arguments.clear();
+
+    size_t i = 0;
+    while (i < message.size()) {
+        if (!IsDigit(message[i])) {
+            format.push_back(message[i] == BinaryLog::argumentSlot ? '?' : message[i]);
+            i++;
+            continue;
+        }
+
+        size_t end = i;
+        while (end < message.size() && IsDigit(message[end]))
+            end++;
+
+        // Leading zeros wouldn't survive the round trip, so those digits stay in the format
+        size_t digits = end - i;
+        if (digits <= BinaryLog::maxArgumentDigits && (message[i] != '0' || digits == 1)) {
+            uint64_t value = 0;
+            std::from_chars(message.data() + i, message.data() + end, value);
+            arguments.push_back(value);
+            format.push_back(BinaryLog::argumentSlot);
+        } else {
+            format.append(message.substr(i, digits));
+        }
+        i = end;
+    }
+}
+
+uint64_t BinaryLogSink::InternFormat() {
+    auto it = formatIds.find(format);
+    if (it != formatIds.end())
+        return it->second;
+
+    uint64_t id = formatIds.size();
+    formatIds.emplace(format, id);
+
+    record.push_back(BinaryLog::stringKind);
+    BinaryLog::WriteVarint(record, format.size());
+    record.insert(record.end(), format.begin(), format.end());
+    return id;
+}
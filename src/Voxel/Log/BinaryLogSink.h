@@ -0,0 +1,55 @@
+#pragma once
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <spdlog/sinks/base_sink.h>
+#include <Voxel/Log/BinaryLogFormat.h>
+#include <Voxel/Log/MemoryTracker.h>
+
+// Records the session to a compact .vlog file (see BinaryLogFormat.h) that the log panel can
+// open later. Formats are interned for the session, so most messages cost a few bytes of
+// varints. Throws spdlog_ex when the file can't be created or already exists, like spdlog's own
+// file sinks. The file stays locked while the sink records to it, see IsRecording.
+class BinaryLogSink final : public spdlog::sinks::base_sink<std::mutex> {
+  public:
+    explicit BinaryLogSink(const std::filesystem::path& path);
+    ~BinaryLogSink() override;
+
+    BinaryLogSink(const BinaryLogSink&) = delete;
+    BinaryLogSink& operator=(const BinaryLogSink&) = delete;
+
+    // Whether a sink, in this process or another, is still recording to the file
+    static bool IsRecording(const std::filesystem::path& path);
+
+    const std::filesystem::path& GetPath() const { return path; }
+    // Includes the header and the string table
+    uint64_t GetBytesWritten() const { return bytesWritten; }
+
+  protected:
+    void sink_it_(const spdlog::details::log_msg& msg) override;
+    void flush_() override;
+
+  private:
+    // Splits the message into format and arguments
+    void ExtractFormat(std::string_view message);
+    uint64_t InternFormat();
+    void ReleaseLock();
+
+    std::filesystem::path path;
+    std::ofstream file;
+    // Held open for the lock that marks the file as being recorded
+#if defined(_WIN32) || defined(_WIN64)
+    void* lockHandle = nullptr;
+#else
+    int lockDescriptor = -1;
+#endif
+    int64_t lastTime;
+    uint64_t bytesWritten = 0;
+
+    TrackedUnorderedMap<std::string, uint64_t, MemoryTag::Logging> formatIds;
+    // Scratch space reused by every message
+    std::string format;
+    TrackedVector<uint64_t, MemoryTag::Logging> arguments;
+    TrackedVector<uint8_t, MemoryTag::Logging> record;
+};
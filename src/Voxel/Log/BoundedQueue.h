@@ -0,0 +1,94 @@
+#pragma once
+#include <Voxel/pch.h>
+#include <atomic>
+#include <bit>
+#include <Voxel/Log/MemoryTracker.h>
+
+// Fixed-capacity lock-free multi-producer multi-consumer queue (Dmitry Vyukov's bounded queue).
+// Each cell's sequence says whether it is free for the producer or filled for the consumer at a
+// given position, so pushes and pops only contend on their own position counter.
+template <typename T, MemoryTag Tag> class BoundedQueue {
+  public:
+    // Rounded up to a power of two
+    explicit BoundedQueue(size_t requestedCapacity)
+        : cells(std::bit_ceil(std::max<size_t>(requestedCapacity, 2))), mask(cells.size() - 1) {
+        for (size_t i = 0; i < cells.size(); i++)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    // False when the queue is full
+    template <typename U> bool TryPush(U&& value) {
+        size_t position = enqueuePosition.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells[position & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+            if (difference == 0) {
+                if (enqueuePosition.compare_exchange_weak(position, position + 1,
+                                                          std::memory_order_relaxed))
+                    break;
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = std::forward<U>(value);
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // False when the queue is empty
+    bool TryPop(T& outValue) {
+        size_t position = dequeuePosition.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells[position & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t difference =
+                static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+
+            if (difference == 0) {
+                if (dequeuePosition.compare_exchange_weak(position, position + 1,
+                                                          std::memory_order_relaxed))
+                    break;
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = dequeuePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        outValue = std::move(cell->value);
+        cell->sequence.store(position + mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Only exact while no other thread is pushing or popping
+    size_t GetSizeApprox() const {
+        size_t enqueued = enqueuePosition.load(std::memory_order_relaxed);
+        size_t dequeued = dequeuePosition.load(std::memory_order_relaxed);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+    size_t GetCapacity() const { return mask + 1; }
+
+  private:
+    struct Cell {
+        std::atomic<size_t> sequence{0};
+        T value;
+    };
+
+    TrackedVector<Cell, Tag> cells;
+    size_t mask;
+
+    // Kept on separate cache lines so producers and the consumer don't false share
+    alignas(64) std::atomic<size_t> enqueuePosition{0};
+    alignas(64) std::atomic<size_t> dequeuePosition{0};
+};
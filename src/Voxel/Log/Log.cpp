@@ -1,20 +1,150 @@
 #include "Log.h"
+#include <chrono>
+#include <ctime>
+#include <format>
+#if defined(_WIN32) || defined(_WIN64)
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+#include <spdlog/sinks/rotating_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/spdlog.h>
+#include <Voxel/EditorSettings.h>
+#include <Voxel/Log/BinaryLogFormat.h>
+#include <Voxel/Log/BinaryLogSink.h>
 std::shared_ptr<spdlog::logger> Log::Logger;
 
+namespace {
+const char* formatString = "%^[%Y-%m-%d] [%T.%e] [T%t] [%l] %v%$";
+// Same without the colour range markers
+const char* fileFormatString = "[%Y-%m-%d] [%T.%e] [T%t] [%l] %v";
+
+// Milliseconds and the process id keep sessions started in the same second apart
+std::filesystem::path MakeSessionPath(const std::filesystem::path& directory) {
+    auto now = std::chrono::system_clock::now();
+    std::time_t seconds = std::chrono::system_clock::to_time_t(now);
+    int milliseconds = static_cast<int>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() %
+        1000);
+    std::tm tm{};
+#if defined(_WIN32) || defined(_WIN64)
+    localtime_s(&tm, &seconds);
+    int pid = _getpid();
+#else
+    localtime_r(&seconds, &tm);
+    int pid = static_cast<int>(getpid());
+#endif
+    return directory / std::format("session_{:04}{:02}{:02}_{:02}{:02}{:02}_{:03}_{}{}",
+                                   tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour,
+                                   tm.tm_min, tm.tm_sec, milliseconds, pid, BinaryLog::extension);
+}
+
+// Deletes the oldest session logs so at most `keep` remain, leaving those another running
+// instance is still recording
+void PruneSessions(const std::filesystem::path& directory, size_t keep) {
+    std::vector<std::filesystem::path> sessions = Log::ListSessions(directory);
+    std::error_code ec;
+    for (size_t i = keep; i < sessions.size(); i++) {
+        if (!BinaryLogSink::IsRecording(sessions[i]))
+            std::filesystem::remove(sessions[i], ec);
+    }
+}
+} // namespace
+
 void Log::Init() {
     Logger = spdlog::stdout_color_mt("VOXEL");
-    const char* formatString = "%^[%Y-%m-%d] [%T.%e] [T%t] [%l] %v%$";
     Logger->set_pattern(formatString);
-    imguiSink = std::make_shared<ImGuiSinkMT>();
-    imguiSink.get()->set_pattern(formatString);
+    consoleSink = Logger->sinks().front();
+    imguiSink = std::make_shared<ImGuiLogSink>();
     Logger->sinks().push_back(imguiSink);
     Logger->set_level(spdlog::level::trace);
 
     LOG_INFO("Logger has initialised");
 }
 
+void Log::ApplySettings() {
+    std::vector<spdlog::sink_ptr> outputs = {consoleSink};
+
+    if (EditorSettings::GetBool("Logging", "File", true)) {
+        std::string path = EditorSettings::GetString("Logging", "FilePath", "logs/voxel.log");
+        size_t maxBytes =
+            static_cast<size_t>(std::max(EditorSettings::GetInt("Logging", "MaxFileSizeMB", 10), 1))
+            << 20;
+        size_t maxFiles =
+            static_cast<size_t>(std::max(EditorSettings::GetInt("Logging", "MaxFiles", 3), 1));
+        try {
+            auto fileSink =
+                std::make_shared<spdlog::sinks::rotating_file_sink_mt>(path, maxBytes, maxFiles);
+            fileSink->set_pattern(fileFormatString);
+            outputs.push_back(fileSink);
+        } catch (const spdlog::spdlog_ex& exception) {
+            LOG_WARN("Unable to open log file {}: {}", path, exception.what());
+        }
+    }
+
+    if (EditorSettings::GetBool("Logging", "Session", true)) {
+        std::filesystem::path directory =
+            EditorSettings::GetString("Logging", "SessionDirectory", "logs");
+        // Room for the one about to be created
+        size_t maxSessions =
+            static_cast<size_t>(std::max(EditorSettings::GetInt("Logging", "MaxSessions", 10), 1));
+        PruneSessions(directory, maxSessions - 1);
+        try {
+            auto sessionSink = std::make_shared<BinaryLogSink>(MakeSessionPath(directory));
+            sessionPath = sessionSink->GetPath();
+            outputs.push_back(sessionSink);
+        } catch (const spdlog::spdlog_ex& exception) {
+            LOG_WARN("Unable to record the session: {}", exception.what());
+        }
+    }
+
+    std::vector<spdlog::sink_ptr>& sinks = Logger->sinks();
+    sinks.assign({imguiSink});
+
+    if (EditorSettings::GetBool("Logging", "Async", true)) {
+        size_t queueSize =
+            static_cast<size_t>(std::max(EditorSettings::GetInt("Logging", "QueueSize", 8192), 2));
+        LogOverflowPolicy policy =
+            AsyncLogSink::ParsePolicy(EditorSettings::GetString("Logging", "OverflowPolicy"));
+        asyncSink = std::make_shared<AsyncLogSink>(std::move(outputs), queueSize, policy);
+        sinks.push_back(asyncSink);
+        LOG_INFO("Logging asynchronously, queue of {}", asyncSink->GetCapacity());
+    } else {
+        sinks.insert(sinks.end(), outputs.begin(), outputs.end());
+    }
+}
+
+void Log::Shutdown() {
+    if (!asyncSink)
+        return;
+
+    if (asyncSink->GetDroppedCount() > 0)
+        LOG_WARN("Dropped {} log messages on a full queue", asyncSink->GetDroppedCount());
+
+    std::vector<spdlog::sink_ptr>& sinks = Logger->sinks();
+    sinks.erase(std::remove(sinks.begin(), sinks.end(), asyncSink), sinks.end());
+    // Joins the backend once the queue is written out
+    asyncSink.reset();
+    sinks.push_back(consoleSink);
+}
+
 std::shared_ptr<spdlog::logger>& Log::GetLogger() { return Logger; }
 
-std::shared_ptr<ImGuiSinkMT> Log::GetImGuiLogSink() { return imguiSink; }
+std::shared_ptr<ImGuiLogSink> Log::GetImGuiLogSink() { return imguiSink; }
+
+std::shared_ptr<AsyncLogSink> Log::GetAsyncSink() { return asyncSink; }
+
+const std::filesystem::path& Log::GetSessionPath() { return sessionPath; }
+
+std::vector<std::filesystem::path> Log::ListSessions(const std::filesystem::path& directory) {
+    std::vector<std::filesystem::path> sessions;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+        if (entry.is_regular_file(ec) && entry.path().extension() == BinaryLog::extension)
+            sessions.push_back(entry.path());
+    }
+    // Names start with the date and time
+    std::sort(sessions.begin(), sessions.end(), std::greater<>());
+    return sessions;
+}
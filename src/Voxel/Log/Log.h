@@ -1,7 +1,10 @@
 #pragma once
+#include <filesystem>
 #include <memory>
+#include <vector>
 #include <spdlog/logger.h>
 #include <spdlog/spdlog.h>
+#include <Voxel/Log/AsyncLogSink.h>
 #include <Voxel/Log/LogSink.h>
 
 #define LOG_TRACE(...) Log::GetLogger()->trace(__VA_ARGS__)
@@ -12,11 +15,28 @@
 
 class Log {
   public:
+    // Logs synchronously to the console until ApplySettings
     static void Init();
+    // Sets up the [Logging] editor settings: async backend, overflow policy and the rotating log
+    // file. Call once EditorSettings is loaded and before other threads start logging.
+    static void ApplySettings();
+    // Writes out queued messages and stops the backend thread, later messages are written to the
+    // console synchronously
+    static void Shutdown();
+
     static std::shared_ptr<spdlog::logger>& GetLogger();
-    static std::shared_ptr<ImGuiSinkMT> GetImGuiLogSink();
+    static std::shared_ptr<ImGuiLogSink> GetImGuiLogSink();
+    // nullptr when logging synchronously
+    static std::shared_ptr<AsyncLogSink> GetAsyncSink();
+    // Session log being recorded, empty when [Logging] Session is off
+    static const std::filesystem::path& GetSessionPath();
+    // Session logs in the directory, newest first
+    static std::vector<std::filesystem::path> ListSessions(const std::filesystem::path& directory);
 
   private:
     static std::shared_ptr<spdlog::logger> Logger;
-    static inline std::shared_ptr<ImGuiSinkMT> imguiSink;
+    static inline std::shared_ptr<ImGuiLogSink> imguiSink;
+    static inline std::shared_ptr<AsyncLogSink> asyncSink;
+    static inline spdlog::sink_ptr consoleSink;
+    static inline std::filesystem::path sessionPath;
 };
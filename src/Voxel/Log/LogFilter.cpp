@@ -0,0 +1,182 @@
+#include "LogFilter.h"
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+
+namespace {
+// Evicted matches are compacted away once they make up half the index
+constexpr size_t compactThreshold = 4096;
+} // namespace
+
+LogTextSearch::LogTextSearch(std::string_view pattern, bool foldCase) : pattern(pattern) {
+    for (size_t c = 0; c < fold.size(); c++)
+        fold[c] = static_cast<uint8_t>(foldCase ? std::tolower(static_cast<int>(c)) : c);
+    for (char& c : this->pattern)
+        c = static_cast<char>(fold[static_cast<uint8_t>(c)]);
+
+    skip.fill(pattern.size());
+    for (size_t i = 0; i + 1 < pattern.size(); i++)
+        skip[static_cast<uint8_t>(this->pattern[i])] = pattern.size() - 1 - i;
+}
+
+bool LogTextSearch::Find(std::string_view text) const {
+    size_t length = pattern.size();
+    if (length == 0)
+        return true;
+
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(text.data());
+    const uint8_t* folded = reinterpret_cast<const uint8_t*>(pattern.data());
+    size_t last = length - 1;
+    for (size_t position = 0; position + length <= text.size();
+         position += skip[fold[bytes[position + last]]]) {
+        size_t i = last;
+        while (fold[bytes[position + i]] == folded[i]) {
+            if (i == 0)
+                return true;
+            i--;
+        }
+    }
+    return false;
+}
+
+void LogFilterIndex::SetSource(const LogRowSource* newSource) {
+    source = newSource;
+    matches.clear();
+    matchStart = 0;
+    candidates.clear();
+    candidateNext = 0;
+    scanRow = source ? source->GetFirstRow() : 0;
+    scanStart = scanRow;
+}
+
+void LogFilterIndex::SetFilter(const LogFilter& newFilter) {
+    if (newFilter == filter)
+        return;
+
+    // Rows failing the old filter fail the new one too, so only previous matches are rechecked.
+    // Those are the matches so far followed by the candidates left from a previous narrowing.
+    bool narrowing = error.empty() && IsNarrowing(newFilter);
+    if (narrowing) {
+        TrackedVector<uint64_t, MemoryTag::Logging> previous;
+        previous.reserve(GetMatchCount() + candidates.size() - candidateNext);
+        previous.insert(previous.end(), matches.begin() + matchStart, matches.end());
+        previous.insert(previous.end(), candidates.begin() + candidateNext, candidates.end());
+        candidates.swap(previous);
+    } else {
+        candidates.clear();
+        scanRow = source ? source->GetFirstRow() : 0;
+    }
+    candidateNext = 0;
+    scanStart = scanRow;
+    matches.clear();
+    matchStart = 0;
+
+    filter = newFilter;
+    textSearch.reset();
+    regex.reset();
+    error.clear();
+    if (filter.search.empty())
+        return;
+
+    if (filter.regex) {
+        auto flags = std::regex::ECMAScript | std::regex::optimize;
+        if (!filter.caseSensitive)
+            flags |= std::regex::icase;
+        try {
+            regex.emplace(filter.search, flags);
+        } catch (const std::regex_error& e) {
+            error = e.what();
+        }
+    } else {
+        textSearch.emplace(filter.search, !filter.caseSensitive);
+    }
+}
+
+bool LogFilterIndex::IsNarrowing(const LogFilter& newFilter) const {
+    if (filter.regex || newFilter.regex || filter.caseSensitive != newFilter.caseSensitive)
+        return false;
+    if ((newFilter.levelMask & ~filter.levelMask) != 0)
+        return false;
+    if (filter.thread && filter.thread != newFilter.thread)
+        return false;
+
+    // Text containing the new search contains the old one as well
+    return LogTextSearch(filter.search, !filter.caseSensitive).Find(newFilter.search);
+}
+
+bool LogFilterIndex::Matches(const LogRow& row) const {
+    if ((filter.levelMask & (1u << row.level)) == 0)
+        return false;
+    if (filter.thread && *filter.thread != row.thread_id)
+        return false;
+    if (!error.empty())
+        return false;
+
+    if (regex)
+        return std::regex_search(row.text.begin(), row.text.end(), *regex);
+    if (textSearch)
+        return textSearch->Find(row.text);
+    return true;
+}
+
+void LogFilterIndex::DropEvicted() {
+    uint64_t firstRow = source->GetFirstRow();
+    scanRow = std::max(scanRow, firstRow);
+
+    while (matchStart < matches.size() && matches[matchStart] < firstRow)
+        matchStart++;
+    if (matchStart == matches.size() ||
+        (matchStart >= compactThreshold && matchStart * 2 >= matches.size())) {
+        matches.erase(matches.begin(), matches.begin() + matchStart);
+        matchStart = 0;
+    }
+}
+
+bool LogFilterIndex::IsFiltering() const {
+    return source && (candidateNext < candidates.size() || scanRow < source->GetEndRow());
+}
+
+bool LogFilterIndex::Update(std::chrono::microseconds budget) {
+    if (!source)
+        return true;
+    DropEvicted();
+
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point deadline = Clock::now() + budget;
+    // Reading the clock for every row would cost more than matching most of them
+    size_t rows = 0;
+    auto outOfTime = [&rows, deadline]() {
+        return (++rows & 255) == 0 && Clock::now() >= deadline;
+    };
+
+    uint64_t firstRow = source->GetFirstRow();
+    while (candidateNext < candidates.size()) {
+        uint64_t row = candidates[candidateNext++];
+        if (row >= firstRow && Matches(source->GetRow(row)))
+            matches.push_back(row);
+        if (outOfTime())
+            return false;
+    }
+    candidates.clear();
+    candidateNext = 0;
+
+    uint64_t endRow = source->GetEndRow();
+    while (scanRow < endRow) {
+        if (Matches(source->GetRow(scanRow)))
+            matches.push_back(scanRow);
+        scanRow++;
+        if (outOfTime())
+            return false;
+    }
+    return true;
+}
+
+float LogFilterIndex::GetProgress() const {
+    if (!source)
+        return 1.0f;
+    uint64_t endRow = source->GetEndRow();
+    uint64_t scanned = scanRow - std::min(scanStart, scanRow);
+    uint64_t total = candidates.size() + (endRow - std::min(scanStart, endRow));
+    if (total == 0)
+        return 1.0f;
+    return static_cast<float>(candidateNext + scanned) / static_cast<float>(total);
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include <Voxel/pch.h>
+#include <chrono>
+#include <optional>
+#include <regex>
+#include <string_view>
+#include <spdlog/common.h>
+#include <Voxel/Log/LogSink.h>
+#include <Voxel/Log/MemoryTracker.h>
+
+// One message as shown by the log panel
+struct LogRow {
+    int64_t time;
+    size_t thread_id;
+    spdlog::level::level_enum level;
+    std::string_view text;
+
+    std::tm GetLocalTime() const { return LogEntry::ToLocalTime(time); }
+    long GetMilliseconds() const { return static_cast<long>(time / 1000000 % 1000); }
+};
+
+// Messages the log panel can browse: the live history or a recorded session
+class LogRowSource {
+  public:
+    virtual ~LogRowSource() = default;
+
+    // Rows [first, end) can be read, both only ever grow
+    virtual uint64_t GetFirstRow() const = 0;
+    virtual uint64_t GetEndRow() const = 0;
+    // The text stays valid until the next call
+    virtual LogRow GetRow(uint64_t row) const = 0;
+
+    virtual size_t GetLevelCount(spdlog::level::level_enum level) const = 0;
+    // Threads seen so far, in order of their first message
+    virtual const std::vector<size_t>& GetThreads() const = 0;
+};
+
+struct LogFilter {
+    // Bit per spdlog level
+    uint32_t levelMask = ~0u;
+    // Every thread when empty
+    std::optional<size_t> thread;
+    std::string search;
+    bool regex = false;
+    bool caseSensitive = false;
+
+    bool operator==(const LogFilter&) const = default;
+};
+
+// Boyer-Moore-Horspool substring search over bytes, optionally ignoring ASCII case
+class LogTextSearch {
+  public:
+    LogTextSearch(std::string_view pattern, bool foldCase);
+
+    bool Find(std::string_view text) const;
+
+  private:
+    // Pattern with case already folded
+    std::string pattern;
+    std::array<uint8_t, 256> fold;
+    // How far the window can move when its last byte is the index
+    std::array<size_t, 256> skip;
+};
+
+// Index of the rows of a LogRowSource passing a filter, main thread only. New rows are checked
+// as they come in. Changing the filter rescans the source in slices of a time budget per frame,
+// and typing more of the same search only rechecks the rows that matched before.
+class LogFilterIndex {
+  public:
+    explicit LogFilterIndex(const LogRowSource* source = nullptr) : source(source) {}
+
+    // Starts over on another source, keeping the filter
+    void SetSource(const LogRowSource* newSource);
+    const LogRowSource* GetSource() const { return source; }
+
+    void SetFilter(const LogFilter& newFilter);
+    const LogFilter& GetFilter() const { return filter; }
+    // Drops evicted rows and filters new ones until done or out of budget, returns true when the
+    // index is complete
+    bool Update(std::chrono::microseconds budget);
+    bool IsFiltering() const;
+    // 0 to 1 while rescanning after a filter change
+    float GetProgress() const;
+    // Set when the search is an invalid regex, nothing matches until it is fixed
+    const std::string& GetError() const { return error; }
+
+    size_t GetMatchCount() const { return matches.size() - matchStart; }
+    // Matches are ordered oldest first
+    LogRow GetMatch(size_t match) const { return source->GetRow(matches[matchStart + match]); }
+
+  private:
+    bool Matches(const LogRow& row) const;
+    bool IsNarrowing(const LogFilter& newFilter) const;
+    void DropEvicted();
+
+    const LogRowSource* source;
+    LogFilter filter;
+    std::optional<LogTextSearch> textSearch;
+    std::optional<std::regex> regex;
+    std::string error;
+
+    // Rows passing the filter, for the rows before scanRow. Evicted rows are skipped through
+    // matchStart and compacted away now and then.
+    TrackedVector<uint64_t, MemoryTag::Logging> matches;
+    size_t matchStart = 0;
+    uint64_t scanRow = 0;
+    // Previous matches still to be rechecked after narrowing the search
+    TrackedVector<uint64_t, MemoryTag::Logging> candidates;
+    size_t candidateNext = 0;
+    uint64_t scanStart = 0;
+};
@@ -0,0 +1,56 @@
+#include "LogHistory.h"
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <bit>
+
+LogHistory::LogHistory(size_t capacity)
+    : capacity(std::bit_ceil(std::max(capacity, minCapacity))),
+      textCapacity(this->capacity * textBytesPerRecord) {}
+
+void LogHistory::Append(const LogEntry& entry) {
+    // Messages never wrap around the end of the text ring
+    uint64_t offset = textEnd;
+    if (offset % textCapacity + entry.length > textCapacity)
+        offset += textCapacity - offset % textCapacity;
+    uint64_t newTextEnd = offset + entry.length;
+
+    while (firstIndex < endIndex &&
+           (GetSize() == capacity || GetRecord(firstIndex).textOffset + textCapacity < newTextEnd))
+        EvictOldest();
+
+    size_t position = static_cast<size_t>(offset % textCapacity);
+    if (position + entry.length > text.size())
+        text.resize(std::min(textCapacity, std::max(position + entry.length, text.size() * 2)));
+    std::memcpy(text.data() + position, entry.message, entry.length);
+    textEnd = newTextEnd;
+
+    LogRecord record{entry.time, entry.thread_id, offset, entry.length, entry.level};
+    if (endIndex < capacity)
+        records.push_back(record);
+    else
+        records[endIndex & (capacity - 1)] = record;
+    endIndex++;
+
+    levelCounts[record.level]++;
+    if (std::find(threads.begin(), threads.end(), record.thread_id) == threads.end())
+        threads.push_back(record.thread_id);
+}
+
+void LogHistory::Clear() {
+    firstIndex = endIndex;
+    lost = 0;
+    levelCounts = {};
+    threads.clear();
+}
+
+void LogHistory::EvictOldest() {
+    levelCounts[GetRecord(firstIndex).level]--;
+    firstIndex++;
+}
+
+LogRow LogHistory::GetRow(uint64_t row) const {
+    const LogRecord& record = GetRecord(row);
+    std::string_view message(text.data() + (record.textOffset & (textCapacity - 1)),
+                             record.length);
+    return {record.time, record.thread_id, record.level, message};
+}
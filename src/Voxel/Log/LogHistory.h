@@ -0,0 +1,63 @@
+#pragma once
+#include <Voxel/pch.h>
+#include <Voxel/Log/LogFilter.h>
+#include <Voxel/Log/LogSink.h>
+#include <Voxel/Log/MemoryTracker.h>
+
+// Long term log history for the log panel, main thread only. Messages are drained from the
+// ImGuiLogSink ring every frame and kept here, up to `capacity` messages (at least minCapacity,
+// rounded up to a power of two) and an average of textBytesPerRecord bytes of text per message,
+// whichever runs out first evicts the oldest.
+class LogHistory final : public LogRowSource {
+  public:
+    static constexpr size_t textBytesPerRecord = 64;
+    // Fewest messages kept, so the text ring always holds the longest message
+    static constexpr size_t minCapacity =
+        (LogEntry::maxMessageLength + textBytesPerRecord) / textBytesPerRecord;
+    static_assert(minCapacity * textBytesPerRecord >= LogEntry::maxMessageLength + 1,
+                  "the text ring must fit a whole message");
+
+    explicit LogHistory(size_t capacity);
+
+    void Append(const LogEntry& entry);
+    // Count of messages that were overwritten in the sink before they could be drained
+    void AddLost(uint64_t count) { lost += count; }
+    void Clear();
+
+    uint64_t GetFirstRow() const override { return firstIndex; }
+    uint64_t GetEndRow() const override { return endIndex; }
+    LogRow GetRow(uint64_t row) const override;
+    size_t GetLevelCount(spdlog::level::level_enum level) const override {
+        return levelCounts[level];
+    }
+    const std::vector<size_t>& GetThreads() const override { return threads; }
+
+    size_t GetSize() const { return static_cast<size_t>(endIndex - firstIndex); }
+    size_t GetCapacity() const { return capacity; }
+    uint64_t GetLostCount() const { return lost; }
+
+  private:
+    // The text lives in the text ring
+    struct LogRecord {
+        int64_t time;
+        size_t thread_id;
+        uint64_t textOffset;
+        uint16_t length;
+        spdlog::level::level_enum level;
+    };
+
+    const LogRecord& GetRecord(uint64_t index) const { return records[index & (capacity - 1)]; }
+    void EvictOldest();
+
+    size_t capacity;
+    size_t textCapacity;
+    TrackedVector<LogRecord, MemoryTag::Logging> records;
+    TrackedVector<char, MemoryTag::Logging> text;
+    // Records [firstIndex, endIndex) are live, text is addressed by offsets that only grow
+    uint64_t firstIndex = 0;
+    uint64_t endIndex = 0;
+    uint64_t textEnd = 0;
+    uint64_t lost = 0;
+    std::array<size_t, spdlog::level::n_levels> levelCounts{};
+    std::vector<size_t> threads;
+};
@@ -1,64 +1,127 @@
-#include <deque>
-#include <mutex>
-#include <spdlog/logger.h>
-#include <spdlog/pattern_formatter.h>
-#include <spdlog/sinks/base_sink.h>
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <string_view>
+#include <spdlog/sinks/sink.h>
 #include <spdlog/spdlog.h>
+#include <Voxel/Log/MemoryTracker.h>
 
+// A message as stored by the ImGui sink. The text is stored inline so logging never allocates,
+// longer messages are truncated here while the other sinks still get them in full.
 struct LogEntry {
-    std::tm time;
-    long long ms;
+    // Sized so a ring slot is 256 bytes
+    static constexpr size_t maxMessageLength = 225;
+
+    // System clock, nanoseconds since the epoch
+    int64_t time;
     size_t thread_id;
     spdlog::level::level_enum level;
-    std::string message;
+    uint16_t length;
+    char message[maxMessageLength + 1];
+
+    std::string_view GetMessage() const { return {message, length}; }
+
+    std::tm GetLocalTime() const { return ToLocalTime(time); }
+    long GetMilliseconds() const { return static_cast<long>(time / 1000000 % 1000); }
+
+    static std::tm ToLocalTime(int64_t time) {
+        std::time_t seconds = static_cast<std::time_t>(time / 1000000000);
+        std::tm tm{};
+#if defined(_WIN32) || defined(_WIN64)
+        localtime_s(&tm, &seconds);
+#else
+        localtime_r(&seconds, &tm);
+#endif
+        return tm;
+    }
 };
 
-template <typename Mutex> class ImGuiLogSink : public spdlog::sinks::base_sink<Mutex> {
+// Hands the last `capacity` messages over to the log panel, which drains them into its
+// LogHistory every frame, through a fixed ring that any number of threads can write without
+// locking. Each writer claims a sequence number, then the slot itself by swapping the version of
+// an earlier published lap for its own odd one, fills it and publishes it with the even version.
+// A writer a whole lap behind, or one finding the slot still being written by another, drops its
+// message, so no two writers ever fill a slot at once. Readers check the version before and after
+// reading, so an entry that is being written or was overwritten meanwhile is skipped rather than
+// torn.
+class ImGuiLogSink final : public spdlog::sinks::sink {
   public:
-    std::deque<LogEntry> buffer;
-    std::mutex bufferMutex;
-    bool updated = false;
+    // Room for bursts of messages between two frames
+    static constexpr size_t capacity = 8192;
+    static_assert((capacity & (capacity - 1)) == 0, "capacity must be a power of two");
 
-    std::vector<LogEntry> GetBufferCopy() {
-        std::lock_guard<std::mutex> lock(bufferMutex);
-        return {buffer.begin(), buffer.end()};
-    }
+    ImGuiLogSink() : slots(capacity) {}
 
-    void ClearBuffer() {
-        std::lock_guard<std::mutex> lock(bufferMutex);
-        buffer.clear();
-        updated = true;
-    }
+    void log(const spdlog::details::log_msg& msg) override {
+        uint64_t sequence = head.fetch_add(1, std::memory_order_relaxed);
+        LogSlot& slot = slots[sequence & (capacity - 1)];
 
-  protected:
-    void sink_it_(const spdlog::details::log_msg& msg) override {
-        spdlog::memory_buf_t formatted;
-        this->formatter_->format(msg, formatted);
+        // Odd while writing, so readers ignore the slot until it is published and other writers
+        // leave it alone
+        uint64_t version = slot.version.load(std::memory_order_relaxed);
+        do {
+            if ((version & 1) != 0 || version >= WritingVersion(sequence))
+                return;
+        } while (!slot.version.compare_exchange_weak(version, WritingVersion(sequence),
+                                                     std::memory_order_acquire,
+                                                     std::memory_order_relaxed));
+        std::atomic_thread_fence(std::memory_order_release);
 
-        std::lock_guard<Mutex> lock(bufferMutex);
+        LogEntry& entry = slot.entry;
+        entry.time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         msg.time.time_since_epoch())
+                         .count();
+        entry.thread_id = msg.thread_id;
+        entry.level = msg.level;
+        size_t length = std::min(msg.payload.size(), LogEntry::maxMessageLength);
+        std::memcpy(entry.message, msg.payload.data(), length);
+        entry.message[length] = '\0';
+        entry.length = static_cast<uint16_t>(length);
 
-        auto tp = msg.time;
-        auto secs = std::chrono::time_point_cast<std::chrono::seconds>(tp);
-        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(tp - secs).count();
+        slot.version.store(PublishedVersion(sequence), std::memory_order_release);
+    }
 
-        auto tt = std::chrono::system_clock::to_time_t(secs);
-        std::tm tm{};
-#if defined(_WIN32) || defined(_WIN64)
-        localtime_s(&tm, &tt);
-#else
-        localtime_r(&tt, &tm);
-#endif
+    // Entries are stored raw and formatted by the panel
+    void flush() override {}
+    void set_pattern(const std::string&) override {}
+    void set_formatter(std::unique_ptr<spdlog::formatter>) override {}
 
-        buffer.push_back({tm, ms, msg.thread_id, msg.level,
-                          std::string(msg.payload.data(), msg.payload.size())});
+    // Sequence number the next message will get
+    uint64_t GetEndSequence() const { return head.load(std::memory_order_acquire); }
 
-        if (buffer.size() > 1000)
-            buffer.pop_front();
-        updated = true;
+    // Oldest sequence still in the ring, entries [first, end) can be read
+    uint64_t GetFirstSequence(uint64_t end) const {
+        uint64_t first = end > capacity ? end - capacity : 0;
+        return std::max(first, clearedBefore.load(std::memory_order_relaxed));
     }
 
-    void flush_() override {}
-};
+    // Copies out one entry, false if it isn't published yet or was overwritten by a newer one
+    bool ReadEntry(uint64_t sequence, LogEntry& outEntry) const {
+        const LogSlot& slot = slots[sequence & (capacity - 1)];
+        uint64_t expected = PublishedVersion(sequence);
+        if (slot.version.load(std::memory_order_acquire) != expected)
+            return false;
 
-using ImGuiSinkMT = ImGuiLogSink<std::mutex>;
-using ImGuiSinkST = ImGuiLogSink<spdlog::details::null_mutex>;
+        std::memcpy(&outEntry, &slot.entry, sizeof(LogEntry));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return slot.version.load(std::memory_order_relaxed) == expected;
+    }
+
+    // Hides everything logged so far from readers
+    void ClearBuffer() { clearedBefore.store(GetEndSequence(), std::memory_order_relaxed); }
+
+  private:
+    struct LogSlot {
+        std::atomic<uint64_t> version{0};
+        LogEntry entry;
+    };
+
+    static uint64_t WritingVersion(uint64_t sequence) { return sequence * 2 + 1; }
+    static uint64_t PublishedVersion(uint64_t sequence) { return sequence * 2 + 2; }
+
+    TrackedVector<LogSlot, MemoryTag::Logging> slots;
+    std::atomic<uint64_t> head{0};
+    std::atomic<uint64_t> clearedBefore{0};
+};
@@ -0,0 +1,50 @@
+#include "MemoryTracker.h"
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <cstdlib>
+#include <new>
+
+// Count every heap allocation so the profiler can show allocations per frame. Array and nothrow
+// forms forward to these. Aligned forms are left to the standard library and not counted.
+void* operator new(size_t size) {
+    MemoryTracker::CountHeapAllocation();
+    if (void* memory = std::malloc(size ? size : 1))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+
+void operator delete(void* memory, size_t) noexcept { std::free(memory); }
+
+void MemoryTracker::EndFrame() {
+    for (MemoryTagStats& tagStats : stats)
+        tagStats.previousFrameAllocations =
+            tagStats.frameAllocations.exchange(0, std::memory_order_relaxed);
+}
+
+const char* MemoryTracker::GetTagName(MemoryTag tag) {
+    switch (tag) {
+    case MemoryTag::ECS:
+        return "ECS";
+    case MemoryTag::Rendering:
+        return "Rendering";
+    case MemoryTag::UI:
+        return "UI";
+    case MemoryTag::Logging:
+        return "Logging";
+    case MemoryTag::Voxel:
+        return "Voxel";
+    case MemoryTag::Undo:
+        return "Undo";
+    case MemoryTag::FrameArena:
+        return "Frame Arena";
+    case MemoryTag::GpuBuffers:
+        return "GPU Buffers";
+    case MemoryTag::GpuTextures:
+        return "GPU Textures";
+    case MemoryTag::Count:
+        break;
+    }
+    return "Unknown";
+}
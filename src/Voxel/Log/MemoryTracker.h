@@ -0,0 +1,117 @@
+#pragma once
+#include <Voxel/pch.h>
+#include <atomic>
+#include <cstdint>
+#include <unordered_set>
+
+// Subsystems memory is accounted to. GPU tags count driver allocations, not host memory.
+enum class MemoryTag : uint8_t {
+    ECS,
+    Rendering,
+    UI,
+    Logging,
+    Voxel,
+    Undo,
+    FrameArena,
+    GpuBuffers,
+    GpuTextures,
+    Count
+};
+
+struct MemoryTagStats {
+    std::atomic<int64_t> liveBytes{0};
+    std::atomic<int64_t> peakBytes{0};
+    std::atomic<uint64_t> totalAllocations{0};
+    std::atomic<uint32_t> frameAllocations{0};
+    // Main thread only, updated by MemoryTracker::EndFrame
+    uint32_t previousFrameAllocations = 0;
+};
+
+// Live and peak bytes per tag. Counters are relaxed atomics so any thread can record, and the
+// storage is constant initialised so allocations made during static initialisation count too.
+class MemoryTracker {
+  public:
+    static void RecordAllocation(MemoryTag tag, size_t bytes) {
+        MemoryTagStats& tagStats = stats[static_cast<size_t>(tag)];
+        int64_t live = tagStats.liveBytes.fetch_add(static_cast<int64_t>(bytes),
+                                                    std::memory_order_relaxed) +
+                       static_cast<int64_t>(bytes);
+        tagStats.totalAllocations.fetch_add(1, std::memory_order_relaxed);
+        tagStats.frameAllocations.fetch_add(1, std::memory_order_relaxed);
+
+        int64_t peak = tagStats.peakBytes.load(std::memory_order_relaxed);
+        while (live > peak &&
+               !tagStats.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+            ;
+    }
+
+    static void RecordFree(MemoryTag tag, size_t bytes) {
+        stats[static_cast<size_t>(tag)].liveBytes.fetch_sub(static_cast<int64_t>(bytes),
+                                                            std::memory_order_relaxed);
+    }
+
+    // An allocation replaced in place, e.g. glBufferData on an existing buffer
+    static void RecordResize(MemoryTag tag, size_t oldBytes, size_t newBytes) {
+        RecordFree(tag, oldBytes);
+        RecordAllocation(tag, newBytes);
+    }
+
+    // Main thread, once per frame
+    static void EndFrame();
+
+    static const MemoryTagStats& GetStats(MemoryTag tag) {
+        return stats[static_cast<size_t>(tag)];
+    }
+    static const char* GetTagName(MemoryTag tag);
+
+    // Every heap allocation through global operator new, tagged or not, on any thread
+    static void CountHeapAllocation() { heapAllocations.fetch_add(1, std::memory_order_relaxed); }
+    // Heap allocations since the last call, main thread once per frame
+    static uint32_t ConsumeHeapAllocations() {
+        return heapAllocations.exchange(0, std::memory_order_relaxed);
+    }
+
+  private:
+    static inline std::array<MemoryTagStats, static_cast<size_t>(MemoryTag::Count)> stats;
+    static inline std::atomic<uint32_t> heapAllocations{0};
+};
+
+// Standard allocator that accounts every allocation to a MemoryTag
+template <typename T, MemoryTag Tag> struct TrackedAllocator {
+    using value_type = T;
+
+    // Needed explicitly, allocator_traits cannot rebind a non-type template parameter
+    template <typename U> struct rebind {
+        using other = TrackedAllocator<U, Tag>;
+    };
+
+    TrackedAllocator() = default;
+    template <typename U> TrackedAllocator(const TrackedAllocator<U, Tag>&) {}
+
+    T* allocate(size_t count) {
+        T* memory = std::allocator<T>().allocate(count);
+        MemoryTracker::RecordAllocation(Tag, count * sizeof(T));
+        return memory;
+    }
+
+    void deallocate(T* memory, size_t count) {
+        MemoryTracker::RecordFree(Tag, count * sizeof(T));
+        std::allocator<T>().deallocate(memory, count);
+    }
+
+    template <typename U> bool operator==(const TrackedAllocator<U, Tag>&) const { return true; }
+};
+
+template <typename T, MemoryTag Tag> using TrackedVector = std::vector<T, TrackedAllocator<T, Tag>>;
+
+template <typename Key, typename Value, MemoryTag Tag>
+using TrackedUnorderedMap =
+    std::unordered_map<Key, Value, std::hash<Key>, std::equal_to<Key>,
+                       TrackedAllocator<std::pair<const Key, Value>, Tag>>;
+
+template <typename Key, MemoryTag Tag>
+using TrackedUnorderedSet =
+    std::unordered_set<Key, std::hash<Key>, std::equal_to<Key>, TrackedAllocator<Key, Tag>>;
+
+template <MemoryTag Tag>
+using TrackedString = std::basic_string<char, std::char_traits<char>, TrackedAllocator<char, Tag>>;
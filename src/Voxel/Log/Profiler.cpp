@@ -0,0 +1,308 @@
+#include "Profiler.h"
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <ctime>
+#include <format>
+#include <iomanip>
+#include <Voxel/Log/MemoryTracker.h>
+
+namespace {
+// The contents of a JSON string: quotes and backslashes escaped, control characters as \u00XX
+void WriteJsonEscaped(std::ostream& file, std::string_view value) {
+    for (char c : value) {
+        if (c == '"' || c == '\\')
+            file << '\\' << c;
+        else if (static_cast<unsigned char>(c) < 0x20)
+            file << std::format("\\u{:04x}", static_cast<unsigned char>(c));
+        else
+            file << c;
+    }
+}
+} // namespace
+
+ProfileScopeId Profiler::RegisterScope(const char* name) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    auto it = std::find(scopeNames.begin(), scopeNames.end(), name);
+    if (it != scopeNames.end())
+        return static_cast<ProfileScopeId>(it - scopeNames.begin());
+
+    scopeNames.emplace_back(name);
+    return static_cast<ProfileScopeId>(scopeNames.size() - 1);
+}
+
+const char* Profiler::GetScopeName(ProfileScopeId scope) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    return scope < scopeNames.size() ? scopeNames[scope].c_str() : "";
+}
+
+ProfilerThread* Profiler::GetLocalThread() {
+    if (localThread)
+        return localThread;
+
+    auto thread = std::make_unique<ProfilerThread>();
+    thread->nodes.emplace_back(0, "", -1, 0, "");
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    thread->id = static_cast<int>(threads.size());
+    thread->name = std::format("Thread {}", thread->id);
+    localThread = thread.get();
+    threads.push_back(std::move(thread));
+    return localThread;
+}
+
+void Profiler::SetThreadName(const std::string& name) {
+    ProfilerThread* thread = GetLocalThread();
+    std::lock_guard<std::mutex> lock(thread->mutex);
+    thread->name = name;
+}
+
+ProfilerNode* Profiler::EnterScope(ProfileScopeId scope) {
+    ProfilerThread* thread = GetLocalThread();
+    int parentIndex = thread->current;
+    ProfilerNode* parent = &thread->nodes[parentIndex];
+
+    // Children are only ever added by this thread, so finding one needs no lock
+    int index = parent->firstChild;
+    while (index != -1 && thread->nodes[index].scope != scope)
+        index = thread->nodes[index].nextSibling;
+
+    if (index == -1) {
+        const char* name = GetScopeName(scope);
+        std::string path = parent->depth == 0 ? name : parent->path + "/" + name;
+
+        std::lock_guard<std::mutex> lock(thread->mutex);
+        index = static_cast<int>(thread->nodes.size());
+        thread->nodes.emplace_back(scope, name, parentIndex, parent->depth + 1, std::move(path));
+
+        // Append so children keep their first-entered order
+        if (parent->firstChild == -1) {
+            parent->firstChild = index;
+        } else {
+            int last = parent->firstChild;
+            while (thread->nodes[last].nextSibling != -1)
+                last = thread->nodes[last].nextSibling;
+            thread->nodes[last].nextSibling = index;
+        }
+    }
+
+    thread->current = index;
+    return &thread->nodes[index];
+}
+
+void Profiler::ExitScope(ProfilerNode* node, uint64_t start, uint64_t end) {
+    node->frameNanoseconds.fetch_add(end - start, std::memory_order_relaxed);
+    node->frameCalls.fetch_add(1, std::memory_order_relaxed);
+    localThread->current = node->parent;
+
+    if (capturing.load(std::memory_order_acquire))
+        RecordEvent(localThread, node, start, end);
+}
+
+void Profiler::RecordEvent(ProfilerThread* thread, const ProfilerNode* node, uint64_t start,
+                           uint64_t end) {
+    ProfilerEventBuffer& buffer = thread->capture;
+
+    // The owning thread resets its own buffer on the first event of a new capture, so nothing
+    // else ever writes to it
+    uint32_t generation = captureGeneration.load(std::memory_order_acquire);
+    if (buffer.generation.load(std::memory_order_relaxed) != generation) {
+        uint32_t capacity = captureCapacity.load(std::memory_order_relaxed);
+        if (buffer.capacity != capacity) {
+            buffer.events = std::make_unique<ProfilerEvent[]>(capacity);
+            buffer.capacity = capacity;
+        }
+        buffer.count.store(0, std::memory_order_relaxed);
+        buffer.dropped.store(0, std::memory_order_relaxed);
+        buffer.generation.store(generation, std::memory_order_release);
+    }
+
+    uint32_t index = buffer.count.load(std::memory_order_relaxed);
+    if (index >= buffer.capacity) {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    buffer.events[index] = {node, start, end};
+    buffer.count.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::StartFrame() {
+    ProfilerThread* thread = GetLocalThread();
+    if (!thread->isMain) {
+        std::lock_guard<std::mutex> lock(thread->mutex);
+        thread->isMain = true;
+        thread->name = "Main";
+    }
+}
+
+// Fold every thread's accumulated time into the per-node history. Worker threads keep running
+// meanwhile, so a scope still open on another thread is counted in the frame it ends in.
+void Profiler::EndFrame() {
+    {
+        std::lock_guard<std::mutex> registryLock(registryMutex);
+        for (const std::unique_ptr<ProfilerThread>& thread : threads) {
+            std::lock_guard<std::mutex> lock(thread->mutex);
+            for (size_t i = 1; i < thread->nodes.size(); i++) {
+                ProfilerNode& node = thread->nodes[i];
+                node.timer.SetWindow(windowFrames);
+                node.gpuTimer.SetWindow(windowFrames);
+
+                uint64_t nanoseconds =
+                    node.frameNanoseconds.exchange(0, std::memory_order_relaxed);
+                node.previousCalls = node.frameCalls.exchange(0, std::memory_order_relaxed);
+                node.timer.thisFrame = static_cast<float>(nanoseconds / 1e6);
+                node.timer.UpdateValues();
+
+                if (node.hasGpuTimer) {
+                    node.gpuTimer.thisFrame = static_cast<float>(node.gpuFrameNanoseconds / 1e6);
+                    node.gpuTimer.UpdateValues();
+                    node.gpuFrameNanoseconds = 0;
+                }
+            }
+        }
+    }
+
+    MemoryTracker::EndFrame();
+    heapAllocations.SetWindow(windowFrames);
+    heapAllocations.thisFrame = static_cast<float>(MemoryTracker::ConsumeHeapAllocations());
+    heapAllocations.UpdateValues();
+
+    for (ProfilerCounter& counter : counters) {
+        counter.history.SetWindow(windowFrames);
+        counter.history.thisFrame = counter.value;
+        counter.history.UpdateValues();
+    }
+
+    if (capturing.load(std::memory_order_relaxed) && --captureFramesLeft <= 0) {
+        capturing.store(false, std::memory_order_release);
+        WriteCapture();
+    }
+}
+
+void Profiler::SetCounter(const char* name, float value) {
+    auto it = std::find_if(counters.begin(), counters.end(),
+                           [name](const ProfilerCounter& counter) { return counter.name == name; });
+    if (it == counters.end()) {
+        counters.push_back(ProfilerCounter{name});
+        it = counters.end() - 1;
+    }
+    it->value = value;
+}
+
+bool Profiler::BeginCapture(int frameCount, uint32_t eventsPerThread,
+                            const std::filesystem::path& path) {
+    if (IsCapturing()) {
+        LOG_WARN("A profiler capture is already running");
+        return false;
+    }
+
+    capturePath = path;
+    if (capturePath.empty()) {
+        std::time_t now = std::time(nullptr);
+        std::tm tm{};
+#if defined(_WIN32) || defined(_WIN64)
+        localtime_s(&tm, &now);
+#else
+        localtime_r(&now, &tm);
+#endif
+        capturePath = std::filesystem::path("captures") /
+                      std::format("profile_{:04}{:02}{:02}_{:02}{:02}{:02}.json",
+                                  tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour,
+                                  tm.tm_min, tm.tm_sec);
+    }
+
+    captureFramesLeft = std::max(frameCount, 1);
+    captureCapacity.store(std::max(eventsPerThread, 1u), std::memory_order_relaxed);
+    captureGeneration.fetch_add(1, std::memory_order_relaxed);
+    captureStart = Now();
+    capturing.store(true, std::memory_order_release);
+
+    LOG_INFO("Capturing {} frames of profiler events", captureFramesLeft);
+    return true;
+}
+
+// Writes the capture as complete ("X") events, which Chrome and Perfetto nest by time. Runs on
+// the main thread, so a long capture hitches the frame it finishes in.
+bool Profiler::WriteCapture() {
+    std::error_code ec;
+    if (capturePath.has_parent_path())
+        std::filesystem::create_directories(capturePath.parent_path(), ec);
+
+    std::ofstream file(capturePath, std::ios::out | std::ios::trunc);
+    if (!file.is_open()) {
+        LOG_ERROR("Unable to open {} for writing", capturePath.string());
+        return false;
+    }
+
+    uint32_t generation = captureGeneration.load(std::memory_order_relaxed);
+    size_t eventCount = 0;
+    size_t droppedCount = 0;
+    bool first = true;
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    file << std::fixed << std::setprecision(3);
+
+    std::lock_guard<std::mutex> registryLock(registryMutex);
+    for (const std::unique_ptr<ProfilerThread>& thread : threads) {
+        std::lock_guard<std::mutex> lock(thread->mutex);
+        const ProfilerEventBuffer& buffer = thread->capture;
+        if (buffer.generation.load(std::memory_order_acquire) != generation)
+            continue;
+
+        file << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+             << thread->id << ",\"args\":{\"name\":\"";
+        WriteJsonEscaped(file, thread->name);
+        file << "\"}}";
+        first = false;
+
+        uint32_t count = buffer.count.load(std::memory_order_acquire);
+        for (uint32_t i = 0; i < count; i++) {
+            const ProfilerEvent& event = buffer.events[i];
+            if (event.end < captureStart)
+                continue;
+
+            const ProfilerNode& node = *event.node;
+            uint64_t start = std::max(event.start, captureStart);
+            file << ",\n{\"name\":\"";
+            WriteJsonEscaped(file, node.name);
+            file << "\",\"cat\":\"";
+            WriteJsonEscaped(file, node.path);
+            file << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread->id
+                 << ",\"ts\":" << (start - captureStart) / 1000.0
+                 << ",\"dur\":" << (event.end - start) / 1000.0 << "}";
+        }
+
+        eventCount += count;
+        droppedCount += buffer.dropped.load(std::memory_order_relaxed);
+    }
+    file << "\n]}\n";
+
+    if (droppedCount > 0)
+        LOG_WARN("Profiler capture dropped {} events, raise the events per thread", droppedCount);
+    if (!file.good()) {
+        LOG_ERROR("Failed to write profiler capture {}", capturePath.string());
+        return false;
+    }
+
+    lastCapturePath = capturePath;
+    LOG_INFO("Wrote {} profiler events to {}", eventCount, capturePath.string());
+    return true;
+}
+
+void Profiler::VisitThreads(const std::function<void(const ProfilerThread&)>& visitor) {
+    std::lock_guard<std::mutex> registryLock(registryMutex);
+    for (const std::unique_ptr<ProfilerThread>& thread : threads) {
+        std::lock_guard<std::mutex> lock(thread->mutex);
+        visitor(*thread);
+    }
+}
+
+const FrameTimer<>* Profiler::FindTimer(const std::string& path) {
+    ProfilerThread* thread = GetLocalThread();
+    std::lock_guard<std::mutex> lock(thread->mutex);
+    for (const ProfilerNode& node : thread->nodes) {
+        if (node.path == path)
+            return &node.timer;
+    }
+    return nullptr;
+}
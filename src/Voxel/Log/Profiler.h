@@ -2,125 +2,342 @@
 
 #include <Voxel/pch.h>
 #include <Voxel/Core.h>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <mutex>
 
-template <size_t N = 300> // last N frames
+// Frame times in fixed log-scale buckets, bucketsPerOctave for every doubling from minMs. Each
+// bucket spans ~4.4%, which bounds the error of the percentiles read from it.
+struct FrameHistogram {
+    static constexpr float minMs = 0.001f;
+    static constexpr int bucketsPerOctave = 16;
+    static constexpr int octaves = 20;
+    // Bucket 0 holds everything below minMs, the last one everything above ~1 second
+    static constexpr int bucketCount = bucketsPerOctave * octaves + 2;
+
+    static int GetBucket(float ms) {
+        if (!(ms > minMs))
+            return 0;
+        int bucket = 1 + static_cast<int>(std::log2(ms / minMs) * bucketsPerOctave);
+        return std::min(bucket, bucketCount - 1);
+    }
+
+    // Upper edge of a bucket in milliseconds
+    static float GetBucketLimit(int bucket) {
+        return minMs * std::exp2(static_cast<float>(bucket) / bucketsPerOctave);
+    }
+
+    void Add(float ms) { counts[GetBucket(ms)]++; }
+    void Remove(float ms) { counts[GetBucket(ms)]--; }
+    void Clear() { counts.fill(0); }
+
+    // Nearest-rank percentile over total samples, as the upper edge of its bucket
+    float GetPercentile(float percent, size_t total) const {
+        if (total == 0)
+            return 0.0f;
+        size_t rank = static_cast<size_t>(std::ceil(percent / 100.0f * total));
+        rank = std::clamp<size_t>(rank, 1, total);
+
+        size_t seen = 0;
+        for (int bucket = 0; bucket < bucketCount; bucket++) {
+            seen += counts[bucket];
+            if (seen >= rank)
+                return GetBucketLimit(bucket);
+        }
+        return GetBucketLimit(bucketCount - 1);
+    }
+
+    std::array<uint16_t, bucketCount> counts{};
+};
+
+// History of a timer over a sliding window of the last frames. The window can be shortened at
+// runtime up to N. Adding a sample is O(1) and never allocates.
+template <size_t N = 300>
 struct FrameTimer {
+    static_assert(N > 0 && N <= UINT16_MAX, "histogram counts are 16 bit");
+
   private:
+    struct MaxEntry {
+        size_t sample;
+        float value;
+    };
+
     std::array<float, N> samples{};
     size_t index = 0;
+    size_t window = N;
+    // Samples currently in the window
     size_t count = 0;
-    float runningSum = 0.0;
-    std::deque<std::pair<size_t, float>> maxDeque;
     size_t totalSamples = 0;
+    double runningSum = 0.0;
+    FrameHistogram histogram;
 
-    static std::vector<FrameTimer*>& GetRegistry() {
-        static std::vector<FrameTimer*> registry;
-        return registry;
-    }
+    // Ring of decreasing values, the front is the window max
+    std::array<MaxEntry, N> maxRing{};
+    size_t maxHead = 0;
+    size_t maxSize = 0;
 
-  public:
-    FrameTimer() {
-        samples.fill(0.0f);
-        count = N;
-        GetRegistry().push_back(this);
+    void PushMax(size_t sample, float value) {
+        size_t windowStart = sample + 1 - count;
+        while (maxSize > 0 && maxRing[maxHead].sample < windowStart) {
+            maxHead = (maxHead + 1) % N;
+            maxSize--;
+        }
+        while (maxSize > 0 && maxRing[(maxHead + maxSize - 1) % N].value <= value)
+            maxSize--;
+        maxRing[(maxHead + maxSize) % N] = {sample, value};
+        maxSize++;
     }
 
+  public:
     void UpdateValues() {
         previousFrame = thisFrame;
 
-        if (count < N) {
-            samples[index] = thisFrame;
-            runningSum += thisFrame;
-            ++count;
+        // Drop the sample leaving the window before its slot can be overwritten
+        if (count == window) {
+            float oldest = samples[(index + N - window) % N];
+            runningSum -= oldest;
+            histogram.Remove(oldest);
         } else {
-            runningSum -= samples[index];
-            samples[index] = thisFrame;
-            runningSum += thisFrame;
+            count++;
         }
 
+        samples[index] = thisFrame;
+        runningSum += thisFrame;
+        histogram.Add(thisFrame);
+        PushMax(totalSamples, thisFrame);
+
         index = (index + 1) % N;
+        totalSamples++;
+    }
 
-        size_t currentIndex = totalSamples++;
+    // Number of frames the statistics cover, clamped to [1, N]. Rebuilds them from the stored
+    // samples, so only call this when the length actually changes.
+    void SetWindow(size_t frames) {
+        frames = std::clamp<size_t>(frames, 1, N);
+        if (frames == window)
+            return;
 
-        while (!maxDeque.empty() && maxDeque.back().second <= thisFrame)
-            maxDeque.pop_back();
-        maxDeque.emplace_back(currentIndex, thisFrame);
-        size_t windowStart = (totalSamples > N) ? totalSamples - N : 0;
+        window = frames;
+        size_t available = std::min(totalSamples, window);
+        size_t first = totalSamples - available;
 
-        while (!maxDeque.empty() && maxDeque.front().first < windowStart)
-            maxDeque.pop_front();
+        count = 0;
+        runningSum = 0.0;
+        histogram.Clear();
+        maxHead = 0;
+        maxSize = 0;
+        for (size_t sample = first; sample < totalSamples; sample++) {
+            float value = samples[sample % N];
+            count++;
+            runningSum += value;
+            histogram.Add(value);
+            PushMax(sample, value);
+        }
     }
 
+    size_t GetWindow() const { return window; }
+
     float GetAverage() const {
         if (count == 0)
-            return 0.0;
-        return runningSum / count;
+            return 0.0f;
+        return static_cast<float>(runningSum / count);
     }
 
     float GetMax() const {
-        if (maxDeque.empty())
+        if (maxSize == 0)
             return 0.0f;
-        return maxDeque.front().second;
+        return maxRing[maxHead].value;
     }
 
-    float thisFrame = 0;
-    float previousFrame = 0.0f;
-
-    static void StartFrame() {
-        for (FrameTimer* timer : GetRegistry())
-            timer->thisFrame = 0.0f;
+    // Estimated from the histogram, never above the exact window max
+    float GetPercentile(float percent) const {
+        return std::min(histogram.GetPercentile(percent, count), GetMax());
     }
 
-    static void EndFrame() {
-        for (FrameTimer* timer : GetRegistry())
-            timer->UpdateValues();
-    }
+    const FrameHistogram& GetHistogram() const { return histogram; }
+
+    float thisFrame = 0;
+    float previousFrame = 0.0f;
 
     // For ImGUI Rendering
     const float* GetBuffer() const { return samples.data(); }
-    int GetCount() const { return static_cast<int>(count); }
+    int GetCount() const { return static_cast<int>(N); }
     int GetOffset() const { return static_cast<int>(index); }
 };
 
-class ScopedTimer {
+using ProfileScopeId = uint32_t;
+
+// One node of a thread's call tree. Timings accumulate over the frame on the owning thread and
+// are folded into the frame history by Profiler::EndFrame on the main thread.
+struct ProfilerNode {
+    ProfilerNode(ProfileScopeId scope, const char* name, int parent, int depth, std::string path)
+        : scope(scope), name(name), parent(parent), depth(depth), path(std::move(path)) {}
+
+    ProfileScopeId scope;
+    const char* name;
+    int parent;
+    int firstChild = -1;
+    int nextSibling = -1;
+    int depth;
+    // e.g. "Frame/System/Render"
+    std::string path;
+
+    std::atomic<uint64_t> frameNanoseconds{0};
+    std::atomic<uint32_t> frameCalls{0};
+
+    // Only touched on the main thread
+    FrameTimer<> timer;
+    uint32_t previousCalls = 0;
+
+    // GPU time of the work submitted inside this scope, see GpuProfiler. Results arrive a few
+    // frames late and are only touched on the main thread.
+    bool hasGpuTimer = false;
+    uint64_t gpuFrameNanoseconds = 0;
+    FrameTimer<> gpuTimer;
+};
+
+// A completed scope, recorded while a capture is running
+struct ProfilerEvent {
+    // Nodes never move once created
+    const ProfilerNode* node;
+    uint64_t start;
+    uint64_t end;
+};
+
+// Preallocated single-producer event buffer. The owning thread appends without locking and
+// publishes each event with a release store of count, readers only look at events below it.
+struct ProfilerEventBuffer {
+    std::unique_ptr<ProfilerEvent[]> events;
+    uint32_t capacity = 0;
+    // Capture this buffer currently holds events for
+    std::atomic<uint32_t> generation{0};
+    std::atomic<uint32_t> count{0};
+    std::atomic<uint32_t> dropped{0};
+};
+
+// A value sampled once per frame rather than a time, e.g. how many chunks are loaded
+struct ProfilerCounter {
+    std::string name;
+    float value = 0.0f;
+    FrameTimer<> history;
+};
+
+struct ProfilerThread {
+    std::string name;
+    bool isMain = false;
+    // Trace thread id
+    int id = 0;
+
+    // Guards the node list, which only grows when the owning thread enters a new scope
+    mutable std::mutex mutex;
+    // Node 0 is the thread root and is never timed
+    std::deque<ProfilerNode> nodes;
+    // Innermost open scope, only touched by the owning thread
+    int current = 0;
+    ProfilerEventBuffer capture;
+
+    const ProfilerNode& Root() const { return nodes.front(); }
+};
+
+class Profiler {
   public:
-    ScopedTimer(FrameTimer<>& entry)
-        : entry(entry), start(std::chrono::high_resolution_clock::now()) {}
+    // Returns the id for a scope name, equal names share an id
+    static ProfileScopeId RegisterScope(const char* name);
+    static const char* GetScopeName(ProfileScopeId scope);
+
+    // Name shown for the calling thread, e.g. "Shader Watcher"
+    static void SetThreadName(const std::string& name);
 
-    ~ScopedTimer() {
-        auto end = std::chrono::high_resolution_clock::now();
-        auto ms = std::chrono::duration<double, std::milli>(end - start).count();
-        entry.thisFrame = ms;
+    static ProfilerNode* EnterScope(ProfileScopeId scope);
+    static void ExitScope(ProfilerNode* node, uint64_t start, uint64_t end);
+    // Steady clock timestamp in nanoseconds
+    static uint64_t Now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
     }
 
+    // Record every scope on every thread for the next frameCount frames, then write them as a
+    // Chrome Trace Event JSON file (chrome://tracing, ui.perfetto.dev). Uses
+    // captures/profile_<time>.json when no path is given.
+    static bool BeginCapture(int frameCount, uint32_t eventsPerThread,
+                             const std::filesystem::path& path = {});
+    static bool IsCapturing() { return capturing.load(std::memory_order_relaxed); }
+    static int GetCaptureFramesLeft() { return captureFramesLeft; }
+    static const std::filesystem::path& GetLastCapturePath() { return lastCapturePath; }
+
+    // Called on the main thread around each frame
+    static void StartFrame();
+    static void EndFrame();
+
+    // Frames covered by every timer's average, max and percentiles. Main thread only, applied
+    // at the next EndFrame.
+    static void SetWindowFrames(size_t frames) { windowFrames = frames; }
+    static size_t GetWindowFrames() { return windowFrames; }
+
+    // Global heap allocations per frame, on all threads
+    static const FrameTimer<>& GetHeapAllocations() { return heapAllocations; }
+
+    // Main thread only. The value is recorded at every EndFrame until it is set again.
+    static void SetCounter(const char* name, float value);
+    static const std::deque<ProfilerCounter>& GetCounters() { return counters; }
+
+    // Calls visitor for every thread while its node list is locked. Main thread only, and the
+    // visitor must not enter scopes or register names.
+    static void VisitThreads(const std::function<void(const ProfilerThread&)>& visitor);
+    // Frame history of a main thread node, e.g. "Frame/System", or nullptr
+    static const FrameTimer<>* FindTimer(const std::string& path);
+
   private:
-    FrameTimer<>& entry;
-    std::chrono::high_resolution_clock::time_point start;
+    static ProfilerThread* GetLocalThread();
+    static void RecordEvent(ProfilerThread* thread, const ProfilerNode* node, uint64_t start,
+                            uint64_t end);
+    static bool WriteCapture();
+
+    static inline std::mutex registryMutex;
+    // Deque so names handed out by GetScopeName stay valid
+    static inline std::deque<std::string> scopeNames;
+    static inline std::vector<std::unique_ptr<ProfilerThread>> threads;
+    static inline thread_local ProfilerThread* localThread = nullptr;
+
+    static inline size_t windowFrames = 300;
+    static inline FrameTimer<> heapAllocations;
+    static inline std::deque<ProfilerCounter> counters;
+
+    static inline std::atomic<bool> capturing{false};
+    static inline std::atomic<uint32_t> captureGeneration{0};
+    static inline std::atomic<uint32_t> captureCapacity{0};
+    static inline uint64_t captureStart = 0;
+    static inline int captureFramesLeft = 0;
+    static inline std::filesystem::path capturePath;
+    static inline std::filesystem::path lastCapturePath;
 };
 
-class Profiler {
+class ProfileScope {
   public:
-    static inline FrameTimer<> frame;
-
-    static inline FrameTimer<> ui;
-    static inline FrameTimer<> ui_profiling;
-    static inline FrameTimer<> ui_properties;
-    static inline FrameTimer<> ui_component;
-    static inline FrameTimer<> ui_viewport;
-
-    static inline FrameTimer<> ui_hierarchy;
-    static inline FrameTimer<> ui_hierarchy_buildList;
-    static inline FrameTimer<> ui_hierarchy_render;
-
-    static inline FrameTimer<> ui_logging;
-    static inline FrameTimer<> ui_logging_copyBuffer;
-    static inline FrameTimer<> ui_logging_render;
-
-    static inline FrameTimer<> system;
-    static inline FrameTimer<> system_render;
-    static inline FrameTimer<> system_transform;
-    static inline FrameTimer<> system_visibility;
-
-    static void StartFrame() { FrameTimer<>::StartFrame(); }
-    static void EndFrame() { FrameTimer<>::EndFrame(); }
-};
\ No newline at end of file
+    explicit ProfileScope(ProfileScopeId scope)
+        : node(Profiler::EnterScope(scope)), start(Profiler::Now()) {}
+
+    ~ProfileScope() { Profiler::ExitScope(node, start, Profiler::Now()); }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+    ProfilerNode* GetNode() const { return node; }
+
+  private:
+    ProfilerNode* node;
+    uint64_t start;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+// Times the rest of the enclosing block, nested under whichever scope is open on this thread
+#define PROFILE_SCOPE(name)                                                                        \
+    static const ProfileScopeId PROFILE_CONCAT(profileScopeId, __LINE__) =                         \
+        Profiler::RegisterScope(name);                                                             \
+    ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(PROFILE_CONCAT(profileScopeId, __LINE__))
+
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__func__)
@@ -0,0 +1,62 @@
+#include "FrameArena.h"
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <Voxel/Log/MemoryTracker.h>
+
+void* FrameArena::Allocate(size_t size, size_t alignment) {
+    size = std::max<size_t>(size, 1);
+
+    while (true) {
+        if (current < blocks.size()) {
+            Block& block = blocks[current];
+            auto address = reinterpret_cast<uintptr_t>(block.data.get()) + offset;
+            size_t padding = (alignment - address % alignment) % alignment;
+            if (offset + padding + size <= block.size) {
+                offset += padding + size;
+                return reinterpret_cast<void*>(address + padding);
+            }
+
+            // Move on to a block that fits, the rest of this one stays unused this frame
+            usedBytes += offset;
+            offset = 0;
+            current++;
+            continue;
+        }
+
+        size_t blockSize = std::max(defaultBlockSize, size + alignment);
+        blocks.push_back({std::make_unique<std::byte[]>(blockSize), blockSize});
+        capacity += blockSize;
+        MemoryTracker::RecordAllocation(MemoryTag::FrameArena, blockSize);
+    }
+}
+
+void FrameArena::Reset() {
+    // Merge the spill blocks so a frame of the same size fits in one block next time
+    if (blocks.size() > 1) {
+        size_t merged = capacity;
+        Release();
+        blocks.push_back({std::make_unique<std::byte[]>(merged), merged});
+        capacity = merged;
+        MemoryTracker::RecordAllocation(MemoryTag::FrameArena, merged);
+    }
+
+    current = 0;
+    offset = 0;
+    usedBytes = 0;
+}
+
+void FrameArena::Release() {
+    MemoryTracker::RecordFree(MemoryTag::FrameArena, capacity);
+    blocks.clear();
+    current = 0;
+    offset = 0;
+    usedBytes = 0;
+    capacity = 0;
+}
+
+std::string_view FrameArena::CopyString(std::string_view text) {
+    char* copy = Allocate<char>(text.size() + 1);
+    std::memcpy(copy, text.data(), text.size());
+    copy[text.size()] = '\0';
+    return {copy, text.size()};
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <Voxel/pch.h>
+#include <format>
+#include <string_view>
+
+// Bump allocator for data that only lives until the end of the frame. Reset in
+// Application::StartFrame, so nothing allocated from it may be kept across frames. Main thread
+// only. When a frame outgrows the arena it spills into extra blocks, and the next reset merges
+// them into one block big enough for that frame.
+class FrameArena {
+  public:
+    static void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+    static void Reset();
+    static void Release();
+
+    template <typename T> static T* Allocate(size_t count) {
+        return static_cast<T*>(Allocate(count * sizeof(T), alignof(T)));
+    }
+
+    // Null terminated copy of text, valid until the end of the frame
+    static std::string_view CopyString(std::string_view text);
+
+    template <typename... Args>
+    static const char* Format(std::format_string<Args...> format, Args&&... args) {
+        size_t size = std::formatted_size(format, std::forward<Args>(args)...);
+        char* text = Allocate<char>(size + 1);
+        *std::format_to_n(text, size, format, std::forward<Args>(args)...).out = '\0';
+        return text;
+    }
+
+    static size_t GetUsedBytes() { return usedBytes + offset; }
+    static size_t GetCapacity() { return capacity; }
+
+  private:
+    struct Block {
+        std::unique_ptr<std::byte[]> data;
+        size_t size;
+    };
+
+    static constexpr size_t defaultBlockSize = 1 << 20;
+
+    static inline std::vector<Block> blocks;
+    static inline size_t current = 0;
+    static inline size_t offset = 0;
+    // Bytes used in the blocks before current
+    static inline size_t usedBytes = 0;
+    static inline size_t capacity = 0;
+};
+
+// Standard allocator over the frame arena. Deallocation is a no-op, memory is reclaimed at the
+// next reset.
+template <typename T> struct FrameAllocator {
+    using value_type = T;
+
+    FrameAllocator() = default;
+    template <typename U> FrameAllocator(const FrameAllocator<U>&) {}
+
+    T* allocate(size_t count) { return FrameArena::Allocate<T>(count); }
+    void deallocate(T*, size_t) {}
+
+    template <typename U> bool operator==(const FrameAllocator<U>&) const { return true; }
+};
+
+template <typename T> using FrameVector = std::vector<T, FrameAllocator<T>>;
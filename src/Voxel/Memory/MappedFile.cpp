@@ -0,0 +1,127 @@
+#include "MappedFile.h"
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <utility>
+
+#if defined(_WIN32) || defined(_WIN64)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(MappedFile&& other) noexcept { *this = std::move(other); }
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this == &other)
+        return *this;
+
+    Close();
+    path = std::move(other.path);
+    data = std::exchange(other.data, nullptr);
+    size = std::exchange(other.size, 0);
+    isOpen = std::exchange(other.isOpen, false);
+#if defined(_WIN32) || defined(_WIN64)
+    fileHandle = std::exchange(other.fileHandle, nullptr);
+    mappingHandle = std::exchange(other.mappingHandle, nullptr);
+#endif
+    return *this;
+}
+
+#if defined(_WIN32) || defined(_WIN64)
+bool MappedFile::Open(const std::filesystem::path& filePath) {
+    Close();
+
+    HANDLE file = CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        LOG_ERROR("Unable to open {}", filePath.string());
+        return false;
+    }
+
+    LARGE_INTEGER fileSize{};
+    GetFileSizeEx(file, &fileSize);
+    fileHandle = file;
+    path = filePath;
+    isOpen = true;
+    if (fileSize.QuadPart == 0)
+        return true;
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        LOG_ERROR("Unable to map {}", filePath.string());
+        if (mapping)
+            CloseHandle(mapping);
+        Close();
+        return false;
+    }
+
+    mappingHandle = mapping;
+    data = static_cast<const std::byte*>(view);
+    size = static_cast<size_t>(fileSize.QuadPart);
+    return true;
+}
+
+void MappedFile::Close() {
+    if (data)
+        UnmapViewOfFile(data);
+    if (mappingHandle)
+        CloseHandle(mappingHandle);
+    if (fileHandle)
+        CloseHandle(fileHandle);
+    data = nullptr;
+    size = 0;
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+    isOpen = false;
+}
+#else
+bool MappedFile::Open(const std::filesystem::path& filePath) {
+    Close();
+
+    int file = ::open(filePath.c_str(), O_RDONLY);
+    if (file < 0) {
+        LOG_ERROR("Unable to open {}", filePath.string());
+        return false;
+    }
+
+    struct stat status {};
+    if (fstat(file, &status) != 0) {
+        LOG_ERROR("Unable to read the size of {}", filePath.string());
+        ::close(file);
+        return false;
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    size_t fileSize = static_cast<size_t>(status.st_size);
+    void* view = nullptr;
+    if (fileSize > 0) {
+        view = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, file, 0);
+        if (view == MAP_FAILED) {
+            LOG_ERROR("Unable to map {}", filePath.string());
+            ::close(file);
+            return false;
+        }
+    }
+    ::close(file);
+
+    path = filePath;
+    data = static_cast<const std::byte*>(view);
+    size = fileSize;
+    isOpen = true;
+    return true;
+}
+
+void MappedFile::Close() {
+    if (data)
+        munmap(const_cast<std::byte*>(data), size);
+    data = nullptr;
+    size = 0;
+    isOpen = false;
+}
+#endif
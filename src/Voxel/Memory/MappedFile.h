@@ -0,0 +1,34 @@
+#pragma once
+#include <Voxel/pch.h>
+#include <span>
+
+// Read only memory mapping of a whole file. Pages are read in by the OS on first access, so
+// opening a large file is cheap and only the parts that are looked at cost anything.
+class MappedFile {
+  public:
+    MappedFile() = default;
+    ~MappedFile() { Close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    bool Open(const std::filesystem::path& path);
+    void Close();
+
+    bool IsOpen() const { return isOpen; }
+    // Empty for an empty file
+    std::span<const std::byte> GetBytes() const { return {data, size}; }
+    const std::filesystem::path& GetPath() const { return path; }
+
+  private:
+    std::filesystem::path path;
+    const std::byte* data = nullptr;
+    size_t size = 0;
+    bool isOpen = false;
+#if defined(_WIN32) || defined(_WIN64)
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
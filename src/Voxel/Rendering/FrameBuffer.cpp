@@ -1,8 +1,9 @@
 #include "FrameBuffer.h"
 #include <Voxel/pch.h>
 #include <Voxel/Core.h>
+#include <Voxel/Log/MemoryTracker.h>
 
-FrameBuffer::FrameBuffer(int width, int height) {
+FrameBuffer::FrameBuffer(int width, int height) : width(width), height(height) {
     // Create frame buffer and bind it
     glGenFramebuffers(1, &fbo);
     Bind();
@@ -18,15 +19,23 @@ FrameBuffer::FrameBuffer(int width, int height) {
     glBindRenderbuffer(GL_RENDERBUFFER, rbo);
     glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
     glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, rbo);
+
+    MemoryTracker::RecordAllocation(MemoryTag::GpuTextures, GetGpuBytes());
 }
 
 FrameBuffer::~FrameBuffer() {
     glDeleteFramebuffers(1, &fbo);
-    glDeleteTextures(1, &fbo);
-    glDeleteRenderbuffers(1, &fbo);
+    glDeleteTextures(1, &texture);
+    glDeleteRenderbuffers(1, &rbo);
+
+    MemoryTracker::RecordFree(MemoryTag::GpuTextures, GetGpuBytes());
 }
 
 void FrameBuffer::RescaleFrameBuffer(int width, int height) {
+    size_t oldBytes = GetGpuBytes();
+    this->width = width;
+    this->height = height;
+
     glBindTexture(GL_TEXTURE_2D, texture);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -37,6 +46,8 @@ void FrameBuffer::RescaleFrameBuffer(int width, int height) {
     glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
     glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, rbo);
 
+    MemoryTracker::RecordResize(MemoryTag::GpuTextures, oldBytes, GetGpuBytes());
+
     // Check buffer is complete
     if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
         LOG_FATAL("Framebuffer is not complete");
@@ -47,4 +58,19 @@ unsigned int FrameBuffer::GetFrameTexture() { return texture; }
 
 void FrameBuffer::Bind() const { glBindFramebuffer(GL_FRAMEBUFFER, fbo); }
 
-void FrameBuffer::Unbind() const { glBindFramebuffer(GL_FRAMEBUFFER, 0); }
\ No newline at end of file
+void FrameBuffer::Unbind() const { glBindFramebuffer(GL_FRAMEBUFFER, 0); }
+
+int FrameBuffer::GetWidth() const { return width; }
+
+int FrameBuffer::GetHeight() const { return height; }
+
+void FrameBuffer::ReadPixels(std::vector<uint8_t>& outPixels) const {
+    outPixels.resize(static_cast<size_t>(width) * height * 3);
+
+    GLint previousFramebuffer = 0;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousFramebuffer);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, outPixels.data());
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, previousFramebuffer);
+}
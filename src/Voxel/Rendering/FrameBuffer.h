@@ -1,4 +1,6 @@
 #pragma once
+#include <cstdint>
+#include <vector>
 
 class FrameBuffer {
   public:
@@ -9,8 +11,18 @@ class FrameBuffer {
     void Bind() const;
     void Unbind() const;
 
+    int GetWidth() const;
+    int GetHeight() const;
+
+    // Read back the colour attachment as tightly packed RGB, rows bottom-up
+    void ReadPixels(std::vector<uint8_t>& outPixels) const;
+
   private:
     unsigned int fbo;
     unsigned int texture;
     unsigned int rbo;
+    int width;
+    int height;
+    // RGB colour texture plus a packed depth/stencil renderbuffer, for MemoryTracker
+    size_t GetGpuBytes() const { return static_cast<size_t>(width) * height * (3 + 4); }
 };
@@ -0,0 +1,90 @@
+#include "GpuProfiler.h"
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+
+void GpuProfiler::Init() {
+    GLint counterBits = 0;
+    glGetQueryiv(GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &counterBits);
+    enabled = counterBits > 0;
+    if (!enabled) {
+        LOG_WARN("GL_TIMESTAMP queries are not supported, GPU timings are disabled");
+        return;
+    }
+
+    currentPool = 0;
+    droppedFrames = 0;
+}
+
+void GpuProfiler::Shutdown() {
+    for (GpuQueryPool& pool : pools) {
+        if (!pool.queries.empty())
+            glDeleteQueries(static_cast<GLsizei>(pool.queries.size()), pool.queries.data());
+        pool = GpuQueryPool();
+    }
+    enabled = false;
+}
+
+unsigned int GpuProfiler::AcquireQuery() {
+    GpuQueryPool& pool = pools[currentPool];
+    if (pool.usedQueries == pool.queries.size()) {
+        // Grow in chunks, pools are reused so this only happens during the first frames
+        size_t oldSize = pool.queries.size();
+        pool.queries.resize(std::max<size_t>(oldSize * 2, 64));
+        glGenQueries(static_cast<GLsizei>(pool.queries.size() - oldSize),
+                     pool.queries.data() + oldSize);
+    }
+    return pool.queries[pool.usedQueries++];
+}
+
+size_t GpuProfiler::BeginScope(ProfilerNode* node) {
+    GpuQueryPool& pool = pools[currentPool];
+    unsigned int startQuery = AcquireQuery();
+    glQueryCounter(startQuery, GL_TIMESTAMP);
+
+    node->hasGpuTimer = true;
+    pool.scopes.push_back({node, startQuery, 0});
+    return pool.scopes.size() - 1;
+}
+
+void GpuProfiler::EndScope(size_t scope) {
+    GpuQueryPool& pool = pools[currentPool];
+    unsigned int endQuery = AcquireQuery();
+    glQueryCounter(endQuery, GL_TIMESTAMP);
+    pool.scopes[scope].endQuery = endQuery;
+}
+
+void GpuProfiler::EndFrame() {
+    if (!enabled)
+        return;
+
+    // The oldest pool is the one about to be reused, read it back if the GPU has caught up
+    currentPool = (currentPool + 1) % framesInFlight;
+    ResolvePool(pools[currentPool]);
+}
+
+void GpuProfiler::ResolvePool(GpuQueryPool& pool) {
+    if (pool.scopes.empty()) {
+        pool.usedQueries = 0;
+        return;
+    }
+
+    // Timestamps complete in submission order, so the last query covers the whole pool
+    GLint available = GL_FALSE;
+    glGetQueryObjectiv(pool.queries[pool.usedQueries - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+
+    if (available) {
+        for (const GpuScope& scope : pool.scopes) {
+            GLuint64 start = 0, end = 0;
+            glGetQueryObjectui64v(scope.startQuery, GL_QUERY_RESULT, &start);
+            glGetQueryObjectui64v(scope.endQuery, GL_QUERY_RESULT, &end);
+            if (end > start)
+                scope.node->gpuFrameNanoseconds += end - start;
+        }
+    } else if (droppedFrames++ == 0) {
+        // Rather lose a frame of GPU timings than stall the CPU waiting for them
+        LOG_WARN("GPU is more than {} frames behind, dropping GPU timings", framesInFlight);
+    }
+
+    pool.scopes.clear();
+    pool.usedQueries = 0;
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <Voxel/pch.h>
+#include <Voxel/Log/Profiler.h>
+
+struct GpuScope {
+    ProfilerNode* node;
+    unsigned int startQuery;
+    unsigned int endQuery;
+};
+
+// Timestamp queries recorded during one frame, reused once their results have been read
+struct GpuQueryPool {
+    std::vector<unsigned int> queries;
+    std::vector<GpuScope> scopes;
+    size_t usedQueries = 0;
+};
+
+// GPU timings for profiler scopes. Each scope brackets its GL commands with a pair of
+// GL_TIMESTAMP queries. Every frame records into its own query pool and a pool is only read back
+// once its results are available, framesInFlight frames later, so the CPU never waits on the GPU.
+// The measured time is attributed to the enclosing CPU ProfilerNode. Main thread only.
+class GpuProfiler {
+  public:
+    // Needs a current GL context, does nothing when timer queries are unsupported
+    static void Init();
+    static void Shutdown();
+
+    // After the frame's last GL command, before Profiler::EndFrame
+    static void EndFrame();
+
+    static bool IsEnabled() { return enabled; }
+
+    static size_t BeginScope(ProfilerNode* node);
+    static void EndScope(size_t scope);
+
+    static constexpr size_t invalidScope = SIZE_MAX;
+
+  private:
+    static unsigned int AcquireQuery();
+    static void ResolvePool(GpuQueryPool& pool);
+
+    static constexpr size_t framesInFlight = 3;
+
+    static inline bool enabled = false;
+    static inline size_t currentPool = 0;
+    static inline std::array<GpuQueryPool, framesInFlight> pools;
+    static inline uint64_t droppedFrames = 0;
+};
+
+// Times the GL commands issued until the end of the scope on the GPU
+class GpuProfileScope {
+  public:
+    explicit GpuProfileScope(ProfilerNode* node)
+        : scope(GpuProfiler::IsEnabled() ? GpuProfiler::BeginScope(node)
+                                        : GpuProfiler::invalidScope) {}
+    ~GpuProfileScope() {
+        if (scope != GpuProfiler::invalidScope)
+            GpuProfiler::EndScope(scope);
+    }
+
+    GpuProfileScope(const GpuProfileScope&) = delete;
+    GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+
+  private:
+    size_t scope;
+};
+
+// CPU scope that also reports the GPU time of the commands submitted inside it
+#define PROFILE_GPU_SCOPE(name)                                                                    \
+    PROFILE_SCOPE(name);                                                                           \
+    GpuProfileScope PROFILE_CONCAT(gpuProfileScope, __LINE__)(                                     \
+        PROFILE_CONCAT(profileScope, __LINE__).GetNode())
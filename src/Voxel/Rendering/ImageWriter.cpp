@@ -0,0 +1,108 @@
+#include "ImageWriter.h"
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+
+namespace {
+uint32_t Crc32(uint32_t crc, const uint8_t* data, size_t length) {
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> result{};
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++)
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            result[n] = c;
+        }
+        return result;
+    }();
+
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++)
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+void AppendBigEndian(std::vector<uint8_t>& out, uint32_t value) {
+    out.push_back(static_cast<uint8_t>(value >> 24));
+    out.push_back(static_cast<uint8_t>(value >> 16));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+void WriteChunk(std::ofstream& file, const char* type, const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> chunk;
+    chunk.reserve(data.size() + 12);
+    AppendBigEndian(chunk, static_cast<uint32_t>(data.size()));
+    chunk.insert(chunk.end(), type, type + 4);
+    chunk.insert(chunk.end(), data.begin(), data.end());
+    AppendBigEndian(chunk, Crc32(0, chunk.data() + 4, data.size() + 4));
+    file.write(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+}
+} // namespace
+
+// Frame dumps are for inspection and diffing rather than distribution, so the image data is
+// stored in uncompressed deflate blocks. This keeps the writer dependency free and fast.
+bool ImageWriter::WritePng(const std::filesystem::path& path, int width, int height, int channels,
+                           const uint8_t* pixels) {
+    if (width <= 0 || height <= 0 || (channels != 3 && channels != 4) || pixels == nullptr)
+        return false;
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        LOG_ERROR("Unable to open {} for writing", path.string());
+        return false;
+    }
+
+    const uint8_t signature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    file.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+
+    std::vector<uint8_t> header;
+    AppendBigEndian(header, static_cast<uint32_t>(width));
+    AppendBigEndian(header, static_cast<uint32_t>(height));
+    header.push_back(8);                        // Bit depth
+    header.push_back(channels == 4 ? 6 : 2);    // Colour type, RGBA or RGB
+    header.insert(header.end(), {0, 0, 0});     // Compression, filter, interlace
+    WriteChunk(file, "IHDR", header);
+
+    // Filtered scanlines, each prefixed with filter type 0 (none)
+    size_t rowSize = static_cast<size_t>(width) * channels;
+    std::vector<uint8_t> raw;
+    raw.reserve((rowSize + 1) * height);
+    for (int y = height - 1; y >= 0; y--) {
+        raw.push_back(0);
+        const uint8_t* row = pixels + rowSize * y;
+        raw.insert(raw.end(), row, row + rowSize);
+    }
+
+    // zlib stream made of stored deflate blocks (max 65535 bytes each)
+    std::vector<uint8_t> compressed;
+    compressed.reserve(raw.size() + raw.size() / 65535 * 5 + 16);
+    compressed.push_back(0x78);
+    compressed.push_back(0x01);
+
+    uint32_t adlerA = 1;
+    uint32_t adlerB = 0;
+    size_t offset = 0;
+    do {
+        size_t blockSize = std::min<size_t>(65535, raw.size() - offset);
+        bool finalBlock = offset + blockSize == raw.size();
+        compressed.push_back(finalBlock ? 1 : 0);
+        compressed.push_back(static_cast<uint8_t>(blockSize));
+        compressed.push_back(static_cast<uint8_t>(blockSize >> 8));
+        compressed.push_back(static_cast<uint8_t>(~blockSize));
+        compressed.push_back(static_cast<uint8_t>(~blockSize >> 8));
+        compressed.insert(compressed.end(), raw.begin() + offset,
+                          raw.begin() + offset + blockSize);
+
+        for (size_t i = offset; i < offset + blockSize; i++) {
+            adlerA = (adlerA + raw[i]) % 65521;
+            adlerB = (adlerB + adlerA) % 65521;
+        }
+        offset += blockSize;
+    } while (offset < raw.size());
+
+    AppendBigEndian(compressed, (adlerB << 16) | adlerA);
+    WriteChunk(file, "IDAT", compressed);
+    WriteChunk(file, "IEND", {});
+
+    return file.good();
+}
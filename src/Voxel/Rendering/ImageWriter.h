@@ -0,0 +1,10 @@
+#pragma once
+#include <Voxel/pch.h>
+
+class ImageWriter {
+  public:
+    // Write tightly packed 8-bit RGB/RGBA pixels as a PNG. Rows are expected bottom-up, as
+    // returned by glReadPixels, and are flipped while writing.
+    static bool WritePng(const std::filesystem::path& path, int width, int height, int channels,
+                         const uint8_t* pixels);
+};
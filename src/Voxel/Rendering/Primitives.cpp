@@ -0,0 +1,38 @@
+#include "Primitives.h"
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+
+RawModel Primitives::CreateCube() {
+    Vertex vertexArray[] = {
+        // Positions							//Colours
+        {glm::vec3(0.5f, 0.5f, 0.5f), glm::vec3(0.0f, 0.0f, 0.0f)},   // Front face top right
+        {glm::vec3(0.5f, -0.5f, 0.5f), glm::vec3(1.0f, 0.0f, 0.0f)},  // Front face bottom right
+        {glm::vec3(-0.5f, -0.5f, 0.5f), glm::vec3(0.0f, 1.0f, 0.0f)}, // Front face bottom left
+        {glm::vec3(-0.5f, 0.5f, 0.5f), glm::vec3(0.0f, 0.0f, 1.0f)},  // Front face top left
+
+        {glm::vec3(0.5f, 0.5f, -0.5f), glm::vec3(1.0f, 1.0f, 0.0f)},   // Back face top right
+        {glm::vec3(0.5f, -0.5f, -0.5f), glm::vec3(0.0f, 1.0f, 1.0f)},  // Back face bottom right
+        {glm::vec3(-0.5f, -0.5f, -0.5f), glm::vec3(1.0f, 0.0f, 1.0f)}, // Back face bottom left
+        {glm::vec3(-0.5f, 0.5f, -0.5f), glm::vec3(1.0f, 1.0f, 1.0f)}   // Back face top left
+    };
+
+    unsigned int indices[] = {
+        3, 1, 0, // first triangle - front top right, front bottom right, front top left
+        3, 2, 1, // second triangle - front bottom right, front bottom left, front top left
+        4, 5, 7, // first triangle - back top right, back bottom right, back top left
+        5, 6, 7, // second triangle - back bottom right, back bottom left, back top left
+        0, 5, 4, // first triangle - front top right, back bottom right, back top right
+        1, 5, 0, // second triangle - front bottom right, back bottom right, front top right
+        7, 6, 3, // first triangle - front top left, back bottom left, back top left
+        3, 6, 2, // second triangle - front bottom left, back bottom left, front top left
+        7, 3, 4, // first triangle - back top left, front top left, back top right
+        3, 0, 4, // second triangle - back top right, front top right, front top left
+        5, 2, 6, // first triangle - back bottom left, front bottom left, back bottom right
+        5, 1, 2, // second triangle - back bottom right, front bottom right, front bottom left
+    };
+
+    std::vector<Vertex> verticesVector(std::begin(vertexArray), std::end(vertexArray));
+    std::vector<unsigned int> indicesVector(std::begin(indices), std::end(indices));
+
+    return RawModel(verticesVector, indicesVector);
+}
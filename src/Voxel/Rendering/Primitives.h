@@ -0,0 +1,9 @@
+#pragma once
+#include <Voxel/pch.h>
+#include <Voxel/Rendering/RawModel.h>
+
+class Primitives {
+  public:
+    // Unit cube centered on the origin with a different colour at each corner
+    static RawModel CreateCube();
+};
@@ -1,6 +1,7 @@
 #include "RawModel.h"
 #include <Voxel/pch.h>
 #include <Voxel/Core.h>
+#include <Voxel/Log/MemoryTracker.h>
 
 RawModel::RawModel(std::vector<Vertex> vertices, std::vector<unsigned int> indices)
     : vertices(std::move(vertices)), indices(std::move(indices)) {
@@ -16,6 +17,10 @@ void RawModel::DeleteModel() {
     glDeleteVertexArrays(1, &VAO);
     glDeleteBuffers(1, &VBO);
     glDeleteBuffers(1, &EBO);
+
+    MemoryTracker::RecordFree(MemoryTag::GpuBuffers, meshBytes + instanceBytes);
+    meshBytes = 0;
+    instanceBytes = 0;
 }
 
 void RawModel::CreateModel() {
@@ -48,6 +53,10 @@ void RawModel::CreateModel() {
     instanceCapacity = 1;
     glBufferData(GL_ARRAY_BUFFER, instanceCapacity * sizeof(glm::mat4), nullptr, GL_DYNAMIC_DRAW);
 
+    meshBytes = vertices.size() * sizeof(Vertex) + indices.size() * sizeof(unsigned int);
+    instanceBytes = instanceCapacity * sizeof(glm::mat4);
+    MemoryTracker::RecordAllocation(MemoryTag::GpuBuffers, meshBytes + instanceBytes);
+
     // A mat4 takes 4 attribute locations
     for (int i = 0; i < 4; ++i) {
         glEnableVertexAttribArray(2 + i);
@@ -59,7 +68,7 @@ void RawModel::CreateModel() {
     glBindVertexArray(0);
 }
 
-void RawModel::UpdateInstanceBuffer(const std::vector<glm::mat4>& matrices) {
+void RawModel::UpdateInstanceBuffer(std::span<const glm::mat4> matrices) {
     glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
 
     // Resize if necessary
@@ -68,6 +77,10 @@ void RawModel::UpdateInstanceBuffer(const std::vector<glm::mat4>& matrices) {
 
         glBufferData(GL_ARRAY_BUFFER, instanceCapacity * sizeof(glm::mat4), nullptr,
                      GL_DYNAMIC_DRAW);
+
+        MemoryTracker::RecordResize(MemoryTag::GpuBuffers, instanceBytes,
+                                    instanceCapacity * sizeof(glm::mat4));
+        instanceBytes = instanceCapacity * sizeof(glm::mat4);
     }
 
     glBufferSubData(GL_ARRAY_BUFFER, 0, matrices.size() * sizeof(glm::mat4), matrices.data());
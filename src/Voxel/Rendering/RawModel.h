@@ -1,5 +1,6 @@
 #pragma once
 #include <Voxel/pch.h>
+#include <span>
 
 struct Vertex {
     Vertex(glm::vec3 position, glm::vec3 colour) {
@@ -19,13 +20,17 @@ class RawModel {
     unsigned int GetIndexCount() const;
     void DeleteModel();
 
-    void UpdateInstanceBuffer(const std::vector<glm::mat4>& matrices);
+    void UpdateInstanceBuffer(std::span<const glm::mat4> matrices);
 
   private:
     void CreateModel();
 
     unsigned int VAO, VBO, EBO;
 
+    // Bytes of GPU memory held by the buffers, for MemoryTracker
+    size_t meshBytes = 0;
+    size_t instanceBytes = 0;
+
     std::vector<Vertex> vertices;
     std::vector<unsigned int> indices;
 
@@ -16,21 +16,21 @@ std::string ShaderLoader::LoadShader(const char* filePath) {
             }
             file.close();
         } else {
-            std::cout << "Unable to open file: " << filePath << std::endl;
+            LOG_ERROR("Unable to open shader file: {}", filePath);
             return shader;
         }
     } catch (const std::ifstream::failure& e) {
-        std::cout << "Unable to open file: " << &e << std::endl;
+        LOG_ERROR("Unable to read shader file {}: {}", filePath, e.what());
         return shader;
     }
 
     return shader;
 }
 
-// Create a shader of a type from a specified file path
-unsigned int ShaderLoader::CreateShader(const char* filePath, unsigned int shaderType) {
-    std::string shaderSource = LoadShader(filePath);
-    const char* shaderString = shaderSource.c_str();
+// Compile a shader of a type from source, name is only used for error messages
+unsigned int ShaderLoader::CompileShader(const std::string& source, unsigned int shaderType,
+                                         const char* name, bool& outSuccess) {
+    const char* shaderString = source.c_str();
 
     unsigned int shader;
     shader = glCreateShader(shaderType);
@@ -39,18 +39,26 @@ unsigned int ShaderLoader::CreateShader(const char* filePath, unsigned int shade
     glCompileShader(shader);
 
     int success;
-    char infoLog[512];
     glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    outSuccess = success;
 
     if (!success) {
-        glGetShaderInfoLog(shader, 512, NULL, infoLog);
-        std::cout << "Error: Shader " << filePath << " failed to compile \n"
-                  << infoLog << std::endl;
+        int logLength = 0;
+        glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &logLength);
+        std::string infoLog(std::max(logLength, 1), '\0');
+        glGetShaderInfoLog(shader, logLength, NULL, infoLog.data());
+        LOG_ERROR("Shader {} failed to compile:\n{}", name, infoLog.c_str());
     }
 
     return shader;
 }
 
+// Create a shader of a type from a specified file path
+unsigned int ShaderLoader::CreateShader(const char* filePath, unsigned int shaderType) {
+    bool success = false;
+    return CompileShader(LoadShader(filePath), shaderType, filePath, success);
+}
+
 // Create a shader program using a vertex shader and fragment shader
 Shader ShaderLoader::CreateShaderProgram(unsigned int vertexShader, unsigned int fragmentShader,
                                          bool& outSuccess) {
@@ -63,11 +71,13 @@ Shader ShaderLoader::CreateShaderProgram(unsigned int vertexShader, unsigned int
 
     outSuccess = true;
     int success;
-    char infoLog[512];
     glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
     if (!success) {
-        glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-        std::cout << "Error: Shader linking failed \n" << infoLog << std::endl;
+        int logLength = 0;
+        glGetProgramiv(shaderProgram, GL_INFO_LOG_LENGTH, &logLength);
+        std::string infoLog(std::max(logLength, 1), '\0');
+        glGetProgramInfoLog(shaderProgram, logLength, NULL, infoLog.data());
+        LOG_ERROR("Shader linking failed:\n{}", infoLog.c_str());
         outSuccess = false;
     }
 
@@ -86,28 +96,160 @@ Shader ShaderLoader::CreateShaderProgram(const char* vertexPath, const char* fra
     return CreateShaderProgram(vertexShader, fragmentShader, outSuccess);
 }
 
+// Create a shader program from vertex and fragment sources that have already been read
+Shader ShaderLoader::CreateShaderProgramFromSource(const std::string& vertexSource,
+                                                   const std::string& fragmentSource,
+                                                   bool& outSuccess) {
+    bool vertexSuccess = false;
+    bool fragmentSuccess = false;
+    unsigned int vertexShader =
+        CompileShader(vertexSource, GL_VERTEX_SHADER, "vertex", vertexSuccess);
+    unsigned int fragmentShader =
+        CompileShader(fragmentSource, GL_FRAGMENT_SHADER, "fragment", fragmentSuccess);
+
+    if (!vertexSuccess || !fragmentSuccess) {
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+        outSuccess = false;
+        return Shader(0);
+    }
+
+    return CreateShaderProgram(vertexShader, fragmentShader, outSuccess);
+}
+
 // SHADER CLASS
 
-Shader::Shader(unsigned int ID) { programID = ID; }
+Shader::Shader(unsigned int ID) {
+    programID = ID;
+    Reflect();
+}
 
 void Shader::Use() { glUseProgram(programID); }
 
 void Shader::Delete() { glDeleteProgram(programID); }
 
-void Shader::SetBool(const std::string& name, bool value) const {
-    glUniform1i(glGetUniformLocation(programID, name.c_str()), (int)value);
+// Setters go through glProgramUniform so the program doesn't need to be bound
+void Shader::SetBool(ShaderName name, bool value) const {
+    glProgramUniform1i(programID, GetUniformLocation(name), (int)value);
+}
+
+void Shader::SetInt(ShaderName name, int value) const {
+    glProgramUniform1i(programID, GetUniformLocation(name), value);
+}
+
+void Shader::SetFloat(ShaderName name, float value) const {
+    glProgramUniform1f(programID, GetUniformLocation(name), value);
+}
+
+void Shader::SetMat4(ShaderName name, const glm::mat4& value) const {
+    glProgramUniformMatrix4fv(programID, GetUniformLocation(name), 1, GL_FALSE, &value[0][0]);
 }
 
-void Shader::SetInt(const std::string& name, int value) const {
-    glUniform1i(glGetUniformLocation(programID, name.c_str()), value);
+int Shader::GetUniformLocation(ShaderName name) const {
+    auto it = std::lower_bound(uniforms.begin(), uniforms.end(), name.hash,
+                               [](const ShaderUniform& u, uint32_t hash) { return u.hash < hash; });
+    if (it == uniforms.end() || it->hash != name.hash)
+        return -1;
+    return it->location;
 }
 
-void Shader::SetFloat(const std::string& name, float value) const {
-    glUniform1f(glGetUniformLocation(programID, name.c_str()), value);
+const ShaderUniformBlock* Shader::GetUniformBlock(ShaderName name) const {
+    auto it = std::lower_bound(
+        uniformBlocks.begin(), uniformBlocks.end(), name.hash,
+        [](const ShaderUniformBlock& b, uint32_t hash) { return b.hash < hash; });
+    if (it == uniformBlocks.end() || it->hash != name.hash)
+        return nullptr;
+    return &*it;
 }
 
-void Shader::SetMat4(const std::string& name, const glm::mat4& value) const {
-    glUniformMatrix4fv(glGetUniformLocation(programID, name.c_str()), 1, GL_FALSE, &value[0][0]);
+bool Shader::BindUniformBlock(ShaderName name, unsigned int bindingPoint) {
+    auto it = std::lower_bound(
+        uniformBlocks.begin(), uniformBlocks.end(), name.hash,
+        [](const ShaderUniformBlock& b, uint32_t hash) { return b.hash < hash; });
+    if (it == uniformBlocks.end() || it->hash != name.hash) {
+        LOG_WARN("Shader {} has no active uniform block named {}", programID, name.name);
+        return false;
+    }
+
+    glUniformBlockBinding(programID, it->index, bindingPoint);
+    it->binding = static_cast<int>(bindingPoint);
+    return true;
 }
 
 unsigned int Shader::GetShaderID() { return programID; }
+
+// Query every active uniform and uniform block once, so lookups never touch the driver again
+void Shader::Reflect() {
+    uniforms.clear();
+    uniformBlocks.clear();
+
+    if (programID == 0)
+        return;
+
+    int linked = GL_FALSE;
+    glGetProgramiv(programID, GL_LINK_STATUS, &linked);
+    if (!linked)
+        return;
+
+    int uniformCount = 0;
+    int blockCount = 0;
+    int maxUniformName = 0;
+    int maxBlockName = 0;
+    glGetProgramInterfaceiv(programID, GL_UNIFORM, GL_ACTIVE_RESOURCES, &uniformCount);
+    glGetProgramInterfaceiv(programID, GL_UNIFORM, GL_MAX_NAME_LENGTH, &maxUniformName);
+    glGetProgramInterfaceiv(programID, GL_UNIFORM_BLOCK, GL_ACTIVE_RESOURCES, &blockCount);
+    glGetProgramInterfaceiv(programID, GL_UNIFORM_BLOCK, GL_MAX_NAME_LENGTH, &maxBlockName);
+
+    std::vector<char> nameBuffer(std::max(maxUniformName, maxBlockName) + 1);
+
+    const GLenum uniformProperties[] = {GL_BLOCK_INDEX, GL_LOCATION, GL_TYPE, GL_ARRAY_SIZE};
+    for (int i = 0; i < uniformCount; i++) {
+        int values[4];
+        glGetProgramResourceiv(programID, GL_UNIFORM, i, 4, uniformProperties, 4, nullptr, values);
+
+        // Members of uniform blocks have no location, they are reached through the block
+        if (values[0] != -1)
+            continue;
+
+        int length = 0;
+        glGetProgramResourceName(programID, GL_UNIFORM, i, (int)nameBuffer.size(), &length,
+                                 nameBuffer.data());
+        std::string_view name(nameBuffer.data(), length);
+
+        // Arrays are reported as "name[0]", look them up by their plain name
+        if (name.ends_with("[0]"))
+            name.remove_suffix(3);
+
+        uniforms.push_back({HashShaderName(name), values[1], (unsigned int)values[2], values[3]});
+    }
+
+    const GLenum blockProperties[] = {GL_BUFFER_BINDING, GL_BUFFER_DATA_SIZE};
+    for (int i = 0; i < blockCount; i++) {
+        int values[2];
+        glGetProgramResourceiv(programID, GL_UNIFORM_BLOCK, i, 2, blockProperties, 2, nullptr,
+                               values);
+
+        int length = 0;
+        glGetProgramResourceName(programID, GL_UNIFORM_BLOCK, i, (int)nameBuffer.size(), &length,
+                                 nameBuffer.data());
+        std::string_view name(nameBuffer.data(), length);
+
+        uniformBlocks.push_back({HashShaderName(name), (unsigned int)i, values[0], values[1]});
+    }
+
+    std::sort(uniforms.begin(), uniforms.end(),
+              [](const ShaderUniform& a, const ShaderUniform& b) { return a.hash < b.hash; });
+    std::sort(uniformBlocks.begin(), uniformBlocks.end(),
+              [](const ShaderUniformBlock& a, const ShaderUniformBlock& b) {
+                  return a.hash < b.hash;
+              });
+
+    for (size_t i = 1; i < uniforms.size(); i++) {
+        if (uniforms[i].hash == uniforms[i - 1].hash)
+            LOG_WARN("Shader {} has colliding uniform name hashes", programID);
+    }
+    for (size_t i = 1; i < uniformBlocks.size(); i++) {
+        if (uniformBlocks[i].hash == uniformBlocks[i - 1].hash)
+            LOG_WARN("Shader {} has colliding uniform block name hashes", programID);
+    }
+}
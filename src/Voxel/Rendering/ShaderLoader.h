@@ -1,6 +1,38 @@
 #pragma once
 #include <Voxel/pch.h>
 
+// FNV-1a hash used to look up uniforms and uniform blocks without comparing strings
+constexpr uint32_t HashShaderName(std::string_view name) {
+    uint32_t hash = 2166136261u;
+    for (char c : name) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Uniform/block name hashed at compile time, so shader->SetMat4("view", ...) costs no hashing
+struct ShaderName {
+    consteval ShaderName(const char* name) : hash(HashShaderName(name)), name(name) {}
+
+    uint32_t hash;
+    const char* name;
+};
+
+struct ShaderUniform {
+    uint32_t hash;
+    int location;
+    unsigned int type;
+    int arraySize;
+};
+
+struct ShaderUniformBlock {
+    uint32_t hash;
+    unsigned int index;
+    int binding;
+    int dataSize;
+};
+
 class Shader {
   public:
     Shader(unsigned int ID);
@@ -8,23 +40,38 @@ class Shader {
     void Use();
     void Delete();
 
-    void SetBool(const std::string& name, bool value) const;
-    void SetInt(const std::string& name, int value) const;
-    void SetFloat(const std::string& name, float value) const;
-    void SetMat4(const std::string& name, const glm::mat4& value) const;
+    void SetBool(ShaderName name, bool value) const;
+    void SetInt(ShaderName name, int value) const;
+    void SetFloat(ShaderName name, float value) const;
+    void SetMat4(ShaderName name, const glm::mat4& value) const;
+
+    int GetUniformLocation(ShaderName name) const;
+    const ShaderUniformBlock* GetUniformBlock(ShaderName name) const;
+    bool BindUniformBlock(ShaderName name, unsigned int bindingPoint);
 
     unsigned int GetShaderID();
 
   private:
+    void Reflect();
+
     unsigned int programID;
+
+    // Reflected once at link time, sorted by name hash
+    std::vector<ShaderUniform> uniforms;
+    std::vector<ShaderUniformBlock> uniformBlocks;
 };
 
 class ShaderLoader {
   public:
     static std::string LoadShader(const char* filePath);
+    static unsigned int CompileShader(const std::string& source, unsigned int shaderType,
+                                      const char* name, bool& outSuccess);
     static unsigned int CreateShader(const char* filePath, unsigned int shaderType);
     static Shader CreateShaderProgram(unsigned int vertexShader, unsigned int fragmentShader,
                                       bool& outSuccess);
     static Shader CreateShaderProgram(const char* vertexPath, const char* fragmentPath,
                                       bool& outSuccess);
+    static Shader CreateShaderProgramFromSource(const std::string& vertexSource,
+                                                const std::string& fragmentSource,
+                                                bool& outSuccess);
 };
@@ -0,0 +1,142 @@
+#include "ShaderWatcher.h"
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <Voxel/Rendering/ShaderLoader.h>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+ShaderWatcher::ShaderWatcher(const std::filesystem::path& vertexPath,
+                             const std::filesystem::path& fragmentPath)
+    : vertexPath(vertexPath), fragmentPath(fragmentPath),
+      directory(vertexPath.parent_path()) {}
+
+ShaderWatcher::~ShaderWatcher() { Stop(); }
+
+void ShaderWatcher::Start() {
+    if (running)
+        return;
+
+    running = true;
+    thread = std::thread(&ShaderWatcher::WatchLoop, this);
+    LOG_INFO("Watching {} for shader changes", directory.string());
+}
+
+void ShaderWatcher::Stop() {
+    running = false;
+    if (thread.joinable())
+        thread.join();
+}
+
+bool ShaderWatcher::ConsumeChanges(ShaderSources& outSources) {
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    if (!hasPendingSources)
+        return false;
+
+    outSources = std::move(pendingSources);
+    hasPendingSources = false;
+    return true;
+}
+
+void ShaderWatcher::WatchLoop() {
+    Profiler::SetThreadName("Shader Watcher");
+    if (!WatchWithInotify())
+        WatchWithPolling();
+}
+
+bool ShaderWatcher::WatchWithInotify() {
+#if defined(__linux__)
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    int wd = inotify_add_watch(fd, directory.string().c_str(),
+                               IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_MODIFY);
+    if (wd < 0) {
+        close(fd);
+        return false;
+    }
+
+    alignas(inotify_event) char buffer[4096];
+    bool changePending = false;
+    auto lastEvent = std::chrono::steady_clock::now();
+
+    while (running) {
+        pollfd pfd{fd, POLLIN, 0};
+        int ready = poll(&pfd, 1, static_cast<int>(debounceTime.count()));
+
+        if (ready > 0 && (pfd.revents & POLLIN)) {
+            ssize_t length;
+            while ((length = read(fd, buffer, sizeof(buffer))) > 0) {
+                for (char* ptr = buffer; ptr < buffer + length;) {
+                    auto* event = reinterpret_cast<inotify_event*>(ptr);
+                    if (event->len > 0 && IsWatchedFile(event->name)) {
+                        changePending = true;
+                        lastEvent = std::chrono::steady_clock::now();
+                    }
+                    ptr += sizeof(inotify_event) + event->len;
+                }
+            }
+        }
+
+        if (changePending && std::chrono::steady_clock::now() - lastEvent >= debounceTime) {
+            changePending = false;
+            ReadSources();
+        }
+    }
+
+    inotify_rm_watch(fd, wd);
+    close(fd);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ShaderWatcher::WatchWithPolling() {
+    auto lastWriteTime = [](const std::filesystem::path& path) {
+        std::error_code ec;
+        auto time = std::filesystem::last_write_time(path, ec);
+        return ec ? std::filesystem::file_time_type::min() : time;
+    };
+
+    auto vertexTime = lastWriteTime(vertexPath);
+    auto fragmentTime = lastWriteTime(fragmentPath);
+
+    while (running) {
+        std::this_thread::sleep_for(pollInterval);
+
+        auto newVertexTime = lastWriteTime(vertexPath);
+        auto newFragmentTime = lastWriteTime(fragmentPath);
+        if (newVertexTime == vertexTime && newFragmentTime == fragmentTime)
+            continue;
+
+        vertexTime = newVertexTime;
+        fragmentTime = newFragmentTime;
+        std::this_thread::sleep_for(debounceTime);
+        ReadSources();
+    }
+}
+
+void ShaderWatcher::ReadSources() {
+    PROFILE_SCOPE("Read Sources");
+    ShaderSources sources;
+    sources.vertexSource = ShaderLoader::LoadShader(vertexPath.string().c_str());
+    sources.fragmentSource = ShaderLoader::LoadShader(fragmentPath.string().c_str());
+
+    // A save can briefly truncate the file, wait for the next event instead of failing to compile
+    if (sources.vertexSource.empty() || sources.fragmentSource.empty())
+        return;
+
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    pendingSources = std::move(sources);
+    hasPendingSources = true;
+}
+
+bool ShaderWatcher::IsWatchedFile(const std::string& fileName) const {
+    return fileName == vertexPath.filename().string() ||
+           fileName == fragmentPath.filename().string();
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <Voxel/pch.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+struct ShaderSources {
+    std::string vertexSource;
+    std::string fragmentSource;
+};
+
+// Watches the shader directory on a background thread (inotify on Linux, timestamp polling
+// elsewhere) and re-reads the watched shader files whenever one of them changes. Compiling and
+// linking is left to the main thread, which owns the GL context.
+class ShaderWatcher {
+  public:
+    ShaderWatcher(const std::filesystem::path& vertexPath,
+                  const std::filesystem::path& fragmentPath);
+    ~ShaderWatcher();
+
+    void Start();
+    void Stop();
+
+    // Main thread: returns true once per change, with the freshly read sources
+    bool ConsumeChanges(ShaderSources& outSources);
+
+  private:
+    void WatchLoop();
+    bool WatchWithInotify();
+    void WatchWithPolling();
+    void ReadSources();
+    bool IsWatchedFile(const std::string& fileName) const;
+
+    std::filesystem::path vertexPath;
+    std::filesystem::path fragmentPath;
+    std::filesystem::path directory;
+
+    std::thread thread;
+    std::atomic<bool> running = false;
+
+    std::mutex pendingMutex;
+    ShaderSources pendingSources;
+    bool hasPendingSources = false;
+
+    // Editors often write a file in several steps, wait for this long without events
+    static constexpr std::chrono::milliseconds debounceTime = std::chrono::milliseconds(50);
+    static constexpr std::chrono::milliseconds pollInterval = std::chrono::milliseconds(250);
+};
@@ -0,0 +1,33 @@
+#include "UniformBuffer.h"
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <Voxel/Log/MemoryTracker.h>
+
+UniformBuffer::UniformBuffer(size_t size, UniformBinding binding) : size(size), binding(binding) {
+    glGenBuffers(1, &ubo);
+    glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+    glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    MemoryTracker::RecordAllocation(MemoryTag::GpuBuffers, size);
+}
+
+UniformBuffer::~UniformBuffer() {
+    glDeleteBuffers(1, &ubo);
+    MemoryTracker::RecordFree(MemoryTag::GpuBuffers, size);
+}
+
+void UniformBuffer::SetData(const void* data, size_t dataSize, size_t offset) {
+    if (offset + dataSize > size) {
+        LOG_ERROR("Uniform buffer write of {} bytes at offset {} exceeds size {}", dataSize, offset,
+                  size);
+        return;
+    }
+
+    glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+    glBufferSubData(GL_UNIFORM_BUFFER, offset, dataSize, data);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void UniformBuffer::Bind() const {
+    glBindBufferBase(GL_UNIFORM_BUFFER, static_cast<unsigned int>(binding), ubo);
+}
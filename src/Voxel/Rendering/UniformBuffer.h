@@ -0,0 +1,21 @@
+#pragma once
+#include <cstddef>
+
+// Binding points shared between the C++ side and every shader's uniform blocks
+enum class UniformBinding : unsigned int { Camera = 0 };
+
+class UniformBuffer {
+  public:
+    UniformBuffer(size_t size, UniformBinding binding);
+    ~UniformBuffer();
+
+    void SetData(const void* data, size_t size, size_t offset = 0);
+    template <typename T> void SetData(const T& data) { SetData(&data, sizeof(T)); }
+
+    void Bind() const;
+
+  private:
+    unsigned int ubo = 0;
+    size_t size = 0;
+    UniformBinding binding;
+};
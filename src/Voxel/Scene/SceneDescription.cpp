@@ -0,0 +1,247 @@
+#include "SceneDescription.h"
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <cerrno>
+#include <format>
+#include <limits>
+#include <Voxel/ECS/Components/HierarchyComponent.h>
+#include <Voxel/ECS/Components/MeshComponent.h>
+#include <Voxel/ECS/Components/MetaComponent.h>
+#include <Voxel/ECS/Components/TransformComponent.h>
+#include <Voxel/ECS/Systems/TransformSystem.h>
+#include <Voxel/ECS/Systems/VisibilitySystem.h>
+
+namespace {
+// Parses a decimal entity id at text, false when there is none or it is out of range
+bool ParseEntity(const char* text, Entity& outEntity, char** end) {
+    errno = 0;
+    unsigned long long value = std::strtoull(text, end, 10);
+    if (*end == text || errno == ERANGE || value >= std::numeric_limits<Entity>::max())
+        return false;
+    outEntity = static_cast<Entity>(value);
+    return true;
+}
+
+// Parses "5" or "5-100" into an inclusive entity range
+bool ParseEntityRange(const std::string& token, Entity& first, Entity& last) {
+    size_t dash = token.find('-');
+    char* end = nullptr;
+    if (!ParseEntity(token.c_str(), first, &end))
+        return false;
+
+    last = first;
+    if (dash != std::string::npos && !ParseEntity(token.c_str() + dash + 1, last, &end))
+        return false;
+    return first != InvalidEntity && last >= first;
+}
+} // namespace
+
+bool SceneDescription::Load(const std::filesystem::path& path, SceneDescription& outScene) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        LOG_ERROR("Unable to open scene {}", path.string());
+        return false;
+    }
+
+    outScene = SceneDescription();
+    outScene.path = path;
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        size_t start = line.find_first_not_of(" \t\r");
+        if (start == std::string::npos || line[start] == '#')
+            continue;
+
+        if (!outScene.ParseLine(line.substr(start)))
+            LOG_WARN("{}:{}: skipping malformed line: {}", path.string(), lineNumber, line);
+    }
+
+    // Keep edits ordered by first application so ApplyEdits stays deterministic
+    std::stable_sort(outScene.edits.begin(), outScene.edits.end(),
+                     [](const SceneEdit& a, const SceneEdit& b) { return a.frame < b.frame; });
+
+    bool first = true;
+    for (const SceneSpawn& spawn : outScene.spawns) {
+        glm::vec3 extent = glm::vec3(spawn.count - 1) * spawn.spacing;
+        outScene.boundsMin = first ? spawn.origin : glm::min(outScene.boundsMin, spawn.origin);
+        outScene.boundsMax =
+            first ? spawn.origin + extent : glm::max(outScene.boundsMax, spawn.origin + extent);
+        first = false;
+    }
+
+    LOG_INFO("Loaded scene {} ({} entities, {} edits)", path.string(),
+             outScene.GetEntityCount(), outScene.edits.size());
+    return true;
+}
+
+bool SceneDescription::ParseLine(const std::string& line) {
+    std::istringstream stream(line);
+    std::string command;
+    stream >> command;
+
+    if (command == "grid") {
+        SceneSpawn spawn;
+        if (!(stream >> spawn.count.x >> spawn.count.y >> spawn.count.z))
+            return false;
+        if (glm::any(glm::lessThan(spawn.count, glm::ivec3(1))))
+            return false;
+        // Optional trailing values keep their defaults when missing
+        if (float spacing; stream >> spacing) {
+            spawn.spacing = spacing;
+            if (Entity parent; stream >> parent)
+                spawn.parent = parent;
+        }
+        spawns.push_back(spawn);
+        return true;
+    }
+
+    if (command == "entity") {
+        SceneSpawn spawn;
+        if (!(stream >> spawn.name >> spawn.origin.x >> spawn.origin.y >> spawn.origin.z))
+            return false;
+        if (Entity parent; stream >> parent)
+            spawn.parent = parent;
+        spawns.push_back(spawn);
+        return true;
+    }
+
+    if (command == "camera") {
+        std::string cameraFile;
+        if (!(stream >> cameraFile))
+            return false;
+        cameraPath = path.parent_path() / cameraFile;
+        return true;
+    }
+
+    if (command == "at")
+        return ParseEdit(stream);
+
+    return false;
+}
+
+bool SceneDescription::ParseEdit(std::istringstream& stream) {
+    SceneEdit edit;
+    std::string when, operation, range;
+    if (!(stream >> when >> operation >> range))
+        return false;
+
+    edit.frame = std::atoi(when.c_str());
+    size_t colon = when.find(':');
+    if (colon != std::string::npos)
+        edit.period = std::max(0, std::atoi(when.c_str() + colon + 1));
+
+    if (edit.frame < 0 || !ParseEntityRange(range, edit.first, edit.last))
+        return false;
+
+    if (operation == "move" || operation == "rotate" || operation == "scale") {
+        edit.type = operation == "move"     ? SceneEditType::Move
+                    : operation == "rotate" ? SceneEditType::Rotate
+                                            : SceneEditType::Scale;
+        if (!(stream >> edit.value.x >> edit.value.y >> edit.value.z))
+            return false;
+    } else if (operation == "hide" || operation == "show") {
+        edit.type = operation == "hide" ? SceneEditType::Hide : SceneEditType::Show;
+    } else if (operation == "reparent") {
+        edit.type = SceneEditType::Reparent;
+        if (!(stream >> edit.parent))
+            return false;
+    } else {
+        return false;
+    }
+
+    edits.push_back(edit);
+    return true;
+}
+
+size_t SceneDescription::GetEntityCount() const {
+    size_t count = 0;
+    for (const SceneSpawn& spawn : spawns)
+        count += static_cast<size_t>(spawn.count.x) * spawn.count.y * spawn.count.z;
+    return count;
+}
+
+void SceneDescription::Instantiate(EntityRegistry* registry, RawModel* model) const {
+    for (const SceneSpawn& spawn : spawns) {
+        Entity parent = spawn.parent;
+        if (parent != InvalidEntity && !registry->HasComponent<HierarchyComponent>(parent)) {
+            LOG_WARN("Scene parent {} does not exist yet, spawning at the root", parent);
+            parent = InvalidEntity;
+        }
+
+        for (int x = 0; x < spawn.count.x; x++) {
+            for (int y = 0; y < spawn.count.y; y++) {
+                for (int z = 0; z < spawn.count.z; z++) {
+                    Entity entity = registry->CreateEntity();
+                    std::string name = spawn.name.empty()
+                                           ? std::format("Cube ({}, {}, {})", x, y, z)
+                                           : spawn.name;
+                    glm::vec3 position = spawn.origin + glm::vec3(x, y, z) * spawn.spacing;
+
+                    registry->AddComponent<MetaComponent>(entity, name, true);
+                    registry->AddComponent<TransformComponent>(entity, position);
+                    registry->AddComponent<MeshComponent>(entity, model);
+                    registry->AddComponent<HierarchyComponent>(entity, parent);
+                }
+            }
+        }
+    }
+}
+
+void SceneDescription::ApplyEdits(EntityRegistry* registry, int frame) const {
+    for (const SceneEdit& edit : edits) {
+        if (edit.frame > frame)
+            break;
+
+        bool due = edit.frame == frame ||
+                   (edit.period > 0 && (frame - edit.frame) % edit.period == 0);
+        if (due)
+            ApplyEdit(registry, edit);
+    }
+}
+
+void SceneDescription::ApplyEdit(EntityRegistry* registry, const SceneEdit& edit) const {
+    // Ranges past the last entity touch nothing, and the wider counter can't wrap
+    Entity last = std::min(edit.last, registry->GetLastEntity());
+    for (uint64_t id = edit.first; id <= last; id++) {
+        Entity entity = static_cast<Entity>(id);
+        switch (edit.type) {
+        case SceneEditType::Move:
+        case SceneEditType::Rotate:
+        case SceneEditType::Scale: {
+            TransformComponent* transform = registry->GetComponent<TransformComponent>(entity);
+            if (!transform)
+                break;
+            if (edit.type == SceneEditType::Move)
+                transform->AddPosition(edit.value);
+            else if (edit.type == SceneEditType::Rotate)
+                transform->AddRotationEulerDegrees(edit.value);
+            else
+                transform->SetScale(edit.value);
+            break;
+        }
+        case SceneEditType::Hide:
+        case SceneEditType::Show: {
+            MetaComponent* meta = registry->GetComponent<MetaComponent>(entity);
+            if (!meta)
+                break;
+            meta->visibility = edit.type == SceneEditType::Show;
+            VisibilitySystem::onEntityChangedVisibility.Notify({entity, meta->visibility});
+            break;
+        }
+        case SceneEditType::Reparent: {
+            if (!registry->HasComponent<HierarchyComponent>(entity))
+                break;
+            // Ignore edits that would create a cycle
+            bool validParent = edit.parent == InvalidEntity ||
+                               (edit.parent != entity &&
+                                registry->HasComponent<HierarchyComponent>(edit.parent) &&
+                                !TransformSystem::IsDescendant(entity, edit.parent));
+            if (validParent)
+                TransformSystem::Reparent(entity, edit.parent);
+            break;
+        }
+        }
+    }
+}
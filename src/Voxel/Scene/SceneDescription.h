@@ -0,0 +1,64 @@
+#pragma once
+#include <Voxel/pch.h>
+#include <sstream>
+#include <Voxel/ECS/Entity.h>
+
+enum class SceneEditType { Move, Rotate, Scale, Hide, Show, Reparent };
+
+// A scripted change to a range of entities. Entity ids are deterministic because entities are
+// created in file order from a cleared registry, so scripts can address them directly.
+struct SceneEdit {
+    int frame = 0;
+    // Repeat every N frames after the first application, 0 to apply once
+    int period = 0;
+    SceneEditType type = SceneEditType::Move;
+    Entity first = InvalidEntity;
+    Entity last = InvalidEntity;
+    glm::vec3 value{0.0f};
+    Entity parent = InvalidEntity;
+};
+
+// Text scene description shared by the editor and voxel_bench, one command per line:
+//   grid <nx> <ny> <nz> [spacing] [parent]   cubes named "Cube (x, y, z)"
+//   entity <name> <x> <y> <z> [parent]       a single cube
+//   camera <path>                            camera path, relative to the scene file
+//   at <frame>[:<period>] move|rotate|scale <first>[-<last>] <x> <y> <z>
+//   at <frame>[:<period>] hide|show <first>[-<last>]
+//   at <frame>[:<period>] reparent <first>[-<last>] <parent|0>
+// Lines starting with '#' are ignored.
+class SceneDescription {
+  public:
+    static bool Load(const std::filesystem::path& path, SceneDescription& outScene);
+
+    // Create every entity in the scene, all sharing the given model
+    void Instantiate(class EntityRegistry* registry, class RawModel* model) const;
+    // Apply all edits scheduled for this frame, before the systems run
+    void ApplyEdits(class EntityRegistry* registry, int frame) const;
+
+    glm::vec3 GetCenter() const { return (boundsMin + boundsMax) * 0.5f; }
+    float GetRadius() const { return std::max(glm::length(boundsMax - boundsMin) * 0.5f, 1.0f); }
+    const std::filesystem::path& GetCameraPath() const { return cameraPath; }
+    const std::filesystem::path& GetPath() const { return path; }
+    size_t GetEntityCount() const;
+
+  private:
+    struct SceneSpawn {
+        // Empty for grids, which name each cube after its cell
+        std::string name;
+        glm::ivec3 count{1};
+        glm::vec3 origin{0.0f};
+        float spacing = 1.0f;
+        Entity parent = InvalidEntity;
+    };
+
+    bool ParseLine(const std::string& line);
+    bool ParseEdit(std::istringstream& stream);
+    void ApplyEdit(class EntityRegistry* registry, const SceneEdit& edit) const;
+
+    std::filesystem::path path;
+    std::filesystem::path cameraPath;
+    std::vector<SceneSpawn> spawns;
+    std::vector<SceneEdit> edits;
+    glm::vec3 boundsMin{0.0f};
+    glm::vec3 boundsMax{0.0f};
+};
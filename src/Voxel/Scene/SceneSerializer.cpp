@@ -0,0 +1,427 @@
+#include "SceneSerializer.h"
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <Voxel/ECS/Components/HierarchyComponent.h>
+#include <Voxel/ECS/Components/MeshComponent.h>
+#include <Voxel/ECS/Components/MetaComponent.h>
+#include <Voxel/ECS/Components/TransformComponent.h>
+#include <Voxel/Memory/MappedFile.h>
+
+namespace {
+constexpr size_t columnCount = 4;
+// Records converted per write when saving
+constexpr size_t writeChunk = 16384;
+
+uint64_t AlignUp(uint64_t offset) {
+    return (offset + SceneSerializer::alignment - 1) & ~(SceneSerializer::alignment - 1);
+}
+
+// Entities of a column, either listed or a contiguous range
+struct ColumnEntities {
+    std::span<const Entity> list;
+    Entity first = InvalidEntity;
+
+    Entity operator[](size_t index) const {
+        return list.empty() ? first + static_cast<Entity>(index) : list[index];
+    }
+};
+
+// Components are sorted by entity and usually contiguous, so the direct index is tried first
+template <typename T> T* FindSorted(TrackedVector<T, MemoryTag::ECS>& components, Entity entity) {
+    if (components.empty())
+        return nullptr;
+    size_t guess = static_cast<size_t>(entity - components.front().entity);
+    if (entity >= components.front().entity && guess < components.size() &&
+        components[guess].entity == entity)
+        return &components[guess];
+
+    auto it = std::lower_bound(components.begin(), components.end(), entity,
+                               [](const T& c, Entity e) { return c.entity < e; });
+    return it != components.end() && it->entity == entity ? &*it : nullptr;
+}
+
+// Writes arrays in file order, padding up to each one
+class ArrayWriter {
+  public:
+    explicit ArrayWriter(std::ofstream& out) : out(out) {}
+
+    void Write(uint64_t offset, const void* data, size_t size) {
+        static const char padding[SceneSerializer::alignment] = {};
+        out.write(padding, static_cast<std::streamsize>(offset - position));
+        out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        position = offset + size;
+    }
+
+    // get(i) gives the i-th element
+    template <typename T, typename Get> void Write(uint64_t offset, size_t count, Get&& get) {
+        buffer.resize(writeChunk * sizeof(T));
+        T* records = reinterpret_cast<T*>(buffer.data());
+        for (size_t start = 0; start < count; start += writeChunk) {
+            size_t chunk = std::min(writeChunk, count - start);
+            for (size_t i = 0; i < chunk; i++)
+                records[i] = get(start + i);
+            Write(offset + start * sizeof(T), records, chunk * sizeof(T));
+        }
+    }
+
+  private:
+    std::ofstream& out;
+    uint64_t position = 0;
+    std::vector<std::byte> buffer;
+};
+} // namespace
+
+bool SceneSerializer::Save(const std::filesystem::path& path, EntityRegistry* registry) {
+    const auto& metas = registry->GetStorage<MetaComponent>().All();
+    const auto& transforms = registry->GetStorage<TransformComponent>().All();
+    const auto& hierarchies = registry->GetStorage<HierarchyComponent>().All();
+    const auto& meshes = registry->GetStorage<MeshComponent>().All();
+
+    uint64_t nameBytes = 0;
+    for (const MetaComponent& meta : metas)
+        nameBytes += meta.name.size();
+    if (nameBytes > std::numeric_limits<uint32_t>::max()) {
+        LOG_ERROR("Unable to save scene {}, entity names are over 4 GB", path.string());
+        return false;
+    }
+
+    // Lay the arrays out in the order they are written
+    uint64_t cursor = AlignUp(sizeof(Header) + columnCount * sizeof(Column));
+    auto place = [&cursor](uint64_t size) {
+        Array array{cursor, size};
+        cursor = AlignUp(cursor + size);
+        return array;
+    };
+    auto makeColumn = [&place](ColumnKind kind, const auto& components) {
+        Column column{};
+        column.kind = kind;
+        column.count = static_cast<uint32_t>(components.size());
+        bool contiguous = components.empty() || components.back().entity -
+                                                        components.front().entity ==
+                                                    components.size() - 1;
+        if (contiguous)
+            column.firstEntity = components.empty() ? InvalidEntity : components.front().entity;
+        else
+            column.entities = place(components.size() * sizeof(Entity));
+        return column;
+    };
+
+    std::array<Column, columnCount> columns;
+    Column& metaColumn = columns[0] = makeColumn(ColumnKind::Meta, metas);
+    metaColumn.data[0] = place(metas.size());
+    metaColumn.data[1] = place((metas.size() + 1) * sizeof(uint32_t));
+    metaColumn.data[2] = place(nameBytes);
+    Column& transformColumn = columns[1] = makeColumn(ColumnKind::Transform, transforms);
+    transformColumn.data[0] = place(transforms.size() * sizeof(TransformRecord));
+    Column& hierarchyColumn = columns[2] = makeColumn(ColumnKind::Hierarchy, hierarchies);
+    hierarchyColumn.data[0] = place(hierarchies.size() * sizeof(Entity));
+    columns[3] = makeColumn(ColumnKind::Mesh, meshes);
+
+    std::filesystem::path tempPath = path;
+    tempPath += ".tmp";
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        LOG_ERROR("Unable to write scene {}", tempPath.string());
+        return false;
+    }
+
+    Header header{magic, version, 0, registry->nextEntity, static_cast<uint32_t>(columnCount)};
+    ArrayWriter writer(out);
+    writer.Write(0, &header, sizeof(header));
+    writer.Write(sizeof(header), columns.data(), sizeof(columns));
+
+    auto writeEntities = [&writer](const Column& column, const auto& components) {
+        if (column.entities.size > 0)
+            writer.Write<Entity>(column.entities.offset, components.size(),
+                                 [&components](size_t i) { return components[i].entity; });
+    };
+
+    writeEntities(metaColumn, metas);
+    writer.Write<uint8_t>(metaColumn.data[0].offset, metas.size(), [&metas](size_t i) {
+        return static_cast<uint8_t>((metas[i].visibility ? MetaVisible : 0) |
+                                    (metas[i].effectiveVisibility ? MetaEffectivelyVisible : 0));
+    });
+    uint32_t nameOffset = 0;
+    writer.Write<uint32_t>(metaColumn.data[1].offset, metas.size() + 1,
+                           [&metas, &nameOffset](size_t i) {
+                               uint32_t offset = nameOffset;
+                               if (i < metas.size())
+                                   nameOffset += static_cast<uint32_t>(metas[i].name.size());
+                               return offset;
+                           });
+    uint64_t namePosition = metaColumn.data[2].offset;
+    for (const MetaComponent& meta : metas) {
+        writer.Write(namePosition, meta.name.data(), meta.name.size());
+        namePosition += meta.name.size();
+    }
+
+    writeEntities(transformColumn, transforms);
+    writer.Write<TransformRecord>(
+        transformColumn.data[0].offset, transforms.size(), [&transforms](size_t i) {
+            const TransformComponent& t = transforms[i];
+            return TransformRecord{
+                {t.position.x, t.position.y, t.position.z},
+                {t.rotation.x, t.rotation.y, t.rotation.z, t.rotation.w},
+                {t.eulerRotation.x, t.eulerRotation.y, t.eulerRotation.z},
+                {t.scale.x, t.scale.y, t.scale.z},
+            };
+        });
+
+    writeEntities(hierarchyColumn, hierarchies);
+    writer.Write<Entity>(hierarchyColumn.data[0].offset, hierarchies.size(),
+                         [&hierarchies](size_t i) { return hierarchies[i].parent; });
+
+    writeEntities(columns[3], meshes);
+
+    out.close();
+    if (!out) {
+        LOG_ERROR("Failed writing scene {}", tempPath.string());
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        LOG_ERROR("Unable to replace scene {}: {}", path.string(), error.message());
+        return false;
+    }
+
+    LOG_INFO("Saved scene {} ({} entities, {} MB)", path.string(), metas.size(),
+             cursor / (1024 * 1024));
+    return true;
+}
+
+template <typename T>
+bool SceneSerializer::GetArray(std::span<const std::byte> bytes, const Array& array, size_t count,
+                               std::span<const T>& outArray) {
+    outArray = {};
+    if (array.size != count * sizeof(T) || array.offset % alignment != 0 ||
+        array.offset > bytes.size() || array.size > bytes.size() - array.offset)
+        return false;
+
+    // The mapping is page aligned, so aligned arrays are read in place
+    outArray = {reinterpret_cast<const T*>(bytes.data() + array.offset), count};
+    return true;
+}
+
+bool SceneSerializer::GetEntities(std::span<const std::byte> bytes, const Column& column,
+                                  std::span<const Entity>& outEntities) {
+    outEntities = {};
+    if (column.entities.size == 0)
+        return column.count == 0 || column.firstEntity != InvalidEntity;
+    if (!GetArray(bytes, column.entities, column.count, outEntities))
+        return false;
+
+    // Storages are looked up by binary search, entities must be strictly ascending
+    for (size_t i = 0; i < outEntities.size(); i++) {
+        if (outEntities[i] == InvalidEntity || (i > 0 && outEntities[i] <= outEntities[i - 1]))
+            return false;
+    }
+    return true;
+}
+
+bool SceneSerializer::Load(const std::filesystem::path& path, EntityRegistry* registry,
+                           RawModel* model) {
+    auto start = std::chrono::steady_clock::now();
+
+    MappedFile file;
+    if (!file.Open(path))
+        return false;
+
+    std::span<const std::byte> bytes = file.GetBytes();
+    Header header{};
+    if (bytes.size() >= sizeof(header))
+        std::memcpy(&header, bytes.data(), sizeof(header));
+    if (header.magic != magic || header.version != version ||
+        header.columnCount > (bytes.size() - sizeof(header)) / sizeof(Column)) {
+        LOG_ERROR("{} is not a version {} scene", path.string(), version);
+        return false;
+    }
+
+    std::vector<Column> columns(header.columnCount);
+    std::memcpy(columns.data(), bytes.data() + sizeof(header), columns.size() * sizeof(Column));
+
+    // Check everything before touching the registry, a bad file leaves the scene as it was
+    ColumnEntities metaEntities, transformEntities, hierarchyEntities, meshEntities;
+    std::span<const uint8_t> metaFlags;
+    std::span<const uint32_t> nameOffsets;
+    std::span<const char> names;
+    std::span<const TransformRecord> transformRecords;
+    std::span<const Entity> parents;
+    size_t meshCount = 0;
+    bool valid = true;
+    for (const Column& column : columns) {
+        ColumnEntities entities;
+        valid = valid && GetEntities(bytes, column, entities.list);
+        entities.first = column.firstEntity;
+        if (entities.list.empty() && column.count > 0)
+            valid = valid && column.count <= header.entityCount &&
+                    column.firstEntity - 1 <= header.entityCount - column.count;
+        else if (!entities.list.empty())
+            valid = valid && entities.list.back() <= header.entityCount;
+
+        switch (column.kind) {
+        case ColumnKind::Meta:
+            metaEntities = entities;
+            valid = valid && GetArray(bytes, column.data[0], column.count, metaFlags) &&
+                    GetArray(bytes, column.data[1], static_cast<size_t>(column.count) + 1,
+                             nameOffsets) &&
+                    GetArray(bytes, column.data[2], column.data[2].size, names);
+            for (size_t i = 0; valid && i < column.count; i++)
+                valid = nameOffsets[i] <= nameOffsets[i + 1];
+            valid = valid && (nameOffsets.empty() || nameOffsets.back() <= names.size());
+            break;
+        case ColumnKind::Transform:
+            transformEntities = entities;
+            valid = valid && GetArray(bytes, column.data[0], column.count, transformRecords);
+            break;
+        case ColumnKind::Hierarchy:
+            hierarchyEntities = entities;
+            valid = valid && GetArray(bytes, column.data[0], column.count, parents);
+            break;
+        case ColumnKind::Mesh:
+            meshEntities = entities;
+            meshCount = column.count;
+            break;
+        default:
+            break;
+        }
+    }
+    if (!valid) {
+        LOG_ERROR("Scene {} is damaged", path.string());
+        return false;
+    }
+
+    // Cleared storages keep their memory, it is given back before building the new ones
+    registry->Cleanup();
+    registry->GetStorage<MetaComponent>().Assign({});
+    registry->GetStorage<TransformComponent>().Assign({});
+    registry->GetStorage<HierarchyComponent>().Assign({});
+    registry->GetStorage<MeshComponent>().Assign({});
+
+    size_t metaCount = metaFlags.size();
+    TrackedVector<MetaComponent, MemoryTag::ECS> metas(metaCount);
+    for (size_t i = 0; i < metas.size(); i++) {
+        MetaComponent& meta = metas[i];
+        meta.entity = metaEntities[i];
+        meta.name.assign(names.data() + nameOffsets[i], nameOffsets[i + 1] - nameOffsets[i]);
+        meta.visibility = (metaFlags[i] & MetaVisible) != 0;
+        meta.effectiveVisibility = (metaFlags[i] & MetaEffectivelyVisible) != 0;
+    }
+
+    // World matrices start out as the local ones and are fixed up below for children
+    TrackedVector<TransformComponent, MemoryTag::ECS> transforms(transformRecords.size());
+    for (size_t i = 0; i < transforms.size(); i++) {
+        const TransformRecord& record = transformRecords[i];
+        TransformComponent& transform = transforms[i];
+        transform.entity = transformEntities[i];
+        transform.position = glm::vec3(record.position[0], record.position[1], record.position[2]);
+        transform.rotation = glm::quat(record.rotation[3], record.rotation[0], record.rotation[1],
+                                       record.rotation[2]);
+        transform.eulerRotation =
+            glm::vec3(record.eulerRotation[0], record.eulerRotation[1], record.eulerRotation[2]);
+        transform.scale = glm::vec3(record.scale[0], record.scale[1], record.scale[2]);
+        transform.localMatrix = transform.ComputeLocalMatrix();
+        transform.worldMatrix = transform.localMatrix;
+    }
+
+    TrackedVector<HierarchyComponent, MemoryTag::ECS> hierarchies(parents.size());
+    for (size_t i = 0; i < hierarchies.size(); i++)
+        hierarchies[i].entity = hierarchyEntities[i];
+
+    size_t orphans = 0;
+    for (size_t i = 0; i < hierarchies.size(); i++) {
+        Entity parent = parents[i];
+        if (parent == InvalidEntity)
+            continue;
+
+        HierarchyComponent* parentHierarchy = FindSorted(hierarchies, parent);
+        if (!parentHierarchy || parent == hierarchies[i].entity) {
+            orphans++;
+            continue;
+        }
+        hierarchies[i].parent = parent;
+        // Children come in ascending order, so they always go at the end
+        parentHierarchy->children.insert(parentHierarchy->children.end(), hierarchies[i].entity);
+    }
+
+    // Parents before children from every root. Whatever is left over is part of a parent cycle,
+    // which only a damaged file has, and is moved to the root.
+    std::vector<bool> placed(hierarchies.size());
+    std::vector<HierarchyComponent*> stack;
+    auto placeFrom = [&](HierarchyComponent* root) {
+        stack.push_back(root);
+        while (!stack.empty()) {
+            HierarchyComponent* hierarchy = stack.back();
+            stack.pop_back();
+            placed[static_cast<size_t>(hierarchy - hierarchies.data())] = true;
+
+            TransformComponent* transform = FindSorted(transforms, hierarchy->entity);
+            for (Entity child : hierarchy->children) {
+                TransformComponent* childTransform = FindSorted(transforms, child);
+                if (transform && childTransform)
+                    childTransform->worldMatrix =
+                        transform->worldMatrix * childTransform->localMatrix;
+                stack.push_back(FindSorted(hierarchies, child));
+            }
+        }
+    };
+    for (HierarchyComponent& hierarchy : hierarchies) {
+        if (!hierarchy.HasParent() && !hierarchy.children.empty())
+            placeFrom(&hierarchy);
+    }
+    for (size_t i = 0; i < hierarchies.size(); i++) {
+        if (placed[i] || !hierarchies[i].HasParent())
+            continue;
+        FindSorted(hierarchies, hierarchies[i].parent)->RemoveChild(hierarchies[i].entity);
+        hierarchies[i].parent = InvalidEntity;
+        orphans++;
+        placeFrom(&hierarchies[i]);
+    }
+    if (orphans > 0)
+        LOG_WARN("Scene {}: {} entities had a missing parent and were moved to the root",
+                 path.string(), orphans);
+
+    TrackedVector<MeshComponent, MemoryTag::ECS> meshes(meshCount);
+    for (size_t i = 0; i < meshes.size(); i++) {
+        meshes[i].entity = meshEntities[i];
+        meshes[i].model = model;
+    }
+
+    registry->GetStorage<MetaComponent>().Assign(std::move(metas));
+    registry->GetStorage<TransformComponent>().Assign(std::move(transforms));
+    registry->GetStorage<HierarchyComponent>().Assign(std::move(hierarchies));
+    registry->GetStorage<MeshComponent>().Assign(std::move(meshes));
+    registry->nextEntity = header.entityCount;
+
+    // One batch per event type, and only when someone is listening, building them for millions
+    // of entities isn't free
+    if (EntityRegistry::onAddEntity.GetObserverCount() > 0) {
+        std::vector<EntityAddEvent> events(metaCount);
+        for (size_t i = 0; i < events.size(); i++)
+            events[i] = {metaEntities[i]};
+        EntityRegistry::onAddEntity.NotifyBatch(events);
+    }
+    if (EntityRegistry::onAddComponent.GetObserverCount() > 0) {
+        std::vector<EntityAddComponentEvent> events;
+        auto addEvents = [&events](const ColumnEntities& entities, size_t count,
+                                   std::type_index type) {
+            for (size_t i = 0; i < count; i++)
+                events.push_back({entities[i], type});
+        };
+        addEvents(metaEntities, metaCount, typeid(MetaComponent));
+        addEvents(transformEntities, transformRecords.size(), typeid(TransformComponent));
+        addEvents(meshEntities, meshCount, typeid(MeshComponent));
+        addEvents(hierarchyEntities, parents.size(), typeid(HierarchyComponent));
+        EntityRegistry::onAddComponent.NotifyBatch(events);
+    }
+
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() -
+                                                             start);
+    LOG_INFO("Loaded scene {} ({} entities) in {:.1f} ms", path.string(), header.entityCount,
+             elapsed.count());
+    return true;
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <Voxel/pch.h>
+#include <span>
+#include <Voxel/ECS/Entity.h>
+
+// Binary scene files (.vscene) holding the whole EntityRegistry.
+//
+// A header and a table of columns are followed by the column data. Every component storage is
+// one column, its arrays stored back to back in entity order and each aligned to 64 bytes, so
+// loading maps the file and builds every storage in one pass straight from the arrays:
+//   Meta       flags (visible, effectively visible), name offsets and the name characters
+//   Transform  position, rotation, euler rotation and scale as raw floats
+//   Hierarchy  parent entity per entity, children are rebuilt from these
+//   Mesh       entities only, all bound to the model given to Load
+// A column of entities first..first + count - 1 leaves its entity array out. Matrices are
+// recomputed on load. Little endian throughout, columns of unknown kinds are skipped.
+class SceneSerializer {
+  public:
+    static constexpr uint32_t magic = 0x4E435356; // "VSCN"
+    static constexpr uint16_t version = 1;
+    static constexpr size_t alignment = 64;
+    static constexpr const char* extension = ".vscene";
+
+    // Writes to a temporary file first, so a failed save leaves the previous file alone
+    static bool Save(const std::filesystem::path& path, class EntityRegistry* registry);
+    // Replaces everything in the registry with the scene
+    static bool Load(const std::filesystem::path& path, class EntityRegistry* registry,
+                     class RawModel* model);
+
+  private:
+    enum class ColumnKind : uint32_t { Meta = 1, Transform = 2, Hierarchy = 3, Mesh = 4 };
+
+    enum MetaFlags : uint8_t { MetaVisible = 1, MetaEffectivelyVisible = 2 };
+
+    struct Header {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t flags;
+        // Entities 1..entityCount have been created, some may have been destroyed since
+        uint32_t entityCount;
+        uint32_t columnCount;
+    };
+
+    // Bytes [offset, offset + size) of the file
+    struct Array {
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    struct Column {
+        ColumnKind kind;
+        uint32_t count;
+        // First entity when the entities are contiguous and the entity array is left out
+        Entity firstEntity;
+        uint32_t reserved;
+        Array entities;
+        Array data[3];
+    };
+
+    struct TransformRecord {
+        float position[3];
+        // x, y, z, w
+        float rotation[4];
+        float eulerRotation[3];
+        float scale[3];
+    };
+
+    static_assert(sizeof(Header) == 16 && sizeof(Column) == 80 && sizeof(TransformRecord) == 52);
+
+    // Typed view of an array checked against the file and the column, empty span on failure
+    template <typename T>
+    static bool GetArray(std::span<const std::byte> bytes, const Array& array, size_t count,
+                         std::span<const T>& outArray);
+    static bool GetEntities(std::span<const std::byte> bytes, const Column& column,
+                            std::span<const Entity>& outEntities);
+};
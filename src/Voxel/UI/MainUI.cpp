@@ -6,17 +6,42 @@
 #include <imgui_impl_opengl3.h>
 #include <imgui_internal.h>
 #include <Voxel/EditorSettings.h>
+#include <Voxel/Log/MemoryTracker.h>
 #include <Voxel/Rendering/FrameBuffer.h>
+#include <Voxel/Rendering/GpuProfiler.h>
 #include <Voxel/UI/MenuBar.h>
 #include <Voxel/UI/Panels/ComponentPanel.h>
 #include <Voxel/UI/Panels/HierarchyPanel.h>
 #include <Voxel/UI/Panels/LogPanel.h>
+#include <Voxel/UI/Panels/MemoryPanel.h>
 #include <Voxel/UI/Panels/ProfilingPanel.h>
 #include <Voxel/UI/Panels/PropertiesPanel.h>
 #include <Voxel/UI/Panels/ViewportPanel.h>
 #include <Voxel/UI/UIPanel.h>
 #include <Voxel/UI/UIStyle.h>
 
+namespace {
+// ImGui frees without a size, so every block starts with a header holding it
+constexpr size_t imGuiHeaderSize = alignof(std::max_align_t);
+
+void* TrackedImGuiAlloc(size_t size, void* userData) {
+    auto* block = static_cast<unsigned char*>(std::malloc(size + imGuiHeaderSize));
+    if (!block)
+        return nullptr;
+    *reinterpret_cast<size_t*>(block) = size;
+    MemoryTracker::RecordAllocation(MemoryTag::UI, size);
+    return block + imGuiHeaderSize;
+}
+
+void TrackedImGuiFree(void* memory, void* userData) {
+    if (!memory)
+        return;
+    unsigned char* block = static_cast<unsigned char*>(memory) - imGuiHeaderSize;
+    MemoryTracker::RecordFree(MemoryTag::UI, *reinterpret_cast<size_t*>(block));
+    std::free(block);
+}
+} // namespace
+
 void MainUI::RegisterPanels() {
     {
         auto panel = std::make_unique<ViewportPanel>();
@@ -43,6 +68,11 @@ void MainUI::RegisterPanels() {
         profilingPanel = panel.get();
         panels.push_back(std::move(panel));
     }
+    {
+        auto panel = std::make_unique<MemoryPanel>();
+        memoryPanel = panel.get();
+        panels.push_back(std::move(panel));
+    }
     {
         auto panel = std::make_unique<PropertiesPanel>();
         propertiesPanel = panel.get();
@@ -55,8 +85,9 @@ void MainUI::RegisterPanels() {
 }
 
 void MainUI::RenderUI() {
-    ScopedTimer timer(Profiler::ui);
+    PROFILE_SCOPE("UI");
     SetupFrame();
+    logPanel->Update();
 
     // Render panels
     for (auto& panel : panels) {
@@ -65,8 +96,11 @@ void MainUI::RenderUI() {
         }
     }
 
-    ImGui::Render();
-    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    {
+        PROFILE_GPU_SCOPE("ImGui Render");
+        ImGui::Render();
+        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    }
 
     // Render other viewports
     ImGuiIO& io = ImGui::GetIO();
@@ -85,6 +119,7 @@ void MainUI::Initialise() {
     }
     float uiScale = EditorSettings::GetFloat("Editor", "UIScale", 1.0f);
     IMGUI_CHECKVERSION();
+    ImGui::SetAllocatorFunctions(TrackedImGuiAlloc, TrackedImGuiFree);
     ImGui::CreateContext();
     ImGuiIO& io = ImGui::GetIO();
     io.IniFilename = "EditorLayout.ini";
@@ -202,6 +237,7 @@ void MainUI::BuildDefaultDockLayout(ImGuiID dockspaceID) {
     ImGui::DockBuilderDockWindow(hierarchyPanel->GetPanelName(), rightTop);
     ImGui::DockBuilderDockWindow(logPanel->GetPanelName(), down);
     ImGui::DockBuilderDockWindow(profilingPanel->GetPanelName(), rightDown);
+    ImGui::DockBuilderDockWindow(memoryPanel->GetPanelName(), rightDown);
     ImGui::DockBuilderFinish(dockspaceID);
 
     dockLayoutBuilt = true;
@@ -258,4 +294,6 @@ ComponentPanel* MainUI::GetComponentPanel() { return componentPanel; }
 
 ProfilingPanel* MainUI::GetProfilingPanel() { return profilingPanel; }
 
+MemoryPanel* MainUI::GetMemoryPanel() { return memoryPanel; }
+
 PropertiesPanel* MainUI::GetPropertiesPanel() { return propertiesPanel; }
\ No newline at end of file
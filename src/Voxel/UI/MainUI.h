@@ -12,6 +12,7 @@ class MainUI {
     static class HierarchyPanel* GetHierarchyPanel();
     static class ComponentPanel* GetComponentPanel();
     static class ProfilingPanel* GetProfilingPanel();
+    static class MemoryPanel* GetMemoryPanel();
     static class PropertiesPanel* GetPropertiesPanel();
 
     static void ResetDockLayout();
@@ -31,6 +32,7 @@ class MainUI {
     static inline class HierarchyPanel* hierarchyPanel = nullptr;
     static inline class ComponentPanel* componentPanel = nullptr;
     static inline class ProfilingPanel* profilingPanel = nullptr;
+    static inline class MemoryPanel* memoryPanel = nullptr;
     static inline class PropertiesPanel* propertiesPanel = nullptr;
 
     static inline bool dockLayoutBuilt = false;
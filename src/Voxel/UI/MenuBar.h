@@ -1,9 +1,13 @@
 #pragma once
 #include <Voxel/pch.h>
 #include <Voxel/Core.h>
+#include <Voxel/Editing/UndoHistory.h>
+#include <Voxel/Memory/FrameArena.h>
+#include <Voxel/Scene/SceneSerializer.h>
 #include <Voxel/UI/Panels/ComponentPanel.h>
 #include <Voxel/UI/Panels/HierarchyPanel.h>
 #include <Voxel/UI/Panels/LogPanel.h>
+#include <Voxel/UI/Panels/MemoryPanel.h>
 #include <Voxel/UI/Panels/ProfilingPanel.h>
 #include <Voxel/UI/Panels/PropertiesPanel.h>
 #include <Voxel/UI/Panels/ViewportPanel.h>
@@ -27,15 +31,28 @@ class MenuBar {
             ImGui::MenuItem("New", "Ctrl+N");
             ImGui::MenuItem("Open", "Ctrl+N");
             ImGui::Separator();
-            ImGui::MenuItem("Save", "Ctrl+S");
+            if (ImGui::MenuItem("Save", "Ctrl+S"))
+                SaveScene();
             ImGui::MenuItem("Save As", "Ctrl+Shift+S");
             ImGui::EndMenu();
         }
     }
+    // A text scene is saved next to it as a binary scene, which --scene can open
+    static void SaveScene() {
+        std::filesystem::path path = Application::GetInstance()->GetLaunchOptions().scenePath;
+        path.replace_extension(SceneSerializer::extension);
+        SceneSerializer::Save(path, EntityRegistry::GetInstance());
+    }
     static void RenderEditMenu() {
         if (ImGui::BeginMenu("Edit")) {
-            ImGui::MenuItem("Undo", "Ctrl+Z");
-            ImGui::MenuItem("Redo", "Ctrl+Shift+Z");
+            const char* undoName = UndoHistory::GetUndoName();
+            const char* redoName = UndoHistory::GetRedoName();
+            if (ImGui::MenuItem(undoName ? FrameArena::Format("Undo {}", undoName) : "Undo",
+                                "Ctrl+Z", false, undoName != nullptr))
+                UndoHistory::Undo();
+            if (ImGui::MenuItem(redoName ? FrameArena::Format("Redo {}", redoName) : "Redo",
+                                "Ctrl+Shift+Z", false, redoName != nullptr))
+                UndoHistory::Redo();
             ImGui::EndMenu();
         }
     }
@@ -48,6 +65,7 @@ class MenuBar {
 
             ImGui::MenuItem("Log", (const char*)0, MainUI::GetLogPanel()->GetOpen());
             ImGui::MenuItem("Profiler", (const char*)0, MainUI::GetProfilingPanel()->GetOpen());
+            ImGui::MenuItem("Memory", (const char*)0, MainUI::GetMemoryPanel()->GetOpen());
             ImGui::MenuItem("Properties", (const char*)0, MainUI::GetPropertiesPanel()->GetOpen());
             ImGui::Separator();
 
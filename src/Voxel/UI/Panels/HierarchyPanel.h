@@ -5,6 +5,8 @@
 #include <Voxel/ECS/Components/HierarchyComponent.h>
 #include <Voxel/ECS/Components/MetaComponent.h>
 #include <Voxel/ECS/Systems/TransformSystem.h>
+#include <Voxel/Editing/EntityEdits.h>
+#include <Voxel/Memory/FrameArena.h>
 #include <Voxel/UI/UIPanel.h>
 
 struct VisibleNode {
@@ -30,32 +32,36 @@ class HierarchyPanel : public UIPanel {
     }
 
   private:
+    // Depth-first walk with an explicit stack on the frame arena, so deep hierarchies can't
+    // overflow the call stack. VisibleNodes keeps its capacity between rebuilds.
     void BuildVisibleList(EntityRegistry* registry) {
         VisibleNodes.clear();
 
+        FrameVector<std::pair<Entity, int>> stack;
         auto view = registry->MakeView<const MetaComponent, const HierarchyComponent>();
-
         for (auto&& [entity, meta, hierarchy] : view) {
-            if (!hierarchy.HasParent()) {
-                AddEntityRecursive(registry, entity, 0);
-            }
+            if (!hierarchy.HasParent())
+                stack.emplace_back(entity, 0);
         }
-    }
+        // Pushed in reverse so nodes pop in their original order
+        std::reverse(stack.begin(), stack.end());
 
-    void AddEntityRecursive(EntityRegistry* registry, Entity entity, int depth) {
-        MetaComponent* meta = registry->GetComponent<MetaComponent>(entity);
-        HierarchyComponent* hierarchy = registry->GetComponent<HierarchyComponent>(entity);
+        while (!stack.empty()) {
+            auto [entity, depth] = stack.back();
+            stack.pop_back();
 
-        if (!meta || !hierarchy)
-            return;
-
-        VisibleNodes.push_back({entity, meta, hierarchy, depth});
+            MetaComponent* meta = registry->GetComponent<MetaComponent>(entity);
+            HierarchyComponent* hierarchy = registry->GetComponent<HierarchyComponent>(entity);
+            if (!meta || !hierarchy)
+                continue;
 
-        if (!IsNodeOpen(entity))
-            return;
+            VisibleNodes.push_back({entity, meta, hierarchy, depth});
+            if (!IsNodeOpen(entity))
+                continue;
 
-        for (Entity child : hierarchy->children) {
-            AddEntityRecursive(registry, child, depth + 1);
+            for (auto child = hierarchy->children.rbegin(); child != hierarchy->children.rend();
+                 ++child)
+                stack.emplace_back(*child, depth + 1);
         }
     }
 
@@ -104,7 +110,7 @@ class HierarchyPanel : public UIPanel {
                 Entity dropped = *(Entity*)payload->Data;
 
                 if (dropped != entity && !TransformSystem::IsDescendant(dropped, entity)) {
-                    TransformSystem::Reparent(dropped, entity);
+                    ReparentEdit::Reparent(dropped, entity);
                     visibleNodesDirty = true;
                 }
             }
@@ -123,14 +129,14 @@ class HierarchyPanel : public UIPanel {
     }
 
     void RenderInternal() override {
-        ScopedTimer timer(Profiler::ui_hierarchy);
+        PROFILE_SCOPE("Hierarchy");
 
         EntityRegistry* registry = EntityRegistry::GetInstance();
         if (!registry)
             return;
 
         {
-            ScopedTimer timer(Profiler::ui_hierarchy_buildList);
+            PROFILE_SCOPE("Build List");
             if (visibleNodesDirty) {
                 BuildVisibleList(registry);
                 visibleNodesDirty = false;
@@ -138,7 +144,7 @@ class HierarchyPanel : public UIPanel {
         }
 
         {
-            ScopedTimer timer(Profiler::ui_hierarchy_render);
+            PROFILE_SCOPE("Render");
 
             ImGuiListClipper clipper;
             clipper.Begin((int)VisibleNodes.size());
@@ -155,7 +161,7 @@ class HierarchyPanel : public UIPanel {
                 if (const ImGuiPayload* payload =
                         ImGui::AcceptDragDropPayload("HIERARCHY_ENTITY")) {
                     Entity dropped = *(Entity*)payload->Data;
-                    TransformSystem::Reparent(dropped, InvalidEntity);
+                    ReparentEdit::Reparent(dropped, InvalidEntity);
                     visibleNodesDirty = true;
                 }
                 ImGui::EndDragDropTarget();
@@ -1,35 +1,99 @@
 #pragma once
 #include <Voxel/pch.h>
 #include <Voxel/Core.h>
+#include <Voxel/EditorSettings.h>
+#include <Voxel/Log/BinaryLogReader.h>
+#include <Voxel/Log/LogHistory.h>
+#include <Voxel/Memory/FrameArena.h>
 #include <Voxel/UI/UIPanel.h>
 
 class LogPanel : public UIPanel {
   public:
+    LogPanel()
+        : history(static_cast<size_t>(
+              std::max(EditorSettings::GetInt("Logging", "HistorySize", 1048576), 1))) {}
+
     const char* GetPanelName() override { return "Log"; }
 
+    // Moves new messages from the sink into the history, every frame even while the panel is
+    // closed so nothing is lost to the sink's ring wrapping around
+    void Update() {
+        PROFILE_SCOPE("Log History");
+        std::shared_ptr<ImGuiLogSink> logSink = Log::GetImGuiLogSink();
+        if (!logSink)
+            return;
+
+        uint64_t endSequence = logSink->GetEndSequence();
+        uint64_t firstSequence = logSink->GetFirstSequence(endSequence);
+        if (lastSeenSequence < firstSequence) {
+            history.AddLost(firstSequence - lastSeenSequence);
+            lastSeenSequence = firstSequence;
+        }
+
+        LogEntry entry;
+        for (; lastSeenSequence < endSequence; lastSeenSequence++) {
+            if (logSink->ReadEntry(lastSeenSequence, entry)) {
+                history.Append(entry);
+                continue;
+            }
+            // Still being written, try again next frame unless it was overwritten meanwhile
+            if (lastSeenSequence >= logSink->GetFirstSequence(logSink->GetEndSequence()))
+                break;
+            history.AddLost(1);
+        }
+
+        index.Update(filterBudget);
+    }
+
+    // Browses a recorded session log instead of the live history until CloseSession
+    bool OpenSession(const std::filesystem::path& path) {
+        auto reader = std::make_unique<BinaryLogReader>();
+        if (!BinaryLogReader::Load(path, *reader))
+            return false;
+
+        index.SetSource(reader.get());
+        session = std::move(reader);
+        return true;
+    }
+
+    void CloseSession() {
+        index.SetSource(&history);
+        session.reset();
+    }
+
   private:
     void RenderInternal() override {
-        ScopedTimer timer(Profiler::ui_logging);
+        PROFILE_SCOPE("Logging");
         static bool wasAtBottom = true;
-        bool newEntries = false;
 
-        std::shared_ptr<ImGuiSinkMT> logSink = Log::GetImGuiLogSink();
-        if (!logSink) {
-            ImGui::End();
-            return;
-        }
+        RenderFilterBar();
 
-        {
-            ScopedTimer timer(Profiler::ui_logging_copyBuffer);
-            if (logSink->updated) {
-                logBufferCopy = logSink->GetBufferCopy();
-                logSink->updated = false;
-                newEntries = true;
+        if (session) {
+            ImGui::TextDisabled("Session %s | %llu messages | %.1f MB | %zu formats%s",
+                                session->GetPath().filename().string().c_str(),
+                                static_cast<unsigned long long>(session->GetEndRow()),
+                                session->GetFileSize() / (1024.0 * 1024.0),
+                                session->GetFormatCount(),
+                                session->IsTruncated() ? " | cut short" : "");
+        } else {
+            if (std::shared_ptr<AsyncLogSink> asyncSink = Log::GetAsyncSink()) {
+                ImGui::TextDisabled("Async queue high-water %zu / %zu | %llu dropped",
+                                    asyncSink->GetHighWaterMark(), asyncSink->GetCapacity(),
+                                    static_cast<unsigned long long>(asyncSink->GetDroppedCount()));
+                ImGui::SameLine();
             }
+            ImGui::TextDisabled("History %zu / %zu | %llu lost", history.GetSize(),
+                                history.GetCapacity(),
+                                static_cast<unsigned long long>(history.GetLostCount()));
         }
 
+        // Only the rows on screen are looked up through the filter index
+        size_t matchCount = index.GetMatchCount();
+        bool newEntries = matchCount != lastMatchCount;
+        lastMatchCount = matchCount;
+
         {
-            ScopedTimer timer(Profiler::ui_logging_render);
+            PROFILE_SCOPE("Render");
             static ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg |
                                            ImGuiTableFlags_Resizable | ImGuiTableFlags_ScrollY |
                                            ImGuiTableFlags_Reorderable;
@@ -50,39 +114,122 @@ class LogPanel : public UIPanel {
             ImGui::TableHeadersRow();
 
             ImGuiListClipper clipper;
-            clipper.Begin(static_cast<int>(logBufferCopy.size()));
+            clipper.Begin(static_cast<int>(matchCount));
             while (clipper.Step()) {
                 for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
-                    const auto& entry = logBufferCopy[i];
                     ImGui::TableNextRow();
+                    LogRow row = index.GetMatch(static_cast<size_t>(i));
 
+                    std::tm time = row.GetLocalTime();
                     ImGui::TableNextColumn();
-                    ImGui::Text("%04d-%02d-%02d", entry.time.tm_year + 1900, entry.time.tm_mon + 1,
-                                entry.time.tm_mday);
+                    ImGui::Text("%04d-%02d-%02d", time.tm_year + 1900, time.tm_mon + 1,
+                                time.tm_mday);
 
                     ImGui::TableNextColumn();
-                    ImGui::Text("%02d:%02d:%02d.%03ld", entry.time.tm_hour, entry.time.tm_min,
-                                entry.time.tm_sec, entry.ms);
+                    ImGui::Text("%02d:%02d:%02d.%03ld", time.tm_hour, time.tm_min, time.tm_sec,
+                                row.GetMilliseconds());
 
                     ImGui::TableNextColumn();
-                    ImGui::Text("%lu", entry.thread_id);
+                    ImGui::Text("%lu", row.thread_id);
 
                     ImGui::TableNextColumn();
-                    DrawSeverity(entry.level);
+                    DrawSeverity(row.level);
 
                     ImGui::TableNextColumn();
                     ImGui::PushTextWrapPos(0.0f);
-                    ImGui::TextUnformatted(entry.message.c_str());
+                    ImGui::TextUnformatted(row.text.data(), row.text.data() + row.text.size());
                     ImGui::PopTextWrapPos();
                 }
             }
-            if (newEntries && wasAtBottom)
+            if (newEntries && wasAtBottom && !session)
                 ImGui::SetScrollHereY(1.0f);
 
             ImGui::EndTable();
         }
     }
 
+    // Edits the panel's copy of the filter, the index only restarts filtering when it changed
+    void RenderFilterBar() {
+        const LogRowSource* source = index.GetSource();
+
+        static constexpr std::pair<spdlog::level::level_enum, const char*> levels[] = {
+            {spdlog::level::trace, "Trace"}, {spdlog::level::debug, "Debug"},
+            {spdlog::level::info, "Info"},   {spdlog::level::warn, "Warn"},
+            {spdlog::level::err, "Error"},   {spdlog::level::critical, "Fatal"},
+        };
+        for (const auto& [level, name] : levels) {
+            bool shown = (filter.levelMask & (1u << level)) != 0;
+            // ### keeps the id stable while the count changes
+            const char* label = FrameArena::Format("{} ({})###{}", name,
+                                                   source->GetLevelCount(level), name);
+            if (ImGui::Checkbox(label, &shown))
+                filter.levelMask ^= 1u << level;
+            ImGui::SameLine();
+        }
+
+        ImGui::SetNextItemWidth(120.0f);
+        const char* threadLabel =
+            filter.thread ? FrameArena::Format("{}", *filter.thread) : "All threads";
+        if (ImGui::BeginCombo("##Thread", threadLabel)) {
+            if (ImGui::Selectable("All threads", !filter.thread))
+                filter.thread.reset();
+            for (size_t thread : source->GetThreads()) {
+                if (ImGui::Selectable(FrameArena::Format("{}", thread), filter.thread == thread))
+                    filter.thread = thread;
+            }
+            ImGui::EndCombo();
+        }
+
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(-320.0f);
+        ImGui::InputTextWithHint("##Search", "Search", searchBuffer, sizeof(searchBuffer));
+        filter.search = searchBuffer;
+        ImGui::SameLine();
+        ImGui::Checkbox("Regex", &filter.regex);
+        ImGui::SameLine();
+        ImGui::Checkbox("Aa", &filter.caseSensitive);
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("Match case");
+        ImGui::SameLine();
+        RenderSessionCombo();
+        ImGui::SameLine();
+        if (!session && ImGui::Button("Clear")) {
+            history.Clear();
+            index.Update(filterBudget);
+        }
+
+        index.SetFilter(filter);
+        if (!index.GetError().empty()) {
+            ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "Invalid regex: %s",
+                               index.GetError().c_str());
+        } else if (index.IsFiltering()) {
+            ImGui::ProgressBar(index.GetProgress(), ImVec2(200.0f, 0.0f), "Filtering");
+            ImGui::SameLine();
+        }
+    }
+
+    // Live history or one of the recorded session logs
+    void RenderSessionCombo() {
+        ImGui::SetNextItemWidth(100.0f);
+        if (!ImGui::BeginCombo("##Session", session ? "Session" : "Live"))
+            return;
+
+        if (ImGui::Selectable("Live", !session) && session)
+            CloseSession();
+
+        std::filesystem::path directory =
+            EditorSettings::GetString("Logging", "SessionDirectory", "logs");
+        for (const std::filesystem::path& path : Log::ListSessions(directory)) {
+            bool selected = session && session->GetPath() == path;
+            std::string name = path.filename().string();
+            if (path == Log::GetSessionPath())
+                name += " (recording)";
+            if (ImGui::Selectable(name.c_str(), selected) && !selected)
+                OpenSession(path);
+        }
+        ImGui::EndCombo();
+    }
+
     static void DrawSeverity(spdlog::level::level_enum level) {
         const char* text = "";
         ImVec4 color;
@@ -127,5 +274,14 @@ class LogPanel : public UIPanel {
     }
 
   private:
-    std::vector<LogEntry> logBufferCopy = std::vector<LogEntry>();
+    // Rescanning after a filter change is spread over frames in slices this long
+    static constexpr std::chrono::microseconds filterBudget{4000};
+
+    LogHistory history;
+    std::unique_ptr<BinaryLogReader> session;
+    LogFilterIndex index{&history};
+    LogFilter filter;
+    uint64_t lastSeenSequence = 0;
+    size_t lastMatchCount = 0;
+    char searchBuffer[256] = {};
 };
\ No newline at end of file
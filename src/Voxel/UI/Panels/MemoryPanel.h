@@ -0,0 +1,74 @@
+#pragma once
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <Voxel/Log/MemoryTracker.h>
+#include <Voxel/UI/UIPanel.h>
+
+class MemoryPanel : public UIPanel {
+  public:
+    const char* GetPanelName() override { return "Memory"; }
+
+  private:
+    static void FormatBytes(char* buffer, size_t size, int64_t bytes) {
+        const char* units[] = {"B", "KB", "MB", "GB", "TB"};
+        double value = static_cast<double>(bytes);
+        int unit = 0;
+        while (std::abs(value) >= 1024.0 && unit < 4) {
+            value /= 1024.0;
+            unit++;
+        }
+        std::snprintf(buffer, size, unit == 0 ? "%.0f %s" : "%.2f %s", value, units[unit]);
+    }
+
+    static void BytesCell(int64_t bytes) {
+        char text[32];
+        FormatBytes(text, sizeof(text), bytes);
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(text);
+    }
+
+    void RenderInternal() override {
+        PROFILE_SCOPE("Memory");
+
+        static ImGuiTableFlags flags =
+            ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable;
+        if (!ImGui::BeginTable("MemoryTable", 5, flags))
+            return;
+
+        ImGui::TableSetupColumn("Tag");
+        ImGui::TableSetupColumn("Live");
+        ImGui::TableSetupColumn("Peak");
+        ImGui::TableSetupColumn("Allocs/frame");
+        ImGui::TableSetupColumn("Total allocs");
+        ImGui::TableHeadersRow();
+
+        int64_t cpuLive = 0, gpuLive = 0;
+        for (size_t i = 0; i < static_cast<size_t>(MemoryTag::Count); i++) {
+            MemoryTag tag = static_cast<MemoryTag>(i);
+            const MemoryTagStats& stats = MemoryTracker::GetStats(tag);
+            int64_t live = stats.liveBytes.load(std::memory_order_relaxed);
+            bool gpu = tag == MemoryTag::GpuBuffers || tag == MemoryTag::GpuTextures;
+            (gpu ? gpuLive : cpuLive) += live;
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(MemoryTracker::GetTagName(tag));
+            BytesCell(live);
+            BytesCell(stats.peakBytes.load(std::memory_order_relaxed));
+            ImGui::TableNextColumn();
+            ImGui::Text("%u", stats.previousFrameAllocations);
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(
+                                    stats.totalAllocations.load(std::memory_order_relaxed)));
+        }
+        ImGui::EndTable();
+
+        // Only tagged allocations are counted, untracked containers are not included
+        char cpuText[32], gpuText[32];
+        FormatBytes(cpuText, sizeof(cpuText), cpuLive);
+        FormatBytes(gpuText, sizeof(gpuText), gpuLive);
+        ImGui::Text("Tracked: %s CPU | %s GPU", cpuText, gpuText);
+    }
+
+    int LoadStyles() override { return 0; }
+};
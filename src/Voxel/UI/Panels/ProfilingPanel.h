@@ -1,20 +1,21 @@
 #pragma once
 #include <Voxel/pch.h>
 #include <Voxel/Core.h>
+#include <Voxel/EditorSettings.h>
 #include <Voxel/Log/Profiler.h>
 #include <Voxel/UI/UIPanel.h>
 
-struct ProfilerNode {
-    const char* name;
-    FrameTimer<>* timer;
-    const ProfilerNode* children;
-    size_t childCount;
-};
-
 class ProfilingPanel : public UIPanel {
   public:
     const char* GetPanelName() override { return "Profiling"; }
 
+    // Capture the next frames to a trace file, sized by the [Profiler] editor settings
+    static void StartCapture() {
+        int frames = EditorSettings::GetInt("Profiler", "CaptureFrames", 120);
+        int eventsPerThread = EditorSettings::GetInt("Profiler", "CaptureEventsPerThread", 262144);
+        Profiler::BeginCapture(frames, static_cast<uint32_t>(std::max(eventsPerThread, 1)));
+    }
+
   private:
     ImVec4 GetColor(bool isRoot, float frameTime) {
         float ratio = glm::clamp(frameTime / frameBudget, 0.0f, 1.0f);
@@ -32,94 +33,176 @@ class ProfilingPanel : public UIPanel {
         return ImVec4(r, g, b, 1.0f);
     }
 
-    void DrawProfilerNode(const ProfilerNode& node, bool isRoot = false) {
-        const char* name = node.name;
-        double avgTime = node.timer->GetAverage();
-        double rawTime = node.timer->previousFrame;
-        double maxTime = node.timer->GetMax();
+    void DrawTime(float column, bool isRoot, float time) {
+        ImGui::PushStyleColor(ImGuiCol_Text, GetColor(isRoot, time));
+        ImGui::SameLine(column);
+        ImGui::Text("%.3f ms", time);
+        ImGui::PopStyleColor();
+    }
+
+    void DrawProfilerNode(const ProfilerThread& thread, const ProfilerNode& node,
+                          bool isRoot = false) {
+        const FrameTimer<>& timer = node.timer;
         ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_SpanAvailWidth |
                                    ImGuiTreeNodeFlags_DefaultOpen |
                                    ImGuiTreeNodeFlags_DrawLinesFull;
 
-        if (node.childCount == 0)
+        if (node.firstChild == -1)
             flags |= ImGuiTreeNodeFlags_Leaf;
 
-        bool opened = ImGui::TreeNodeEx((void*)&node, flags, "%s", name);
+        bool opened = ImGui::TreeNodeEx((void*)&node, flags, "%s", node.name);
 
-        ImGui::PushStyleColor(ImGuiCol_Text, GetColor(isRoot, rawTime));
         ImGui::SameLine(250.0f);
-        ImGui::Text("%.3f ms", rawTime);
-        ImGui::PopStyleColor();
-
-        ImGui::PushStyleColor(ImGuiCol_Text, GetColor(isRoot, avgTime));
-        ImGui::SameLine(400.0f);
-        ImGui::Text("%.3f ms", avgTime);
-        ImGui::PopStyleColor();
-
-        ImGui::PushStyleColor(ImGuiCol_Text, GetColor(isRoot, maxTime));
-        ImGui::SameLine(550.0f);
-        ImGui::Text("%.3f ms", maxTime);
-        ImGui::PopStyleColor();
+        ImGui::Text("%u", node.previousCalls);
+
+        DrawTime(320.0f, isRoot, timer.previousFrame);
+        DrawTime(420.0f, isRoot, timer.GetAverage());
+        DrawTime(520.0f, isRoot, timer.GetPercentile(50.0f));
+        DrawTime(620.0f, isRoot, timer.GetPercentile(95.0f));
+        DrawTime(720.0f, isRoot, timer.GetPercentile(99.0f));
+        DrawTime(820.0f, isRoot, timer.GetMax());
+
+        // GPU results lag a few frames behind, the average hides that
+        ImGui::SameLine(920.0f);
+        if (node.hasGpuTimer)
+            ImGui::Text("%.3f ms", node.gpuTimer.GetAverage());
+        else
+            ImGui::TextDisabled("-");
 
         if (opened) {
-            for (size_t i = 0; i < node.childCount; ++i)
-                DrawProfilerNode(node.children[i]);
+            for (int child = node.firstChild; child != -1;
+                 child = thread.nodes[child].nextSibling)
+                DrawProfilerNode(thread, thread.nodes[child]);
             ImGui::TreePop();
         }
     }
 
-    void RenderInternal() override {
-        ScopedTimer timer(Profiler::ui_profiling);
+    void DrawThread(const ProfilerThread& thread) {
+        const ProfilerNode& root = thread.Root();
+        if (root.firstChild == -1)
+            return;
+
+        // Worker threads get their own collapsible timeline below the main thread
+        bool opened = thread.isMain;
+        if (!thread.isMain) {
+            ImGui::Spacing();
+            opened = ImGui::TreeNodeEx((void*)&thread,
+                                       ImGuiTreeNodeFlags_SpanAvailWidth |
+                                           ImGuiTreeNodeFlags_DefaultOpen,
+                                       "%s", thread.name.c_str());
+        }
+        if (!opened)
+            return;
 
-        float frameFPS =
-            Profiler::frame.previousFrame > 0.0 ? 1000.0f / Profiler::frame.previousFrame : 0.0f;
-        float frameFPSAvg =
-            Profiler::frame.GetAverage() > 0.0 ? 1000.0f / Profiler::frame.GetAverage() : 0.0f;
+        for (int child = root.firstChild; child != -1; child = thread.nodes[child].nextSibling)
+            DrawProfilerNode(thread, thread.nodes[child], thread.isMain);
 
-        ImGui::Text("%.2f FPS | %.2f Average FPS", frameFPS, frameFPSAvg);
-        float budget = 1000 / targetFPS;
-        ImGui::PlotLines("Frame time (ms)", Profiler::frame.GetBuffer(), Profiler::frame.GetCount(),
-                         Profiler::frame.GetOffset(), nullptr, 0.0f, budget * 5.0, ImVec2(0, 140));
+        if (!thread.isMain)
+            ImGui::TreePop();
+    }
 
-        ImGui::Text("System");
-        ImGui::SameLine(250.0f);
-        ImGui::Text("Prev ms");
-        ImGui::SameLine(400.0f);
-        ImGui::Text("Avg ms");
-        ImGui::SameLine(550.0f);
-        ImGui::Text("Max ms");
+    // Frame time distribution over the window, from maxMs / 100 to maxMs on a log scale.
+    // Neighbouring buckets are merged into plot bars, the outer bars include everything beyond.
+    void DrawHistogram(const FrameTimer<>& timer, float maxMs) {
+        const FrameHistogram& histogram = timer.GetHistogram();
+        int firstBucket = FrameHistogram::GetBucket(maxMs / 100.0f);
+        int span = FrameHistogram::GetBucket(maxMs) - firstBucket + 1;
+        int maxBars = static_cast<int>(histogramBars.size());
+        int bucketsPerBar = (span + maxBars - 1) / maxBars;
+        int bars = (span + bucketsPerBar - 1) / bucketsPerBar;
+
+        histogramBars.fill(0.0f);
+        for (int bucket = 0; bucket < FrameHistogram::bucketCount; bucket++) {
+            int bar = std::clamp((bucket - firstBucket) / bucketsPerBar, 0, bars - 1);
+            histogramBars[bar] += histogram.counts[bucket];
+        }
 
-        DrawProfilerNode(root, true);
+        ImGui::PlotHistogram("Frame time distribution", histogramBars.data(), bars, 0, nullptr,
+                             0.0f, FLT_MAX, ImVec2(0, 80));
     }
 
-    static inline ProfilerNode uiLoggingChildren[] = {
-        {"Copy Buffer", &Profiler::ui_logging_copyBuffer, nullptr, 0},
-        {"Render", &Profiler::ui_logging_render, nullptr, 0}};
-
-    static inline ProfilerNode uiHierarchyChildren[] = {
-        {"Build List", &Profiler::ui_hierarchy_buildList, nullptr, 0},
-        {"Render", &Profiler::ui_hierarchy_render, nullptr, 0}};
+    void DrawCounters() {
+        const std::deque<ProfilerCounter>& counters = Profiler::GetCounters();
+        if (counters.empty() || !ImGui::TreeNodeEx("Counters", ImGuiTreeNodeFlags_DefaultOpen))
+            return;
+
+        for (const ProfilerCounter& counter : counters) {
+            ImGui::Text("%s", counter.name.c_str());
+            ImGui::SameLine(250.0f);
+            ImGui::Text("%.1f", counter.value);
+            ImGui::SameLine(320.0f);
+            ImGui::Text("%.1f avg", counter.history.GetAverage());
+            ImGui::SameLine(420.0f);
+            ImGui::Text("%.1f max", counter.history.GetMax());
+        }
+        ImGui::TreePop();
+    }
 
-    static inline ProfilerNode uiChildren[] = {
-        {"Viewport", &Profiler::ui_viewport, nullptr, 0},
-        {"Components", &Profiler::ui_component, nullptr, 0},
-        {"Hierarchy", &Profiler::ui_hierarchy, uiHierarchyChildren, 2},
-        {"Logging", &Profiler::ui_logging, uiLoggingChildren, 2},
-        {"Profiling", &Profiler::ui_profiling, nullptr, 0},
-        {"Properties", &Profiler::ui_properties, nullptr, 0}};
+    void RenderInternal() override {
+        PROFILE_SCOPE("Profiling");
+
+        const FrameTimer<>* frame = Profiler::FindTimer("Frame");
+        if (frame) {
+            float frameFPS = frame->previousFrame > 0.0 ? 1000.0f / frame->previousFrame : 0.0f;
+            float frameFPSAvg = frame->GetAverage() > 0.0 ? 1000.0f / frame->GetAverage() : 0.0f;
+
+            ImGui::Text("%.2f FPS | %.2f Average FPS", frameFPS, frameFPSAvg);
+            float budget = 1000 / targetFPS;
+            ImGui::PlotLines("Frame time (ms)", frame->GetBuffer(), frame->GetCount(),
+                             frame->GetOffset(), nullptr, 0.0f, budget * 5.0, ImVec2(0, 140));
+
+            // Stutters show up as a tail on the right that the average hides
+            ImGui::Text("p50 %.2f ms | p95 %.2f ms | p99 %.2f ms | max %.2f ms",
+                        frame->GetPercentile(50.0f), frame->GetPercentile(95.0f),
+                        frame->GetPercentile(99.0f), frame->GetMax());
+            DrawHistogram(*frame, budget * 5.0f);
+        }
 
-    static inline ProfilerNode systemChildren[] = {
-        {"Render", &Profiler::system_render, nullptr, 0},
-        {"Transform", &Profiler::system_transform, nullptr, 0},
-        {"Visibility", &Profiler::system_visibility, nullptr, 0}};
+        const FrameTimer<>& heapAllocations = Profiler::GetHeapAllocations();
+        ImGui::Text("Heap allocations: %.0f last frame | %.1f average | %.0f max",
+                    heapAllocations.previousFrame, heapAllocations.GetAverage(),
+                    heapAllocations.GetMax());
+
+        DrawCounters();
+
+        int window = static_cast<int>(Profiler::GetWindowFrames());
+        ImGui::SetNextItemWidth(200.0f);
+        if (ImGui::SliderInt("Window (frames)", &window, 30, frame ? frame->GetCount() : 300))
+            Profiler::SetWindowFrames(static_cast<size_t>(window));
+
+        if (Profiler::IsCapturing()) {
+            ImGui::BeginDisabled();
+            ImGui::Button("Capturing...");
+            ImGui::EndDisabled();
+            ImGui::SameLine();
+            ImGui::Text("%d frames left", Profiler::GetCaptureFramesLeft());
+        } else {
+            if (ImGui::Button("Capture Trace"))
+                StartCapture();
+            if (!Profiler::GetLastCapturePath().empty()) {
+                ImGui::SameLine();
+                ImGui::TextDisabled("%s", Profiler::GetLastCapturePath().string().c_str());
+            }
+        }
 
-    static inline ProfilerNode frameChildren[] = {{"UI", &Profiler::ui, uiChildren, 6},
-                                                  {"System", &Profiler::system, systemChildren, 3}};
+        ImGui::Text("Scope");
+        ImGui::SameLine(250.0f);
+        ImGui::Text("Calls");
+        const std::pair<float, const char*> columns[] = {
+            {320.0f, "Prev ms"}, {420.0f, "Avg ms"}, {520.0f, "p50 ms"}, {620.0f, "p95 ms"},
+            {720.0f, "p99 ms"},  {820.0f, "Max ms"}, {920.0f, "GPU ms"},
+        };
+        for (const auto& [column, label] : columns) {
+            ImGui::SameLine(column);
+            ImGui::Text("%s", label);
+        }
 
-    static inline ProfilerNode root = {"Frame", &Profiler::frame, frameChildren, 2};
+        Profiler::VisitThreads([this](const ProfilerThread& thread) { DrawThread(thread); });
+    }
 
     int LoadStyles() override { return 0; }
 
+    std::array<float, 64> histogramBars{};
     float targetFPS = 60.0f;
     float frameBudget = 1000.0f / targetFPS;
 };
\ No newline at end of file
@@ -10,7 +10,7 @@ class PropertiesPanel : public UIPanel {
 
   private:
     void RenderInternal() override {
-        ScopedTimer timer(Profiler::ui_properties);
+        PROFILE_SCOPE("Properties");
         const float leftWidth = 180.0f;
         float footerHeight = ImGui::GetFrameHeightWithSpacing();
 
@@ -0,0 +1,169 @@
+#include "ChunkCodec.h"
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <cstring>
+
+namespace {
+constexpr size_t voxelCount = VoxelChunk::voxelCount;
+
+size_t VarintSize(size_t value) {
+    size_t size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        size++;
+    }
+    return size;
+}
+
+// Bits per palette index, 8 when a palette saves nothing
+int PaletteBits(size_t distinct) {
+    return distinct <= 2 ? 1 : distinct <= 4 ? 2 : distinct <= 16 ? 4 : 8;
+}
+
+void EncodePalette(std::span<const Voxel, voxelCount> voxels, const std::array<bool, 256>& seen,
+                   size_t distinct, std::vector<uint8_t>& out) {
+    std::array<uint8_t, 256> indices{};
+    out.push_back(static_cast<uint8_t>(distinct - 1));
+    for (size_t voxel = 0, next = 0; voxel < seen.size(); voxel++) {
+        if (!seen[voxel])
+            continue;
+        indices[voxel] = static_cast<uint8_t>(next++);
+        out.push_back(static_cast<uint8_t>(voxel));
+    }
+
+    int bits = PaletteBits(distinct);
+    size_t perByte = static_cast<size_t>(8 / bits);
+    size_t start = out.size();
+    out.resize(start + voxelCount / perByte);
+    uint8_t* packed = out.data() + start;
+    for (size_t i = 0; i < voxelCount; i += perByte) {
+        uint8_t byte = 0;
+        for (size_t j = 0; j < perByte; j++)
+            byte |= static_cast<uint8_t>(indices[voxels[i + j]] << (j * bits));
+        packed[i / perByte] = byte;
+    }
+}
+
+void EncodeRunLength(std::span<const Voxel, voxelCount> voxels, std::vector<uint8_t>& out) {
+    size_t start = 0;
+    while (start < voxelCount) {
+        Voxel voxel = voxels[start];
+        size_t end = start + 1;
+        while (end < voxelCount && voxels[end] == voxel)
+            end++;
+
+        out.push_back(voxel);
+        size_t run = end - start - 1;
+        while (run >= 0x80) {
+            out.push_back(static_cast<uint8_t>(run | 0x80));
+            run >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(run));
+        start = end;
+    }
+}
+
+bool DecodePalette(std::span<const uint8_t> data, std::span<Voxel, voxelCount> voxels) {
+    if (data.empty())
+        return false;
+    size_t distinct = static_cast<size_t>(data[0]) + 1;
+    int bits = PaletteBits(distinct);
+    size_t perByte = static_cast<size_t>(8 / bits);
+    if (bits == 8 || data.size() != 1 + distinct + voxelCount / perByte)
+        return false;
+
+    const uint8_t* palette = data.data() + 1;
+    const uint8_t* packed = palette + distinct;
+    uint8_t mask = static_cast<uint8_t>((1 << bits) - 1);
+    for (size_t i = 0; i < voxelCount; i += perByte) {
+        uint8_t byte = packed[i / perByte];
+        for (size_t j = 0; j < perByte; j++) {
+            size_t index = (byte >> (j * bits)) & mask;
+            if (index >= distinct)
+                return false;
+            voxels[i + j] = palette[index];
+        }
+    }
+    return true;
+}
+
+bool DecodeRunLength(std::span<const uint8_t> data, std::span<Voxel, voxelCount> voxels) {
+    size_t position = 0;
+    size_t voxel = 0;
+    while (position < data.size()) {
+        Voxel value = data[position++];
+        size_t run = 0;
+        for (int shift = 0;; shift += 7) {
+            if (position >= data.size() || shift > 14)
+                return false;
+            uint8_t byte = data[position++];
+            run |= static_cast<size_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+                break;
+        }
+
+        if (run >= voxelCount - voxel)
+            return false;
+        std::memset(voxels.data() + voxel, value, run + 1);
+        voxel += run + 1;
+    }
+    return voxel == voxelCount;
+}
+} // namespace
+
+ChunkCodec::Encoding ChunkCodec::Encode(const VoxelChunk& chunk, std::vector<uint8_t>& out) {
+    std::span<const Voxel, voxelCount> voxels = chunk.GetVoxels();
+
+    // One pass for the distinct voxels and the exact run length encoded size
+    std::array<bool, 256> seen{};
+    size_t runLengthSize = 0;
+    size_t runStart = 0;
+    for (size_t i = 0; i < voxelCount; i++) {
+        seen[voxels[i]] = true;
+        if (i + 1 == voxelCount || voxels[i + 1] != voxels[i]) {
+            runLengthSize += 1 + VarintSize(i - runStart);
+            runStart = i + 1;
+        }
+    }
+    size_t distinct = static_cast<size_t>(std::count(seen.begin(), seen.end(), true));
+
+    if (distinct == 1) {
+        out.push_back(voxels[0]);
+        return Encoding::Uniform;
+    }
+
+    int bits = PaletteBits(distinct);
+    size_t paletteSize = bits < 8 ? 1 + distinct + voxelCount * bits / 8 : voxelCount;
+    if (runLengthSize < paletteSize) {
+        EncodeRunLength(voxels, out);
+        return Encoding::RunLength;
+    }
+    if (bits < 8) {
+        EncodePalette(voxels, seen, distinct, out);
+        return Encoding::Palette;
+    }
+
+    out.insert(out.end(), voxels.begin(), voxels.end());
+    return Encoding::Raw;
+}
+
+bool ChunkCodec::Decode(Encoding encoding, std::span<const uint8_t> data, VoxelChunk& outChunk) {
+    std::span<Voxel, voxelCount> voxels = outChunk.GetVoxels();
+    switch (encoding) {
+    case Encoding::Uniform:
+        if (data.size() != 1)
+            return false;
+        outChunk.Fill(data[0]);
+        return true;
+    case Encoding::Palette:
+        return DecodePalette(data, voxels);
+    case Encoding::RunLength:
+        return DecodeRunLength(data, voxels);
+    case Encoding::Raw:
+        if (data.size() != voxelCount)
+            return false;
+        std::memcpy(voxels.data(), data.data(), voxelCount);
+        return true;
+    }
+    return false;
+}
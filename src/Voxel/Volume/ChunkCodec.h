@@ -0,0 +1,20 @@
+#pragma once
+#include <Voxel/pch.h>
+#include <span>
+#include <Voxel/Volume/VoxelChunk.h>
+
+// Lossless chunk encodings, picked per chunk by whichever is smallest. The result is what gets
+// block compressed on disk, both encodings leave it far more compressible than the raw voxels.
+//   Uniform    the one voxel
+//   Palette    count - 1, the distinct voxels, then 1, 2 or 4 bit indices into them
+//   RunLength  pairs of voxel and LEB128 run length - 1, in voxel order
+//   Raw        the voxels as they are
+class ChunkCodec {
+  public:
+    enum class Encoding : uint8_t { Uniform, Palette, RunLength, Raw };
+
+    // Appends the encoded chunk to out
+    static Encoding Encode(const VoxelChunk& chunk, std::vector<uint8_t>& out);
+    // False when the data is malformed, the chunk is then left partly written
+    static bool Decode(Encoding encoding, std::span<const uint8_t> data, VoxelChunk& outChunk);
+};
@@ -0,0 +1,329 @@
+#include "ChunkFile.h"
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <cstring>
+#include <zstd.h>
+
+namespace {
+// Chunks that outgrow their slot get this much room to grow again before the next move
+constexpr uint32_t slotSlackDivisor = 8;
+} // namespace
+
+bool ChunkFile::Create(const std::filesystem::path& filePath, uint32_t directoryCapacity,
+                       int level) {
+    Close();
+    {
+        std::ofstream create(filePath, std::ios::binary | std::ios::trunc);
+        if (!create.is_open()) {
+            LOG_ERROR("Unable to create chunk file {}", filePath.string());
+            return false;
+        }
+    }
+
+    file.open(filePath, std::ios::binary | std::ios::in | std::ios::out);
+    if (!file.is_open()) {
+        LOG_ERROR("Unable to open chunk file {}", filePath.string());
+        return false;
+    }
+
+    path = filePath;
+    compressionLevel = level;
+    header = Header{};
+    header.magic = magic;
+    header.version = version;
+    header.chunkSize = static_cast<uint16_t>(VoxelChunk::size);
+    header.directoryCapacity = std::max(directoryCapacity, 1u);
+    header.dataEnd = GetDataStart(header.directoryCapacity);
+    palette = VoxelVolume().GetPalette();
+
+    // The directory is written out in full so the file is valid from the start
+    if (!WriteAt(paletteOffset, palette.data(), sizeof(palette)) || !WriteDirectory()) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+bool ChunkFile::Open(const std::filesystem::path& filePath, int level) {
+    Close();
+    file.open(filePath, std::ios::binary | std::ios::in | std::ios::out);
+    if (!file.is_open()) {
+        LOG_ERROR("Unable to open chunk file {}", filePath.string());
+        return false;
+    }
+
+    path = filePath;
+    compressionLevel = level;
+    std::error_code error;
+    uint64_t fileSize = std::filesystem::file_size(filePath, error);
+    if (error || !Validate(fileSize)) {
+        LOG_ERROR("{} is not a version {} chunk file of {}^3 chunks", filePath.string(), version,
+                  VoxelChunk::size);
+        Close();
+        return false;
+    }
+    return true;
+}
+
+bool ChunkFile::Validate(uint64_t fileSize) {
+    if (fileSize < directoryOffset || !ReadAt(0, &header, sizeof(header)))
+        return false;
+    if (header.magic != magic || header.version != version ||
+        header.chunkSize != VoxelChunk::size || header.chunkCount > header.directoryCapacity ||
+        GetDataStart(header.directoryCapacity) > fileSize)
+        return false;
+
+    entries.resize(header.chunkCount);
+    if (!ReadAt(paletteOffset, palette.data(), sizeof(palette)) ||
+        !ReadAt(directoryOffset, entries.data(), entries.size() * sizeof(DirectoryEntry)))
+        return false;
+
+    // The unused end of the last slot may lie past the end of the file
+    uint64_t dataStart = GetDataStart(header.directoryCapacity);
+    for (uint32_t i = 0; i < entries.size(); i++) {
+        const DirectoryEntry& entry = entries[i];
+        if (entry.size > entry.capacity || entry.offset < dataStart ||
+            entry.offset + entry.capacity > header.dataEnd ||
+            entry.offset + entry.size > fileSize || entry.encodedSize > VoxelChunk::voxelCount ||
+            !lookup.emplace(entry.chunk, i).second)
+            return false;
+    }
+    return true;
+}
+
+void ChunkFile::Close() {
+    if (file.is_open())
+        file.close();
+    file.clear();
+    entries.clear();
+    lookup.clear();
+    header = Header{};
+
+    ZSTD_freeCCtx(compressor);
+    compressor = nullptr;
+    ZSTD_freeDCtx(decompressor);
+    decompressor = nullptr;
+}
+
+bool ChunkFile::LoadChunk(const glm::ivec3& chunk, VoxelChunk& outChunk) {
+    auto it = lookup.find(chunk);
+    if (it == lookup.end())
+        return false;
+    return Unpack(entries[it->second], outChunk);
+}
+
+bool ChunkFile::SaveChunk(const glm::ivec3& chunk, const VoxelChunk& voxels) {
+    return WriteChunk(chunk, voxels, true);
+}
+
+std::vector<glm::ivec3> ChunkFile::GetChunkPositions() const {
+    std::vector<glm::ivec3> positions;
+    positions.reserve(entries.size());
+    for (const DirectoryEntry& entry : entries)
+        positions.push_back(entry.chunk);
+    return positions;
+}
+
+bool ChunkFile::SavePalette(const std::array<uint32_t, 256>& newPalette) {
+    palette = newPalette;
+    return WriteAt(paletteOffset, palette.data(), sizeof(palette));
+}
+
+uint64_t ChunkFile::GetStoredBytes() const {
+    uint64_t bytes = 0;
+    for (const DirectoryEntry& entry : entries)
+        bytes += entry.size;
+    return bytes;
+}
+
+uint64_t ChunkFile::GetEncodedBytes() const {
+    uint64_t bytes = 0;
+    for (const DirectoryEntry& entry : entries)
+        bytes += entry.encodedSize;
+    return bytes;
+}
+
+uint64_t ChunkFile::GetUnusedBytes() const {
+    uint64_t used = GetDataStart(header.directoryCapacity);
+    for (const DirectoryEntry& entry : entries)
+        used += entry.capacity;
+    return header.dataEnd - std::min(used, header.dataEnd);
+}
+
+std::span<const uint8_t> ChunkFile::Pack(const VoxelChunk& voxels, DirectoryEntry& entry) {
+    encoded.clear();
+    entry.encoding = ChunkCodec::Encode(voxels, encoded);
+    entry.encodedSize = static_cast<uint32_t>(encoded.size());
+    entry.compression = Compression::None;
+    if (entry.encoding == ChunkCodec::Encoding::Uniform)
+        return encoded;
+
+    if (!compressor)
+        compressor = ZSTD_createCCtx();
+    compressed.resize(ZSTD_compressBound(encoded.size()));
+    size_t size = ZSTD_compressCCtx(compressor, compressed.data(), compressed.size(),
+                                    encoded.data(), encoded.size(), compressionLevel);
+    if (ZSTD_isError(size) || size >= encoded.size())
+        return encoded;
+
+    entry.compression = Compression::Zstd;
+    return std::span<const uint8_t>(compressed.data(), size);
+}
+
+bool ChunkFile::Unpack(const DirectoryEntry& entry, VoxelChunk& outChunk) {
+    compressed.resize(entry.size);
+    if (!ReadAt(entry.offset, compressed.data(), entry.size))
+        return false;
+
+    std::span<const uint8_t> data = compressed;
+    if (entry.compression == Compression::Zstd) {
+        if (!decompressor)
+            decompressor = ZSTD_createDCtx();
+        encoded.resize(entry.encodedSize);
+        size_t size = ZSTD_decompressDCtx(decompressor, encoded.data(), encoded.size(),
+                                          compressed.data(), compressed.size());
+        if (ZSTD_isError(size) || size != encoded.size()) {
+            LOG_ERROR("Chunk ({}, {}, {}) in {} is damaged: {}", entry.chunk.x, entry.chunk.y,
+                      entry.chunk.z, path.string(),
+                      ZSTD_isError(size) ? ZSTD_getErrorName(size) : "wrong size");
+            return false;
+        }
+        data = encoded;
+    } else if (entry.compression != Compression::None) {
+        return false;
+    }
+
+    if (!ChunkCodec::Decode(entry.encoding, data, outChunk)) {
+        LOG_ERROR("Chunk ({}, {}, {}) in {} does not decode", entry.chunk.x, entry.chunk.y,
+                  entry.chunk.z, path.string());
+        return false;
+    }
+    return true;
+}
+
+bool ChunkFile::WriteChunk(const glm::ivec3& chunk, const VoxelChunk& voxels,
+                           bool writeDirectory) {
+    auto it = lookup.find(chunk);
+    if (it == lookup.end()) {
+        if (entries.size() == header.directoryCapacity && !GrowDirectory())
+            return false;
+        it = lookup.emplace(chunk, static_cast<uint32_t>(entries.size())).first;
+        entries.push_back(DirectoryEntry{chunk});
+        header.chunkCount = static_cast<uint32_t>(entries.size());
+    }
+
+    uint32_t index = it->second;
+    DirectoryEntry entry = entries[index];
+    std::span<const uint8_t> data = Pack(voxels, entry);
+    entry.size = static_cast<uint32_t>(data.size());
+
+    // New chunks get a slot that fits exactly, ones that outgrew theirs some room to grow
+    if (entry.size > entry.capacity) {
+        bool moving = entry.capacity > 0;
+        entry.offset = header.dataEnd;
+        entry.capacity = entry.size + (moving ? entry.size / slotSlackDivisor : 0);
+        header.dataEnd += entry.capacity;
+    }
+
+    if (!WriteAt(entry.offset, data.data(), data.size()))
+        return false;
+    entries[index] = entry;
+    if (!writeDirectory)
+        return true;
+
+    return WriteAt(directoryOffset + uint64_t(index) * sizeof(DirectoryEntry), &entry,
+                   sizeof(entry)) &&
+           WriteAt(0, &header, sizeof(header));
+}
+
+bool ChunkFile::WriteDirectory() {
+    // Unused directory slots are zeroed
+    TrackedVector<DirectoryEntry, MemoryTag::Voxel> directory(header.directoryCapacity);
+    std::copy(entries.begin(), entries.end(), directory.begin());
+    return WriteAt(directoryOffset, directory.data(), directory.size() * sizeof(DirectoryEntry)) &&
+           WriteAt(0, &header, sizeof(header));
+}
+
+bool ChunkFile::GrowDirectory() {
+    uint32_t capacity = std::max(header.directoryCapacity * 2, 64u);
+    uint64_t dataStart = GetDataStart(capacity);
+    header.dataEnd = std::max(header.dataEnd, dataStart);
+
+    // Chunks in the way of the bigger directory move to the end of the file
+    std::vector<uint8_t> data;
+    for (DirectoryEntry& entry : entries) {
+        if (entry.offset >= dataStart)
+            continue;
+        data.resize(entry.size);
+        if (!ReadAt(entry.offset, data.data(), data.size()) ||
+            !WriteAt(header.dataEnd, data.data(), data.size()))
+            return false;
+        entry.offset = header.dataEnd;
+        header.dataEnd += entry.capacity;
+    }
+
+    header.directoryCapacity = capacity;
+    return WriteDirectory();
+}
+
+bool ChunkFile::WriteAt(uint64_t offset, const void* data, size_t size) {
+    file.seekp(static_cast<std::streamoff>(offset));
+    file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    if (!file) {
+        LOG_ERROR("Failed writing chunk file {}", path.string());
+        file.clear();
+        return false;
+    }
+    return true;
+}
+
+bool ChunkFile::ReadAt(uint64_t offset, void* data, size_t size) {
+    file.seekg(static_cast<std::streamoff>(offset));
+    file.read(static_cast<char*>(data), static_cast<std::streamsize>(size));
+    if (!file) {
+        file.clear();
+        return false;
+    }
+    return true;
+}
+
+bool ChunkFile::SaveVolume(const std::filesystem::path& path, const VoxelVolume& volume,
+                           int compressionLevel) {
+    ChunkFile chunkFile;
+    uint32_t capacity = static_cast<uint32_t>(std::max<size_t>(volume.GetChunkCount(), 1));
+    if (!chunkFile.Create(path, capacity, compressionLevel) ||
+        !chunkFile.SavePalette(volume.GetPalette()))
+        return false;
+
+    for (const auto& [chunk, voxels] : volume.GetChunks()) {
+        if (!chunkFile.WriteChunk(chunk, *voxels, false))
+            return false;
+    }
+    return chunkFile.WriteDirectory();
+}
+
+bool ChunkFile::LoadVolume(const std::filesystem::path& path, VoxelVolume& outVolume) {
+    ChunkFile chunkFile;
+    if (!chunkFile.Open(path))
+        return false;
+
+    outVolume.Clear();
+    outVolume.SetPalette(chunkFile.palette);
+
+    // In file order, so the reads are sequential
+    std::vector<const DirectoryEntry*> order;
+    order.reserve(chunkFile.entries.size());
+    for (const DirectoryEntry& entry : chunkFile.entries)
+        order.push_back(&entry);
+    std::sort(order.begin(), order.end(), [](const DirectoryEntry* a, const DirectoryEntry* b) {
+        return a->offset < b->offset;
+    });
+
+    for (const DirectoryEntry* entry : order) {
+        ChunkHandle voxels = ChunkHandle::Make();
+        if (!chunkFile.Unpack(*entry, voxels.Write()))
+            return false;
+        outVolume.SetChunk(entry->chunk, std::move(voxels));
+    }
+    return true;
+}
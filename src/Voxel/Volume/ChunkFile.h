@@ -0,0 +1,123 @@
+#pragma once
+#include <Voxel/pch.h>
+#include <glm/gtx/hash.hpp>
+#include <Voxel/Log/MemoryTracker.h>
+#include <Voxel/Volume/ChunkCodec.h>
+#include <Voxel/Volume/VoxelVolume.h>
+
+struct ZSTD_CCtx_s;
+struct ZSTD_DCtx_s;
+
+// Voxel chunks on disk (.vxchunks), each stored on its own so one chunk can be loaded or saved
+// without reading or rewriting the rest of the file. One thread at a time.
+//
+// A 64 byte header, the volume palette and a directory of chunks sit at the head of the file,
+// followed by the chunk data. Each chunk is encoded by ChunkCodec, then zstd compressed unless
+// that doesn't make it smaller. A chunk that grows past its slot moves to the end of the file
+// and leaves a hole behind, a directory that fills up doubles and moves the chunks in its way.
+class ChunkFile {
+  public:
+    static constexpr uint32_t magic = 0x4B435856; // "VXCK"
+    static constexpr uint16_t version = 1;
+    static constexpr const char* extension = ".vxchunks";
+    static constexpr int defaultCompressionLevel = 3;
+
+    ChunkFile() = default;
+    ~ChunkFile() { Close(); }
+
+    ChunkFile(const ChunkFile&) = delete;
+    ChunkFile& operator=(const ChunkFile&) = delete;
+
+    // Replaces any file at path with an empty one
+    bool Create(const std::filesystem::path& path, uint32_t directoryCapacity = 1024,
+                int compressionLevel = defaultCompressionLevel);
+    bool Open(const std::filesystem::path& path, int compressionLevel = defaultCompressionLevel);
+    void Close();
+    bool IsOpen() const { return file.is_open(); }
+
+    bool HasChunk(const glm::ivec3& chunk) const { return lookup.contains(chunk); }
+    bool LoadChunk(const glm::ivec3& chunk, VoxelChunk& outChunk);
+    bool SaveChunk(const glm::ivec3& chunk, const VoxelChunk& voxels);
+    std::vector<glm::ivec3> GetChunkPositions() const;
+    size_t GetChunkCount() const { return entries.size(); }
+    // Bytes a chunk takes in the file, 0 when there is no such chunk
+    uint32_t GetStoredSize(const glm::ivec3& chunk) const {
+        auto it = lookup.find(chunk);
+        return it != lookup.end() ? entries[it->second].size : 0;
+    }
+
+    const std::array<uint32_t, 256>& GetPalette() const { return palette; }
+    bool SavePalette(const std::array<uint32_t, 256>& newPalette);
+
+    uint64_t GetFileSize() const { return header.dataEnd; }
+    // Bytes of chunk data as stored, and as encoded before compression
+    uint64_t GetStoredBytes() const;
+    uint64_t GetEncodedBytes() const;
+    // Holes left by chunks that moved
+    uint64_t GetUnusedBytes() const;
+
+    // Every chunk of the volume, written in one sequential pass
+    static bool SaveVolume(const std::filesystem::path& path, const VoxelVolume& volume,
+                           int compressionLevel = defaultCompressionLevel);
+    static bool LoadVolume(const std::filesystem::path& path, VoxelVolume& outVolume);
+
+  private:
+    enum class Compression : uint8_t { None, Zstd };
+
+    struct Header {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t chunkSize;
+        uint32_t directoryCapacity;
+        uint32_t chunkCount;
+        // Where the next chunk that needs a new slot goes
+        uint64_t dataEnd;
+        uint8_t reserved[40];
+    };
+
+    struct DirectoryEntry {
+        glm::ivec3 chunk;
+        ChunkCodec::Encoding encoding;
+        Compression compression;
+        uint16_t reserved;
+        uint64_t offset;
+        // Stored bytes, in a slot of capacity bytes
+        uint32_t size;
+        uint32_t capacity;
+        uint32_t encodedSize;
+        uint32_t reserved2;
+    };
+
+    static_assert(sizeof(Header) == 64 && sizeof(DirectoryEntry) == 40);
+
+    static constexpr uint64_t paletteOffset = sizeof(Header);
+    static constexpr uint64_t directoryOffset = paletteOffset + 256 * sizeof(uint32_t);
+    static uint64_t GetDataStart(uint32_t directoryCapacity) {
+        return directoryOffset + uint64_t(directoryCapacity) * sizeof(DirectoryEntry);
+    }
+
+    bool Validate(uint64_t fileSize);
+    // Encodes and compresses a chunk into the scratch buffers, returns the bytes to store
+    std::span<const uint8_t> Pack(const VoxelChunk& voxels, DirectoryEntry& entry);
+    bool Unpack(const DirectoryEntry& entry, VoxelChunk& outChunk);
+    // writeDirectory false leaves the directory and header to WriteDirectory
+    bool WriteChunk(const glm::ivec3& chunk, const VoxelChunk& voxels, bool writeDirectory);
+    bool WriteDirectory();
+    bool GrowDirectory();
+
+    bool WriteAt(uint64_t offset, const void* data, size_t size);
+    bool ReadAt(uint64_t offset, void* data, size_t size);
+
+    std::filesystem::path path;
+    std::fstream file;
+    int compressionLevel = defaultCompressionLevel;
+    Header header{};
+    std::array<uint32_t, 256> palette{};
+    TrackedVector<DirectoryEntry, MemoryTag::Voxel> entries;
+    TrackedUnorderedMap<glm::ivec3, uint32_t, MemoryTag::Voxel> lookup;
+
+    ZSTD_CCtx_s* compressor = nullptr;
+    ZSTD_DCtx_s* decompressor = nullptr;
+    std::vector<uint8_t> encoded;
+    std::vector<uint8_t> compressed;
+};
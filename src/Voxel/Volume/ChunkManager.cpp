@@ -0,0 +1,389 @@
+#include "ChunkManager.h"
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <Voxel/Log/Profiler.h>
+#include <Voxel/Volume/ChunkMesher.h>
+
+ChunkManager::ChunkManager(const ChunkStreamingSettings& settings) : settings(settings) {}
+
+bool ChunkManager::Open(const std::filesystem::path& path) {
+    Close();
+    if (!source.Open(path))
+        return false;
+
+    cachePath = std::filesystem::temp_directory_path() /
+                (path.stem().string() + ".cache" + ChunkFile::extension);
+    if (!cache.Create(cachePath)) {
+        source.Close();
+        return false;
+    }
+
+    palette = source.GetPalette();
+    for (const glm::ivec3& chunk : source.GetChunkPositions())
+        known.insert(chunk);
+
+    running = true;
+    thread = std::thread(&ChunkManager::IoLoop, this);
+    lastUpdate = std::chrono::steady_clock::now();
+    LOG_INFO("Streaming {} chunks from {}, {} MB budget", known.size(), path.string(),
+             settings.memoryBudget >> 20);
+    return true;
+}
+
+void ChunkManager::Close() {
+    if (thread.joinable()) {
+        {
+            std::unique_lock<std::mutex> lock(jobMutex);
+            // Loads aren't wanted any more, but saves and stored evictions hold the only copy of
+            // edits, so the thread finishes those first
+            std::erase_if(jobs, [](const Job& job) { return job.type == JobType::Load; });
+            idle.wait(lock, [this]() { return jobs.empty() && !busy; });
+            running = false;
+        }
+        jobAdded.notify_all();
+        thread.join();
+    }
+
+    for (const auto& [chunk, residentChunk] : resident)
+        onChunkUnloaded.Notify(ChunkUnloadedEvent{chunk});
+    resident.clear();
+    loading.clear();
+    known.clear();
+    recent.clear();
+    remeshQueue.clear();
+    results.clear();
+    centerValid = false;
+    overBudgetWarned = false;
+
+    source.Close();
+    if (cache.IsOpen()) {
+        cache.Close();
+        std::error_code error;
+        std::filesystem::remove(cachePath, error);
+    }
+}
+
+void ChunkManager::Update(const glm::vec3& focus) {
+    PROFILE_SCOPE("Chunk Streaming");
+    if (!thread.joinable())
+        return;
+
+    TakeResults();
+
+    glm::ivec3 focusChunk = VoxelVolume::ToChunk(glm::ivec3(glm::floor(focus)));
+    if (!centerValid || focusChunk != center) {
+        center = focusChunk;
+        centerValid = true;
+        RequestLoads();
+    }
+
+    Remesh();
+    Evict();
+    PublishCounters();
+}
+
+Voxel ChunkManager::Get(const glm::ivec3& position) const {
+    const VoxelChunk* chunk = GetChunk(VoxelVolume::ToChunk(position));
+    if (!chunk)
+        return 0;
+
+    glm::ivec3 local = VoxelVolume::ToLocal(position);
+    return chunk->Get(local.x, local.y, local.z);
+}
+
+bool ChunkManager::Set(const glm::ivec3& position, Voxel voxel) {
+    glm::ivec3 local = VoxelVolume::ToLocal(position);
+    const VoxelChunk* current = GetChunk(VoxelVolume::ToChunk(position));
+    if (current && current->Get(local.x, local.y, local.z) == voxel)
+        return true;
+
+    VoxelChunk* chunk = EditChunk(VoxelVolume::ToChunk(position));
+    if (!chunk)
+        return false;
+    chunk->Set(local.x, local.y, local.z, voxel);
+    return true;
+}
+
+const VoxelChunk* ChunkManager::GetChunk(const glm::ivec3& chunk) const {
+    auto it = resident.find(chunk);
+    return it != resident.end() ? it->second.voxels.get() : nullptr;
+}
+
+VoxelChunk* ChunkManager::EditChunk(const glm::ivec3& chunk) {
+    auto it = resident.find(chunk);
+    if (it == resident.end()) {
+        if (known.contains(chunk)) {
+            if (loading.insert(chunk).second)
+                Push(Job{JobType::Load, chunk});
+            return nullptr;
+        }
+
+        known.insert(chunk);
+        recent.push_front(chunk);
+        it = resident.emplace(chunk, ResidentChunk{std::make_unique<VoxelChunk>(), recent.begin()})
+                 .first;
+    }
+
+    ResidentChunk& residentChunk = it->second;
+    residentChunk.edited = true;
+    Touch(residentChunk);
+    if (!residentChunk.remesh) {
+        residentChunk.remesh = true;
+        remeshQueue.push_back(chunk);
+    }
+    return residentChunk.voxels.get();
+}
+
+void ChunkManager::Save() {
+    if (!thread.joinable())
+        return;
+
+    // Evicted edits first, the resident copies of the same chunks are newer
+    Push(Job{JobType::Commit});
+    size_t count = 0;
+    for (auto& [chunk, residentChunk] : resident) {
+        if (!residentChunk.edited)
+            continue;
+        Push(Job{JobType::Save, chunk, std::make_unique<VoxelChunk>(*residentChunk.voxels)});
+        residentChunk.edited = false;
+        count++;
+    }
+    LOG_INFO("Saving {} resident and every evicted edited chunk", count);
+}
+
+void ChunkManager::WaitForIdle() {
+    std::unique_lock<std::mutex> lock(jobMutex);
+    idle.wait(lock, [this]() { return !running || (jobs.empty() && !busy); });
+}
+
+void ChunkManager::IoLoop() {
+    Profiler::SetThreadName("Chunk I/O");
+
+    std::unique_lock<std::mutex> lock(jobMutex);
+    while (true) {
+        jobAdded.wait(lock, [this]() { return !running || !jobs.empty(); });
+        if (!running)
+            break;
+
+        Job job = std::move(jobs.front());
+        jobs.pop_front();
+        busy = true;
+        lock.unlock();
+
+        RunJob(job);
+
+        lock.lock();
+        busy = false;
+        if (jobs.empty())
+            idle.notify_all();
+    }
+    idle.notify_all();
+}
+
+void ChunkManager::RunJob(Job& job) {
+    switch (job.type) {
+    case JobType::Load:
+        LoadJob(job.chunk);
+        break;
+    case JobType::Store: {
+        PROFILE_SCOPE("Store Chunk");
+        if (cache.SaveChunk(job.chunk, *job.voxels))
+            bytesWritten.fetch_add(cache.GetStoredSize(job.chunk), std::memory_order_relaxed);
+        break;
+    }
+    case JobType::Save: {
+        PROFILE_SCOPE("Save Chunk");
+        if (source.SaveChunk(job.chunk, *job.voxels))
+            bytesWritten.fetch_add(source.GetStoredSize(job.chunk), std::memory_order_relaxed);
+        break;
+    }
+    case JobType::Commit: {
+        PROFILE_SCOPE("Commit Chunks");
+        VoxelChunk voxels;
+        for (const glm::ivec3& chunk : cache.GetChunkPositions()) {
+            if (!cache.LoadChunk(chunk, voxels) || !source.SaveChunk(chunk, voxels))
+                continue;
+            bytesRead.fetch_add(cache.GetStoredSize(chunk), std::memory_order_relaxed);
+            bytesWritten.fetch_add(source.GetStoredSize(chunk), std::memory_order_relaxed);
+        }
+        cache.Create(cachePath);
+        break;
+    }
+    }
+}
+
+void ChunkManager::LoadJob(const glm::ivec3& chunk) {
+    PROFILE_SCOPE("Load Chunk");
+    LoadResult result{chunk, std::make_unique<VoxelChunk>()};
+    result.fromCache = cache.HasChunk(chunk);
+    ChunkFile& file = result.fromCache ? cache : source;
+
+    if (file.LoadChunk(chunk, *result.voxels)) {
+        bytesRead.fetch_add(file.GetStoredSize(chunk), std::memory_order_relaxed);
+        ChunkMesher::Build(*result.voxels, palette, result.vertices, result.indices);
+    } else {
+        result.voxels.reset();
+    }
+
+    std::lock_guard<std::mutex> lock(resultMutex);
+    results.push_back(std::move(result));
+}
+
+void ChunkManager::Push(Job job) {
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        jobs.push_back(std::move(job));
+    }
+    jobAdded.notify_one();
+}
+
+void ChunkManager::TakeResults() {
+    std::vector<LoadResult> taken;
+    {
+        std::lock_guard<std::mutex> lock(resultMutex);
+        size_t count = std::min(results.size(), static_cast<size_t>(settings.maxUploadsPerFrame));
+        std::move(results.begin(), results.begin() + count, std::back_inserter(taken));
+        results.erase(results.begin(), results.begin() + count);
+    }
+
+    for (LoadResult& result : taken) {
+        loading.erase(result.chunk);
+        if (!result.voxels) {
+            LOG_WARN("Chunk ({}, {}, {}) failed to load, it won't be asked for again",
+                     result.chunk.x, result.chunk.y, result.chunk.z);
+            known.erase(result.chunk);
+            continue;
+        }
+        if (resident.contains(result.chunk))
+            continue;
+
+        loadedCount++;
+        recent.push_front(result.chunk);
+        ResidentChunk residentChunk{std::move(result.voxels), recent.begin()};
+        residentChunk.edited = result.fromCache;
+        resident.emplace(result.chunk, std::move(residentChunk));
+        onChunkMeshChanged.Notify(ChunkMeshEvent{result.chunk, result.vertices, result.indices});
+    }
+}
+
+// Queued loads are replaced by the chunks near the new center, nearest first
+void ChunkManager::RequestLoads() {
+    PROFILE_SCOPE("Request Chunks");
+    int radius = settings.residentRadius;
+
+    std::vector<std::pair<int, glm::ivec3>> near;
+    for (int z = -radius; z <= radius; z++) {
+        for (int y = -radius; y <= radius; y++) {
+            for (int x = -radius; x <= radius; x++) {
+                int distance = x * x + y * y + z * z;
+                glm::ivec3 chunk = center + glm::ivec3(x, y, z);
+                if (distance <= radius * radius && known.contains(chunk))
+                    near.emplace_back(distance, chunk);
+            }
+        }
+    }
+    std::sort(near.begin(), near.end(), [](const auto& a, const auto& b) {
+        return a.first < b.first;
+    });
+
+    // Farthest first, so the nearest end up most recently used
+    for (auto it = near.rbegin(); it != near.rend(); ++it) {
+        auto residentChunk = resident.find(it->second);
+        if (residentChunk != resident.end())
+            Touch(residentChunk->second);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        std::erase_if(jobs, [this](const Job& job) {
+            if (job.type != JobType::Load)
+                return false;
+            loading.erase(job.chunk);
+            return true;
+        });
+
+        for (const auto& [distance, chunk] : near) {
+            if (!resident.contains(chunk) && loading.insert(chunk).second)
+                jobs.push_back(Job{JobType::Load, chunk});
+        }
+    }
+    jobAdded.notify_one();
+}
+
+void ChunkManager::Remesh() {
+    for (const glm::ivec3& chunk : remeshQueue) {
+        auto it = resident.find(chunk);
+        if (it == resident.end() || !it->second.remesh)
+            continue;
+
+        it->second.remesh = false;
+        ChunkMesher::Build(*it->second.voxels, palette, meshVertices, meshIndices);
+        onChunkMeshChanged.Notify(ChunkMeshEvent{chunk, meshVertices, meshIndices});
+    }
+    remeshQueue.clear();
+}
+
+// Least recently used first, passing over chunks near the camera: loads taken in and edits can
+// put far chunks ahead of them
+void ChunkManager::Evict() {
+    size_t budget = std::max<size_t>(settings.memoryBudget / sizeof(VoxelChunk), 1);
+    auto it = recent.end();
+    while (resident.size() > budget && it != recent.begin()) {
+        --it;
+        glm::ivec3 chunk = *it;
+        if (IsNear(chunk))
+            continue;
+
+        auto residentIt = resident.find(chunk);
+        if (residentIt->second.edited)
+            Push(Job{JobType::Store, chunk, std::move(residentIt->second.voxels)});
+        it = recent.erase(it);
+        resident.erase(residentIt);
+        onChunkUnloaded.Notify(ChunkUnloadedEvent{chunk});
+        evictedCount++;
+        evictedThisFrame++;
+    }
+
+    // Warned once per overrun, only near chunks are left to evict
+    if (resident.size() <= budget) {
+        overBudgetWarned = false;
+    } else if (!overBudgetWarned) {
+        LOG_WARN("The chunks near the camera need more than the {} MB streaming budget",
+                 settings.memoryBudget >> 20);
+        overBudgetWarned = true;
+    }
+}
+
+void ChunkManager::Touch(ResidentChunk& chunk) {
+    recent.splice(recent.begin(), recent, chunk.recent);
+}
+
+bool ChunkManager::IsNear(const glm::ivec3& chunk) const {
+    if (!centerValid)
+        return false;
+    glm::ivec3 offset = chunk - center;
+    int distance = offset.x * offset.x + offset.y * offset.y + offset.z * offset.z;
+    return distance <= settings.residentRadius * settings.residentRadius;
+}
+
+void ChunkManager::PublishCounters() {
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    float seconds = std::chrono::duration<float>(now - lastUpdate).count();
+    lastUpdate = now;
+
+    constexpr float megabyte = 1024.0f * 1024.0f;
+    uint64_t read = GetBytesRead();
+    uint64_t written = GetBytesWritten();
+    Profiler::SetCounter("Chunks resident", static_cast<float>(resident.size()));
+    Profiler::SetCounter("Chunks loading", static_cast<float>(loading.size()));
+    Profiler::SetCounter("Chunks evicted", static_cast<float>(evictedThisFrame));
+    Profiler::SetCounter("Chunk memory (MB)", GetResidentBytes() / megabyte);
+    if (seconds > 0.0f) {
+        Profiler::SetCounter("Chunk reads (MB/s)", (read - lastBytesRead) / megabyte / seconds);
+        Profiler::SetCounter("Chunk writes (MB/s)",
+                             (written - lastBytesWritten) / megabyte / seconds);
+    }
+    lastBytesRead = read;
+    lastBytesWritten = written;
+    evictedThisFrame = 0;
+}
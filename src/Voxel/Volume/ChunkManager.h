@@ -0,0 +1,163 @@
+#pragma once
+#include <Voxel/pch.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <glm/gtx/hash.hpp>
+#include <Voxel/Event/Event.h>
+#include <Voxel/Log/MemoryTracker.h>
+#include <Voxel/Rendering/RawModel.h>
+#include <Voxel/Volume/ChunkFile.h>
+
+// A chunk got a new mesh, in chunk local voxel units. Empty when there is nothing to draw.
+struct ChunkMeshEvent {
+    glm::ivec3 chunk;
+    std::span<const Vertex> vertices;
+    std::span<const unsigned int> indices;
+};
+
+struct ChunkUnloadedEvent {
+    glm::ivec3 chunk;
+};
+
+struct ChunkStreamingSettings {
+    // Voxel data kept in memory, least recently used chunks beyond it are evicted
+    size_t memoryBudget = size_t(512) << 20;
+    // Chunks within this many chunks of the camera stay resident whatever the budget
+    int residentRadius = 8;
+    // Loaded chunks handed to the renderer per frame, bounds the upload hitch
+    int maxUploadsPerFrame = 32;
+};
+
+// Keeps the chunks of a chunk file near the camera, and recently edited ones, in memory. The rest
+// lives on disk: chunks are loaded and meshed on a background I/O thread, and edited chunks that
+// get evicted go to a cache file in the temp directory, so the source file only changes on Save.
+// Everything but the I/O thread runs on the main thread.
+class ChunkManager {
+  public:
+    explicit ChunkManager(const ChunkStreamingSettings& settings = ChunkStreamingSettings());
+    // Unsaved edits are lost
+    ~ChunkManager() { Close(); }
+
+    ChunkManager(const ChunkManager&) = delete;
+    ChunkManager& operator=(const ChunkManager&) = delete;
+
+    bool Open(const std::filesystem::path& path);
+    void Close();
+
+    // Once per frame: takes in loaded chunks, asks for the ones near focus and evicts down to
+    // the budget
+    void Update(const glm::vec3& focus);
+
+    // Empty when the chunk isn't resident
+    Voxel Get(const glm::ivec3& position) const;
+    // False when the chunk exists but isn't resident yet, it is then asked for
+    bool Set(const glm::ivec3& position, Voxel voxel);
+    const VoxelChunk* GetChunk(const glm::ivec3& chunk) const;
+    // Marks the chunk edited and remeshes it at the next Update. Creates chunks that don't exist
+    // yet, returns nullptr for ones that aren't resident.
+    VoxelChunk* EditChunk(const glm::ivec3& chunk);
+
+    // Writes every edit to the source file, in the background
+    void Save();
+    // Blocks until the I/O thread has nothing left to do
+    void WaitForIdle();
+
+    size_t GetResidentCount() const { return resident.size(); }
+    size_t GetLoadingCount() const { return loading.size(); }
+    size_t GetEvictedCount() const { return evictedCount; }
+    size_t GetLoadedCount() const { return loadedCount; }
+    size_t GetResidentBytes() const { return resident.size() * sizeof(VoxelChunk); }
+    // Chunk data read from and written to disk, as stored
+    uint64_t GetBytesRead() const { return bytesRead.load(std::memory_order_relaxed); }
+    uint64_t GetBytesWritten() const { return bytesWritten.load(std::memory_order_relaxed); }
+
+    static inline Subject<ChunkMeshEvent> onChunkMeshChanged;
+    static inline Subject<ChunkUnloadedEvent> onChunkUnloaded;
+
+  private:
+    enum class JobType { Load, Store, Save, Commit };
+
+    struct Job {
+        JobType type;
+        glm::ivec3 chunk;
+        // The chunk to store or save
+        std::unique_ptr<VoxelChunk> voxels;
+    };
+
+    struct LoadResult {
+        glm::ivec3 chunk;
+        std::unique_ptr<VoxelChunk> voxels;
+        bool fromCache = false;
+        std::vector<Vertex> vertices;
+        std::vector<unsigned int> indices;
+    };
+
+    struct ResidentChunk {
+        std::unique_ptr<VoxelChunk> voxels;
+        std::list<glm::ivec3>::iterator recent;
+        // Differs from the source file
+        bool edited = false;
+        bool remesh = false;
+    };
+
+    // I/O thread
+    void IoLoop();
+    void RunJob(Job& job);
+    void LoadJob(const glm::ivec3& chunk);
+
+    void Push(Job job);
+    void TakeResults();
+    void RequestLoads();
+    void Remesh();
+    void Evict();
+    void Touch(ResidentChunk& chunk);
+    bool IsNear(const glm::ivec3& chunk) const;
+    void PublishCounters();
+
+    ChunkStreamingSettings settings;
+    std::filesystem::path cachePath;
+
+    // Only touched by the I/O thread once it runs
+    ChunkFile source;
+    ChunkFile cache;
+    std::array<uint32_t, 256> palette{};
+
+    // Main thread
+    TrackedUnorderedMap<glm::ivec3, ResidentChunk, MemoryTag::Voxel> resident;
+    TrackedUnorderedSet<glm::ivec3, MemoryTag::Voxel> loading;
+    // Every chunk in the source, the cache or memory
+    TrackedUnorderedSet<glm::ivec3, MemoryTag::Voxel> known;
+    // Most recently used first
+    std::list<glm::ivec3> recent;
+    TrackedVector<glm::ivec3, MemoryTag::Voxel> remeshQueue;
+    glm::ivec3 center{0};
+    bool centerValid = false;
+    bool overBudgetWarned = false;
+    size_t evictedCount = 0;
+    size_t loadedCount = 0;
+    size_t evictedThisFrame = 0;
+    std::vector<Vertex> meshVertices;
+    std::vector<unsigned int> meshIndices;
+
+    std::thread thread;
+    std::mutex jobMutex;
+    std::condition_variable jobAdded;
+    std::condition_variable idle;
+    std::deque<Job> jobs;
+    bool running = false;
+    bool busy = false;
+
+    std::mutex resultMutex;
+    std::vector<LoadResult> results;
+
+    std::atomic<uint64_t> bytesRead{0};
+    std::atomic<uint64_t> bytesWritten{0};
+    uint64_t lastBytesRead = 0;
+    uint64_t lastBytesWritten = 0;
+    std::chrono::steady_clock::time_point lastUpdate;
+};
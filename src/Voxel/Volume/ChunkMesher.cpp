@@ -0,0 +1,94 @@
+#include "ChunkMesher.h"
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <Voxel/Volume/VoxelVolume.h>
+
+namespace {
+struct Face {
+    glm::ivec3 normal;
+    // Counter clockwise seen from outside the voxel
+    glm::vec3 corners[4];
+    float shade;
+};
+
+constexpr int size = VoxelChunk::size;
+
+const Face faces[6] = {
+    {{1, 0, 0}, {{1, 0, 1}, {1, 0, 0}, {1, 1, 0}, {1, 1, 1}}, 0.8f},
+    {{-1, 0, 0}, {{0, 0, 0}, {0, 0, 1}, {0, 1, 1}, {0, 1, 0}}, 0.8f},
+    {{0, 1, 0}, {{0, 1, 0}, {0, 1, 1}, {1, 1, 1}, {1, 1, 0}}, 1.0f},
+    {{0, -1, 0}, {{0, 0, 0}, {1, 0, 0}, {1, 0, 1}, {0, 0, 1}}, 0.5f},
+    {{0, 0, 1}, {{0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1}}, 0.65f},
+    {{0, 0, -1}, {{1, 0, 0}, {0, 0, 0}, {0, 1, 0}, {1, 1, 0}}, 0.65f},
+};
+
+// Neighbouring chunks in face order, null where there is none
+using Neighbours = std::array<const VoxelChunk*, 6>;
+
+bool IsCovered(const VoxelChunk& chunk, const Neighbours& neighbours, int face, int x, int y,
+               int z) {
+    if (x < 0 || y < 0 || z < 0 || x >= size || y >= size || z >= size) {
+        const VoxelChunk* neighbour = neighbours[face];
+        constexpr int mask = size - 1;
+        return neighbour && neighbour->Get(x & mask, y & mask, z & mask) != 0;
+    }
+    return chunk.Get(x, y, z) != 0;
+}
+
+void BuildFaces(const VoxelChunk& chunk, const Neighbours& neighbours,
+                const std::array<uint32_t, 256>& palette, std::vector<Vertex>& vertices,
+                std::vector<unsigned int>& indices) {
+    vertices.clear();
+    indices.clear();
+
+    Voxel uniform;
+    if (chunk.IsUniform(uniform) && uniform == 0)
+        return;
+
+    for (int z = 0; z < size; z++) {
+        for (int y = 0; y < size; y++) {
+            for (int x = 0; x < size; x++) {
+                Voxel voxel = chunk.Get(x, y, z);
+                if (voxel == 0)
+                    continue;
+
+                glm::vec3 colour = VoxelVolume::UnpackColour(palette[voxel]);
+                glm::vec3 position(static_cast<float>(x), static_cast<float>(y),
+                                   static_cast<float>(z));
+                for (int face = 0; face < 6; face++) {
+                    const glm::ivec3& normal = faces[face].normal;
+                    if (IsCovered(chunk, neighbours, face, x + normal.x, y + normal.y,
+                                  z + normal.z))
+                        continue;
+
+                    unsigned int first = static_cast<unsigned int>(vertices.size());
+                    for (const glm::vec3& corner : faces[face].corners)
+                        vertices.emplace_back(position + corner, colour * faces[face].shade);
+                    for (unsigned int index : {0u, 1u, 2u, 0u, 2u, 3u})
+                        indices.push_back(first + index);
+                }
+            }
+        }
+    }
+}
+} // namespace
+
+void ChunkMesher::Build(const VoxelChunk& chunk, const std::array<uint32_t, 256>& palette,
+                        std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+    BuildFaces(chunk, Neighbours{}, palette, vertices, indices);
+}
+
+void ChunkMesher::Build(const VoxelVolume& volume, const glm::ivec3& chunk,
+                        std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+    const VoxelChunk* voxels = volume.GetChunk(chunk);
+    if (!voxels) {
+        vertices.clear();
+        indices.clear();
+        return;
+    }
+
+    Neighbours neighbours;
+    for (int face = 0; face < 6; face++)
+        neighbours[face] = volume.GetChunk(chunk + faces[face].normal);
+    BuildFaces(*voxels, neighbours, volume.GetPalette(), vertices, indices);
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include <Voxel/pch.h>
+#include <Voxel/Rendering/RawModel.h>
+#include <Voxel/Volume/VoxelChunk.h>
+
+class VoxelVolume;
+
+// Triangles for the visible faces of a chunk, in chunk local voxel units with one quad per face.
+class ChunkMesher {
+  public:
+    // Replaces the contents of vertices and indices. Colours come from the palette, darkened per
+    // face direction so the shapes read without lighting. Faces on the chunk border are always
+    // kept, the neighbouring chunk may not be loaded.
+    static void Build(const VoxelChunk& chunk, const std::array<uint32_t, 256>& palette,
+                      std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+    // The same for a chunk of a volume, with border faces culled against its neighbours
+    static void Build(const VoxelVolume& volume, const glm::ivec3& chunk,
+                      std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+};
@@ -0,0 +1,492 @@
+#include "MeshExporter.h"
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <format>
+#include <Voxel/Jobs/JobSystem.h>
+#include <Voxel/Volume/ChunkMesher.h>
+
+namespace {
+constexpr size_t bufferSize = size_t(1) << 20;
+
+// Appends to a file through a fixed size buffer
+class BufferedWriter {
+  public:
+    bool Open(const std::filesystem::path& path) {
+        file.open(path, std::ios::binary | std::ios::trunc);
+        buffer.reserve(bufferSize);
+        return file.is_open();
+    }
+
+    void Write(const void* data, size_t size) {
+        if (buffer.size() + size > bufferSize)
+            Flush();
+        if (size >= bufferSize) {
+            file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+            written += size;
+            return;
+        }
+        const char* bytes = static_cast<const char*>(data);
+        buffer.insert(buffer.end(), bytes, bytes + size);
+    }
+
+    template <typename T> void Put(const T& value) { Write(&value, sizeof(T)); }
+    void Text(std::string_view text) { Write(text.data(), text.size()); }
+
+    void Int(int64_t value) {
+        char digits[24];
+        Text({digits, std::to_chars(digits, digits + sizeof(digits), value).ptr});
+    }
+    void Float(float value, int precision) {
+        char digits[32];
+        Text({digits, std::to_chars(digits, digits + sizeof(digits), value,
+                                    std::chars_format::fixed, precision)
+                          .ptr});
+    }
+
+    void Flush() {
+        file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        written += buffer.size();
+        buffer.clear();
+    }
+
+    // Overwrites bytes written earlier, the next writes still go to the end
+    void Patch(uint64_t offset, const void* data, size_t size) {
+        Flush();
+        file.seekp(static_cast<std::streamoff>(offset));
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        file.seekp(0, std::ios::end);
+    }
+
+    // Copies a whole file to the end of this one, through the buffer
+    bool Append(const std::filesystem::path& path) {
+        Flush();
+        std::ifstream in(path, std::ios::binary);
+        buffer.resize(bufferSize);
+        while (in) {
+            in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            file.write(buffer.data(), in.gcount());
+            written += static_cast<uint64_t>(in.gcount());
+        }
+        buffer.clear();
+        return in.eof();
+    }
+
+    bool Close() {
+        Flush();
+        file.close();
+        return !file.fail();
+    }
+
+    // Where the next write lands
+    uint64_t GetPosition() const { return written + buffer.size(); }
+
+  private:
+    std::ofstream file;
+    std::vector<char> buffer;
+    uint64_t written = 0;
+};
+
+constexpr int cornersPerAxis = VoxelChunk::size + 1;
+
+// One chunk's mesh with its vertices shared, positions in voxel units of the volume
+struct ChunkMesh {
+    std::vector<glm::vec3> positions;
+    // 0x00BBGGRR, empty without colours
+    std::vector<uint32_t> colours;
+    // Into this chunk's vertices
+    std::vector<uint32_t> indices;
+
+    // Reused from chunk to chunk
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> faceIndices;
+    // Hash map from a vertex to its index. Corners hash to themselves, so each corner of the
+    // chunk has a bucket: the last vertex added there plus one, chained through next for the
+    // other colours at the same corner.
+    std::vector<uint32_t> buckets;
+    std::vector<uint32_t> next;
+
+    size_t GetBytes() const {
+        return positions.capacity() * sizeof(glm::vec3) +
+               (colours.capacity() + indices.capacity() + faceIndices.capacity() +
+                buckets.capacity() + next.capacity()) *
+                   sizeof(uint32_t) +
+               vertices.capacity() * sizeof(Vertex);
+    }
+};
+
+uint32_t PackColour(const glm::vec3& colour) {
+    auto channel = [](float value) {
+        return static_cast<uint32_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+    };
+    return channel(colour.x) | channel(colour.y) << 8 | channel(colour.z) << 16;
+}
+
+void MeshChunk(const VoxelVolume& volume, const glm::ivec3& chunk, bool colours,
+               ChunkMesh& mesh) {
+    ChunkMesher::Build(volume, chunk, mesh.vertices, mesh.faceIndices);
+    mesh.positions.clear();
+    mesh.colours.clear();
+    mesh.indices.clear();
+    mesh.next.clear();
+    mesh.buckets.assign(cornersPerAxis * cornersPerAxis * cornersPerAxis, 0);
+
+    glm::vec3 origin(chunk * VoxelChunk::size);
+    for (unsigned int face : mesh.faceIndices) {
+        const Vertex& vertex = mesh.vertices[face];
+        // Corners are whole numbers from 0 to 32
+        glm::ivec3 corner(vertex.position);
+        uint32_t& bucket =
+            mesh.buckets[corner.x + cornersPerAxis * (corner.y + cornersPerAxis * corner.z)];
+        uint32_t colour = colours ? PackColour(vertex.colour) : 0;
+
+        uint32_t index = bucket;
+        while (index != 0 && colours && mesh.colours[index - 1] != colour)
+            index = mesh.next[index - 1];
+        if (index == 0) {
+            mesh.positions.push_back(origin + vertex.position);
+            if (colours)
+                mesh.colours.push_back(colour);
+            mesh.next.push_back(bucket);
+            bucket = index = static_cast<uint32_t>(mesh.positions.size());
+        }
+        mesh.indices.push_back(index - 1);
+    }
+}
+
+// A file format, fed the chunks in order
+class FormatWriter {
+  public:
+    // The spill file is gone either way
+    virtual ~FormatWriter() {
+        if (spillPath.empty())
+            return;
+        spill.Close();
+        std::error_code error;
+        std::filesystem::remove(spillPath, error);
+    }
+    virtual bool Begin(BufferedWriter& out) = 0;
+    virtual void WriteChunk(BufferedWriter& out, const ChunkMesh& mesh, uint64_t firstVertex) = 0;
+    virtual bool Finish(BufferedWriter& out, uint64_t vertices, uint64_t triangles) = 0;
+
+    size_t GetBufferBytes() const { return spillPath.empty() ? 0 : bufferSize; }
+
+  protected:
+    // Faces or indices, which have to come after every vertex
+    bool OpenSpill(const std::filesystem::path& path) {
+        spillPath = path;
+        spillPath += ".part";
+        if (!spill.Open(spillPath)) {
+            LOG_ERROR("Unable to create {}", spillPath.string());
+            return false;
+        }
+        return true;
+    }
+    bool AppendSpill(BufferedWriter& out) { return spill.Close() && out.Append(spillPath); }
+
+    BufferedWriter spill;
+    std::filesystem::path spillPath;
+};
+
+// Text, vertices and faces interleaved since faces only refer back. Colours follow the
+// position on the v line, which most tools read.
+class ObjWriter : public FormatWriter {
+  public:
+    explicit ObjWriter(bool colours) : colours(colours) {}
+
+    bool Begin(BufferedWriter& out) override {
+        out.Text("# Voxel Editor mesh export\n");
+        return true;
+    }
+
+    void WriteChunk(BufferedWriter& out, const ChunkMesh& mesh, uint64_t firstVertex) override {
+        for (size_t i = 0; i < mesh.positions.size(); i++) {
+            const glm::vec3& position = mesh.positions[i];
+            out.Text("v ");
+            out.Int(static_cast<int64_t>(position.x));
+            out.Text(" ");
+            out.Int(static_cast<int64_t>(position.y));
+            out.Text(" ");
+            out.Int(static_cast<int64_t>(position.z));
+            if (colours) {
+                for (int channel = 0; channel < 3; channel++) {
+                    out.Text(" ");
+                    out.Float(((mesh.colours[i] >> (8 * channel)) & 0xFF) / 255.0f, 3);
+                }
+            }
+            out.Text("\n");
+        }
+        // One based
+        for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+            out.Text("f ");
+            out.Int(static_cast<int64_t>(firstVertex + mesh.indices[i] + 1));
+            out.Text(" ");
+            out.Int(static_cast<int64_t>(firstVertex + mesh.indices[i + 1] + 1));
+            out.Text(" ");
+            out.Int(static_cast<int64_t>(firstVertex + mesh.indices[i + 2] + 1));
+            out.Text("\n");
+        }
+    }
+
+    bool Finish(BufferedWriter&, uint64_t, uint64_t) override { return true; }
+
+  private:
+    bool colours;
+};
+
+// binary_little_endian 1.0. The counts in the header are zero padded so they can be patched in
+// place, and the faces are spilled until the vertices are done.
+class PlyWriter : public FormatWriter {
+  public:
+    PlyWriter(const std::filesystem::path& path, bool colours) : path(path), colours(colours) {}
+
+    bool Begin(BufferedWriter& out) override {
+        if (!OpenSpill(path))
+            return false;
+        out.Text("ply\nformat binary_little_endian 1.0\ncomment Voxel Editor mesh export\n"
+                 "element vertex ");
+        vertexCountOffset = out.GetPosition();
+        out.Text(std::format("{:010}\n", 0));
+        out.Text("property float x\nproperty float y\nproperty float z\n");
+        if (colours)
+            out.Text("property uchar red\nproperty uchar green\nproperty uchar blue\n");
+        out.Text("element face ");
+        faceCountOffset = out.GetPosition();
+        out.Text(std::format("{:010}\n", 0));
+        out.Text("property list uchar uint vertex_indices\nend_header\n");
+        return true;
+    }
+
+    void WriteChunk(BufferedWriter& out, const ChunkMesh& mesh, uint64_t firstVertex) override {
+        for (size_t i = 0; i < mesh.positions.size(); i++) {
+            out.Put(mesh.positions[i]);
+            if (colours)
+                out.Write(&mesh.colours[i], 3);
+        }
+        for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+            uint8_t face[13] = {3};
+            for (int corner = 0; corner < 3; corner++) {
+                uint32_t index = static_cast<uint32_t>(firstVertex + mesh.indices[i + corner]);
+                std::memcpy(face + 1 + corner * sizeof(index), &index, sizeof(index));
+            }
+            spill.Write(face, sizeof(face));
+        }
+    }
+
+    bool Finish(BufferedWriter& out, uint64_t vertices, uint64_t triangles) override {
+        if (!AppendSpill(out))
+            return false;
+        std::string vertexCount = std::format("{:010}", vertices);
+        std::string faceCount = std::format("{:010}", triangles);
+        out.Patch(vertexCountOffset, vertexCount.data(), vertexCount.size());
+        out.Patch(faceCountOffset, faceCount.data(), faceCount.size());
+        return true;
+    }
+
+  private:
+    std::filesystem::path path;
+    bool colours;
+    uint64_t vertexCountOffset = 0;
+    uint64_t faceCountOffset = 0;
+};
+
+// glTF 2.0 binary: header, JSON chunk, BIN chunk. The JSON gets a fixed amount of room filled
+// in at the end, the spec pads it with spaces anyway. BIN holds the interleaved vertices, 16
+// bytes with RGB8 colours or 12 without, then the 32 bit indices spilled until the end.
+class GlbWriter : public FormatWriter {
+  public:
+    GlbWriter(const std::filesystem::path& path, bool colours) : path(path), colours(colours) {}
+
+    bool Begin(BufferedWriter& out) override {
+        if (!OpenSpill(path))
+            return false;
+        std::vector<char> header(headerSize + jsonSpace + chunkHeaderSize, ' ');
+        out.Write(header.data(), header.size());
+        return true;
+    }
+
+    void WriteChunk(BufferedWriter& out, const ChunkMesh& mesh, uint64_t firstVertex) override {
+        for (size_t i = 0; i < mesh.positions.size(); i++) {
+            const glm::vec3& position = mesh.positions[i];
+            out.Put(position);
+            if (colours)
+                out.Put(mesh.colours[i]);
+            boundsMin = glm::min(boundsMin, position);
+            boundsMax = glm::max(boundsMax, position);
+        }
+        for (uint32_t index : mesh.indices)
+            spill.Put(static_cast<uint32_t>(firstVertex + index));
+    }
+
+    bool Finish(BufferedWriter& out, uint64_t vertices, uint64_t triangles) override {
+        if (!AppendSpill(out))
+            return false;
+
+        uint32_t stride = colours ? 16 : 12;
+        uint64_t vertexBytes = vertices * stride;
+        uint64_t indexBytes = triangles * 3 * sizeof(uint32_t);
+        std::string json = R"({"asset":{"version":"2.0","generator":"Voxel Editor"},)"
+                           R"("scene":0,"scenes":[{"nodes":[)";
+        if (triangles > 0) {
+            json += std::format(
+                R"(0]}}],"nodes":[{{"mesh":0}}],"meshes":[{{"primitives":[{{"attributes":)"
+                R"({{"POSITION":0{}}},"indices":{},"mode":4}}]}}],)"
+                R"("buffers":[{{"byteLength":{}}}],"bufferViews":[)"
+                R"({{"buffer":0,"byteLength":{},"byteStride":{},"target":34962}},)"
+                R"({{"buffer":0,"byteOffset":{},"byteLength":{},"target":34963}}],"accessors":[)"
+                R"({{"bufferView":0,"componentType":5126,"count":{},"type":"VEC3",)"
+                R"("min":[{},{},{}],"max":[{},{},{}]}},)",
+                colours ? R"(,"COLOR_0":1)" : "", colours ? 2 : 1, vertexBytes + indexBytes,
+                vertexBytes, stride, vertexBytes, indexBytes, vertices, boundsMin.x, boundsMin.y,
+                boundsMin.z, boundsMax.x, boundsMax.y, boundsMax.z);
+            if (colours)
+                json += std::format(R"({{"bufferView":0,"byteOffset":12,"componentType":5121,)"
+                                    R"("normalized":true,"count":{},"type":"VEC3"}},)",
+                                    vertices);
+            json += std::format(
+                R"({{"bufferView":1,"componentType":5125,"count":{},"type":"SCALAR"}}]}})",
+                triangles * 3);
+        } else {
+            json += "]}]}";
+        }
+        if (out.GetPosition() > std::numeric_limits<uint32_t>::max()) {
+            LOG_ERROR("{} would be over the 4 GB a .glb can hold", path.string());
+            return false;
+        }
+        if (json.size() > jsonSpace) {
+            LOG_ERROR("glTF JSON for {} needs {} bytes, more than the {} kept for it",
+                      path.string(), json.size(), jsonSpace);
+            return false;
+        }
+        // Without a buffer there is no BIN chunk, the JSON takes up its header too
+        json.resize(triangles > 0 ? jsonSpace : jsonSpace + chunkHeaderSize, ' ');
+
+        uint32_t header[5] = {0x46546C67, 2, static_cast<uint32_t>(out.GetPosition()),
+                              static_cast<uint32_t>(json.size()),
+                              0x4E4F534A}; // "glTF", version, length, JSON chunk
+        out.Patch(0, header, sizeof(header));
+        out.Patch(sizeof(header), json.data(), json.size());
+        if (triangles > 0) {
+            uint32_t binHeader[2] = {static_cast<uint32_t>(vertexBytes + indexBytes),
+                                     0x004E4942}; // BIN chunk
+            out.Patch(sizeof(header) + jsonSpace, binHeader, sizeof(binHeader));
+        }
+        return true;
+    }
+
+  private:
+    static constexpr uint32_t headerSize = 20;
+    static constexpr uint32_t jsonSpace = 4096;
+    static constexpr uint32_t chunkHeaderSize = 8;
+
+    std::filesystem::path path;
+    bool colours;
+    glm::vec3 boundsMin{std::numeric_limits<float>::max()};
+    glm::vec3 boundsMax{std::numeric_limits<float>::lowest()};
+};
+
+std::string GetExtension(const std::filesystem::path& path) {
+    std::string extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return extension;
+}
+} // namespace
+
+bool MeshExporter::IsSupported(const std::filesystem::path& path) {
+    std::string extension = GetExtension(path);
+    return extension == ".obj" || extension == ".ply" || extension == ".glb";
+}
+
+bool MeshExporter::Export(const std::filesystem::path& path, const VoxelVolume& volume,
+                          const MeshExportSettings& settings, MeshExportStats* outStats) {
+    auto start = std::chrono::steady_clock::now();
+    std::string extension = GetExtension(path);
+    std::unique_ptr<FormatWriter> format;
+    if (extension == ".obj")
+        format = std::make_unique<ObjWriter>(settings.colours);
+    else if (extension == ".ply")
+        format = std::make_unique<PlyWriter>(path, settings.colours);
+    else if (extension == ".glb")
+        format = std::make_unique<GlbWriter>(path, settings.colours);
+    else {
+        LOG_ERROR("Unable to export {}, expected .obj, .ply or .glb", path.string());
+        return false;
+    }
+
+    // Written next to the target and renamed at the end, like scenes
+    std::filesystem::path tempPath = path;
+    tempPath += ".tmp";
+    BufferedWriter out;
+    if (!out.Open(tempPath)) {
+        LOG_ERROR("Unable to write {}", tempPath.string());
+        return false;
+    }
+    // Leaves nothing behind when the export fails part way
+    auto fail = [&]() {
+        out.Close();
+        std::error_code error;
+        std::filesystem::remove(tempPath, error);
+        return false;
+    };
+    if (!format->Begin(out))
+        return fail();
+
+    // z, then y, then x, the same order every time
+    std::vector<glm::ivec3> order;
+    order.reserve(volume.GetChunkCount());
+    for (const auto& [chunk, voxels] : volume.GetChunks())
+        order.push_back(chunk);
+    std::sort(order.begin(), order.end(), [](const glm::ivec3& a, const glm::ivec3& b) {
+        return std::tie(a.z, a.y, a.x) < std::tie(b.z, b.y, b.x);
+    });
+
+    MeshExportStats stats;
+    std::vector<ChunkMesh> batch(static_cast<size_t>(std::max(settings.chunksPerBatch, 1)));
+    for (size_t first = 0; first < order.size(); first += batch.size()) {
+        size_t count = std::min(batch.size(), order.size() - first);
+        JobSystem::ParallelFor(count, [&](size_t i) {
+            MeshChunk(volume, order[first + i], settings.colours, batch[i]);
+        });
+
+        size_t working = bufferSize + format->GetBufferBytes();
+        for (size_t i = 0; i < count; i++) {
+            const ChunkMesh& mesh = batch[i];
+            format->WriteChunk(out, mesh, stats.vertices);
+            stats.vertices += mesh.positions.size();
+            stats.triangles += mesh.indices.size() / 3;
+            working += mesh.GetBytes();
+        }
+        stats.peakWorkingBytes = std::max(stats.peakWorkingBytes, working);
+
+        if (stats.vertices > std::numeric_limits<uint32_t>::max()) {
+            LOG_ERROR("Unable to export {}, it has more vertices than 32 bit indices can address",
+                      path.string());
+            return fail();
+        }
+    }
+
+    bool ok = format->Finish(out, stats.vertices, stats.triangles);
+    stats.fileBytes = out.GetPosition();
+    if (!ok || !out.Close()) {
+        LOG_ERROR("Failed writing {}", tempPath.string());
+        return fail();
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        LOG_ERROR("Unable to replace {}: {}", path.string(), error.message());
+        return false;
+    }
+
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() -
+                                                             start);
+    LOG_INFO("Exported {} ({} vertices, {} triangles, {:.1f} MB) in {:.1f} ms", path.string(),
+             stats.vertices, stats.triangles, stats.fileBytes / double(1 << 20), elapsed.count());
+    if (outStats)
+        *outStats = stats;
+    return true;
+}
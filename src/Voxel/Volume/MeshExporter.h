@@ -0,0 +1,36 @@
+#pragma once
+#include <Voxel/pch.h>
+#include <Voxel/Volume/VoxelVolume.h>
+
+struct MeshExportSettings {
+    // Vertex colours from the palette, shaded per face like in the editor
+    bool colours = true;
+    // Chunks meshed at once across the JobSystem, the working memory grows with it
+    int chunksPerBatch = 16;
+};
+
+struct MeshExportStats {
+    uint64_t vertices = 0;
+    uint64_t triangles = 0;
+    uint64_t fileBytes = 0;
+    // Most memory held for meshes and buffers at any one time
+    size_t peakWorkingBytes = 0;
+};
+
+// Writes the face culled mesh of a volume as OBJ, binary PLY or glTF 2.0 binary (.glb), picked by
+// the file extension. Chunks are meshed in batches in position order and written out straight
+// away through a buffer, so memory stays bounded however large the volume is. Vertices are
+// shared between faces of a chunk that have the same position and colour, not across chunks.
+//
+// PLY and glb need the counts before the data: the header is patched once the counts are known,
+// and the faces or indices go to a temporary file next to the output and are appended at the
+// end. Positions are in voxel units, Y up.
+class MeshExporter {
+  public:
+    static bool Export(const std::filesystem::path& path, const VoxelVolume& volume,
+                       const MeshExportSettings& settings = MeshExportSettings(),
+                       MeshExportStats* outStats = nullptr);
+
+    // Extensions Export understands, lower case
+    static bool IsSupported(const std::filesystem::path& path);
+};
@@ -0,0 +1,51 @@
+#include "VolumeAutosave.h"
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+
+bool VolumeAutosave::Save(const VoxelVolume& volume, const std::filesystem::path& path,
+                          int compressionLevel) {
+    if (IsSaving())
+        return false;
+    if (thread.joinable())
+        thread.join();
+
+    auto start = std::chrono::steady_clock::now();
+    VoxelVolume snapshot = volume.Snapshot();
+    snapshotMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start)
+                     .count();
+
+    saving.store(true, std::memory_order_release);
+    thread = std::thread([this, snapshot = std::move(snapshot), path, compressionLevel]() {
+        auto writeStart = std::chrono::steady_clock::now();
+        std::filesystem::path tempPath = path;
+        tempPath += ".tmp";
+
+        bool ok = ChunkFile::SaveVolume(tempPath, snapshot, compressionLevel);
+        std::error_code error;
+        if (ok) {
+            std::filesystem::rename(tempPath, path, error);
+            if (error)
+                LOG_ERROR("Unable to replace {}: {}", path.string(), error.message());
+        } else {
+            std::filesystem::remove(tempPath, error);
+        }
+        ok = ok && !error;
+
+        float elapsed = std::chrono::duration<float, std::milli>(
+                            std::chrono::steady_clock::now() - writeStart)
+                            .count();
+        if (ok)
+            LOG_INFO("Autosaved {} chunks to {} in {:.1f} ms", snapshot.GetChunkCount(),
+                     path.string(), elapsed);
+        writeMs.store(elapsed, std::memory_order_relaxed);
+        succeeded.store(ok, std::memory_order_relaxed);
+        saving.store(false, std::memory_order_release);
+    });
+    return true;
+}
+
+bool VolumeAutosave::Wait() {
+    if (thread.joinable())
+        thread.join();
+    return succeeded.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <Voxel/pch.h>
+#include <atomic>
+#include <thread>
+#include <Voxel/Volume/ChunkFile.h>
+#include <Voxel/Volume/VoxelVolume.h>
+
+// Saves a volume to a chunk file on a background thread while editing carries on. Save takes a
+// VoxelVolume::Snapshot, which costs a handle copy per chunk, and the thread writes that: chunks
+// edited in the meantime are copied by the edit and the file gets them as they were at Save.
+// The file is written next to the target and renamed over it once complete.
+class VolumeAutosave {
+  public:
+    VolumeAutosave() = default;
+    // Waits for a save still running
+    ~VolumeAutosave() { Wait(); }
+
+    VolumeAutosave(const VolumeAutosave&) = delete;
+    VolumeAutosave& operator=(const VolumeAutosave&) = delete;
+
+    // False without saving when the previous save hasn't finished
+    bool Save(const VoxelVolume& volume, const std::filesystem::path& path,
+              int compressionLevel = ChunkFile::defaultCompressionLevel);
+    bool IsSaving() const { return saving.load(std::memory_order_acquire); }
+    // Blocks until the running save is done, returns whether the last save worked
+    bool Wait();
+
+    // Time Save held up the caller for, and the background write of the last finished save
+    float GetSnapshotMs() const { return snapshotMs; }
+    float GetWriteMs() const { return writeMs.load(std::memory_order_relaxed); }
+
+  private:
+    std::thread thread;
+    std::atomic<bool> saving = false;
+    std::atomic<bool> succeeded = true;
+    float snapshotMs = 0.0f;
+    std::atomic<float> writeMs = 0.0f;
+};
@@ -0,0 +1,65 @@
+#include "VolumeMesh.h"
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <Voxel/Jobs/JobSystem.h>
+#include <Voxel/Volume/ChunkMesher.h>
+
+size_t VolumeMesh::Update(VoxelVolume& volume) {
+    const glm::ivec3 neighbours[] = {{1, 0, 0},  {-1, 0, 0}, {0, 1, 0},
+                                     {0, -1, 0}, {0, 0, 1},  {0, 0, -1}};
+    VoxelVolume::ChunkSet stale;
+    for (const glm::ivec3& chunk : volume.GetDirtyChunks()) {
+        stale.insert(chunk);
+        for (const glm::ivec3& neighbour : neighbours) {
+            if (volume.GetChunk(chunk + neighbour))
+                stale.insert(chunk + neighbour);
+        }
+    }
+    volume.ClearDirtyChunks();
+    return Remesh(volume, std::vector<glm::ivec3>(stale.begin(), stale.end()));
+}
+
+size_t VolumeMesh::Rebuild(VoxelVolume& volume) {
+    meshes.clear();
+    volume.ClearDirtyChunks();
+    std::vector<glm::ivec3> chunks;
+    chunks.reserve(volume.GetChunkCount());
+    for (const auto& [chunk, voxels] : volume.GetChunks())
+        chunks.push_back(chunk);
+    return Remesh(volume, chunks);
+}
+
+const VolumeMesh::ChunkMesh* VolumeMesh::GetMesh(const glm::ivec3& chunk) const {
+    auto it = meshes.find(chunk);
+    return it != meshes.end() ? &it->second : nullptr;
+}
+
+size_t VolumeMesh::GetTriangleCount() const {
+    size_t count = 0;
+    for (const auto& [chunk, mesh] : meshes)
+        count += mesh.indices.size() / 3;
+    return count;
+}
+
+size_t VolumeMesh::Remesh(const VoxelVolume& volume, const std::vector<glm::ivec3>& chunks) {
+    // Entries made up front, the map isn't touched while the jobs run
+    std::vector<std::pair<glm::ivec3, ChunkMesh*>> work;
+    work.reserve(chunks.size());
+    for (const glm::ivec3& chunk : chunks) {
+        if (volume.GetChunk(chunk))
+            work.emplace_back(chunk, &meshes[chunk]);
+        else
+            meshes.erase(chunk);
+    }
+
+    JobSystem::ParallelFor(work.size(), [&](size_t i) {
+        ChunkMesh& mesh = *work[i].second;
+        ChunkMesher::Build(volume, work[i].first, mesh.vertices, mesh.indices);
+    });
+
+    for (const auto& [chunk, mesh] : work) {
+        if (mesh->indices.empty())
+            meshes.erase(chunk);
+    }
+    return work.size();
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <Voxel/pch.h>
+#include <glm/gtx/hash.hpp>
+#include <Voxel/Log/MemoryTracker.h>
+#include <Voxel/Rendering/RawModel.h>
+#include <Voxel/Volume/VoxelVolume.h>
+
+// Meshes of the chunks of a volume, kept up to date from its dirty chunks. A chunk's border faces
+// are culled against its neighbours, so the neighbours of a changed chunk are meshed again too.
+// Chunks with nothing to draw have no mesh.
+class VolumeMesh {
+  public:
+    struct ChunkMesh {
+        std::vector<Vertex> vertices;
+        std::vector<unsigned int> indices;
+    };
+    using MeshMap = TrackedUnorderedMap<glm::ivec3, ChunkMesh, MemoryTag::Rendering>;
+
+    // Meshes the dirty chunks and their neighbours across the JobSystem, then clears the dirty
+    // chunks. Returns the number of chunks meshed.
+    size_t Update(VoxelVolume& volume);
+    // Meshes every chunk of the volume from scratch
+    size_t Rebuild(VoxelVolume& volume);
+
+    // nullptr when the chunk has nothing to draw
+    const ChunkMesh* GetMesh(const glm::ivec3& chunk) const;
+    const MeshMap& GetMeshes() const { return meshes; }
+    size_t GetTriangleCount() const;
+
+  private:
+    size_t Remesh(const VoxelVolume& volume, const std::vector<glm::ivec3>& chunks);
+
+    MeshMap meshes;
+};
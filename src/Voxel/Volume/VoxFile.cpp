@@ -0,0 +1,441 @@
+#include "VoxFile.h"
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <format>
+#include <sstream>
+#include <glm/gtc/quaternion.hpp>
+#include <Voxel/ECS/Components/HierarchyComponent.h>
+#include <Voxel/ECS/Components/MeshComponent.h>
+#include <Voxel/ECS/Components/MetaComponent.h>
+#include <Voxel/ECS/Components/TransformComponent.h>
+#include <Voxel/Jobs/JobSystem.h>
+#include <Voxel/Memory/MappedFile.h>
+#include <Voxel/Volume/ChunkMesher.h>
+
+namespace {
+// Deep enough for any real file, stops cycles in broken ones
+constexpr int maxNodeDepth = 64;
+
+using Dict = std::unordered_map<std::string, std::string>;
+
+// Little endian reads that stop at the end of the bytes, check ok once at the end
+struct Reader {
+    std::span<const std::byte> bytes;
+    size_t offset = 0;
+    bool ok = true;
+
+    std::span<const std::byte> Take(size_t size) {
+        if (!ok || size > bytes.size() - offset) {
+            ok = false;
+            return {};
+        }
+        std::span<const std::byte> taken = bytes.subspan(offset, size);
+        offset += size;
+        return taken;
+    }
+
+    int32_t Int() {
+        int32_t value = 0;
+        std::span<const std::byte> taken = Take(sizeof(value));
+        if (ok)
+            std::memcpy(&value, taken.data(), sizeof(value));
+        return value;
+    }
+
+    std::string String() {
+        int32_t size = Int();
+        std::span<const std::byte> taken = Take(size < 0 ? bytes.size() + 1 : size_t(size));
+        return ok ? std::string(reinterpret_cast<const char*>(taken.data()), taken.size()) : "";
+    }
+
+    Dict ReadDict() {
+        Dict dict;
+        int32_t count = Int();
+        for (int32_t i = 0; i < count && ok; i++) {
+            std::string key = String();
+            dict[key] = String();
+        }
+        return dict;
+    }
+
+    bool AtEnd() const { return offset == bytes.size(); }
+};
+
+std::string GetString(const Dict& dict, const std::string& key) {
+    auto it = dict.find(key);
+    return it == dict.end() ? "" : it->second;
+}
+
+// MagicaVoxel's palette for files without an RGBA chunk: a 6x6x6 colour cube brightest first,
+// then ramps of red, green, blue and grey
+std::array<uint32_t, 256> DefaultPalette() {
+    std::array<uint32_t, 256> palette{};
+    size_t next = 1;
+    for (int r = 5; r >= 0; r--) {
+        for (int g = 5; g >= 0; g--) {
+            for (int b = 5; b >= 0; b--) {
+                if (r == 0 && g == 0 && b == 0)
+                    continue;
+                palette[next++] = 0xFF000000u | uint32_t(b * 0x33) << 16 |
+                                  uint32_t(g * 0x33) << 8 | uint32_t(r * 0x33);
+            }
+        }
+    }
+    for (int channel = 0; channel < 4; channel++) {
+        for (uint32_t level : {0xEEu, 0xDDu, 0xBBu, 0xAAu, 0x88u, 0x77u, 0x55u, 0x44u, 0x22u,
+                               0x11u}) {
+            uint32_t colour = channel == 3 ? level * 0x010101u : level << (8 * channel);
+            palette[next++] = 0xFF000000u | colour;
+        }
+    }
+    return palette;
+}
+
+// MagicaVoxel (x, y, z) to (x, z, -y), as a matrix
+const glm::mat3 toEditorAxes(1, 0, 0, 0, 0, -1, 0, 1, 0);
+
+// _r packs a signed permutation matrix: the column of row 0's one in bits 0-1, row 1's in
+// bits 2-3, row 2 takes the column left over, and bits 4-6 negate rows 0-2
+bool DecodeRotation(uint8_t bits, glm::mat3& outRotation) {
+    int row0 = bits & 3;
+    int row1 = (bits >> 2) & 3;
+    if (row0 > 2 || row1 > 2 || row0 == row1)
+        return false;
+    int row2 = 3 - row0 - row1;
+
+    outRotation = glm::mat3(0.0f);
+    outRotation[row0][0] = bits & 0x10 ? -1.0f : 1.0f;
+    outRotation[row1][1] = bits & 0x20 ? -1.0f : 1.0f;
+    outRotation[row2][2] = bits & 0x40 ? -1.0f : 1.0f;
+    return true;
+}
+
+// XYZI is a voxel count followed by x, y, z and a palette index per voxel, in any order. Models
+// are at most 8x8x8 chunks, so chunks are looked up in a flat table rather than the map.
+size_t DecodeModel(std::span<const std::byte> content, VoxModel& model) {
+    uint32_t count = 0;
+    std::memcpy(&count, content.data(), sizeof(count));
+    const uint8_t* voxel = reinterpret_cast<const uint8_t*>(content.data()) + sizeof(count);
+
+    glm::ivec3 chunkCount = (model.size + (VoxelChunk::size - 1)) >> VoxelChunk::shift;
+    std::vector<VoxelChunk*> chunks(static_cast<size_t>(chunkCount.x) * chunkCount.y *
+                                    chunkCount.z);
+    const glm::ivec3 size = model.size;
+    size_t skipped = 0;
+    for (uint32_t i = 0; i < count; i++, voxel += 4) {
+        // size is already in editor axes
+        int x = voxel[0], y = voxel[2], z = size.z - 1 - voxel[1];
+        if (voxel[3] == 0 || x >= size.x || y >= size.y || z < 0) {
+            skipped++;
+            continue;
+        }
+
+        glm::ivec3 position(x, y, z);
+        glm::ivec3 chunk = VoxelVolume::ToChunk(position);
+        VoxelChunk*& voxels = chunks[chunk.x + chunkCount.x * (chunk.y + chunkCount.y * chunk.z)];
+        if (!voxels)
+            voxels = &model.voxels.GetOrCreateChunk(chunk);
+        glm::ivec3 local = VoxelVolume::ToLocal(position);
+        voxels->Set(local.x, local.y, local.z, voxel[3]);
+    }
+    model.voxelCount = count - skipped;
+    return skipped;
+}
+
+// Every chunk mesh of the model in one, around the model's pivot
+void BuildMesh(const VoxModel& model, std::vector<Vertex>& vertices,
+               std::vector<unsigned int>& indices) {
+    std::vector<Vertex> chunkVertices;
+    std::vector<unsigned int> chunkIndices;
+    for (const auto& [chunk, voxels] : model.voxels.GetChunks()) {
+        ChunkMesher::Build(model.voxels, chunk, chunkVertices, chunkIndices);
+        glm::vec3 offset(chunk * VoxelChunk::size - model.pivot);
+        unsigned int first = static_cast<unsigned int>(vertices.size());
+        for (const Vertex& vertex : chunkVertices)
+            vertices.emplace_back(vertex.position + offset, vertex.colour);
+        for (unsigned int index : chunkIndices)
+            indices.push_back(first + index);
+    }
+}
+} // namespace
+
+bool VoxFile::Load(const std::filesystem::path& path, VoxFile& outFile) {
+    auto start = std::chrono::steady_clock::now();
+    MappedFile file;
+    if (!file.Open(path)) {
+        LOG_ERROR("Unable to open {}", path.string());
+        return false;
+    }
+
+    outFile.DeleteMeshes();
+    outFile = VoxFile();
+    outFile.path = path;
+    outFile.palette = DefaultPalette();
+
+    Reader reader{file.GetBytes()};
+    std::span<const std::byte> magic = reader.Take(4);
+    int32_t version = reader.Int();
+    std::span<const std::byte> mainId = reader.Take(4);
+    int32_t mainContent = reader.Int();
+    int32_t mainChildren = reader.Int();
+    if (!reader.ok || std::memcmp(magic.data(), "VOX ", 4) != 0 ||
+        std::memcmp(mainId.data(), "MAIN", 4) != 0) {
+        LOG_ERROR("{} is not a .vox file", path.string());
+        return false;
+    }
+    if (version != 150 && version != 200)
+        LOG_WARN("{} has version {}, reading it like version 200", path.string(), version);
+
+    reader.Take(std::max(mainContent, 0));
+    Reader children{reader.Take(std::max(mainChildren, 0))};
+    if (!reader.ok) {
+        LOG_ERROR("{} is truncated", path.string());
+        return false;
+    }
+
+    while (children.ok && !children.AtEnd()) {
+        std::span<const std::byte> id = children.Take(4);
+        int32_t contentSize = children.Int();
+        int32_t childrenSize = children.Int();
+        std::span<const std::byte> content = children.Take(std::max(contentSize, 0));
+        // Only MAIN has children
+        children.Take(std::max(childrenSize, 0));
+        if (!children.ok) {
+            LOG_ERROR("{} is truncated", path.string());
+            return false;
+        }
+
+        char name[5] = {};
+        std::memcpy(name, id.data(), 4);
+        if (!outFile.ReadChunk(name, content)) {
+            LOG_ERROR("{}: malformed {} chunk at byte {}", path.string(), name,
+                      content.data() - file.GetBytes().data());
+            return false;
+        }
+    }
+    if (outFile.modelVoxels.size() != outFile.models.size()) {
+        LOG_ERROR("{}: model {} has a SIZE but no XYZI", path.string(),
+                  outFile.modelVoxels.size());
+        return false;
+    }
+
+    std::atomic<size_t> skipped = 0;
+    JobSystem::ParallelFor(outFile.models.size(), [&](size_t i) {
+        VoxModel& model = outFile.models[i];
+        skipped += DecodeModel(outFile.modelVoxels[i], model);
+        model.voxels.SetPalette(outFile.palette);
+    });
+    outFile.modelVoxels.clear();
+    if (skipped > 0)
+        LOG_WARN("{}: skipped {} empty or out of bounds voxels", path.string(), skipped.load());
+
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() -
+                                                             start);
+    LOG_INFO("Loaded {} ({} models, {} voxels, {} nodes) in {:.1f} ms", path.string(),
+             outFile.models.size(), outFile.GetVoxelCount(), outFile.nodes.size(),
+             elapsed.count());
+    return true;
+}
+
+bool VoxFile::ReadChunk(const char* id, std::span<const std::byte> content) {
+    Reader reader{content};
+    std::string_view type(id);
+
+    if (type == "SIZE") {
+        int32_t x = reader.Int(), y = reader.Int(), z = reader.Int();
+        if (!reader.ok || x < 1 || y < 1 || z < 1 || x > maxModelSize || y > maxModelSize ||
+            z > maxModelSize)
+            return false;
+
+        VoxModel& model = models.emplace_back();
+        model.size = glm::ivec3(x, z, y);
+        // Voxel x occupies [x - size / 2, x - size / 2 + 1) about the centre, the same holds
+        // along -y once it is flipped
+        model.pivot = glm::ivec3(x / 2, z / 2, y - y / 2);
+    } else if (type == "XYZI") {
+        int32_t count = reader.Int();
+        if (!reader.ok || count < 0 || modelVoxels.size() + 1 != models.size() ||
+            size_t(count) > (content.size() - sizeof(count)) / 4)
+            return false;
+        modelVoxels.push_back(content);
+    } else if (type == "RGBA") {
+        std::span<const std::byte> colours = reader.Take(256 * sizeof(uint32_t));
+        if (!reader.ok)
+            return false;
+        // Colour i is palette index i + 1, the last one is unused
+        std::memcpy(palette.data() + 1, colours.data(), 255 * sizeof(uint32_t));
+    } else if (type == "nTRN") {
+        int32_t nodeId = reader.Int();
+        Dict attributes = reader.ReadDict();
+        Node node;
+        node.type = NodeType::Transform;
+        node.name = GetString(attributes, "_name");
+        node.hidden = GetString(attributes, "_hidden") == "1";
+        node.children.push_back(reader.Int());
+        reader.Int(); // Reserved
+        node.layer = reader.Int();
+        int32_t frameCount = reader.Int();
+        for (int32_t frame = 0; frame < frameCount && reader.ok; frame++) {
+            Dict values = reader.ReadDict();
+            if (frame > 0)
+                continue;
+            if (std::string rotation = GetString(values, "_r"); !rotation.empty())
+                node.rotation = static_cast<uint8_t>(std::atoi(rotation.c_str()));
+            std::istringstream translation(GetString(values, "_t"));
+            translation >> node.translation.x >> node.translation.y >> node.translation.z;
+        }
+        if (!reader.ok)
+            return false;
+        nodes[nodeId] = std::move(node);
+    } else if (type == "nGRP") {
+        int32_t nodeId = reader.Int();
+        Dict attributes = reader.ReadDict();
+        Node node;
+        node.type = NodeType::Group;
+        node.hidden = GetString(attributes, "_hidden") == "1";
+        int32_t childCount = reader.Int();
+        for (int32_t i = 0; i < childCount && reader.ok; i++)
+            node.children.push_back(reader.Int());
+        if (!reader.ok)
+            return false;
+        nodes[nodeId] = std::move(node);
+    } else if (type == "nSHP") {
+        int32_t nodeId = reader.Int();
+        reader.ReadDict();
+        Node node;
+        node.type = NodeType::Shape;
+        int32_t modelCount = reader.Int();
+        for (int32_t i = 0; i < modelCount && reader.ok; i++) {
+            int32_t model = reader.Int();
+            reader.ReadDict();
+            if (i == 0)
+                node.model = model;
+        }
+        if (!reader.ok)
+            return false;
+        nodes[nodeId] = std::move(node);
+    } else if (type == "LAYR") {
+        int32_t layer = reader.Int();
+        Dict attributes = reader.ReadDict();
+        if (!reader.ok)
+            return false;
+        hiddenLayers[layer] = GetString(attributes, "_hidden") == "1";
+    }
+    return true;
+}
+
+Entity VoxFile::Instantiate(EntityRegistry* registry) {
+    auto start = std::chrono::steady_clock::now();
+    DeleteMeshes();
+
+    std::vector<std::vector<Vertex>> vertices(models.size());
+    std::vector<std::vector<unsigned int>> indices(models.size());
+    JobSystem::ParallelFor(models.size(),
+                           [&](size_t i) { BuildMesh(models[i], vertices[i], indices[i]); });
+
+    // GL calls stay on this thread
+    meshes.resize(models.size());
+    for (size_t i = 0; i < models.size(); i++) {
+        if (!indices[i].empty())
+            meshes[i] = std::make_unique<RawModel>(std::move(vertices[i]), std::move(indices[i]));
+    }
+
+    Entity root = InvalidEntity;
+    if (nodes.contains(0)) {
+        root = InstantiateNode(registry, 0, InvalidEntity, 0);
+    } else {
+        // Version 150 files have no scene graph, every model sits at the origin
+        root = registry->CreateEntity();
+        registry->AddComponent<MetaComponent>(root, path.stem().string(), true);
+        registry->AddComponent<TransformComponent>(root, glm::vec3(0.0f));
+        registry->AddComponent<HierarchyComponent>(root);
+        for (size_t i = 0; i < models.size(); i++) {
+            Entity entity = registry->CreateEntity();
+            registry->AddComponent<MetaComponent>(entity, std::format("Model {}", i), true);
+            registry->AddComponent<TransformComponent>(entity, glm::vec3(0.0f));
+            if (meshes[i])
+                registry->AddComponent<MeshComponent>(entity, meshes[i].get());
+            registry->AddComponent<HierarchyComponent>(entity, root);
+        }
+    }
+
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() -
+                                                             start);
+    LOG_INFO("Instantiated {} in {:.1f} ms", path.string(), elapsed.count());
+    return root;
+}
+
+Entity VoxFile::InstantiateNode(EntityRegistry* registry, int nodeId, Entity parent, int depth) {
+    auto it = nodes.find(nodeId);
+    if (it == nodes.end() || depth > maxNodeDepth) {
+        LOG_WARN("{}: skipping node {}, it is missing or nested too deep", path.string(), nodeId);
+        return InvalidEntity;
+    }
+    const Node& node = it->second;
+
+    // Groups hang their children off the transform above them
+    if (node.type == NodeType::Group) {
+        for (int child : node.children)
+            InstantiateNode(registry, child, parent, depth + 1);
+        return InvalidEntity;
+    }
+    if (node.type == NodeType::Shape)
+        return InvalidEntity;
+
+    const Node* child = nullptr;
+    if (auto childIt = nodes.find(node.children.front()); childIt != nodes.end())
+        child = &childIt->second;
+    bool isShape = child && child->type == NodeType::Shape;
+    bool hasMesh = isShape && child->model >= 0 && size_t(child->model) < meshes.size() &&
+                   meshes[child->model];
+
+    std::string name = node.name;
+    if (depth == 0)
+        name = path.stem().string();
+    else if (name.empty())
+        name = isShape ? std::format("Model {}", child->model) : std::format("Group {}", nodeId);
+    auto layer = hiddenLayers.find(node.layer);
+    bool visible = !node.hidden && (layer == hiddenLayers.end() || !layer->second);
+
+    glm::mat3 rotation(1.0f);
+    if (!DecodeRotation(node.rotation, rotation))
+        LOG_WARN("{}: node {} has an invalid rotation {}", path.string(), nodeId, node.rotation);
+    rotation = toEditorAxes * rotation * glm::transpose(toEditorAxes);
+    // Mirroring goes into the scale, which a quaternion can't hold
+    glm::vec3 scale(1.0f);
+    if (glm::determinant(rotation) < 0.0f) {
+        scale.x = -1.0f;
+        rotation[0] = -rotation[0];
+    }
+    glm::vec3 euler = glm::degrees(glm::eulerAngles(glm::quat_cast(rotation)));
+    glm::vec3 position = toEditorAxes * glm::vec3(node.translation);
+
+    Entity entity = registry->CreateEntity();
+    registry->AddComponent<MetaComponent>(entity, name, visible);
+    registry->AddComponent<TransformComponent>(entity, position, euler, scale);
+    if (hasMesh)
+        registry->AddComponent<MeshComponent>(entity, meshes[child->model].get());
+    registry->AddComponent<HierarchyComponent>(entity, parent);
+
+    if (child && !isShape)
+        InstantiateNode(registry, node.children.front(), entity, depth + 1);
+    return entity;
+}
+
+void VoxFile::DeleteMeshes() {
+    for (std::unique_ptr<RawModel>& mesh : meshes) {
+        if (mesh)
+            mesh->DeleteModel();
+    }
+    meshes.clear();
+}
+
+size_t VoxFile::GetVoxelCount() const {
+    size_t count = 0;
+    for (const VoxModel& model : models)
+        count += model.voxelCount;
+    return count;
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <Voxel/pch.h>
+#include <span>
+#include <Voxel/ECS/Entity.h>
+#include <Voxel/Rendering/RawModel.h>
+#include <Voxel/Volume/VoxelVolume.h>
+
+// A model of a .vox file, converted to the editor's Y up axes
+struct VoxModel {
+    glm::ivec3 size{0};
+    // Offset of the model's origin from voxel (0, 0, 0), MagicaVoxel places models by their
+    // centre
+    glm::ivec3 pivot{0};
+    VoxelVolume voxels;
+    size_t voxelCount = 0;
+};
+
+// MagicaVoxel .vox files: SIZE/XYZI models, the RGBA palette and the nTRN/nGRP/nSHP scene
+// graph, with the layers' hidden flags. Other chunks are skipped.
+//
+// Load maps the file, walks its chunks once and then decodes the models in parallel, each into
+// its own VoxelVolume. Instantiate turns every transform node into an entity with a
+// TransformComponent and a HierarchyComponent mirroring the graph, shapes share one mesh per
+// model through MeshComponent. MagicaVoxel is Z up, (x, y, z) there is (x, z, -y) here.
+class VoxFile {
+  public:
+    static constexpr const char* extension = ".vox";
+    // XYZI stores coordinates as bytes
+    static constexpr int maxModelSize = 256;
+
+    static bool Load(const std::filesystem::path& path, VoxFile& outFile);
+
+    // Creates the entities under one root entity named after the file, meshing the models in
+    // parallel. The meshes belong to this file, call DeleteMeshes once the entities are gone.
+    Entity Instantiate(class EntityRegistry* registry);
+    void DeleteMeshes();
+
+    const std::vector<VoxModel>& GetModels() const { return models; }
+    const std::array<uint32_t, 256>& GetPalette() const { return palette; }
+    size_t GetNodeCount() const { return nodes.size(); }
+    size_t GetVoxelCount() const;
+
+  private:
+    enum class NodeType { Transform, Group, Shape };
+
+    struct Node {
+        NodeType type = NodeType::Transform;
+        std::string name;
+        bool hidden = false;
+        int layer = -1;
+        // Transform: the one child. Group: every child.
+        std::vector<int> children;
+        // Shape: the model, the first one for animated shapes
+        int model = -1;
+        // Transform: first frame, in MagicaVoxel axes
+        glm::ivec3 translation{0};
+        uint8_t rotation = 0x04; // Identity
+    };
+
+    // Reads a chunk's content into the file, false when it is malformed
+    bool ReadChunk(const char* id, std::span<const std::byte> content);
+    // The node's entity, InvalidEntity for nodes that aren't transforms
+    Entity InstantiateNode(class EntityRegistry* registry, int nodeId, Entity parent, int depth);
+
+    std::filesystem::path path;
+    std::array<uint32_t, 256> palette{};
+    std::vector<VoxModel> models;
+    std::unordered_map<int, Node> nodes;
+    std::unordered_map<int, bool> hiddenLayers;
+
+    // The XYZI content of every model while Load runs, pointing into the mapping
+    std::vector<std::span<const std::byte>> modelVoxels;
+
+    // One per model, null for empty ones
+    std::vector<std::unique_ptr<RawModel>> meshes;
+};
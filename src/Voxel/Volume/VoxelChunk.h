@@ -0,0 +1,83 @@
+#pragma once
+#include <Voxel/pch.h>
+#include <atomic>
+#include <cstring>
+#include <span>
+#include <Voxel/Log/MemoryTracker.h>
+
+// Palette index of a voxel, 0 is empty
+using Voxel = uint8_t;
+
+// Cube of size^3 voxels, x varies fastest, then y, then z
+class VoxelChunk {
+  public:
+    static constexpr int shift = 5;
+    static constexpr int size = 1 << shift;
+    static constexpr size_t voxelCount = size_t(1) << (3 * shift);
+
+    VoxelChunk() { MemoryTracker::RecordAllocation(MemoryTag::Voxel, sizeof(VoxelChunk)); }
+    VoxelChunk(const VoxelChunk& other) : voxels(other.voxels) {
+        MemoryTracker::RecordAllocation(MemoryTag::Voxel, sizeof(VoxelChunk));
+    }
+    VoxelChunk& operator=(const VoxelChunk& other) = default;
+    ~VoxelChunk() { MemoryTracker::RecordFree(MemoryTag::Voxel, sizeof(VoxelChunk)); }
+
+    static size_t Index(int x, int y, int z) {
+        return static_cast<size_t>(x | (y << shift) | (z << (2 * shift)));
+    }
+
+    Voxel Get(int x, int y, int z) const { return voxels[Index(x, y, z)]; }
+    void Set(int x, int y, int z, Voxel voxel) { voxels[Index(x, y, z)] = voxel; }
+    void Fill(Voxel voxel) { voxels.fill(voxel); }
+
+    std::span<Voxel, voxelCount> GetVoxels() { return voxels; }
+    std::span<const Voxel, voxelCount> GetVoxels() const { return voxels; }
+
+    // True when every voxel is the same, which is then written to outVoxel
+    bool IsUniform(Voxel& outVoxel) const {
+        outVoxel = voxels[0];
+        // Every voxel equals the next one
+        return std::memcmp(voxels.data(), voxels.data() + 1, voxelCount - 1) == 0;
+    }
+
+    bool operator==(const VoxelChunk& other) const { return voxels == other.voxels; }
+
+  private:
+    std::array<Voxel, voxelCount> voxels{};
+};
+
+// Shared reference to a chunk, copied on write. Copying a handle shares the voxels and Write
+// copies them first when another handle still holds them, so copying a whole volume costs a
+// pointer per chunk. The count is atomic: a copy can be read and dropped on another thread while
+// the thread that made it keeps writing through its own handle.
+class ChunkHandle {
+  public:
+    ChunkHandle() = default;
+    ChunkHandle(std::unique_ptr<VoxelChunk> voxels) : voxels(std::move(voxels)) {}
+
+    static ChunkHandle Make() {
+        ChunkHandle handle;
+        handle.voxels = std::make_shared<VoxelChunk>();
+        return handle;
+    }
+
+    const VoxelChunk* Get() const { return voxels.get(); }
+    const VoxelChunk& operator*() const { return *voxels; }
+    const VoxelChunk* operator->() const { return voxels.get(); }
+    explicit operator bool() const { return voxels != nullptr; }
+
+    // Voxels only this handle holds, copied first when they are shared. Not for empty handles.
+    VoxelChunk& Write() {
+        if (voxels.use_count() > 1) {
+            voxels = std::make_shared<VoxelChunk>(*voxels);
+        } else {
+            // Pairs with the release of the last other handle, whose reads finish before ours
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        return *voxels;
+    }
+    bool IsShared() const { return voxels.use_count() > 1; }
+
+  private:
+    std::shared_ptr<VoxelChunk> voxels;
+};
@@ -0,0 +1,77 @@
+#include "VoxelMask.h"
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+#include <bit>
+// GCC and Clang define __SSE2__ when targeting it, MSVC never does: its x64 builds always have
+// SSE2 and 32 bit x86 ones from /arch:SSE2 on. Anything else, ARM included, gets the scalar loop.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VOXEL_MASK_SSE2
+#include <emmintrin.h>
+#endif
+#include <Voxel/Volume/VoxelVolume.h>
+
+uint32_t VoxelMask::RowOccupancy(const Voxel* row) {
+#if defined(VOXEL_MASK_SSE2)
+    // A compare and a byte sign mask per 16 voxels
+    __m128i zero = _mm_setzero_si128();
+    __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row));
+    __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + 16));
+    uint32_t empty = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(low, zero))) |
+                     static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(high, zero))) << 16;
+    return ~empty;
+#else
+    uint32_t bits = 0;
+    for (int x = 0; x < VoxelChunk::size; x++)
+        bits |= static_cast<uint32_t>(row[x] != 0) << x;
+    return bits;
+#endif
+}
+
+void VoxelMask::Occupancy(std::span<const Voxel, VoxelChunk::voxelCount> voxels, ChunkBits& out) {
+    for (int row = 0; row < rowCount; row++)
+        out[row] = RowOccupancy(voxels.data() + (row << VoxelChunk::shift));
+}
+
+bool VoxelMask::Contains(const glm::ivec3& position) const {
+    const ChunkBits* bits = GetChunk(VoxelVolume::ToChunk(position));
+    if (!bits)
+        return false;
+
+    glm::ivec3 local = VoxelVolume::ToLocal(position);
+    return ((*bits)[local.y + local.z * VoxelChunk::size] >> local.x) & 1;
+}
+
+void VoxelMask::Insert(const glm::ivec3& position) {
+    glm::ivec3 local = VoxelVolume::ToLocal(position);
+    GetOrCreateChunk(VoxelVolume::ToChunk(position))[local.y + local.z * VoxelChunk::size] |=
+        uint32_t(1) << local.x;
+}
+
+const VoxelMask::ChunkBits* VoxelMask::GetChunk(const glm::ivec3& chunk) const {
+    auto it = chunks.find(chunk);
+    return it != chunks.end() ? &it->second : nullptr;
+}
+
+VoxelMask::ChunkBits& VoxelMask::GetOrCreateChunk(const glm::ivec3& chunk) {
+    auto [it, inserted] = chunks.try_emplace(chunk);
+    if (inserted)
+        it->second.fill(0);
+    return it->second;
+}
+
+void VoxelMask::SetChunk(const glm::ivec3& chunk, const ChunkBits& bits) {
+    bool any = std::any_of(bits.begin(), bits.end(), [](uint32_t row) { return row != 0; });
+    if (any)
+        chunks[chunk] = bits;
+    else
+        chunks.erase(chunk);
+}
+
+size_t VoxelMask::Count() const {
+    size_t count = 0;
+    for (const auto& [chunk, bits] : chunks) {
+        for (uint32_t row : bits)
+            count += std::popcount(row);
+    }
+    return count;
+}
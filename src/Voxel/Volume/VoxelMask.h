@@ -0,0 +1,46 @@
+#pragma once
+#include <Voxel/pch.h>
+#include <glm/gtx/hash.hpp>
+#include <Voxel/Log/MemoryTracker.h>
+#include <Voxel/Volume/VoxelChunk.h>
+
+// Sparse set of voxel positions, a bit per voxel for each chunk holding any of them, as used for
+// selections. Chunks are laid out as in VoxelChunk with a word per row along x: bit x of word
+// y + z * size is voxel (x, y, z).
+class VoxelMask {
+  public:
+    static_assert(VoxelChunk::size == 32, "a row of a chunk is one 32 bit word");
+    static constexpr int rowCount = VoxelChunk::size * VoxelChunk::size;
+    using ChunkBits = std::array<uint32_t, rowCount>;
+    using ChunkMap = TrackedUnorderedMap<glm::ivec3, ChunkBits, MemoryTag::Voxel>;
+
+    // Bits first to last of a row word, both included
+    static uint32_t RowBits(int first, int last) {
+        return static_cast<uint32_t>((uint64_t(2) << last) - (uint64_t(1) << first));
+    }
+
+    // Bits of the voxels of a row that aren't empty, from 32 voxels along x
+    static uint32_t RowOccupancy(const Voxel* row);
+    // RowOccupancy of every row of a chunk's voxels
+    static void Occupancy(std::span<const Voxel, VoxelChunk::voxelCount> voxels, ChunkBits& out);
+
+    bool Contains(const glm::ivec3& position) const;
+    void Insert(const glm::ivec3& position);
+
+    // nullptr when no voxel of the chunk is in the mask
+    const ChunkBits* GetChunk(const glm::ivec3& chunk) const;
+    // Cleared when the chunk wasn't in the mask yet
+    ChunkBits& GetOrCreateChunk(const glm::ivec3& chunk);
+    // Leaves the chunk out when bits has none set
+    void SetChunk(const glm::ivec3& chunk, const ChunkBits& bits);
+    const ChunkMap& GetChunks() const { return chunks; }
+    size_t GetChunkCount() const { return chunks.size(); }
+
+    // Voxels in the mask
+    size_t Count() const;
+    bool IsEmpty() const { return chunks.empty(); }
+    void Clear() { chunks.clear(); }
+
+  private:
+    ChunkMap chunks;
+};
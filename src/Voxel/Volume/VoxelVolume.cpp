@@ -0,0 +1,84 @@
+#include "VoxelVolume.h"
+#include <Voxel/pch.h>
+#include <Voxel/Core.h>
+
+VoxelVolume::VoxelVolume() {
+    // Greys, so voxels show up before a palette is set
+    for (size_t i = 0; i < palette.size(); i++) {
+        uint32_t grey = static_cast<uint32_t>(i);
+        palette[i] = 0xFF000000u | (grey << 16) | (grey << 8) | grey;
+    }
+}
+
+Voxel VoxelVolume::Get(const glm::ivec3& position) const {
+    const VoxelChunk* chunk = GetChunk(ToChunk(position));
+    if (!chunk)
+        return 0;
+
+    glm::ivec3 local = ToLocal(position);
+    return chunk->Get(local.x, local.y, local.z);
+}
+
+void VoxelVolume::Set(const glm::ivec3& position, Voxel voxel) {
+    glm::ivec3 local = ToLocal(position);
+    GetOrCreateChunk(ToChunk(position)).Set(local.x, local.y, local.z, voxel);
+}
+
+const VoxelChunk* VoxelVolume::GetChunk(const glm::ivec3& chunk) const {
+    auto it = chunks.find(chunk);
+    return it != chunks.end() ? it->second.Get() : nullptr;
+}
+
+ChunkHandle VoxelVolume::GetChunkHandle(const glm::ivec3& chunk) const {
+    auto it = chunks.find(chunk);
+    return it != chunks.end() ? it->second : ChunkHandle();
+}
+
+VoxelChunk* VoxelVolume::WriteChunk(const glm::ivec3& chunk) {
+    auto it = chunks.find(chunk);
+    return it != chunks.end() ? &it->second.Write() : nullptr;
+}
+
+VoxelChunk& VoxelVolume::GetOrCreateChunk(const glm::ivec3& chunk) {
+    ChunkHandle& voxels = chunks[chunk];
+    if (!voxels)
+        voxels = ChunkHandle::Make();
+    return voxels.Write();
+}
+
+void VoxelVolume::SetChunk(const glm::ivec3& chunk, ChunkHandle voxels) {
+    chunks[chunk] = std::move(voxels);
+}
+
+ChunkHandle VoxelVolume::ExchangeChunk(const glm::ivec3& chunk, ChunkHandle voxels) {
+    if (!voxels) {
+        auto it = chunks.find(chunk);
+        if (it == chunks.end())
+            return ChunkHandle();
+        ChunkHandle previous = std::move(it->second);
+        chunks.erase(it);
+        return previous;
+    }
+
+    ChunkHandle& slot = chunks[chunk];
+    std::swap(slot, voxels);
+    return voxels;
+}
+
+VoxelVolume VoxelVolume::Snapshot() const {
+    VoxelVolume snapshot;
+    snapshot.chunks = chunks;
+    snapshot.palette = palette;
+    return snapshot;
+}
+
+size_t VoxelVolume::GetSharedChunkCount() const {
+    return std::count_if(chunks.begin(), chunks.end(),
+                         [](const auto& entry) { return entry.second.IsShared(); });
+}
+
+glm::vec3 VoxelVolume::UnpackColour(uint32_t colour) {
+    return glm::vec3(static_cast<float>(colour & 0xFF), static_cast<float>((colour >> 8) & 0xFF),
+                     static_cast<float>((colour >> 16) & 0xFF)) /
+           255.0f;
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <Voxel/pch.h>
+#include <glm/gtx/hash.hpp>
+#include <Voxel/Log/MemoryTracker.h>
+#include <Voxel/Volume/VoxelChunk.h>
+
+// Sparse voxel grid made of chunks, only chunks that were written to exist. Voxels are palette
+// indices into a 256 colour palette shared by the whole volume.
+//
+// Chunks are held through ChunkHandles, so a Snapshot shares every chunk with the volume and the
+// first write to a chunk afterwards copies it. Pointers from the writing functions are only good
+// until the next snapshot.
+class VoxelVolume {
+  public:
+    using ChunkMap = TrackedUnorderedMap<glm::ivec3, ChunkHandle, MemoryTag::Voxel>;
+    using ChunkSet = TrackedUnorderedSet<glm::ivec3, MemoryTag::Voxel>;
+
+    VoxelVolume();
+    VoxelVolume(VoxelVolume&&) = default;
+    VoxelVolume& operator=(VoxelVolume&&) = default;
+
+    // Chunk holding a voxel, rounding towards negative infinity
+    static glm::ivec3 ToChunk(const glm::ivec3& position) {
+        return glm::ivec3(position.x >> VoxelChunk::shift, position.y >> VoxelChunk::shift,
+                          position.z >> VoxelChunk::shift);
+    }
+    // Position of a voxel inside its chunk
+    static glm::ivec3 ToLocal(const glm::ivec3& position) {
+        constexpr int mask = VoxelChunk::size - 1;
+        return glm::ivec3(position.x & mask, position.y & mask, position.z & mask);
+    }
+
+    // Empty outside of the chunks
+    Voxel Get(const glm::ivec3& position) const;
+    // Creates the chunk when needed
+    void Set(const glm::ivec3& position, Voxel voxel);
+
+    const VoxelChunk* GetChunk(const glm::ivec3& chunk) const;
+    // Empty when there is no such chunk
+    ChunkHandle GetChunkHandle(const glm::ivec3& chunk) const;
+    // Voxels of the chunk to write to, copied first when a snapshot shares them. nullptr when
+    // there is no such chunk.
+    VoxelChunk* WriteChunk(const glm::ivec3& chunk);
+    // WriteChunk, creating the chunk when needed
+    VoxelChunk& GetOrCreateChunk(const glm::ivec3& chunk);
+    void SetChunk(const glm::ivec3& chunk, ChunkHandle voxels);
+    void RemoveChunk(const glm::ivec3& chunk) { chunks.erase(chunk); }
+    // Puts voxels in place of the chunk and hands back what was there, an empty handle removes
+    // the chunk
+    ChunkHandle ExchangeChunk(const glm::ivec3& chunk, ChunkHandle voxels);
+    const ChunkMap& GetChunks() const { return chunks; }
+    size_t GetChunkCount() const { return chunks.size(); }
+    void Clear() { chunks.clear(); }
+
+    // Copy of the chunks and palette that shares every chunk with this volume, a handle copy per
+    // chunk. Take it on the thread that writes to the volume, it can then be read anywhere.
+    VoxelVolume Snapshot() const;
+    // Chunks this volume shares with a snapshot or an undo entry
+    size_t GetSharedChunkCount() const;
+
+    // Chunks edits changed since the last ClearDirtyChunks, for whoever meshes the volume. Set and
+    // the chunk functions above don't mark anything, edit tools and undo do.
+    void MarkDirty(const glm::ivec3& chunk) { dirtyChunks.insert(chunk); }
+    const ChunkSet& GetDirtyChunks() const { return dirtyChunks; }
+    void ClearDirtyChunks() { dirtyChunks.clear(); }
+
+    // RGBA, 0xAABBGGRR. Index 0 is never drawn.
+    const std::array<uint32_t, 256>& GetPalette() const { return palette; }
+    void SetPalette(const std::array<uint32_t, 256>& newPalette) { palette = newPalette; }
+    glm::vec3 GetColour(Voxel voxel) const { return UnpackColour(palette[voxel]); }
+    // 0xAABBGGRR to an RGB colour in [0, 1]
+    static glm::vec3 UnpackColour(uint32_t colour);
+
+  private:
+    ChunkMap chunks;
+    ChunkSet dirtyChunks;
+    std::array<uint32_t, 256> palette;
+};
@@ -2,61 +2,40 @@
 
 #include <Voxel/pch.h>
 #include <Voxel/Core.h>
+#include <Voxel/Benchmark/HeadlessRunner.h>
 #include <Voxel/Camera.h>
-#include <Voxel/ECS/Components/MeshComponent.h>
-#include <Voxel/ECS/Components/MetaComponent.h>
-#include <Voxel/ECS/Components/TransformComponent.h>
 #include <Voxel/ECS/Systems/RenderSystem.h>
 #include <Voxel/ECS/Systems/TransformSystem.h>
 #include <Voxel/ECS/Systems/VisibilitySystem.h>
+#include <Voxel/EditorSettings.h>
+#include <Voxel/Editing/UndoHistory.h>
+#include <Voxel/Rendering/Primitives.h>
 #include <Voxel/Rendering/RawModel.h>
 #include <Voxel/Rendering/ShaderLoader.h>
+#include <Voxel/Scene/SceneDescription.h>
+#include <Voxel/Scene/SceneSerializer.h>
+#include <Voxel/UI/Panels/ProfilingPanel.h>
+#include <Voxel/Volume/ChunkManager.h>
+#include <Voxel/Volume/VoxFile.h>
 
 bool mouseLocked = true;
 bool wireframeMode = false;
 
 void ToggleWireframeMode();
 void CloseWindow();
+void UndoEdit();
+void RedoEdit();
 
-int main() {
+int main(int argc, char** argv) {
     Log::Init();
+    LaunchOptions options = LaunchOptions::Parse(argc, argv);
     Application* application = Application::GetInstance();
-    if (!application->Initialise()) {
+    if (!application->Initialise(options)) {
+        Log::Shutdown();
         return -1;
     }
 
-    Vertex vertexArray[] = {
-        // Positions							//Colours
-        {glm::vec3(0.5f, 0.5f, 0.5f), glm::vec3(0.0f, 0.0f, 0.0f)},   // Front face top right
-        {glm::vec3(0.5f, -0.5f, 0.5f), glm::vec3(1.0f, 0.0f, 0.0f)},  // Front face bottom right
-        {glm::vec3(-0.5f, -0.5f, 0.5f), glm::vec3(0.0f, 1.0f, 0.0f)}, // Front face bottom left
-        {glm::vec3(-0.5f, 0.5f, 0.5f), glm::vec3(0.0f, 0.0f, 1.0f)},  // Front face top left
-
-        {glm::vec3(0.5f, 0.5f, -0.5f), glm::vec3(1.0f, 1.0f, 0.0f)},   // Back face top right
-        {glm::vec3(0.5f, -0.5f, -0.5f), glm::vec3(0.0f, 1.0f, 1.0f)},  // Back face bottom right
-        {glm::vec3(-0.5f, -0.5f, -0.5f), glm::vec3(1.0f, 0.0f, 1.0f)}, // Back face bottom left
-        {glm::vec3(-0.5f, 0.5f, -0.5f), glm::vec3(1.0f, 1.0f, 1.0f)}   // Back face top left
-    };
-
-    unsigned int indices[] = {
-        3, 1, 0, // first triangle - front top right, front bottom right, front top left
-        3, 2, 1, // second triangle - front bottom right, front bottom left, front top left
-        4, 5, 7, // first triangle - back top right, back bottom right, back top left
-        5, 6, 7, // second triangle - back bottom right, back bottom left, back top left
-        0, 5, 4, // first triangle - front top right, back bottom right, back top right
-        1, 5, 0, // second triangle - front bottom right, back bottom right, front top right
-        7, 6, 3, // first triangle - front top left, back bottom left, back top left
-        3, 6, 2, // second triangle - front bottom left, back bottom left, front top left
-        7, 3, 4, // first triangle - back top left, front top left, back top right
-        3, 0, 4, // second triangle - back top right, front top right, front top left
-        5, 2, 6, // first triangle - back bottom left, front bottom left, back bottom right
-        5, 1, 2, // second triangle - back bottom right, front bottom right, front bottom left
-    };
-
-    std::vector<Vertex> verticesVector(std::begin(vertexArray), std::end(vertexArray));
-    std::vector<unsigned int> indicesVector(std::begin(indices), std::end(indices));
-
-    RawModel testModel = RawModel(verticesVector, indicesVector);
+    RawModel testModel = Primitives::CreateCube();
     Camera* camera = application->GetCamera();
 
     EntityRegistry* entityRegistry = EntityRegistry::GetInstance();
@@ -75,35 +54,64 @@ int main() {
         return -3;
     }
 
+    inputManager->BindAction(InputAction::Edit_Undo, InputTrigger::Pressed, UndoEdit);
+    inputManager->BindAction(InputAction::Edit_Redo, InputTrigger::Pressed, RedoEdit);
     inputManager->BindAction(InputAction::Debug_Exit, InputTrigger::Released, CloseWindow);
     inputManager->BindAction(InputAction::Debug_Wireframe, InputTrigger::Released,
                              ToggleWireframeMode);
+    inputManager->BindAction(InputAction::Debug_ProfilerCapture, InputTrigger::Released,
+                             ProfilingPanel::StartCapture);
 
     // TODO: Use configurable bindings
+    inputManager->AddBinding(InputAction::Edit_Undo, InputDevice::Keyboard, GLFW_KEY_Z,
+                             GLFW_MOD_CONTROL);
+    inputManager->AddBinding(InputAction::Edit_Redo, InputDevice::Keyboard, GLFW_KEY_Z,
+                             GLFW_MOD_CONTROL | GLFW_MOD_SHIFT);
     inputManager->AddBinding(InputAction::Debug_Exit, InputDevice::Keyboard, GLFW_KEY_ESCAPE, 0);
     inputManager->AddBinding(InputAction::Debug_Wireframe, InputDevice::Keyboard, GLFW_KEY_0, 0);
+    inputManager->AddBinding(InputAction::Debug_ProfilerCapture, InputDevice::Keyboard, GLFW_KEY_F9,
+                             0);
+
+    UndoHistory::SetMemoryCap(
+        size_t(std::max(EditorSettings::GetInt("Editor", "UndoMemoryMB", 256), 1)) << 20);
+
+    SceneDescription scene;
+    VoxFile voxFile;
+    ChunkManager* chunkManager = nullptr;
+    if (options.scenePath.extension() == ChunkFile::extension) {
+        ChunkStreamingSettings streaming;
+        streaming.memoryBudget =
+            size_t(std::max(EditorSettings::GetInt("Streaming", "MemoryBudgetMB", 512), 1)) << 20;
+        streaming.residentRadius = EditorSettings::GetInt("Streaming", "ResidentRadius", 8);
+        streaming.maxUploadsPerFrame =
+            std::max(EditorSettings::GetInt("Streaming", "MaxUploadsPerFrame", 32), 1);
+        chunkManager = new ChunkManager(streaming);
+        chunkManager->Open(options.scenePath);
+    } else if (options.scenePath.extension() == VoxFile::extension) {
+        if (VoxFile::Load(options.scenePath, voxFile))
+            voxFile.Instantiate(entityRegistry);
+    } else if (options.scenePath.extension() == SceneSerializer::extension) {
+        SceneSerializer::Load(options.scenePath, entityRegistry, &testModel);
+    } else if (SceneDescription::Load(options.scenePath, scene)) {
+        scene.Instantiate(entityRegistry, &testModel);
+    }
 
-    // Create entities
-    for (int x = 0; x < 8; x++) {
-        for (int y = 0; y < 8; y++) {
-            for (int z = 0; z < 8; z++) {
-                Entity entity = entityRegistry->CreateEntity();
-                auto& meta = entityRegistry->AddComponent<MetaComponent>(
-                    entity, std::format("Cube ({}, {}, {})", x, y, z), true);
-                auto& transform =
-                    entityRegistry->AddComponent<TransformComponent>(entity, glm::vec3(x, y, z));
-                auto& mesh = entityRegistry->AddComponent<MeshComponent>(entity, &testModel);
-                auto& hierarchy = entityRegistry->AddComponent<HierarchyComponent>(entity);
-            }
-        }
+    HeadlessRunner* headlessRunner = nullptr;
+    if (application->IsHeadless()) {
+        headlessRunner = new HeadlessRunner(options, camera, scene.GetCenter(), scene.GetRadius());
+    } else {
+        glfwShowWindow(application->GetWindow());
     }
 
-    glfwShowWindow(application->GetWindow());
     LOG_INFO("Initialisation complete");
+    int frameIndex = 0;
     while (application->ShouldStayOpen()) {
+        if (headlessRunner)
+            headlessRunner->BeginFrame(frameIndex);
+
         Profiler::StartFrame();
         {
-            ScopedTimer timer(Profiler::frame);
+            PROFILE_SCOPE("Frame");
             application->StartFrame();
             inputManager->Update();
 
@@ -120,20 +128,38 @@ int main() {
             };
 
             {
-                ScopedTimer timer(Profiler::system);
+                PROFILE_SCOPE("System");
                 VisibilitySystem::Run();
                 TransformSystem::Run();
+                if (chunkManager)
+                    chunkManager->Update(camera->GetPosition());
                 RenderSystem::Run();
             }
 
             application->EndFrame();
         }
         Profiler::EndFrame();
+
+        if (headlessRunner)
+            headlessRunner->EndFrame(frameIndex);
+        frameIndex++;
     }
 
+    if (headlessRunner) {
+        headlessRunner->WriteTimings();
+        delete headlessRunner;
+        headlessRunner = nullptr;
+    }
+
+    // Entries point at entities and volumes that are about to go
+    UndoHistory::Clear();
     delete inputManager;
     inputManager = nullptr;
+    delete chunkManager;
+    chunkManager = nullptr;
+    RenderSystem::Shutdown();
     testModel.DeleteModel();
+    voxFile.DeleteMeshes();
     entityRegistry->Cleanup();
     delete entityRegistry;
     entityRegistry = nullptr;
@@ -141,12 +167,24 @@ int main() {
     delete application;
     application = nullptr;
     LOG_INFO("Exiting...");
+    Log::Shutdown();
 
     return 0;
 }
 
 void ToggleWireframeMode() { wireframeMode = !wireframeMode; }
 
+// Text fields have their own undo for Ctrl+Z
+void UndoEdit() {
+    if (!ImGui::GetIO().WantTextInput)
+        UndoHistory::Undo();
+}
+
+void RedoEdit() {
+    if (!ImGui::GetIO().WantTextInput)
+        UndoHistory::Redo();
+}
+
 void CloseWindow() {
     Application* application = Application::GetInstance();
     if (application == nullptr) {